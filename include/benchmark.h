@@ -1,6 +1,7 @@
 #ifndef BENCHMARK_H
 #define BENCHMARK_H
 
+#include <stddef.h>
 #include <time.h>
 #include <sys/time.h>
 
@@ -38,6 +39,75 @@ typedef struct {
 void run_benchmark_suite(Benchmark *benchmarks, int count);
 void print_benchmark_results(const Benchmark *benchmarks, int count);
 
+/* Benchmark registry: self-registering, parameterized benchmarks */
+typedef struct {
+    size_t size;            /* problem size (matrix dimension, text length, ...) */
+    int pattern_length;     /* search pattern length, 0 if unused */
+    int threads;            /* worker threads, 0 if unused */
+} BenchmarkParams;
+
+/* setup/teardown run outside the timed region; run returns a checksum */
+typedef void* (*BenchmarkSetupFunc)(const BenchmarkParams *params);
+typedef double (*BenchmarkRunFunc)(void *state, const BenchmarkParams *params);
+typedef void (*BenchmarkTeardownFunc)(void *state);
+
+typedef struct RegisteredBenchmark {
+    const char *name;
+    BenchmarkSetupFunc setup;
+    BenchmarkRunFunc run;
+    BenchmarkTeardownFunc teardown;
+    const BenchmarkParams *params;
+    int param_count;
+    struct RegisteredBenchmark *next;
+} RegisteredBenchmark;
+
+typedef struct {
+    const char *filter;         /* POSIX extended regex on instance names, NULL = all */
+    int repetitions;            /* timed runs per instance */
+    BenchmarkParams overrides;  /* non-zero fields replace registered values */
+} BenchmarkRunOptions;
+
+void benchmark_register(RegisteredBenchmark *benchmark);
+void benchmark_run_options_init(BenchmarkRunOptions *options);
+int benchmark_registry_list(const char *filter);
+int benchmark_registry_run(const BenchmarkRunOptions *options);
+
+/*
+ * Register a benchmark from any translation unit before main() runs:
+ *   static const BenchmarkParams sizes[] = { {64, 0, 0}, {256, 0, 0} };
+ *   BENCHMARK_REGISTER(gemm, "matrix/gemm", setup, run, teardown, sizes);
+ */
+#define BENCHMARK_REGISTER(id, bench_name, setup_fn, run_fn, teardown_fn, param_array) \
+    static RegisteredBenchmark id##_registration = { \
+        bench_name, setup_fn, run_fn, teardown_fn, param_array, \
+        (int)(sizeof(param_array) / sizeof((param_array)[0])), NULL }; \
+    __attribute__((constructor)) static void id##_register(void) { \
+        benchmark_register(&id##_registration); \
+    }
+
+/* Benchmark environment: CPU placement and noise detection */
+#define BENCH_MAX_CPUS 256
+
+typedef struct {
+    int pinned_cpus[BENCH_MAX_CPUS];
+    int pinned_count;           /* 0 when not pinned */
+    int priority_raised;        /* 1 if the nice value was lowered */
+    int nice_value;
+    char governor[32];          /* cpufreq governor of the first pinned/online CPU */
+    int turbo_enabled;          /* 1 on, 0 off, -1 unknown */
+    int smt_active;             /* 1 on, 0 off, -1 unknown */
+    double sibling_busy_pct;    /* busiest SMT sibling outside the pinned set */
+    double background_busy_pct; /* CPU use by other processes, averaged over online CPUs */
+    double load_average;        /* 1-minute load average */
+    int warnings;
+} BenchmarkEnvironment;
+
+int benchmark_parse_cpu_list(const char *list, int *cpus, int max_cpus);
+int benchmark_pin_cpus(const char *list);
+int benchmark_raise_priority(void);
+void benchmark_environment_detect(BenchmarkEnvironment *env);
+void benchmark_environment_print(const BenchmarkEnvironment *env);
+
 /* Memory usage tracking */
 typedef struct {
     long peak_memory_kb;
@@ -0,0 +1,192 @@
+#ifndef BITMANIP_H
+#define BITMANIP_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Bit-manipulation primitives for word-at-a-time kernels. With Zbb/Zbc
+ * enabled in -march these map to single RISC-V instructions (orc.b,
+ * ctz, clz, clmul, clmulh); other targets get portable SWAR or loop
+ * fallbacks with identical results. Words are little-endian.
+ */
+
+#if defined(__riscv) && defined(__riscv_zbb)
+#define BITMANIP_HAS_ZBB 1
+#endif
+
+#if defined(__riscv) && defined(__riscv_zbc)
+#define BITMANIP_HAS_ZBC 1
+#endif
+
+#if !defined(BITMANIP_HAS_ZBC) && defined(__x86_64__) && defined(__PCLMUL__)
+#include <wmmintrin.h>
+#define BITMANIP_HAS_PCLMUL 1
+#endif
+
+#define BIT_ONES  0x0101010101010101ULL
+#define BIT_HIGHS 0x8080808080808080ULL
+#define BIT_LOWS7 0x7f7f7f7f7f7f7f7fULL
+
+/*
+ * Scanners that read whole aligned words may touch bytes past the end of
+ * a string. An aligned word never crosses a page, so this is safe, but
+ * AddressSanitizer would report it.
+ */
+#if defined(__GNUC__)
+#define BITMANIP_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define BITMANIP_NO_SANITIZE
+#endif
+
+/* Portable 64-bit load from any address (byte loads on strict-alignment RISC-V tunings) */
+static inline uint64_t bit_load64(const void *p) {
+    uint64_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+/*
+ * Aligned 64-bit load for scanners that may read past the terminator
+ * (see BITMANIP_NO_SANITIZE); may_alias keeps it valid on char data.
+ */
+typedef uint64_t __attribute__((may_alias)) bit_word_t;
+
+BITMANIP_NO_SANITIZE
+static inline uint64_t bit_load64_aligned(const void *p) {
+    return *(const bit_word_t *)p;
+}
+
+static inline void bit_store64_aligned(void *p, uint64_t w) {
+    *(bit_word_t *)p = w;
+}
+
+/*
+ * A single native 64-bit load even when p is misaligned. On RISC-V this
+ * may trap and be emulated by firmware, so only use it once misaligned
+ * access is known to be fast (see string_misaligned_access()).
+ */
+typedef uint64_t __attribute__((may_alias, aligned(1))) bit_uword_t;
+
+BITMANIP_NO_SANITIZE
+static inline uint64_t bit_load64_misaligned(const void *p) {
+#ifdef __riscv
+    uint64_t w;
+    __asm__ ("ld %0, 0(%1)" : "=r"(w) : "r"(p), "m"(*(const char (*)[8])p));
+    return w;
+#else
+    return *(const bit_uword_t *)p;
+#endif
+}
+
+/* Bytes [shift/8, shift/8 + 8) of the aligned pair lo:hi; shift is 8..56 */
+static inline uint64_t bit_merge64(uint64_t lo, uint64_t hi, unsigned shift) {
+    return (lo >> shift) | (hi << (64 - shift));
+}
+
+/* Count trailing/leading zero bits; x must be non-zero */
+static inline int bit_ctz64(uint64_t x) {
+    return __builtin_ctzll(x);
+}
+
+static inline int bit_clz64(uint64_t x) {
+    return __builtin_clzll(x);
+}
+
+/* orc.b: 0xff in every byte of x that is non-zero, 0x00 in every zero byte */
+static inline uint64_t bit_orc_b(uint64_t x) {
+#ifdef BITMANIP_HAS_ZBB
+    uint64_t r;
+    __asm__ ("orc.b %0, %1" : "=r"(r) : "r"(x));
+    return r;
+#else
+    // Adding 0x7f sets bit 7 of every byte with a non-zero low part
+    // without carrying into the next byte
+    uint64_t t = ((x & BIT_LOWS7) + BIT_LOWS7) | x;
+    return ((t & BIT_HIGHS) >> 7) * 0xff;
+#endif
+}
+
+/* 0xff in every zero byte of x */
+static inline uint64_t bit_zero_bytes(uint64_t x) {
+    return ~bit_orc_b(x);
+}
+
+/* 0xff in every byte of x equal to c */
+static inline uint64_t bit_match_bytes(uint64_t x, unsigned char c) {
+    return ~bit_orc_b(x ^ (BIT_ONES * c));
+}
+
+/* 0x20 in every byte of x that is an ASCII letter (the case bit), 0 elsewhere */
+static inline uint64_t bit_alpha_bytes(uint64_t x) {
+    // Fold to lowercase, then range-check 'a'..'z' in the low seven bits
+    // with carry-free adds; bytes >= 0x80 are masked out at the end
+    uint64_t folded = (x | (BIT_ONES * 0x20)) & BIT_LOWS7;
+    uint64_t ge_a = folded + BIT_ONES * (0x80 - 'a');
+    uint64_t gt_z = folded + BIT_ONES * (0x80 - 'z' - 1);
+    return ((ge_a ^ gt_z) & ~x & BIT_HIGHS) >> 2;
+}
+
+/* Bit i set for every 0xff byte i of a byte mask (a scalar movemask) */
+static inline unsigned bit_byte_mask(uint64_t bytes) {
+    // Each flag bit lands in its own bit of the top byte, so no carries
+    return (unsigned)((((bytes & BIT_HIGHS) >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/* Number of set bits (cpop on Zbb) */
+static inline int bit_popcount64(uint64_t x) {
+    return __builtin_popcountll(x);
+}
+
+/* Index of the first flagged byte in a non-zero byte mask */
+static inline int bit_first_byte(uint64_t mask) {
+    return bit_ctz64(mask) >> 3;
+}
+
+/* Carry-less multiply: low and high 64 bits of the 128-bit product */
+static inline uint64_t bit_clmul(uint64_t a, uint64_t b) {
+#if defined(BITMANIP_HAS_ZBC)
+    uint64_t r;
+    __asm__ ("clmul %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+#elif defined(BITMANIP_HAS_PCLMUL)
+    __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a),
+                                     _mm_cvtsi64_si128((long long)b), 0x00);
+    return (uint64_t)_mm_cvtsi128_si64(p);
+#else
+    uint64_t r = 0;
+    for (int i = 0; i < 64; i++) {
+        if ((b >> i) & 1) r ^= a << i;
+    }
+    return r;
+#endif
+}
+
+static inline uint64_t bit_clmulh(uint64_t a, uint64_t b) {
+#if defined(BITMANIP_HAS_ZBC)
+    uint64_t r;
+    __asm__ ("clmulh %0, %1, %2" : "=r"(r) : "r"(a), "r"(b));
+    return r;
+#elif defined(BITMANIP_HAS_PCLMUL)
+    __m128i p = _mm_clmulepi64_si128(_mm_cvtsi64_si128((long long)a),
+                                     _mm_cvtsi64_si128((long long)b), 0x00);
+    return (uint64_t)_mm_cvtsi128_si64(_mm_unpackhi_epi64(p, p));
+#else
+    uint64_t r = 0;
+    for (int i = 1; i < 64; i++) {
+        if ((b >> i) & 1) r ^= a >> (64 - i);
+    }
+    return r;
+#endif
+}
+
+/* Reverse the bit order of a 64-bit word (table setup, not hot paths) */
+static inline uint64_t bit_reverse64(uint64_t x) {
+    uint64_t r = 0;
+    for (int i = 0; i < 64; i++) {
+        r = (r << 1) | ((x >> i) & 1);
+    }
+    return r;
+}
+
+#endif /* BITMANIP_H */
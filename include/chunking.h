@@ -0,0 +1,94 @@
+#ifndef CHUNKING_H
+#define CHUNKING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Content-defined chunking for deduplication. Boundaries come from a
+ * Gear rolling hash (shift-left plus a per-byte table entry, so bit k
+ * depends on the last k + 1 bytes only) tested against a mask of spread
+ * high bits. FastCDC normalization uses a harder mask before the average
+ * size and an easier one after it, which narrows the size distribution
+ * without a sliding window. A cut depends only on the bytes since the
+ * previous cut, so boundaries realign shortly after an edit and the
+ * streaming and threaded paths reproduce the one-shot result exactly.
+ */
+
+typedef struct {
+    size_t min_size;        /* no cut before this many bytes */
+    size_t avg_size;        /* target size, a power of two */
+    size_t max_size;        /* forced cut */
+    int normalization;      /* FastCDC level: mask bits added/removed around avg_size (0 = plain Gear) */
+    uint64_t mask_small;    /* set by cdc_params_init */
+    uint64_t mask_large;
+} CdcParams;
+
+/* avg_size/4, avg_size, avg_size*8 with normalization 2; -1 unless avg_size is a power of two >= 64 */
+int cdc_params_init(CdcParams *params, size_t avg_size, int normalization);
+
+/*
+ * Length of the chunk starting at data: the first cut, max_size, or
+ * length when neither occurs first (so a stream needs more input when the
+ * result equals length and is below max_size).
+ */
+size_t cdc_find_boundary(const CdcParams *params, const void *data, size_t length);
+
+/* Baseline: 48-byte Rabin-Karp style polynomial window, same sizes, no normalization */
+size_t cdc_find_boundary_rabin(const CdcParams *params, const void *data, size_t length);
+
+typedef struct {
+    uint64_t offset;
+    size_t length;
+    uint64_t fingerprint;   /* hash64 of the chunk bytes, seed 0 */
+} CdcChunk;
+
+typedef struct {
+    CdcChunk *chunks;
+    size_t count;
+    size_t capacity;
+} CdcChunkList;
+
+void cdc_chunk_list_free(CdcChunkList *list);
+
+/*
+ * Chunk and fingerprint a whole buffer into list (replacing its contents).
+ * With threads > 1 every worker chunks its own segment from the segment
+ * start; a serial pass then walks the true boundaries into each segment
+ * until they meet one the worker found and adopts the rest of its list.
+ */
+int cdc_chunk_buffer(const CdcParams *params, const void *data, size_t size, int threads, CdcChunkList *list);
+
+/*
+ * Streaming chunker. Completed chunks are appended to stream->chunks;
+ * callers may consume them and reset chunks.count at any time. Only the
+ * open chunk (at most max_size bytes) is buffered, and its hash state is
+ * kept so each update scans only the new bytes.
+ */
+typedef struct {
+    CdcParams params;
+    unsigned char *pending;
+    size_t pending_size;
+    size_t scanned;         /* pending bytes already searched for a cut */
+    uint64_t hash;          /* Gear hash after them */
+    uint64_t offset;        /* stream offset of pending[0] */
+    CdcChunkList chunks;
+} CdcStream;
+
+int cdc_stream_init(CdcStream *stream, const CdcParams *params);
+int cdc_stream_update(CdcStream *stream, const void *data, size_t length);
+
+/* Emit the open chunk as the last one */
+int cdc_stream_finish(CdcStream *stream);
+void cdc_stream_free(CdcStream *stream);
+
+/* Bytes in chunks whose content repeats an earlier chunk of list over data (fingerprint, then memcmp) */
+uint64_t cdc_duplicate_bytes(const CdcChunkList *list, const void *data);
+
+/* --chunks: mmap path, chunk it in parallel and report GB/s, sizes and duplicate bytes */
+int cdc_chunk_file(const char *path, int threads);
+
+/* Rabin vs Gear vs FastCDC vs threaded throughput, size spread and edit resilience */
+void compare_chunking_algorithms(size_t size);
+
+#endif /* CHUNKING_H */
@@ -0,0 +1,32 @@
+#ifndef FLOAT_TEXT_H
+#define FLOAT_TEXT_H
+
+#include <stddef.h>
+
+/*
+ * Decimal text <-> double without libc. Parsing reads up to 19
+ * significant digits (eight at a time with SWAR) and converts them with
+ * Clinger's exact fast path or the Eisel-Lemire 128-bit power-of-ten
+ * multiply; the rare inputs neither can round correctly (more digits,
+ * halfway ambiguities, subnormals, overflow) fall back to strtod.
+ * Formatting is Ryu: the shortest digit string that parses back to the
+ * same double, from the same power-of-ten table.
+ */
+
+/* Output buffer size for float_text_format, including the terminator */
+#define FLOAT_TEXT_MAX 32
+
+/*
+ * Parse [+-]digits[.digits][(e|E)[+-]digits], inf, infinity or nan
+ * (any case) from [begin, end). Returns the first byte after the number,
+ * or NULL when the text does not start with one.
+ */
+const char* float_text_parse(const char *begin, const char *end, double *value);
+
+/*
+ * Shortest round-trip text of value ("0.1", "1e22", "-5e-324", "inf");
+ * writes a terminated string to out and returns its length.
+ */
+size_t float_text_format(double value, char *out);
+
+#endif /* FLOAT_TEXT_H */
@@ -0,0 +1,40 @@
+#ifndef HASH_OPS_H
+#define HASH_OPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * CRC-32 (IEEE 802.3 polynomial, reflected; same values as zlib's crc32).
+ * Start with crc = 0 and pass the previous result to continue a stream.
+ * Zbc and PCLMUL builds fold 16 bytes per step with carry-less
+ * multiplies; other builds use slice-by-8 tables.
+ */
+uint32_t crc32_ieee(uint32_t crc, const void *data, size_t length);
+
+/*
+ * CRC-32C (Castagnoli, as used by iSCSI, ext4 and SCTP). SSE4.2 builds
+ * use the crc32 instruction; otherwise the same engine as crc32_ieee.
+ */
+uint32_t crc32c(uint32_t crc, const void *data, size_t length);
+
+/* Bit-at-a-time reference implementations for validation */
+uint32_t crc32_ieee_reference(uint32_t crc, const void *data, size_t length);
+uint32_t crc32c_reference(uint32_t crc, const void *data, size_t length);
+
+/*
+ * Fast non-cryptographic 64-bit hash for keys and records (wyhash/xxh3
+ * style; inputs over 256 bytes take the vectorizable 8-lane path).
+ * Equal seeds give equal results on every platform.
+ */
+uint64_t hash64(const void *data, size_t length, uint64_t seed);
+uint64_t hash64_string(const char *str);
+
+/* Byte-at-a-time FNV-1a baseline */
+uint64_t hash64_fnv1a(const void *data, size_t length);
+
+/* Performance comparison */
+void compare_crc_algorithms(size_t size);
+void compare_hash_algorithms(size_t size);
+
+#endif /* HASH_OPS_H */
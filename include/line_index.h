@@ -0,0 +1,46 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include <stddef.h>
+
+/*
+ * Line-oriented access to a byte buffer. Newlines are found 64 bytes at
+ * a time: vector compares (AVX2/SSE2, SWAR words elsewhere) produce a
+ * 64-bit hit mask that is popcounted for counting or walked with ctz to
+ * emit offsets. Large buffers are split into chunks across workers: a
+ * counting pass sizes every chunk's slice of the index, then each chunk
+ * writes its offsets in place, so the index is built without merging.
+ */
+
+/* Number of '\n' bytes in data[0, size) */
+size_t line_count_newlines(const char *data, size_t size);
+
+/* As line_count_newlines, with threads workers (<= 0: default) */
+size_t line_count_newlines_parallel(const char *data, size_t size, int threads);
+
+typedef struct {
+    const char *data;       /* indexed buffer, not owned */
+    size_t size;
+    size_t *newlines;       /* offset of every '\n', ascending */
+    size_t count;
+} LineIndex;
+
+int line_index_build(LineIndex *index, const char *data, size_t size, int threads);
+void line_index_free(LineIndex *index);
+
+/* Lines in the buffer; a final line without '\n' counts, an empty buffer has none */
+size_t line_index_lines(const LineIndex *index);
+
+/* Start and length (without '\n') of 0-based line; 0, or -1 when out of range */
+int line_index_line(const LineIndex *index, size_t line, const char **start, size_t *length);
+
+/* 0-based line holding byte offset (a '\n' belongs to the line it ends) */
+size_t line_index_line_of(const LineIndex *index, size_t offset);
+
+/* --lines: mmap path, count and index its lines and report GB/s */
+int line_index_file(const char *path, int threads);
+
+/* Bytewise vs vector vs threaded counting and indexing on a synthetic log */
+void compare_line_counting(size_t size);
+
+#endif /* LINE_INDEX_H */
@@ -0,0 +1,36 @@
+#ifndef LOG_STATS_H
+#define LOG_STATS_H
+
+#include <stddef.h>
+#include "string_map.h"
+
+/*
+ * Access-log analytics: per-key frequencies over a whole log. Lines in
+ * Common/Combined Log Format count their client, request path and status;
+ * any other line counts its space-separated tokens (word frequencies).
+ */
+typedef struct {
+    StringMap *clients;     /* first field: client address */
+    StringMap *paths;       /* request target inside the quoted request line */
+    StringMap *statuses;    /* 3-digit status after the request line */
+    StringMap *tokens;      /* words of lines in no known format */
+    size_t lines;
+    size_t bytes;
+} LogStats;
+
+int log_stats_init(LogStats *stats);
+void log_stats_free(LogStats *stats);
+
+/* Count every line of data[0, size) with threads workers (<= 0 uses all cores) */
+int log_stats_process(const char *data, size_t size, int threads, LogStats *stats);
+
+/* Print the top entries of each non-empty table */
+void log_stats_print(const LogStats *stats, size_t top);
+
+/* --logstats: mmap path, process it and report GB/s and lines/s */
+int log_stats_file(const char *path, int threads);
+
+/* Synthetic Combined Log Format text of about bytes bytes (caller frees) */
+char* log_stats_synthetic(size_t bytes, size_t *length);
+
+#endif /* LOG_STATS_H */
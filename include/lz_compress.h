@@ -0,0 +1,81 @@
+#ifndef LZ_COMPRESS_H
+#define LZ_COMPRESS_H
+
+#include <stddef.h>
+#include "string_builder.h"
+
+/*
+ * LZ77 compression in the LZ4 block format: sequences of a token byte,
+ * literals and a 16-bit offset, with 4-byte minimum matches and the last
+ * 5 bytes always literal. Level 0 probes one hash-table slot per position
+ * and skips ahead faster the longer nothing matches; levels 1-9 walk a
+ * hash chain 2^level candidates deep for the longest match. Matches are
+ * extended eight bytes per compare. The decoder copies literals 16 bytes
+ * and matches 8 bytes at a time into the output slack, so most sequences
+ * decode without a per-byte loop.
+ */
+
+#define LZ_MAX_LEVEL 9
+
+/* Worst-case compressed size (incompressible input) */
+size_t lz_compress_bound(size_t size);
+
+/* Compress into dst; returns the compressed size, or 0 when capacity is too small or size too large */
+size_t lz_compress(const void *src, size_t size, void *dst, size_t capacity, int level);
+
+/* Decode one block into dst; -1 on malformed input or when capacity is too small */
+int lz_decompress(const void *src, size_t size, void *dst, size_t capacity, size_t *decoded);
+
+/* Byte-at-a-time decoder, the baseline for the wide-copy one */
+int lz_decompress_reference(const void *src, size_t size, void *dst, size_t capacity, size_t *decoded);
+
+/*
+ * Streaming frames: "RVLZ", log2 of the block size and a flags byte,
+ * then blocks of a 32-bit little-endian header (bit 31 set: stored raw,
+ * low bits: payload length) followed by the payload and the CRC-32C of
+ * the decoded block, then a zero header. Blocks are independent.
+ * Frame bytes collect in output; callers may take them and reset
+ * output.length at any time.
+ */
+typedef struct {
+    int level;
+    size_t block_size;
+    unsigned char *block;       /* input gathered for the next block */
+    size_t block_fill;
+    unsigned char *scratch;     /* compressed block */
+    void *state;                /* match finder tables, reused across blocks */
+    StringBuilder output;
+} LzFrameEncoder;
+
+/* block_size is a power of two from 64 KiB to 4 MiB */
+int lz_frame_encoder_init(LzFrameEncoder *encoder, int level, size_t block_size);
+int lz_frame_encoder_update(LzFrameEncoder *encoder, const void *data, size_t size);
+int lz_frame_encoder_finish(LzFrameEncoder *encoder);
+void lz_frame_encoder_free(LzFrameEncoder *encoder);
+
+typedef struct {
+    unsigned char *pending;     /* header or block bytes not yet complete */
+    size_t pending_size;
+    size_t pending_capacity;
+    size_t block_size;          /* from the frame header, 0 until it is read */
+    int checksums;
+    int done;                   /* end mark seen */
+    StringBuilder output;
+} LzFrameDecoder;
+
+int lz_frame_decoder_init(LzFrameDecoder *decoder);
+
+/* -1 on a corrupt frame, a failed checksum or data after the end mark */
+int lz_frame_decoder_update(LzFrameDecoder *decoder, const void *data, size_t size);
+
+/* -1 unless the end mark was reached */
+int lz_frame_decoder_finish(LzFrameDecoder *decoder);
+void lz_frame_decoder_free(LzFrameDecoder *decoder);
+
+/* --lz: mmap path and report ratio and throughput per level */
+int lz_compress_file(const char *path);
+
+/* Ratio and compress/decompress throughput on log text, binary records and random data */
+void compare_lz_algorithms(size_t size);
+
+#endif /* LZ_COMPRESS_H */
@@ -21,9 +21,45 @@ Matrix* matrix_multiply_riscv_optimized(const Matrix *a, const Matrix *b);
 void matrix_print(const Matrix *matrix);
 double matrix_sum(const Matrix *matrix);
 void matrix_transpose(Matrix *matrix);
+Matrix* matrix_transpose_copy(const Matrix *matrix);
+
+/* Memory-traffic tuning for large matrices */
+#ifndef MATRIX_STREAMING_THRESHOLD
+#define MATRIX_STREAMING_THRESHOLD (4u << 20)   /* bytes written before stores bypass cache */
+#endif
+#ifndef MATRIX_PREFETCH_THRESHOLD
+#define MATRIX_PREFETCH_THRESHOLD (256u << 10)  /* operand bytes before GEMM prefetches */
+#endif
+#ifndef MATRIX_PREFETCH_DISTANCE
+#define MATRIX_PREFETCH_DISTANCE 8              /* rows of B ahead in the reduction loop */
+#endif
+
+void matrix_set_streaming_threshold(size_t bytes);
+int matrix_use_streaming(size_t bytes);
+void matrix_set_prefetch_distance(size_t rows);
+size_t matrix_prefetch_distance(size_t operand_bytes);
+
+/*
+ * Text I/O on float_text (shortest round-trip output, exact parsing).
+ * CSV is one row per line, comma-separated. Matrix Market reads "array"
+ * (general) and "coordinate" (general, symmetric, skew-symmetric; real,
+ * integer or pattern) files and writes "array real general". Rows or
+ * entries are parsed and formatted in chunks across threads (<= 0 uses
+ * all cores). Parsers return NULL on malformed input.
+ */
+Matrix* matrix_parse_csv(const char *text, size_t size, int threads);
+char* matrix_format_csv(const Matrix *matrix, int threads, size_t *length);
+Matrix* matrix_parse_market(const char *text, size_t size, int threads);
+char* matrix_format_market(const Matrix *matrix, int threads, size_t *length);
+Matrix* matrix_read_csv(const char *path, int threads);
+int matrix_write_csv(const Matrix *matrix, const char *path, int threads);
+Matrix* matrix_read_market(const char *path, int threads);
+int matrix_write_market(const Matrix *matrix, const char *path, int threads);
 
 /* Performance measurement utilities */
 double benchmark_matrix_multiply(size_t size, int iterations);
 void compare_matrix_algorithms(size_t size);
+void compare_streaming_kernels(size_t size);
+void compare_matrix_io(size_t rows, size_t cols);
 
 #endif /* MATRIX_OPS_H */
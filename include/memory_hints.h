@@ -0,0 +1,102 @@
+#ifndef MEMORY_HINTS_H
+#define MEMORY_HINTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*
+ * Cache-bypassing store and prefetch helpers for bandwidth-bound kernels.
+ *
+ * x86-64:  non-temporal stores (movntpd) skip the read-for-ownership of the
+ *          destination line; an sfence orders them before later stores.
+ * RISC-V:  with Zicboz, cbo.zero claims a whole cache block without fetching
+ *          it, which is the RISC-V equivalent for zero fills. Other streaming
+ *          writes fall back to regular stores.
+ */
+
+/*
+ * Zicboz block size in bytes from the kernel's hwprobe report, or 0 when
+ * it is unknown (not RISC-V Linux, no Zicboz, or an older kernel). The
+ * size is implementation-defined, so it is read at runtime and cached.
+ */
+size_t memory_cbo_zero_block_size(void);
+
+/* Software prefetch (compiles to prefetch.r with Zicbop, prefetcht* on x86) */
+#define PREFETCH_READ(addr)  __builtin_prefetch((addr), 0, 3)
+#define PREFETCH_WRITE(addr) __builtin_prefetch((addr), 1, 3)
+
+/* Order streaming stores before subsequent normal stores */
+static inline void stream_fence(void) {
+#if defined(__SSE2__)
+    _mm_sfence();
+#elif defined(__riscv)
+    __asm__ volatile ("fence w, w" ::: "memory");
+#endif
+}
+
+/* Store one double without allocating its line in cache (where supported) */
+static inline void stream_store_double(double *dst, double value) {
+#if defined(__SSE2__) && defined(__x86_64__)
+    long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+    _mm_stream_si64((long long *)dst, bits);
+#else
+    *dst = value;
+#endif
+}
+
+/* Write n doubles from src to dst, bypassing the cache where supported */
+static inline void stream_copy_doubles(double *dst, const double *src, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    // movntpd needs a 16-byte aligned destination
+    if (((uintptr_t)dst & 15) != 0 && n > 0) {
+        dst[0] = src[0];
+        i = 1;
+    }
+    for (; i + 1 < n; i += 2) {
+        _mm_stream_pd(&dst[i], _mm_loadu_pd(&src[i]));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] = src[i];
+    }
+}
+
+/* Zero n doubles without read-for-ownership traffic where supported */
+static inline void stream_zero_doubles(double *dst, size_t n) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (((uintptr_t)dst & 15) != 0 && n > 0) {
+        dst[0] = 0.0;
+        i = 1;
+    }
+    const __m128d zero = _mm_setzero_pd();
+    for (; i + 1 < n; i += 2) {
+        _mm_stream_pd(&dst[i], zero);
+    }
+#elif defined(__riscv) && defined(__riscv_zicboz)
+    // The loop steps whole blocks of doubles from a block-aligned address,
+    // so it needs a known power-of-two size; anything else uses memset
+    const size_t block = memory_cbo_zero_block_size();
+    if (block >= sizeof(double) && (block & (block - 1)) == 0) {
+        const size_t per_block = block / sizeof(double);
+        size_t head = ((block - ((uintptr_t)dst & (block - 1))) & (block - 1)) / sizeof(double);
+        if (head > n) head = n;
+        memset(dst, 0, head * sizeof(double));
+        for (i = head; i + per_block <= n; i += per_block) {
+            __asm__ volatile ("cbo.zero (%0)" :: "r"(&dst[i]) : "memory");
+        }
+    }
+#endif
+    if (i < n) {
+        memset(&dst[i], 0, (n - i) * sizeof(double));
+    }
+}
+
+#endif /* MEMORY_HINTS_H */
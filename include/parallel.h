@@ -0,0 +1,27 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+/* Work function for a half-open range [begin, end) executed by thread_id */
+typedef void (*ParallelRangeFunc)(size_t begin, size_t end, int thread_id, void *arg);
+
+/* Thread count used when callers pass threads <= 0 */
+int parallel_default_threads(void);
+
+/* Resolve a requested thread count (<= 0 selects the default) */
+int parallel_resolve_threads(int threads);
+
+/* Pin worker t to cpus[t % count] in later parallel_for calls (count 0 clears) */
+void parallel_set_cpu_affinity(const int *cpus, int count);
+
+/*
+ * Split [0, count) into chunks of `grain` items and hand them out
+ * dynamically to `threads` workers. Runs inline when only one worker
+ * is needed. thread_id is in [0, threads) so callers can index
+ * per-thread scratch buffers.
+ */
+void parallel_for(size_t count, size_t grain, int threads,
+                  ParallelRangeFunc func, void *arg);
+
+#endif /* PARALLEL_H */
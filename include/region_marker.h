@@ -0,0 +1,119 @@
+#ifndef REGION_MARKER_H
+#define REGION_MARKER_H
+
+/*
+ * Kernel region markers for emulator-based instruction counting.
+ *
+ * On RISC-V each marker is a single HINT instruction (an integer shift
+ * with rd = x0, a no-op on every implementation) that the QEMU plugin in
+ * tools/qemu_plugin recognises while translating code:
+ *
+ *   begin:  slli x0, x<id / 64>, <id % 64>
+ *   end:    srli x0, x0, 1
+ *
+ * Regions nest; the plugin attributes each instruction to the innermost
+ * open region. Other architectures compile the markers out, as does
+ * -DNO_REGION_MARKERS. Markers clobber "memory" so the region's loads
+ * and stores stay between them; that also makes each one a compiler
+ * barrier, so mark whole kernels or benchmark loops, not small helpers
+ * that get inlined into callers' hot loops.
+ *
+ * The region table below is shared with the plugin, which uses it to
+ * name regions in its report. Append new regions at the end.
+ */
+
+#define KERNEL_REGIONS(X)                                   \
+    X(REGION_GEMM_NAIVE,        "matrix/gemm_naive")        \
+    X(REGION_GEMM_BLOCKED,      "matrix/gemm_blocked")      \
+    X(REGION_GEMM_RISCV,        "matrix/gemm_riscv")        \
+    X(REGION_FILL_RANDOM,       "matrix/fill_random")       \
+    X(REGION_FILL_IDENTITY,     "matrix/fill_identity")     \
+    X(REGION_TRANSPOSE_COPY,    "matrix/transpose_copy")    \
+    X(REGION_SPMM,              "sparse/spmm")              \
+    X(REGION_SPGEMM_SYMBOLIC,   "sparse/spgemm_symbolic")   \
+    X(REGION_SPGEMM_NUMERIC,    "sparse/spgemm_numeric")    \
+    X(REGION_STRING_LENGTH,     "string/length")            \
+    X(REGION_STRING_FIND,       "string/find_naive")        \
+    X(REGION_STRING_FIND_OPT,   "string/find_optimized")    \
+    X(REGION_KMP,               "string/kmp")               \
+    X(REGION_BOYER_MOORE,       "string/boyer_moore")       \
+    X(REGION_RABIN_KARP,        "string/rabin_karp")        \
+    X(REGION_FAST_SIN,          "math/fast_sin")            \
+    X(REGION_FAST_EXP,          "math/fast_exp")            \
+    X(REGION_FAST_SQRT,         "math/fast_sqrt")           \
+    X(REGION_IS_PRIME,          "math/is_prime")            \
+    X(REGION_CRC32,             "hash/crc32")               \
+    X(REGION_STRING_MEMCHR,     "string/memchr")            \
+    X(REGION_STRING_FIND_CHAR,  "string/find_char")         \
+    X(REGION_STRING_COMPARE,    "string/compare_optimized") \
+    X(REGION_STRING_MEMCPY,     "string/memcpy")            \
+    X(REGION_CRC32C,            "hash/crc32c")              \
+    X(REGION_HASH64,            "hash/hash64")              \
+    X(REGION_STRING_MAP,        "string/map")               \
+    X(REGION_LOG_STATS,         "string/logstats")          \
+    X(REGION_STRING_BUILDER,    "string/builder")           \
+    X(REGION_ROPE,              "string/rope")              \
+    X(REGION_REGEX_DFA,         "string/regex_dfa")         \
+    X(REGION_REGEX_BUILD,       "string/regex_build")       \
+    X(REGION_ALIGN_SCALAR,      "string/align_scalar")      \
+    X(REGION_ALIGN_STRIPED,     "string/align_striped")     \
+    X(REGION_STRING_FIND_NOCASE, "string/find_nocase")      \
+    X(REGION_LINE_COUNT,        "string/count_lines")       \
+    X(REGION_LINE_INDEX,        "string/line_index")        \
+    X(REGION_FLOAT_PARSE,       "string/float_parse")       \
+    X(REGION_FLOAT_FORMAT,      "string/float_format")      \
+    X(REGION_MATRIX_CSV_PARSE,  "matrix/csv_parse")         \
+    X(REGION_MATRIX_CSV_FORMAT, "matrix/csv_format")        \
+    X(REGION_BASE64_ENCODE,     "string/base64_encode")     \
+    X(REGION_BASE64_DECODE,     "string/base64_decode")     \
+    X(REGION_HEX_ENCODE,        "string/hex_encode")        \
+    X(REGION_HEX_DECODE,        "string/hex_decode")        \
+    X(REGION_CDC_CHUNK,         "hash/cdc_chunk")           \
+    X(REGION_CDC_FINGERPRINT,   "hash/cdc_fingerprint")     \
+    X(REGION_KEY_SET_SCAN,      "string/keyset_scan")       \
+    X(REGION_LZ_COMPRESS,       "string/lz_compress")       \
+    X(REGION_LZ_DECOMPRESS,     "string/lz_decompress")
+
+#define REGION_ENUM_ENTRY(id, name) id,
+#define REGION_NAME_ENTRY(id, name) name,
+
+enum {
+    REGION_NONE = 0,                /* code outside any marked region */
+    KERNEL_REGIONS(REGION_ENUM_ENTRY)
+    REGION_COUNT
+};
+
+#if defined(__riscv) && !defined(NO_REGION_MARKERS)
+
+#define REGION_BEGIN(id)                                                \
+    __asm__ volatile (".option push\n\t.option norvc\n\t"               \
+                      "slli x0, x%0, %1\n\t.option pop"                 \
+                      :: "i"((id) >> 6), "i"((id) & 63) : "memory")
+
+#define REGION_END()                                                    \
+    __asm__ volatile (".option push\n\t.option norvc\n\t"               \
+                      "srli x0, x0, 1\n\t.option pop" ::: "memory")
+
+static inline __attribute__((always_inline)) void region_scope_exit(int *unused) {
+    (void)unused;
+    REGION_END();
+}
+
+#define REGION_SCOPE_CONCAT_INNER(a, b) a##b
+#define REGION_SCOPE_CONCAT(a, b) REGION_SCOPE_CONCAT_INNER(a, b)
+
+/* Open a region that closes automatically when the enclosing block exits */
+#define REGION_SCOPE(id)                                                \
+    REGION_BEGIN(id);                                                   \
+    int REGION_SCOPE_CONCAT(region_scope_, __LINE__)                    \
+        __attribute__((cleanup(region_scope_exit), unused)) = (id)
+
+#else
+
+#define REGION_BEGIN(id) ((void)0)
+#define REGION_END()     ((void)0)
+#define REGION_SCOPE(id) ((void)0)
+
+#endif
+
+#endif /* REGION_MARKER_H */
@@ -0,0 +1,87 @@
+#ifndef SEQUENCE_ALIGN_H
+#define SEQUENCE_ALIGN_H
+
+#include <stddef.h>
+
+/*
+ * Pairwise DNA alignment with affine gaps: Smith-Waterman (local) and
+ * Needleman-Wunsch (global). A gap of length k costs
+ * gap_open + (k - 1) * gap_extend. Bases are A, C, G, T in either case;
+ * any other byte (N, IUPAC codes) scores as a mismatch against everything.
+ *
+ * The SIMD kernels use Farrar's striped layout: the query is split into
+ * vector-length stripes so the only dependency left inside a column is
+ * the vertical gap, fixed up by a short "lazy F" pass. Local alignment
+ * runs with 8-bit saturating scores first and is rerun with 16-bit
+ * scores when the 8-bit result saturates; anything 16 bits cannot hold
+ * falls back to the scalar 32-bit kernel. Results are exact in every
+ * case.
+ */
+typedef struct {
+    int match;          /* added for equal bases, > 0 */
+    int mismatch;       /* added for different bases, <= 0 */
+    int gap_open;       /* cost of the first gap position, >= gap_extend */
+    int gap_extend;     /* cost of each further position, > 0 */
+} AlignScoring;
+
+typedef enum {
+    ALIGN_LOCAL,        /* Smith-Waterman: best-scoring pair of substrings */
+    ALIGN_GLOBAL        /* Needleman-Wunsch: both sequences end to end */
+} AlignMode;
+
+typedef enum {
+    ALIGN_WIDTH_8,
+    ALIGN_WIDTH_16,
+    ALIGN_WIDTH_32      /* scalar */
+} AlignWidth;
+
+typedef struct {
+    int score;
+    size_t query_end;   /* last aligned positions (inclusive; global: the sequence ends) */
+    size_t ref_end;
+    AlignWidth width;   /* score width that produced the result */
+} AlignResult;
+
+typedef struct {
+    const char *query;
+    size_t query_length;
+    const char *ref;
+    size_t ref_length;
+} AlignPair;
+
+/* Match 2, mismatch -3, open 5, extend 2 */
+extern const AlignScoring align_default_scoring;
+
+/* Scalar Gotoh reference (32-bit scores); returns 0 or -1 on bad input */
+int align_scalar(const char *query, size_t query_length, const char *ref, size_t ref_length,
+                 const AlignScoring *scoring, AlignMode mode, AlignResult *result);
+
+/*
+ * Striped query profile: per base, the score of every query position
+ * laid out in stripe order. Build one per query and align it against
+ * any number of references.
+ */
+typedef struct AlignProfile AlignProfile;
+
+AlignProfile* align_profile_create(const char *query, size_t length, const AlignScoring *scoring);
+void align_profile_free(AlignProfile *profile);
+
+/* Striped alignment with width promotion; returns 0 or -1 on failure */
+int align_striped(AlignProfile *profile, const char *ref, size_t ref_length,
+                  AlignMode mode, AlignResult *result);
+
+/* One-shot striped alignment (builds and frees a profile) */
+int align_sequences(const char *query, size_t query_length, const char *ref, size_t ref_length,
+                    const AlignScoring *scoring, AlignMode mode, AlignResult *result);
+
+/* Align every pair on `threads` workers (<= 0: default); returns 0 or -1 */
+int align_batch(const AlignPair *pairs, size_t count, const AlignScoring *scoring,
+                AlignMode mode, int threads, AlignResult *results);
+
+/* Vector width in bytes of the striped kernels in this build */
+int align_vector_bytes(void);
+
+/* Scalar vs striped vs batched alignment of random read pairs */
+void compare_alignment_algorithms(size_t pairs, size_t length);
+
+#endif /* SEQUENCE_ALIGN_H */
@@ -0,0 +1,34 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <stddef.h>
+#include "matrix_ops.h"
+
+/* Compressed Sparse Row (CSR) matrix */
+typedef struct {
+    double *values;         /* nnz non-zero values, row by row */
+    size_t *col_indices;    /* nnz column indices, sorted within each row */
+    size_t *row_ptr;        /* rows + 1 offsets into values/col_indices */
+    size_t rows;
+    size_t cols;
+    size_t nnz;
+} SparseMatrix;
+
+/* Sparse matrix construction and conversion */
+SparseMatrix* sparse_matrix_create(size_t rows, size_t cols, size_t nnz);
+void sparse_matrix_destroy(SparseMatrix *matrix);
+SparseMatrix* sparse_matrix_random(size_t rows, size_t cols, double density);
+SparseMatrix* sparse_matrix_from_dense(const Matrix *dense, double tolerance);
+Matrix* sparse_matrix_to_dense(const SparseMatrix *sparse);
+double sparse_matrix_sum(const SparseMatrix *matrix);
+
+/* SpMM: sparse x dense, row-parallel (threads <= 0 uses all cores) */
+Matrix* sparse_multiply_dense(const SparseMatrix *a, const Matrix *b, int threads);
+
+/* SpGEMM: sparse x sparse, two-pass symbolic/numeric with hash accumulators */
+SparseMatrix* sparse_multiply_sparse(const SparseMatrix *a, const SparseMatrix *b, int threads);
+
+/* Performance measurement utilities */
+void compare_sparse_algorithms(size_t size, double density);
+
+#endif /* SPARSE_MATRIX_H */
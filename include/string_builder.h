@@ -0,0 +1,60 @@
+#ifndef STRING_BUILDER_H
+#define STRING_BUILDER_H
+
+#include <stddef.h>
+
+/*
+ * Growable byte buffer for building a string from many pieces. Capacity
+ * doubles when full, so n bytes of appends cost O(n) copying in total
+ * (chained string_concatenate recopies the whole prefix every call).
+ * The buffer is always NUL-terminated.
+ */
+typedef struct {
+    char *data;
+    size_t length;
+    size_t capacity;        /* usable bytes, excluding the terminator */
+} StringBuilder;
+
+int string_builder_init(StringBuilder *builder, size_t capacity);
+void string_builder_free(StringBuilder *builder);
+int string_builder_reserve(StringBuilder *builder, size_t additional);
+int string_builder_append(StringBuilder *builder, const char *data, size_t length);
+int string_builder_append_str(StringBuilder *builder, const char *str);
+int string_builder_append_char(StringBuilder *builder, char c);
+int string_builder_appendf(StringBuilder *builder, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/* Hand the buffer to the caller (free() it) and reset the builder */
+char* string_builder_finish(StringBuilder *builder, size_t *length);
+
+/*
+ * Rope: an immutable, reference-counted, height-balanced (AVL) tree of
+ * leaf chunks. Concatenation and splitting copy only the O(log n) nodes
+ * on one path and share everything else, so both inputs stay valid.
+ * Every function returning a Rope* returns a new reference (NULL on
+ * allocation failure) that the caller drops with rope_release. Counts
+ * are not atomic: share a rope between threads only while it is read.
+ */
+typedef struct RopeNode Rope;
+
+Rope* rope_from_string(const char *data, size_t length);
+Rope* rope_retain(Rope *rope);
+void rope_release(Rope *rope);
+
+size_t rope_length(const Rope *rope);
+int rope_height(const Rope *rope);
+char rope_char_at(const Rope *rope, size_t index);
+
+Rope* rope_concat(Rope *left, Rope *right);
+Rope* rope_append(Rope *rope, const char *data, size_t length);
+
+/* left = [0, position), right = [position, length); returns 0 or -1 */
+int rope_split(Rope *rope, size_t position, Rope **left, Rope **right);
+
+/* Copy the whole rope into one NUL-terminated malloc'd buffer */
+char* rope_flatten(const Rope *rope, size_t *length);
+
+/* Building a string from pieces: chained concatenate vs builder vs rope */
+void compare_string_building(size_t total, size_t piece);
+
+#endif /* STRING_BUILDER_H */
@@ -0,0 +1,49 @@
+#ifndef STRING_CODEC_H
+#define STRING_CODEC_H
+
+#include <stddef.h>
+
+/*
+ * Binary-to-text codecs (RFC 4648 base64 and base16/hex). The vector
+ * paths keep every lookup in registers: x86 uses pshufb shuffles and
+ * range compares (AVX2, else SSSE3); other targets run 48/64-byte lane
+ * loops written for auto-vectorization (RVV compilers lower them to
+ * compares and merges). The *_scalar functions are the byte-at-a-time
+ * references. Encoders write no terminator.
+ */
+
+typedef enum {
+    BASE64_STANDARD,        /* A-Z a-z 0-9 + /, '='-padded output */
+    BASE64_URL              /* A-Z a-z 0-9 - _, unpadded output */
+} Base64Alphabet;
+
+size_t base64_encoded_length(size_t length, Base64Alphabet alphabet);
+
+/* Upper bound on the bytes decoded from length characters */
+size_t base64_decoded_max(size_t length);
+
+/* Encode length bytes into out (base64_encoded_length bytes); returns the characters written */
+size_t base64_encode(const void *data, size_t length, char *out, Base64Alphabet alphabet);
+size_t base64_encode_scalar(const void *data, size_t length, char *out, Base64Alphabet alphabet);
+
+/*
+ * Decode into out (base64_decoded_max bytes) and store the byte count in
+ * decoded. Padding is optional for either alphabet; returns -1 on a
+ * character outside the alphabet, misplaced or excess '=', a dangling
+ * character, or non-zero bits after the last byte.
+ */
+int base64_decode(const char *text, size_t length, void *out, size_t *decoded, Base64Alphabet alphabet);
+int base64_decode_scalar(const char *text, size_t length, void *out, size_t *decoded, Base64Alphabet alphabet);
+
+/* Lowercase hex: 2 * length characters */
+size_t hex_encode(const void *data, size_t length, char *out);
+size_t hex_encode_scalar(const void *data, size_t length, char *out);
+
+/* Either case; length / 2 bytes into out, -1 on odd length or a non-hex character */
+int hex_decode(const char *text, size_t length, void *out);
+int hex_decode_scalar(const char *text, size_t length, void *out);
+
+/* Scalar vs vector encode/decode throughput for both codecs */
+void compare_codec_algorithms(size_t size);
+
+#endif /* STRING_CODEC_H */
@@ -0,0 +1,87 @@
+#ifndef STRING_FILTER_H
+#define STRING_FILTER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Approximate membership filters over 64-bit key hashes, and a
+ * multi-key substring scanner that uses them as a reject prefilter in
+ * front of the exact lookup. Both filters answer "maybe present" or
+ * "definitely absent" from one cache line per probe, so a million keys
+ * stay L2-resident while the exact table does not.
+ */
+
+/*
+ * Blocked Bloom filter: the high hash bits pick one 64-byte block and
+ * the low 32 bits, multiplied by eight odd salts, set one bit in each
+ * of its eight words. AVX2 builds probe the whole block with two
+ * variable-shift compares; elsewhere the word loop auto-vectorizes.
+ */
+typedef struct {
+    uint64_t *blocks;       /* block_count * 8 words, 64-byte aligned */
+    size_t block_count;
+} BloomFilter;
+
+/* Size for keys at bits_per_key (about 1% false positives at 10); -1 on failure */
+int bloom_filter_init(BloomFilter *filter, size_t keys, double bits_per_key);
+void bloom_filter_free(BloomFilter *filter);
+void bloom_filter_add(BloomFilter *filter, uint64_t hash);
+int bloom_filter_contains(const BloomFilter *filter, uint64_t hash);
+
+/*
+ * Cuckoo filter: 16-bit fingerprints in buckets of four, one 64-bit word
+ * per bucket tested with a SWAR lane compare. The alternate bucket is
+ * (c(fingerprint) - bucket) mod buckets, an involution for any bucket
+ * count, so the table is sized to the key count rather than a power of
+ * two. Supports removal; false positives are about 8 / 65536.
+ */
+typedef struct {
+    uint64_t *buckets;      /* four 16-bit fingerprints each, 0 = empty */
+    size_t bucket_count;
+    size_t count;
+    uint16_t victim;        /* fingerprint evicted when an insert failed, 0 = none */
+    size_t victim_bucket;
+} CuckooFilter;
+
+int cuckoo_filter_init(CuckooFilter *filter, size_t keys);
+void cuckoo_filter_free(CuckooFilter *filter);
+
+/* 0, or -1 once the table is full (the filter stays usable for lookups) */
+int cuckoo_filter_add(CuckooFilter *filter, uint64_t hash);
+int cuckoo_filter_contains(const CuckooFilter *filter, uint64_t hash);
+
+/* Remove one copy of a previously added hash; returns 1 if found */
+int cuckoo_filter_remove(CuckooFilter *filter, uint64_t hash);
+
+typedef enum {
+    STRING_PREFILTER_NONE,      /* exact table lookup at every position */
+    STRING_PREFILTER_BLOOM,
+    STRING_PREFILTER_CUCKOO
+} StringPrefilter;
+
+/*
+ * Set of byte-string keys searched for in text. Every text position is
+ * hashed over the first `window` bytes (the shortest key, at most 8); the
+ * prefilter drops positions no key can start at, the rest go through a
+ * StringMap of key prefixes and a byte compare of each candidate key.
+ */
+typedef struct StringKeySet StringKeySet;
+
+StringKeySet* string_key_set_create(const char *const *keys, const size_t *lengths, size_t count,
+                                    StringPrefilter prefilter);
+void string_key_set_destroy(StringKeySet *set);
+
+/* Bytes used by the prefilter (0 for STRING_PREFILTER_NONE) */
+size_t string_key_set_filter_bytes(const StringKeySet *set);
+
+/* Earliest occurrence of any key (first added wins at a position) and its index, or NULL */
+const char* string_key_set_find(const StringKeySet *set, const char *text, size_t length, size_t *key);
+
+/* Number of (position, key) matches; candidates receives the positions that passed the prefilter */
+size_t string_key_set_count(const StringKeySet *set, const char *text, size_t length, size_t *candidates);
+
+/* Exact-only vs Bloom vs cuckoo prefiltered scans over a synthetic blocklist */
+void compare_prefilter_algorithms(size_t keys, size_t text_size);
+
+#endif /* STRING_FILTER_H */
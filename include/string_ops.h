@@ -15,10 +15,44 @@ char* string_to_lowercase(const char *str);
 /* Advanced string operations */
 int string_find(const char *haystack, const char *needle);
 int string_find_optimized(const char *haystack, const char *needle);
+const char* string_find_bytes(const char *haystack, size_t haystack_len,
+                              const char *needle, size_t needle_len);
+const char* string_find_bytes_at(const char *haystack, size_t haystack_len,
+                                 const char *needle, size_t needle_len, size_t anchor);
 int string_count_occurrences(const char *text, const char *pattern);
 char** string_split(const char *str, char delimiter, int *count);
 void string_array_free(char **array, int count);
 
+/* ASCII case-insensitive search; case is folded inside the word compares */
+int string_find_nocase(const char *haystack, const char *needle);
+const char* string_find_bytes_nocase(const char *haystack, size_t haystack_len,
+                                     const char *needle, size_t needle_len);
+const char* string_find_bytes_nocase_at(const char *haystack, size_t haystack_len,
+                                        const char *needle, size_t needle_len, size_t anchor);
+
+/* Word-at-a-time scanning (orc.b on Zbb, SWAR fallback elsewhere) */
+const void* string_memchr(const void *buf, int c, size_t n);
+const char* string_find_char(const char *str, char c);
+int string_compare_optimized(const char *str1, const char *str2);
+void* string_memcpy(void *dst, const void *src, size_t n);
+int string_bytes_equal(const void *a, const void *b, size_t n);
+const void* string_memchr_nocase(const void *buf, int c, size_t n);
+int string_bytes_equal_nocase(const void *a, const void *b, size_t n);
+
+/*
+ * How word kernels read a stream misaligned relative to the aligned one:
+ * native misaligned loads when fast, shift-and-merge of aligned loads
+ * when they trap or are slow. Detected once at startup.
+ */
+typedef struct {
+    int fast;               /* 1: use misaligned loads */
+    double ratio;           /* measured misaligned/aligned time, 0 if not measured */
+    const char *source;     /* "RVOPT_MISALIGNED", "hwprobe", "measured" or "override" */
+} MisalignedAccessInfo;
+
+const MisalignedAccessInfo* string_misaligned_access(void);
+void string_set_misaligned_access(int fast);    /* 1 fast, 0 merge, -1 detected */
+
 /* Pattern matching algorithms */
 int kmp_search(const char *text, const char *pattern);
 int boyer_moore_search(const char *text, const char *pattern);
@@ -0,0 +1,39 @@
+#ifndef STRING_REGEX_H
+#define STRING_REGEX_H
+
+#include <stddef.h>
+
+/*
+ * Line-oriented regular expressions (grep semantics: matches never span
+ * a newline, ^ and $ anchor at line boundaries). Syntax: literals, '.',
+ * [classes] with ranges and negation, \d \w \s \D \W \S, escapes,
+ * grouping with ( ) or (?: ), '|', and the quantifiers * + ? {m} {m,}
+ * {m,n}.
+ *
+ * Patterns compile to a Thompson NFA that is determinized lazily while
+ * scanning, one DFA state per distinct NFA state set seen, kept in a
+ * bounded cache that is flushed when full. A literal that every match
+ * must contain is extracted at compile time and searched for first, so
+ * the automaton only runs on lines that contain it.
+ *
+ * A compiled regex caches DFA states as it runs: use one per thread.
+ */
+typedef struct StringRegex StringRegex;
+
+/* NULL on syntax error or allocation failure */
+StringRegex* string_regex_compile(const char *pattern);
+void string_regex_free(StringRegex *regex);
+
+/* 1 if text contains a match (*end: offset where the first match ends), 0 if not, -1 on error */
+int string_regex_search(StringRegex *regex, const char *text, size_t length, size_t *end);
+
+/* Number of lines of text containing a match */
+size_t string_regex_count_lines(StringRegex *regex, const char *text, size_t length);
+
+/* Required literal used as the prefilter (length 0 when there is none) */
+const char* string_regex_literal(const StringRegex *regex, size_t *length);
+
+/* Line counting on a synthetic access log: lazy DFA vs POSIX regexec */
+void compare_regex_algorithms(size_t size);
+
+#endif /* STRING_REGEX_H */
@@ -0,0 +1,56 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+/*
+ * Hot-path trace zones.
+ *
+ * Zones record begin/end timestamps into a per-thread ring buffer that only
+ * the owning thread writes, so recording needs no locks. Build with
+ * -DENABLE_TRACING (make trace) to compile the zones in; otherwise every
+ * macro expands to nothing. When compiled in, recording is still off until
+ * trace_enable() is called, costing one predictable branch per zone.
+ *
+ * Zone names must be string literals (only the pointer is stored).
+ */
+
+#ifndef TRACE_BUFFER_EVENTS
+#define TRACE_BUFFER_EVENTS (1u << 16)   /* events per thread, power of two */
+#endif
+
+typedef struct {
+    const char *name;
+    uint64_t timestamp_ns;
+    char phase;                 /* 'B' begin, 'E' end */
+} TraceEvent;
+
+void trace_enable(void);
+void trace_disable(void);
+int trace_is_enabled(void);
+
+void trace_record(const char *name, char phase);
+const char* trace_zone_begin(const char *name);
+void trace_zone_end(const char *name);
+void trace_zone_cleanup(const char **name);
+
+/* Write all recorded events as Chrome trace-event JSON (Perfetto compatible) */
+int trace_export_chrome(const char *path);
+
+#ifdef ENABLE_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#define TRACE_BEGIN(name) trace_zone_begin(name)
+#define TRACE_END(name)   trace_zone_end(name)
+/* Zone closed automatically when the enclosing block exits */
+#define TRACE_ZONE(name) \
+    const char *TRACE_CONCAT(trace_zone_, __LINE__) \
+        __attribute__((cleanup(trace_zone_cleanup), unused)) = trace_zone_begin(name)
+#else
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END(name)   ((void)0)
+#define TRACE_ZONE(name)  ((void)0)
+#endif
+
+#endif /* TRACE_H */
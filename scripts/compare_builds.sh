@@ -0,0 +1,112 @@
+#!/bin/bash
+
+# Build Variant Comparison Script
+# Runs the registered benchmarks with several builds of the optimizer and
+# reports the per-kernel speedup of each build over the first one.
+#
+# Usage: compare_builds.sh [-a "BENCHMARK ARGS"] LABEL=BINARY [LABEL=BINARY ...]
+#   RUNNER="qemu-riscv64 -L /usr/riscv64-linux-gnu" runs the binaries under
+#   an emulator (timings then track emulated instruction counts, not a core).
+
+set -e
+
+BENCH_ARGS="--run --repeat 5"
+RUNNER="${RUNNER:-}"
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m'
+
+log_info() {
+    echo -e "${GREEN}[INFO]${NC} $1" >&2
+}
+
+log_error() {
+    echo -e "${RED}[ERROR]${NC} $1" >&2
+}
+
+usage() {
+    echo "Usage: $0 [-a \"BENCHMARK ARGS\"] LABEL=BINARY [LABEL=BINARY ...]" >&2
+    exit 1
+}
+
+while getopts "a:h" opt; do
+    case $opt in
+        a) BENCH_ARGS="$OPTARG" ;;
+        *) usage ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+[ $# -ge 1 ] || usage
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# Run one variant and keep "name min_ms" for every benchmark instance
+LABELS=()
+for variant in "$@"; do
+    label="${variant%%=*}"
+    binary="${variant#*=}"
+    if [ "$label" = "$variant" ] || [ ! -x "$binary" ]; then
+        log_error "Expected LABEL=BINARY with an executable binary: $variant"
+        exit 1
+    fi
+
+    log_info "Running $label ($binary)"
+    # shellcheck disable=SC2086
+    $RUNNER "$binary" $BENCH_ARGS | awk '
+        /^---------/ { table = 1; next }
+        table && NF >= 5 && $2 ~ /^[0-9]+$/ { print $1, $3 }
+    ' > "$WORK_DIR/$label.txt"
+    LABELS+=("$label")
+done
+
+BASE="${LABELS[0]}"
+
+echo "Build variant comparison (min time per benchmark, speedup vs $BASE)"
+echo "Benchmark arguments: $BENCH_ARGS"
+echo
+
+awk -v base="$BASE" -v labels="${LABELS[*]}" -v dir="$WORK_DIR" '
+BEGIN {
+    n = split(labels, names, " ")
+    for (v = 1; v <= n; v++) {
+        file = dir "/" names[v] ".txt"
+        while ((getline line < file) > 0) {
+            split(line, f, " ")
+            if (!(f[1] in seen)) { seen[f[1]] = 1; order[++count] = f[1] }
+            time[f[1], v] = f[2]
+        }
+        close(file)
+    }
+
+    printf "%-50s", "Benchmark"
+    printf " %12s", names[1] "(ms)"
+    for (v = 2; v <= n; v++) printf " %14s", names[v]
+    printf "\n"
+
+    for (i = 1; i <= count; i++) {
+        b = order[i]
+        printf "%-50s", b
+        t0 = time[b, 1]
+        printf " %12s", (t0 == "" ? "-" : sprintf("%.4f", t0))
+        for (v = 2; v <= n; v++) {
+            t = time[b, v]
+            if (t0 == "" || t == "" || t + 0 == 0) printf " %14s", "-"
+            else {
+                s = t0 / t
+                printf " %13.2fx", s
+                sum[v] += log(s); samples[v]++
+            }
+        }
+        printf "\n"
+    }
+
+    printf "%-50s %12s", "Geometric mean", ""
+    for (v = 2; v <= n; v++) {
+        if (samples[v]) printf " %13.2fx", exp(sum[v] / samples[v])
+        else printf " %14s", "-"
+    }
+    printf "\n"
+}'
@@ -0,0 +1,80 @@
+#!/bin/bash
+
+# ISA Profile Comparison Script
+# Compares per-kernel dynamic instruction counts of several RISC-V builds
+# (one kernel_profile plugin CSV per -march profile) against the first one.
+#
+# Usage: compare_profiles.sh LABEL=CSV [LABEL=CSV ...]
+#   Each CSV comes from: qemu-riscv64 -plugin libkernel_profile.so,csv=on,outfile=CSV
+
+set -e
+
+RED='\033[0;31m'
+NC='\033[0m'
+
+log_error() {
+    echo -e "${RED}[ERROR]${NC} $1" >&2
+}
+
+usage() {
+    echo "Usage: $0 LABEL=CSV [LABEL=CSV ...]" >&2
+    exit 1
+}
+
+[ $# -ge 1 ] || usage
+
+LABELS=()
+FILES=()
+for profile in "$@"; do
+    label="${profile%%=*}"
+    file="${profile#*=}"
+    if [ "$label" = "$profile" ] || [ ! -r "$file" ]; then
+        log_error "Expected LABEL=CSV with a readable plugin CSV: $profile"
+        exit 1
+    fi
+    LABELS+=("$label")
+    FILES+=("$file")
+done
+
+echo "ISA profile comparison (dynamic instructions per kernel, ratio vs ${LABELS[0]})"
+echo "Lower is better; QEMU -cpu max executes every extension"
+echo
+
+awk -v labels="${LABELS[*]}" '
+FNR == 1 { v++; next }                      # CSV header
+{
+    split($0, f, ",")
+    if (!(f[1] in seen)) { seen[f[1]] = 1; order[++count] = f[1] }
+    insns[f[1], v] = f[3]
+}
+END {
+    n = split(labels, names, " ")
+    printf "%-26s", "Region"
+    printf " %14s", names[1]
+    for (p = 2; p <= n; p++) printf " %22s", names[p]
+    printf "\n"
+
+    for (i = 1; i <= count; i++) {
+        r = order[i]
+        printf "%-26s", r
+        base = insns[r, 1]
+        printf " %14s", (base == "" ? "-" : base)
+        for (p = 2; p <= n; p++) {
+            c = insns[r, p]
+            if (base == "" || c == "" || base + 0 == 0) printf " %22s", (c == "" ? "-" : c)
+            else {
+                ratio = c / base
+                printf " %14s (%5.2fx)", c, ratio
+                sum[p] += log(ratio); samples[p]++
+            }
+        }
+        printf "\n"
+    }
+
+    printf "%-26s %14s", "Geometric mean", ""
+    for (p = 2; p <= n; p++) {
+        if (samples[p]) printf " %14s (%5.2fx)", "", exp(sum[p] / samples[p])
+        else printf " %22s", "-"
+    }
+    printf "\n"
+}' "${FILES[@]}"
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <regex.h>
+#include <math.h>
 
 /* Timer implementation */
 void timer_start(Timer *timer) {
@@ -121,6 +123,185 @@ void print_benchmark_results(const Benchmark *benchmarks, int count) {
     printf("\n");
 }
 
+/* Benchmark registry */
+static RegisteredBenchmark *registry_head = NULL;
+static int registry_count = 0;
+
+void benchmark_register(RegisteredBenchmark *benchmark) {
+    if (!benchmark || !benchmark->name || !benchmark->run) return;
+    benchmark->next = registry_head;
+    registry_head = benchmark;
+    registry_count++;
+}
+
+void benchmark_run_options_init(BenchmarkRunOptions *options) {
+    if (!options) return;
+    memset(options, 0, sizeof(BenchmarkRunOptions));
+    options->repetitions = 5;
+}
+
+static int compare_registered(const void *a, const void *b) {
+    const RegisteredBenchmark *x = *(const RegisteredBenchmark * const *)a;
+    const RegisteredBenchmark *y = *(const RegisteredBenchmark * const *)b;
+    return strcmp(x->name, y->name);
+}
+
+/* Registration order depends on the linker; present benchmarks by name */
+static RegisteredBenchmark **registry_sorted(void) {
+    RegisteredBenchmark **sorted = malloc((registry_count + 1) * sizeof(RegisteredBenchmark *));
+    if (!sorted) return NULL;
+
+    int n = 0;
+    for (RegisteredBenchmark *b = registry_head; b; b = b->next) {
+        sorted[n++] = b;
+    }
+    qsort(sorted, n, sizeof(RegisteredBenchmark *), compare_registered);
+    return sorted;
+}
+
+static void format_instance_name(char *out, size_t out_size, const char *name,
+                                 const BenchmarkParams *params) {
+    int len = snprintf(out, out_size, "%s", name);
+    if (params->size > 0 && len < (int)out_size) {
+        len += snprintf(out + len, out_size - len, "/size=%zu", params->size);
+    }
+    if (params->pattern_length > 0 && len < (int)out_size) {
+        len += snprintf(out + len, out_size - len, "/pattern=%d", params->pattern_length);
+    }
+    if (params->threads > 0 && len < (int)out_size) {
+        snprintf(out + len, out_size - len, "/threads=%d", params->threads);
+    }
+}
+
+static void apply_overrides(BenchmarkParams *params, const BenchmarkParams *overrides) {
+    if (overrides->size > 0) params->size = overrides->size;
+    if (overrides->pattern_length > 0 && params->pattern_length > 0) {
+        params->pattern_length = overrides->pattern_length;
+    }
+    if (overrides->threads > 0 && params->threads > 0) {
+        params->threads = overrides->threads;
+    }
+}
+
+/* Visit every (benchmark, parameter set) instance whose name matches filter */
+typedef int (*InstanceVisitor)(const RegisteredBenchmark *bench, const BenchmarkParams *params,
+                               const char *instance, void *ctx);
+
+static int registry_for_each(const char *filter, const BenchmarkParams *overrides,
+                             InstanceVisitor visit, void *ctx) {
+    regex_t regex;
+    if (filter && regcomp(&regex, filter, REG_EXTENDED | REG_NOSUB) != 0) {
+        fprintf(stderr, "Invalid benchmark filter: %s\n", filter);
+        return -1;
+    }
+
+    RegisteredBenchmark **sorted = registry_sorted();
+    if (!sorted) {
+        if (filter) regfree(&regex);
+        return -1;
+    }
+
+    int matched = 0;
+    char instance[256];
+    for (int i = 0; i < registry_count; i++) {
+        const RegisteredBenchmark *bench = sorted[i];
+        BenchmarkParams none = { 0, 0, 0 };
+        int count = (bench->param_count > 0) ? bench->param_count : 1;
+
+        for (int p = 0; p < count; p++) {
+            BenchmarkParams params = (bench->param_count > 0) ? bench->params[p] : none;
+            if (overrides) apply_overrides(&params, overrides);
+            format_instance_name(instance, sizeof(instance), bench->name, &params);
+
+            if (filter && regexec(&regex, instance, 0, NULL, 0) != 0) continue;
+            matched++;
+            if (visit && visit(bench, &params, instance, ctx) != 0) break;
+        }
+    }
+
+    free(sorted);
+    if (filter) regfree(&regex);
+    return matched;
+}
+
+static int list_visitor(const RegisteredBenchmark *bench, const BenchmarkParams *params,
+                        const char *instance, void *ctx) {
+    (void)bench;
+    (void)params;
+    (void)ctx;
+    printf("  %s\n", instance);
+    return 0;
+}
+
+int benchmark_registry_list(const char *filter) {
+    printf("Registered benchmarks%s%s:\n", filter ? " matching " : "", filter ? filter : "");
+    int matched = registry_for_each(filter, NULL, list_visitor, NULL);
+    if (matched >= 0) printf("%d benchmark instance(s)\n", matched);
+    return matched;
+}
+
+static volatile double benchmark_sink;
+
+static int run_visitor(const RegisteredBenchmark *bench, const BenchmarkParams *params,
+                       const char *instance, void *ctx) {
+    const BenchmarkRunOptions *options = ctx;
+    int reps = (options->repetitions > 0) ? options->repetitions : 1;
+
+    void *state = bench->setup ? bench->setup(params) : NULL;
+    if (bench->setup && !state) {
+        printf("%-48s %s\n", instance, "setup failed");
+        return 0;
+    }
+
+    // One untimed warm-up run faults pages in and warms caches
+    benchmark_sink = bench->run(state, params);
+
+    double min_ms = 0.0, total_ms = 0.0, total_sq = 0.0;
+    for (int r = 0; r < reps; r++) {
+        Timer timer;
+        timer_start(&timer);
+        benchmark_sink = bench->run(state, params);
+        timer_stop(&timer);
+
+        double ms = timer_elapsed_ms(&timer);
+        if (r == 0 || ms < min_ms) min_ms = ms;
+        total_ms += ms;
+        total_sq += ms * ms;
+    }
+
+    if (bench->teardown) bench->teardown(state);
+
+    double mean = total_ms / reps;
+    double variance = total_sq / reps - mean * mean;
+    double stddev = (variance > 0.0) ? sqrt(variance) : 0.0;
+    printf("%-48s %6d %12.4f %12.4f %10.4f\n", instance, reps, min_ms, mean, stddev);
+    return 0;
+}
+
+int benchmark_registry_run(const BenchmarkRunOptions *options) {
+    BenchmarkRunOptions defaults;
+    if (!options) {
+        benchmark_run_options_init(&defaults);
+        options = &defaults;
+    }
+
+    BenchmarkEnvironment env;
+    benchmark_environment_detect(&env);
+    benchmark_environment_print(&env);
+    printf("\n");
+    
+    printf("%-48s %6s %12s %12s %10s\n", "Benchmark", "Reps", "Min(ms)", "Mean(ms)", "StdDev");
+    printf("%-48s %6s %12s %12s %10s\n", "---------", "----", "-------", "--------", "------");
+
+    int matched = registry_for_each(options->filter, &options->overrides,
+                                    run_visitor, (void *)options);
+    if (matched == 0) {
+        printf("No benchmarks match '%s' (use --list)\n", options->filter ? options->filter : "");
+    }
+    printf("\n");
+    return matched;
+}
+
 /* Memory usage tracking (simplified) */
 void memory_stats_start(MemoryStats *stats) {
     if (stats) {
@@ -0,0 +1,281 @@
+#define _GNU_SOURCE
+#include "benchmark.h"
+#include "parallel.h"
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#define ENV_SAMPLE_US 200000        /* /proc/stat sampling window */
+#define ENV_BUSY_WARN_PCT 10.0      /* warn above this CPU use by others */
+
+/* Placement requested through benchmark_pin_cpus() */
+static int pinned_cpus[BENCH_MAX_CPUS];
+static int pinned_count = 0;
+static int priority_raised = 0;
+
+/* Parse "0,2,4-7" into a CPU array; returns the count or -1 on error */
+int benchmark_parse_cpu_list(const char *list, int *cpus, int max_cpus) {
+    if (!list || !cpus) return -1;
+
+    int count = 0;
+    const char *p = list;
+    while (*p) {
+        char *end;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0) return -1;
+
+        long last = first;
+        if (*end == '-') {
+            p = end + 1;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first) return -1;
+        }
+
+        for (long cpu = first; cpu <= last; cpu++) {
+            if (count >= max_cpus) return -1;
+            cpus[count++] = (int)cpu;
+        }
+
+        if (*end == ',') {
+            end++;
+        } else if (*end != '\0') {
+            return -1;
+        }
+        p = end;
+    }
+    return count;
+}
+
+/*
+ * Restrict the process to the listed CPUs. Worker threads are created
+ * later and inherit the mask; parallel_for additionally pins worker t
+ * to the t-th listed CPU so placement is stable between runs.
+ */
+int benchmark_pin_cpus(const char *list) {
+    int cpus[BENCH_MAX_CPUS];
+    int count = benchmark_parse_cpu_list(list, cpus, BENCH_MAX_CPUS);
+    if (count <= 0) {
+        fprintf(stderr, "Invalid CPU list: %s\n", list ? list : "(null)");
+        return -1;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < count; i++) {
+        if (cpus[i] >= CPU_SETSIZE) {
+            fprintf(stderr, "Invalid CPU list: %s (CPU %d is above the limit of %d)\n",
+                    list, cpus[i], CPU_SETSIZE - 1);
+            return -1;
+        }
+        CPU_SET(cpus[i], &set);
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        perror("sched_setaffinity");
+        return -1;
+    }
+
+    memcpy(pinned_cpus, cpus, (size_t)count * sizeof(int));
+    pinned_count = count;
+    parallel_set_cpu_affinity(pinned_cpus, pinned_count);
+    return 0;
+}
+
+/* Lower the nice value; needs CAP_SYS_NICE, otherwise only warns */
+int benchmark_raise_priority(void) {
+    if (setpriority(PRIO_PROCESS, 0, -10) != 0) {
+        fprintf(stderr, "Warning: cannot raise scheduling priority (needs CAP_SYS_NICE)\n");
+        return -1;
+    }
+    priority_raised = 1;
+    return 0;
+}
+
+static int read_sysfs_line(const char *path, char *buf, size_t size) {
+    FILE *f = fopen(path, "r");
+    if (!f) return -1;
+
+    int ok = fgets(buf, (int)size, f) != NULL;
+    fclose(f);
+    if (!ok) return -1;
+
+    buf[strcspn(buf, "\n")] = '\0';
+    return 0;
+}
+
+static int read_sysfs_int(const char *path) {
+    char buf[32];
+    if (read_sysfs_line(path, buf, sizeof(buf)) != 0) return -1;
+    return atoi(buf);
+}
+
+/* Per-CPU busy/total jiffies from /proc/stat ("cpuN ..." lines) */
+typedef struct {
+    unsigned long long busy;
+    unsigned long long total;
+} CpuTimes;
+
+static int read_cpu_times(CpuTimes *times, int max_cpus) {
+    FILE *f = fopen("/proc/stat", "r");
+    if (!f) return -1;
+
+    char line[512];
+    int count = 0;
+    while (fgets(line, sizeof(line), f)) {
+        int cpu;
+        unsigned long long user, nice, system, idle, iowait, irq, softirq, steal;
+        if (strncmp(line, "cpu", 3) != 0 || line[3] < '0' || line[3] > '9') continue;
+        if (sscanf(line, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu", &cpu,
+                   &user, &nice, &system, &idle, &iowait, &irq, &softirq, &steal) != 9) {
+            continue;
+        }
+        if (cpu < 0 || cpu >= max_cpus) continue;
+
+        times[cpu].busy = user + nice + system + irq + softirq + steal;
+        times[cpu].total = times[cpu].busy + idle + iowait;
+        if (cpu + 1 > count) count = cpu + 1;
+    }
+    fclose(f);
+    return count;
+}
+
+static int cpu_is_pinned(int cpu) {
+    for (int i = 0; i < pinned_count; i++) {
+        if (pinned_cpus[i] == cpu) return 1;
+    }
+    return 0;
+}
+
+/*
+ * Sample every CPU while this process sleeps: anything busy now is
+ * background load. SMT siblings of the pinned CPUs are reported
+ * separately because they share execution resources with the benchmark.
+ */
+static void sample_cpu_activity(BenchmarkEnvironment *env) {
+    static CpuTimes before[BENCH_MAX_CPUS], after[BENCH_MAX_CPUS];
+    memset(before, 0, sizeof(before));
+    memset(after, 0, sizeof(after));
+
+    int n = read_cpu_times(before, BENCH_MAX_CPUS);
+    if (n <= 0) return;
+    usleep(ENV_SAMPLE_US);
+    read_cpu_times(after, BENCH_MAX_CPUS);
+
+    double busy_total = 0.0;
+    for (int cpu = 0; cpu < n; cpu++) {
+        unsigned long long total = after[cpu].total - before[cpu].total;
+        if (total == 0) continue;
+        double pct = 100.0 * (after[cpu].busy - before[cpu].busy) / total;
+        busy_total += pct;
+    }
+    // Average over the online CPUs so the warning threshold means the same on any core count
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    env->background_busy_pct = busy_total / (online > 0 ? (double)online : (double)n);
+
+    const int *cpus = pinned_count ? pinned_cpus : NULL;
+    int cpu_count = pinned_count ? pinned_count : 1;
+    for (int i = 0; i < cpu_count; i++) {
+        int cpu = cpus ? cpus[i] : 0;
+        char path[128], siblings[64];
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+        if (read_sysfs_line(path, siblings, sizeof(siblings)) != 0) continue;
+
+        int list[BENCH_MAX_CPUS];
+        int count = benchmark_parse_cpu_list(siblings, list, BENCH_MAX_CPUS);
+        for (int s = 0; s < count; s++) {
+            int sib = list[s];
+            if (sib == cpu || cpu_is_pinned(sib) || sib >= n) continue;
+
+            unsigned long long total = after[sib].total - before[sib].total;
+            if (total == 0) continue;
+            double pct = 100.0 * (after[sib].busy - before[sib].busy) / total;
+            if (pct > env->sibling_busy_pct) env->sibling_busy_pct = pct;
+        }
+    }
+}
+
+void benchmark_environment_detect(BenchmarkEnvironment *env) {
+    if (!env) return;
+    memset(env, 0, sizeof(BenchmarkEnvironment));
+
+    memcpy(env->pinned_cpus, pinned_cpus, sizeof(pinned_cpus));
+    env->pinned_count = pinned_count;
+    env->priority_raised = priority_raised;
+    env->nice_value = getpriority(PRIO_PROCESS, 0);
+
+    // Frequency scaling: governor of the first CPU we run on
+    char path[128];
+    int cpu = pinned_count ? pinned_cpus[0] : 0;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu);
+    if (read_sysfs_line(path, env->governor, sizeof(env->governor)) != 0) {
+        strcpy(env->governor, "unknown");
+    }
+
+    // intel_pstate exposes no_turbo (inverted); acpi-cpufreq/amd use boost
+    int no_turbo = read_sysfs_int("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    int boost = read_sysfs_int("/sys/devices/system/cpu/cpufreq/boost");
+    env->turbo_enabled = (no_turbo >= 0) ? !no_turbo : boost;
+
+    env->smt_active = read_sysfs_int("/sys/devices/system/cpu/smt/active");
+
+    double loads[1];
+    env->load_average = (getloadavg(loads, 1) == 1) ? loads[0] : -1.0;
+
+    sample_cpu_activity(env);
+
+    if (strcmp(env->governor, "unknown") != 0 && strcmp(env->governor, "performance") != 0) {
+        env->warnings++;
+    }
+    if (env->turbo_enabled == 1) env->warnings++;
+    if (env->sibling_busy_pct > ENV_BUSY_WARN_PCT) env->warnings++;
+    if (env->background_busy_pct > ENV_BUSY_WARN_PCT) env->warnings++;
+    if (env->pinned_count == 0) env->warnings++;
+}
+
+/* Metadata lines are prefixed with '#' so result parsers can skip them */
+void benchmark_environment_print(const BenchmarkEnvironment *env) {
+    if (!env) return;
+
+    printf("# Benchmark environment\n");
+    printf("#   architecture:   %s (%d cores)\n", get_cpu_architecture(), get_cpu_core_count());
+    if (env->pinned_count > 0) {
+        printf("#   pinned cpus:    ");
+        for (int i = 0; i < env->pinned_count; i++) {
+            printf("%s%d", i ? "," : "", env->pinned_cpus[i]);
+        }
+        printf("\n");
+    } else {
+        printf("#   pinned cpus:    none\n");
+    }
+    printf("#   nice value:     %d%s\n", env->nice_value, env->priority_raised ? " (raised)" : "");
+    printf("#   governor:       %s\n", env->governor);
+    printf("#   turbo/boost:    %s\n",
+           env->turbo_enabled < 0 ? "unknown" : (env->turbo_enabled ? "on" : "off"));
+    printf("#   smt:            %s\n",
+           env->smt_active < 0 ? "unknown" : (env->smt_active ? "on" : "off"));
+    printf("#   sibling busy:   %.1f%%\n", env->sibling_busy_pct);
+    printf("#   background:     %.1f%% of all CPUs, load average %.2f\n",
+           env->background_busy_pct, env->load_average);
+
+    if (strcmp(env->governor, "unknown") != 0 && strcmp(env->governor, "performance") != 0) {
+        printf("# WARNING: cpufreq governor is '%s'; use 'performance' for stable clocks\n",
+               env->governor);
+    }
+    if (env->turbo_enabled == 1) {
+        printf("# WARNING: turbo/boost is enabled; clocks vary with temperature and load\n");
+    }
+    if (env->sibling_busy_pct > ENV_BUSY_WARN_PCT) {
+        printf("# WARNING: an SMT sibling of a benchmark CPU is %.0f%% busy\n",
+               env->sibling_busy_pct);
+    }
+    if (env->background_busy_pct > ENV_BUSY_WARN_PCT) {
+        printf("# WARNING: background processes use %.0f%% of all CPUs\n", env->background_busy_pct);
+    }
+    if (env->pinned_count == 0) {
+        printf("# WARNING: threads are not pinned; use --pin CPUS\n");
+    }
+}
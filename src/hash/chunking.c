@@ -0,0 +1,676 @@
+#define _GNU_SOURCE
+#include "chunking.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "hash_ops.h"
+#include "parallel.h"
+#include "region_marker.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CDC_MAX_NORMALIZATION   8
+#define CDC_RABIN_WINDOW        48
+#define CDC_RABIN_BASE          0x9e3779b97f4a7c15ULL
+#define CDC_SEGMENT_MIN         (4 * 1024 * 1024)
+#define CDC_FINGERPRINT_GRAIN   64
+
+/* Gear table: splitmix64 outputs, fixed so boundaries match across builds */
+static const uint64_t cdc_gear[256] = {
+    0x5e1d544eca480567ULL, 0xe55421dcb5d694c9ULL, 0x011066580c870529ULL, 0x95888816fd175101ULL,
+    0x9c97c921e538227bULL, 0x7529759aede11014ULL, 0xab24701bcfdfc764ULL, 0x293d3e386d330f9cULL,
+    0xe2f169e7b9863fcaULL, 0x13c1d9f12c43739bULL, 0xeaac9ad3fe001ff0ULL, 0x8ca3bc80d0b9d7daULL,
+    0x9b6d845efdf91268ULL, 0xfb48620f521154a4ULL, 0x320e7aff0c42f5deULL, 0x004096e52562c153ULL,
+    0x1aa45e3770433a1bULL, 0x0b23cb84343d14baULL, 0x7f258ea46aa0aea2ULL, 0xa8887f3172a05cc0ULL,
+    0xad76fe34f79c1426ULL, 0xd45826eaf472f336ULL, 0xe0e1ed7324e8d193ULL, 0xbbdcad484fdcdae4ULL,
+    0x453895e1f551051fULL, 0xc5698fafb05be04fULL, 0x634d71c9422fb49fULL, 0x6e7fa89e720240faULL,
+    0x1c23ecb46b15885bULL, 0x3dbbe8e143c020adULL, 0x9439c11e1c33af15ULL, 0x475da7e61ad3d402ULL,
+    0xfc5461ec40648aebULL, 0x8f7b43663605947eULL, 0x008b270a084d4e57ULL, 0xe5ffa39373308793ULL,
+    0x3c772ae1153e932eULL, 0xb0a6c274044e460eULL, 0xe9d1d16b300d71c6ULL, 0xaa2ae1d102b10136ULL,
+    0x094342c86a549725ULL, 0x2a1b2dd948ef1cd4ULL, 0xae4c474ec3142180ULL, 0xa117d16896f42536ULL,
+    0x7f5c94760341c269ULL, 0x17b478a93688bd13ULL, 0x7e9db874a49efc97ULL, 0x8223ea8dcfe41d59ULL,
+    0x05eb6598bef5e37eULL, 0x08d25ed66c362880ULL, 0xa8d7c89227f93060ULL, 0x443510e35a26b706ULL,
+    0x8eb629cd2d5d473dULL, 0x936f2b1e7c1fe783ULL, 0x8cb29c16c1ed388eULL, 0xb24eac55f4c63a34ULL,
+    0xf1580546afe1114aULL, 0xeed2808d681930feULL, 0xb55cc6ba6c4426dbULL, 0x7c12eede6bfa2ce1ULL,
+    0xd9a76c9de75d10d4ULL, 0x338a5fa641a9dec9ULL, 0xeaef254f9eb9c3b0ULL, 0xd5f2ad60e6c229efULL,
+    0x4180472e9d70727fULL, 0xed5cc060f79af8d8ULL, 0x76fc07808cb67a5eULL, 0x73985d17d6974e37ULL,
+    0xf44b8e430f8c3c14ULL, 0x6b7c6a3d14b138edULL, 0xfcf8377d0a1e2fafULL, 0xcb47d5e3f64eac82ULL,
+    0x0e89131cd598053dULL, 0xd3cb8fe84a363c45ULL, 0x8a9ef014bea5ca5cULL, 0x8bf81e96b908c276ULL,
+    0x1ca1de176357a6d6ULL, 0x81d3c15564f43d88ULL, 0x3bcc27a593f1db50ULL, 0x705b6f44dc203cddULL,
+    0x0c4d48298a48bcbcULL, 0x4903cadcd31e0b3eULL, 0x32f0ee528a55124bULL, 0x12e6a7d0a9e59aa6ULL,
+    0x8ba25b8c4d750ceaULL, 0x60a4f01a830b48b9ULL, 0xf1bf678a17fdbd8eULL, 0x9ce65efe4cbf9071ULL,
+    0x0adaef50dfff47e5ULL, 0x7802057f89e4775fULL, 0xf6ee8185bd7829d7ULL, 0x680d9ad19613cec3ULL,
+    0xaab51be21ea8bce1ULL, 0x72676a30ae0f2d9dULL, 0xe50ec92b14e4343dULL, 0x0627e1cb0f47a07fULL,
+    0xcadedb29395683b0ULL, 0x58516ae3365ec5c0ULL, 0x2974e231bf8b0037ULL, 0x4e8e2422eb334f37ULL,
+    0xd3e8ce0c1bca36c9ULL, 0x2188b8cfce8de5d5ULL, 0x465cdc4bf3c830f5ULL, 0x8df90c1ae681f614ULL,
+    0xe0fa9ed5ab16c1c0ULL, 0xbee22b34ea3f0067ULL, 0x2e8ce4253b5e7081ULL, 0x3cfac6b916de5c65ULL,
+    0x7c355da609e2c813ULL, 0xe0c6a67d62b593b2ULL, 0x1523425751578cb3ULL, 0x6068817f7c3e67f8ULL,
+    0x18b285f8e51d0463ULL, 0x6ed13f33b7b4f5a5ULL, 0xc33c117b900745c4ULL, 0xef79156eac9e3b64ULL,
+    0x9e836e26954f33e1ULL, 0xc2947c66612213c0ULL, 0x22b78e0f8ee6f301ULL, 0x7b50509398b11818ULL,
+    0xf8ea881c74f20ea9ULL, 0x5a73f63d40cb50c8ULL, 0x38e31fe6f1ab720dULL, 0xd497efdf7ebfcb44ULL,
+    0xcf98e9c6c7e8ab26ULL, 0x67d8ebcaba530c32ULL, 0x79865343da591506ULL, 0x8b739ab38abfc058ULL,
+    0x892d4cdcd2e7e59cULL, 0x7025ff60d18248ceULL, 0x227d30fe375e2aadULL, 0x6151518744e31a8aULL,
+    0x7e6989c45f28641fULL, 0xc368d66a41a5aa80ULL, 0x040224f649703c15ULL, 0x631ed3aab0ac4124ULL,
+    0x0dd6912c4e9f044eULL, 0xc6d250495a4d3316ULL, 0xdd40df94cc049690ULL, 0xdf18d4f80c151703ULL,
+    0x476ac9213b387d2fULL, 0x097f49749bbbcf09ULL, 0x9a25d2a8bf38a779ULL, 0xc371aa9bbe168a6fULL,
+    0x72bb5710a7c94dc3ULL, 0x70353aeabd014cadULL, 0x8a9524a9ff8322a7ULL, 0xa0df5d7afd2dba6dULL,
+    0xd54603f1a38286c1ULL, 0x72398a80b33ccb7fULL, 0x9f47b9470df58f66ULL, 0xb09876f8540000d0ULL,
+    0xf17a07454fcab405ULL, 0x2a6af8da71659e76ULL, 0x11684a066a8fd2d6ULL, 0x96c685b9fa037068ULL,
+    0xbdd371e4ab01e0bbULL, 0x52059c01c21ad415ULL, 0xe6f23046d54bf0f5ULL, 0x86920381a27ffc3dULL,
+    0xa277c3bb24905642ULL, 0xe94b2b89e0fad9e1ULL, 0x5cec56bc8db6ba3aULL, 0x4ce814d59b9d0f2dULL,
+    0x2921ca2d61cfad0eULL, 0x670cb85e0d9e686cULL, 0x60f6bae8ce03be7bULL, 0x33277fb10ca02ee1ULL,
+    0xd6b26535a4d0c217ULL, 0x6f6094b022d2f2a2ULL, 0x8880370c0609c053ULL, 0x34473697c56a0d11ULL,
+    0x010065cd01445f65ULL, 0xe9a61cca1c68294cULL, 0xb1e708bdedb09b28ULL, 0xd6a6646744edef57ULL,
+    0xb24edc2a6bdcbf15ULL, 0x0e6e9a252bdd64b8ULL, 0x99151926054ff8f7ULL, 0xa343ebf75b6dd707ULL,
+    0x0ac39352c8218a84ULL, 0x4778834196f0126bULL, 0x21bef4b14b115b13ULL, 0xf05ea6538fd6d202ULL,
+    0xbe082408891ee051ULL, 0x5f7256c29cdae3f7ULL, 0x17d72772edadc56bULL, 0xe5ef801f281fe36dULL,
+    0xc39bf92fcdefe07cULL, 0x937effebea8f5a6cULL, 0x0becd0f55c8b1d2bULL, 0xee1c245adf44f404ULL,
+    0xaed003d3370e7acfULL, 0xa39fa41a144d3efdULL, 0xe297cb98734a27f3ULL, 0xd28d1399c4937908ULL,
+    0x81422072bdc25d98ULL, 0x066633112b7262daULL, 0x7e5a26ece9805006ULL, 0xeee3b07970c05bcdULL,
+    0xdf9d710bf0a3fdbaULL, 0xbebabd72bb6b3cb7ULL, 0x2963e2e2ab4baab1ULL, 0x8f15977a54aa179cULL,
+    0x0b44d60107cdc3f6ULL, 0xedef83598ff537f6ULL, 0x597c4d102db03f24ULL, 0xbde25fab7dd86b1cULL,
+    0x0190f51908bda0b5ULL, 0x071b2bcae30f297bULL, 0x5b1528566f87024bULL, 0x59b4a378c7a8f960ULL,
+    0xdb629de67ea080f9ULL, 0x4738908df5d9b6a9ULL, 0x6fcf8a7e6b088274ULL, 0x4b64e0be7aee3e9dULL,
+    0x12540b0f669b8faeULL, 0xc2640936f7ff529aULL, 0xcbb5517543a0f481ULL, 0xa6c6c8c8bbbd18d8ULL,
+    0x2cb6a8d57a3bf1fcULL, 0x551b03ccd4f55bdbULL, 0x90084a0585fcd80fULL, 0x046bdb929f24caecULL,
+    0x9a476ead827a2da8ULL, 0x3db923b57641dcd0ULL, 0xe5ea2add206d7647ULL, 0x1a14559b2948796cULL,
+    0x5d452f7ad60f64afULL, 0x081d94fd2a382a50ULL, 0x85ecfa90032ede33ULL, 0xb6b45a21a2f549beULL,
+    0x4d6a92db6ab515f4ULL, 0xf6cdf04c89a910d2ULL, 0x470d5267fb4db586ULL, 0xdb29c6da6805be88ULL,
+    0x78f1d084104c744bULL, 0x2ef7a9842b7a5c64ULL, 0xcdc2cf0979d1efbaULL, 0xcfc5aa7701a32b62ULL,
+    0x7f1ea258e4fd6307ULL, 0x2f549bb9772307ebULL, 0x1510b2ae2bc172e5ULL, 0xceafd0f266722cfdULL,
+    0xf8fdde6e784963b3ULL, 0x8c0b6de9b892a0e6ULL, 0xde01b1609231170bULL, 0x22fdc7f2011bb3e5ULL,
+    0x53b9d13233483e32ULL, 0x2cc7d1ce74322c4fULL, 0x11a2ab2279642218ULL, 0x1f0ecad9a70848f3ULL,
+    0xd5c08888facfbfd5ULL, 0x1d2d86a150dc0cd1ULL, 0xe6861cf7fec17fe5ULL, 0x721b5f2009929fa7ULL
+};
+
+/* bits mask bits spread over the high half: bit k of the Gear hash sees only the last k + 1 bytes */
+static uint64_t cdc_mask(int bits) {
+    if (bits < 1) bits = 1;
+    int step = bits <= 24 ? 2 : 1;
+    uint64_t mask = 0;
+    for (int i = 0; i < bits; i++) mask |= 1ULL << (63 - i * step);
+    return mask;
+}
+
+int cdc_params_init(CdcParams *params, size_t avg_size, int normalization) {
+    if (!params || avg_size < 64 || (avg_size & (avg_size - 1)) != 0) return -1;
+    if (normalization < 0 || normalization > CDC_MAX_NORMALIZATION) return -1;
+    int bits = bit_ctz64(avg_size);
+    params->min_size = avg_size / 4;
+    params->avg_size = avg_size;
+    params->max_size = avg_size * 8;
+    params->normalization = normalization;
+    params->mask_small = cdc_mask(bits + normalization);
+    params->mask_large = cdc_mask(bits - normalization);
+    return 0;
+}
+
+/*
+ * Continue a boundary search over p[*scanned, n), n <= max_size, with the
+ * Gear hash of the bytes before it. Returns the cut, or 0 when none lies
+ * below n; *scanned and *state then cover all n bytes so a later call with
+ * more data resumes instead of rehashing.
+ */
+static size_t cdc_scan(const CdcParams *params, const unsigned char *p, size_t n, size_t *scanned, uint64_t *state) {
+    if (n <= params->min_size) {
+        *scanned = n;
+        return 0;
+    }
+    size_t normal = params->avg_size < n ? params->avg_size : n;
+    const uint64_t mask_small = params->mask_small, mask_large = params->mask_large;
+    uint64_t hash = *state;
+    size_t i = *scanned > params->min_size ? *scanned : params->min_size;
+
+    // Harder mask up to the average size, easier one after it
+    for (; i < normal; i++) {
+        hash = (hash << 1) + cdc_gear[p[i]];
+        if (!(hash & mask_small)) return i + 1;
+    }
+    for (; i < n; i++) {
+        hash = (hash << 1) + cdc_gear[p[i]];
+        if (!(hash & mask_large)) return i + 1;
+    }
+    *scanned = n;
+    *state = hash;
+    return 0;
+}
+
+size_t cdc_find_boundary(const CdcParams *params, const void *data, size_t length) {
+    size_t n = length < params->max_size ? length : params->max_size;
+    size_t scanned = 0;
+    uint64_t hash = 0;
+    size_t cut = cdc_scan(params, data, n, &scanned, &hash);
+    return cut ? cut : n;
+}
+
+size_t cdc_find_boundary_rabin(const CdcParams *params, const void *data, size_t length) {
+    const unsigned char *p = data;
+    size_t n = length < params->max_size ? length : params->max_size;
+    if (n <= params->min_size) return n;
+    const uint64_t mask = ~0ULL << (64 - bit_ctz64(params->avg_size));
+
+    // base^window removes the byte leaving the window, as in rabin_karp_search
+    uint64_t out_factor = 1;
+    for (int k = 0; k < CDC_RABIN_WINDOW; k++) out_factor *= CDC_RABIN_BASE;
+
+    size_t start = params->min_size > CDC_RABIN_WINDOW ? params->min_size - CDC_RABIN_WINDOW : 0;
+    uint64_t hash = 0;
+    size_t i = start;
+    for (; i < params->min_size; i++) hash = hash * CDC_RABIN_BASE + p[i];
+    for (; i < n; i++) {
+        hash = hash * CDC_RABIN_BASE + p[i];
+        if (i >= start + CDC_RABIN_WINDOW) hash -= p[i - CDC_RABIN_WINDOW] * out_factor;
+        if (!(hash & mask)) return i + 1;
+    }
+    return n;
+}
+
+void cdc_chunk_list_free(CdcChunkList *list) {
+    if (!list) return;
+    free(list->chunks);
+    list->chunks = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+static int chunk_list_push(CdcChunkList *list, uint64_t offset, size_t length) {
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        CdcChunk *chunks = realloc(list->chunks, capacity * sizeof(CdcChunk));
+        if (!chunks) return -1;
+        list->chunks = chunks;
+        list->capacity = capacity;
+    }
+    CdcChunk *chunk = &list->chunks[list->count++];
+    chunk->offset = offset;
+    chunk->length = length;
+    chunk->fingerprint = 0;
+    return 0;
+}
+
+/* Cut offsets a worker found from its segment start, up to the first at or past the segment end */
+typedef struct {
+    size_t *cuts;
+    size_t count;
+    size_t capacity;
+    int failed;
+} CdcSegment;
+
+typedef struct {
+    const CdcParams *params;
+    const unsigned char *data;
+    size_t size;
+    size_t segment_size;
+    CdcSegment *segments;
+    CdcChunk *chunks;
+} CdcJob;
+
+static void chunk_segments(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_CDC_CHUNK);
+    CdcJob *job = arg;
+    (void)thread_id;
+    for (size_t s = begin; s < end; s++) {
+        CdcSegment *segment = &job->segments[s];
+        size_t pos = s * job->segment_size;
+        size_t stop = pos + job->segment_size < job->size ? pos + job->segment_size : job->size;
+        while (pos < stop) {
+            pos += cdc_find_boundary(job->params, job->data + pos, job->size - pos);
+            if (segment->count == segment->capacity) {
+                size_t capacity = segment->capacity ? segment->capacity * 2 : 256;
+                size_t *cuts = realloc(segment->cuts, capacity * sizeof(size_t));
+                if (!cuts) {
+                    segment->failed = 1;
+                    return;
+                }
+                segment->cuts = cuts;
+                segment->capacity = capacity;
+            }
+            segment->cuts[segment->count++] = pos;
+        }
+    }
+}
+
+static void fingerprint_chunks(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_CDC_FINGERPRINT);
+    CdcJob *job = arg;
+    (void)thread_id;
+    for (size_t i = begin; i < end; i++) {
+        CdcChunk *chunk = &job->chunks[i];
+        chunk->fingerprint = hash64(job->data + chunk->offset, chunk->length, 0);
+    }
+}
+
+int cdc_chunk_buffer(const CdcParams *params, const void *data, size_t size, int threads, CdcChunkList *list) {
+    if (!params || !list || (!data && size > 0) || params->max_size == 0) return -1;
+    list->count = 0;
+    if (size == 0) return 0;
+
+    threads = parallel_resolve_threads(threads);
+    size_t segment_size = size;
+    if (threads > 1) {
+        // Segments far larger than max_size so the resync walk is a small fraction of the work
+        size_t floor_size = params->max_size * 64 > CDC_SEGMENT_MIN ? params->max_size * 64 : CDC_SEGMENT_MIN;
+        segment_size = size / ((size_t)threads * 4);
+        if (segment_size < floor_size) segment_size = floor_size;
+    }
+    size_t segment_count = (size + segment_size - 1) / segment_size;
+    CdcSegment *segments = calloc(segment_count, sizeof(CdcSegment));
+    if (!segments) return -1;
+
+    CdcJob job = { params, data, size, segment_size, segments, NULL };
+    parallel_for(segment_count, 1, threads, chunk_segments, &job);
+
+    int status = 0;
+    for (size_t s = 0; s < segment_count; s++) {
+        if (segments[s].failed) status = -1;
+    }
+
+    // Walk the true boundaries into each segment until they land on one the worker found
+    size_t pos = 0;
+    for (size_t s = 0; status == 0 && s < segment_count; s++) {
+        const CdcSegment *segment = &segments[s];
+        size_t start = s * segment_size;
+        size_t stop = start + segment_size < size ? start + segment_size : size;
+        size_t k = 0;
+        int synced = pos == start;
+        while (!synced && pos < stop) {
+            while (k < segment->count && segment->cuts[k] < pos) k++;
+            if (k < segment->count && segment->cuts[k] == pos) {
+                k++;
+                synced = 1;
+                break;
+            }
+            size_t length = cdc_find_boundary(params, (const unsigned char *)data + pos, size - pos);
+            if (chunk_list_push(list, pos, length) != 0) status = -1;
+            pos += length;
+        }
+        for (; synced && status == 0 && k < segment->count; k++) {
+            if (chunk_list_push(list, pos, segment->cuts[k] - pos) != 0) status = -1;
+            pos = segment->cuts[k];
+        }
+    }
+
+    for (size_t s = 0; s < segment_count; s++) free(segments[s].cuts);
+    free(segments);
+    if (status != 0) {
+        list->count = 0;
+        return -1;
+    }
+
+    job.chunks = list->chunks;
+    parallel_for(list->count, CDC_FINGERPRINT_GRAIN, threads, fingerprint_chunks, &job);
+    return 0;
+}
+
+int cdc_stream_init(CdcStream *stream, const CdcParams *params) {
+    if (!stream) return -1;
+    memset(stream, 0, sizeof(*stream));
+    if (!params || params->max_size == 0) return -1;
+    stream->params = *params;
+    stream->pending = malloc(params->max_size);
+    return stream->pending ? 0 : -1;
+}
+
+static int stream_emit(CdcStream *stream, const unsigned char *chunk, size_t length) {
+    if (chunk_list_push(&stream->chunks, stream->offset, length) != 0) return -1;
+    stream->chunks.chunks[stream->chunks.count - 1].fingerprint = hash64(chunk, length, 0);
+    stream->offset += length;
+    return 0;
+}
+
+int cdc_stream_update(CdcStream *stream, const void *data, size_t length) {
+    REGION_SCOPE(REGION_CDC_CHUNK);
+    if (!stream || !stream->pending || (!data && length > 0)) return -1;
+    const unsigned char *p = data;
+    const size_t max_size = stream->params.max_size;
+
+    while (length > 0) {
+        if (stream->pending_size > 0) {
+            // Top up the open chunk and resume the hash at the old pending end, where any cut must lie
+            size_t take = length < max_size - stream->pending_size ? length : max_size - stream->pending_size;
+            memcpy(stream->pending + stream->pending_size, p, take);
+            size_t available = stream->pending_size + take;
+            size_t cut = cdc_scan(&stream->params, stream->pending, available, &stream->scanned, &stream->hash);
+            if (!cut && available < max_size) {
+                stream->pending_size = available;
+                return 0;
+            }
+            if (!cut) cut = max_size;
+            if (stream_emit(stream, stream->pending, cut) != 0) return -1;
+            size_t used = cut - stream->pending_size;
+            stream->pending_size = 0;
+            p += used;
+            length -= used;
+            continue;
+        }
+
+        // Nothing buffered: cut straight from the caller's data
+        size_t n = length < max_size ? length : max_size;
+        stream->scanned = 0;
+        stream->hash = 0;
+        size_t cut = cdc_scan(&stream->params, p, n, &stream->scanned, &stream->hash);
+        if (!cut && n < max_size) {
+            memcpy(stream->pending, p, n);
+            stream->pending_size = n;
+            return 0;
+        }
+        if (!cut) cut = max_size;
+        if (stream_emit(stream, p, cut) != 0) return -1;
+        p += cut;
+        length -= cut;
+    }
+    return 0;
+}
+
+int cdc_stream_finish(CdcStream *stream) {
+    if (!stream || !stream->pending) return -1;
+    if (stream->pending_size == 0) return 0;
+    int status = stream_emit(stream, stream->pending, stream->pending_size);
+    stream->pending_size = 0;
+    return status;
+}
+
+void cdc_stream_free(CdcStream *stream) {
+    if (!stream) return;
+    free(stream->pending);
+    cdc_chunk_list_free(&stream->chunks);
+    memset(stream, 0, sizeof(*stream));
+}
+
+static int compare_fingerprint(const void *a, const void *b) {
+    const CdcChunk *x = a;
+    const CdcChunk *y = b;
+    if (x->fingerprint != y->fingerprint) return x->fingerprint < y->fingerprint ? -1 : 1;
+    return 0;
+}
+
+/* Bytes in chunks whose fingerprint already occurred earlier in the sorted copy */
+/* Fingerprints only narrow the candidates; equal bytes decide */
+static int same_content(const unsigned char *a, const CdcChunk *x, const unsigned char *b, const CdcChunk *y) {
+    return x->length == y->length && memcmp(a + x->offset, b + y->offset, x->length) == 0;
+}
+
+uint64_t cdc_duplicate_bytes(const CdcChunkList *list, const void *data) {
+    if (!list || !data || list->count == 0) return 0;
+    CdcChunk *sorted = malloc(list->count * sizeof(CdcChunk));
+    if (!sorted) return 0;
+    memcpy(sorted, list->chunks, list->count * sizeof(CdcChunk));
+    qsort(sorted, list->count, sizeof(CdcChunk), compare_fingerprint);
+    uint64_t duplicate = 0;
+    size_t run = 0;
+    for (size_t i = 1; i < list->count; i++) {
+        if (sorted[i].fingerprint != sorted[i - 1].fingerprint) {
+            run = i;
+            continue;
+        }
+        // Count the chunk once it matches any earlier chunk with its fingerprint
+        for (size_t j = run; j < i; j++) {
+            if (same_content(data, &sorted[j], data, &sorted[i])) {
+                duplicate += sorted[i].length;
+                break;
+            }
+        }
+    }
+    free(sorted);
+    return duplicate;
+}
+
+int cdc_chunk_file(const char *path, int threads) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const unsigned char *data = NULL;
+    if (size > 0) {
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            perror("mmap");
+            close(fd);
+            return -1;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = mapped;
+    }
+    close(fd);
+
+    CdcParams params;
+    cdc_params_init(&params, 8192, 2);
+    CdcChunkList list = { NULL, 0, 0 };
+    threads = parallel_resolve_threads(threads);
+    Timer timer;
+    timer_start(&timer);
+    int status = cdc_chunk_buffer(&params, data, size, threads, &list);
+    timer_stop(&timer);
+    double seconds = timer_elapsed_ms(&timer) / 1000.0;
+
+    if (status == 0) {
+        size_t smallest = list.count ? list.chunks[0].length : 0, largest = 0;
+        for (size_t i = 0; i < list.count; i++) {
+            if (list.chunks[i].length < smallest) smallest = list.chunks[i].length;
+            if (list.chunks[i].length > largest) largest = list.chunks[i].length;
+        }
+        uint64_t duplicate = cdc_duplicate_bytes(&list, data);
+        printf("Chunks of %s [%zu bytes, %d threads, FastCDC avg %zu]\n", path, size, threads, params.avg_size);
+        printf("=========================================\n");
+        printf("Chunks: %zu (mean %.0f bytes, min %zu, max %zu)\n", list.count,
+               list.count ? (double)size / list.count : 0.0, smallest, largest);
+        printf("Chunk + fingerprint: %.3f ms (%.3f GB/s)\n", seconds * 1000.0,
+               seconds > 0 ? (double)size / 1e9 / seconds : 0.0);
+        printf("Duplicate chunk bytes: %llu (%.1f%%)\n", (unsigned long long)duplicate,
+               size ? 100.0 * duplicate / size : 0.0);
+    } else {
+        printf("Out of memory while chunking %s\n", path);
+    }
+
+    cdc_chunk_list_free(&list);
+    if (data) munmap((void *)data, size);
+    return status;
+}
+
+typedef size_t (*CdcBoundaryFunc)(const CdcParams *params, const void *data, size_t length);
+
+/* Chunk count and sum of squared lengths for a boundary function over data */
+static size_t boundary_walk(CdcBoundaryFunc find, const CdcParams *params, const unsigned char *data, size_t size,
+                            double *sum_squares) {
+    size_t count = 0;
+    double squares = 0.0;
+    for (size_t pos = 0; pos < size; count++) {
+        size_t length = find(params, data + pos, size - pos);
+        squares += (double)length * length;
+        pos += length;
+    }
+    if (sum_squares) *sum_squares = squares;
+    return count;
+}
+
+static void fill_random_bytes(unsigned char *data, size_t size, unsigned seed) {
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+static int same_chunks(const CdcChunkList *a, const CdcChunkList *b) {
+    if (a->count != b->count) return 0;
+    for (size_t i = 0; i < a->count; i++) {
+        if (a->chunks[i].offset != b->chunks[i].offset || a->chunks[i].length != b->chunks[i].length ||
+            a->chunks[i].fingerprint != b->chunks[i].fingerprint) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void compare_chunking_algorithms(size_t size) {
+    const size_t insert = 17;
+    unsigned char *data = malloc(size);
+    unsigned char *edited = malloc(size + insert);
+    if (!data || !edited) {
+        printf("Failed to allocate buffers for chunking comparison\n");
+        free(data);
+        free(edited);
+        return;
+    }
+    fill_random_bytes(data, size, 42);
+
+    CdcParams gear, fastcdc;
+    cdc_params_init(&gear, 8192, 0);
+    cdc_params_init(&fastcdc, 8192, 2);
+
+    printf("Content-Defined Chunking [%zu bytes, avg %zu]\n", size, fastcdc.avg_size);
+    printf("=========================================\n");
+
+    struct {
+        const char *name;
+        CdcBoundaryFunc find;
+        const CdcParams *params;
+    } methods[] = {
+        { "Rabin (48-byte window)", cdc_find_boundary_rabin, &gear },
+        { "Gear", cdc_find_boundary, &gear },
+        { "FastCDC (normalized)", cdc_find_boundary, &fastcdc },
+    };
+    Timer timer;
+    for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+        double squares = 0.0;
+        timer_start(&timer);
+        size_t count = boundary_walk(methods[m].find, methods[m].params, data, size, &squares);
+        timer_stop(&timer);
+        double ms = timer_elapsed_ms(&timer);
+        double mean = (double)size / count;
+        printf("%-24s %8.2f ms (%5.2f GB/s), %zu chunks, mean %.0f, stddev %.0f\n", methods[m].name, ms,
+               size / 1e6 / ms, count, mean, sqrt(squares / count - mean * mean));
+    }
+
+    // Full pipeline (boundaries + fingerprints), serial then threaded
+    CdcChunkList serial = { NULL, 0, 0 }, threaded = { NULL, 0, 0 }, after = { NULL, 0, 0 };
+    timer_start(&timer);
+    int ok = cdc_chunk_buffer(&fastcdc, data, size, 1, &serial) == 0;
+    timer_stop(&timer);
+    double serial_ms = timer_elapsed_ms(&timer);
+    int threads = parallel_resolve_threads(0);
+    timer_start(&timer);
+    ok = ok && cdc_chunk_buffer(&fastcdc, data, size, threads, &threaded) == 0;
+    timer_stop(&timer);
+    double threaded_ms = timer_elapsed_ms(&timer);
+    ok = ok && same_chunks(&serial, &threaded);
+    printf("Chunk + fingerprint:     %8.2f ms (%5.2f GB/s) serial, %.2f ms with %d threads\n",
+           serial_ms, size / 1e6 / serial_ms, threaded_ms, threads);
+
+    // Streaming in uneven pieces must reproduce the one-shot boundaries
+    CdcStream stream;
+    ok = cdc_stream_init(&stream, &fastcdc) == 0 && ok;
+    unsigned seed = 9;
+    for (size_t pos = 0; ok && pos < size;) {
+        seed = seed * 1103515245u + 12345u;
+        size_t piece = 1 + (seed >> 16) % 20000;
+        if (piece > size - pos) piece = size - pos;
+        ok = cdc_stream_update(&stream, data + pos, piece) == 0;
+        pos += piece;
+    }
+    ok = ok && cdc_stream_finish(&stream) == 0 && same_chunks(&serial, &stream.chunks);
+    cdc_stream_free(&stream);
+
+    // Insert a few bytes a third of the way in: only the chunks around the edit should change
+    memcpy(edited, data, size / 3);
+    fill_random_bytes(edited + size / 3, insert, 5);
+    memcpy(edited + size / 3 + insert, data + size / 3, size - size / 3);
+    uint64_t reused = 0;
+    if (ok && cdc_chunk_buffer(&fastcdc, edited, size + insert, threads, &after) == 0) {
+        CdcChunk *sorted = malloc(serial.count * sizeof(CdcChunk));
+        if (sorted) {
+            memcpy(sorted, serial.chunks, serial.count * sizeof(CdcChunk));
+            qsort(sorted, serial.count, sizeof(CdcChunk), compare_fingerprint);
+            for (size_t i = 0; i < after.count; i++) {
+                const CdcChunk *match = bsearch(&after.chunks[i], sorted, serial.count, sizeof(CdcChunk),
+                                                compare_fingerprint);
+                if (match && same_content(data, match, edited, &after.chunks[i])) {
+                    reused += after.chunks[i].length;
+                }
+            }
+            free(sorted);
+        }
+    }
+    double reuse = 100.0 * reused / (size + insert);
+    printf("Reused after a %zu-byte insert: %.2f%% of bytes\n", insert, reuse);
+    ok = ok && reuse > 90.0;
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    cdc_chunk_list_free(&serial);
+    cdc_chunk_list_free(&threaded);
+    cdc_chunk_list_free(&after);
+    free(data);
+    free(edited);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    unsigned char *data;
+    CdcParams gear;
+    CdcParams fastcdc;
+    CdcChunkList list;
+} CdcBenchState;
+
+static void *cdc_bench_setup(const BenchmarkParams *params) {
+    CdcBenchState *state = calloc(1, sizeof(CdcBenchState));
+    if (!state) return NULL;
+    state->data = malloc(params->size);
+    if (!state->data) {
+        free(state);
+        return NULL;
+    }
+    fill_random_bytes(state->data, params->size, 7);
+    cdc_params_init(&state->gear, 8192, 0);
+    cdc_params_init(&state->fastcdc, 8192, 2);
+    return state;
+}
+
+static void cdc_bench_teardown(void *p) {
+    CdcBenchState *state = p;
+    cdc_chunk_list_free(&state->list);
+    free(state->data);
+    free(state);
+}
+
+static double bench_cdc_rabin(void *p, const BenchmarkParams *params) {
+    CdcBenchState *state = p;
+    return (double)boundary_walk(cdc_find_boundary_rabin, &state->gear, state->data, params->size, NULL);
+}
+
+static double bench_cdc_gear(void *p, const BenchmarkParams *params) {
+    CdcBenchState *state = p;
+    return (double)boundary_walk(cdc_find_boundary, &state->gear, state->data, params->size, NULL);
+}
+
+static double bench_cdc_fastcdc(void *p, const BenchmarkParams *params) {
+    CdcBenchState *state = p;
+    return (double)boundary_walk(cdc_find_boundary, &state->fastcdc, state->data, params->size, NULL);
+}
+
+static double bench_cdc_chunk_buffer(void *p, const BenchmarkParams *params) {
+    CdcBenchState *state = p;
+    cdc_chunk_buffer(&state->fastcdc, state->data, params->size, params->threads, &state->list);
+    return (double)state->list.count;
+}
+
+static const BenchmarkParams cdc_sizes[] = { {1 << 24, 0, 0} };
+static const BenchmarkParams cdc_thread_sizes[] = { {1 << 24, 0, 1}, {1 << 24, 0, 4} };
+
+BENCHMARK_REGISTER(hash_cdc_rabin, "hash/cdc_rabin", cdc_bench_setup, bench_cdc_rabin, cdc_bench_teardown, cdc_sizes)
+BENCHMARK_REGISTER(hash_cdc_gear, "hash/cdc_gear", cdc_bench_setup, bench_cdc_gear, cdc_bench_teardown, cdc_sizes)
+BENCHMARK_REGISTER(hash_cdc_fastcdc, "hash/cdc_fastcdc", cdc_bench_setup, bench_cdc_fastcdc, cdc_bench_teardown, cdc_sizes)
+BENCHMARK_REGISTER(hash_cdc_chunk_buffer, "hash/cdc_chunk_buffer", cdc_bench_setup, bench_cdc_chunk_buffer, cdc_bench_teardown, cdc_thread_sizes)
@@ -0,0 +1,290 @@
+#include "hash_ops.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "region_marker.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__SSE4_2__) && defined(__x86_64__)
+#include <nmmintrin.h>
+#define CRC32C_USE_SSE42 1
+#endif
+
+/*
+ * Reflected CRC engine. Slice-by-8 tables and the carry-less constants
+ * are derived from the polynomial at startup.
+ *
+ * In the reflected domain the raw clmul product of A and K represents
+ * A * K * x, so the fold constant for x^n is x^(n-1) mod P. Long inputs
+ * keep a 128-bit remainder and fold in each further 16 bytes with four
+ * independent multiplies:
+ *   s' = next16 ^ s_hi * (x^191 mod P) ^ s_lo * (x^127 mod P)
+ * The remainder and tail words are then reduced with one Barrett step
+ * per 64-bit reflected word r (crc already xored in):
+ *   q   = r ^ (clmul(r, mu) << 1)        mu = reflected floor(x^96 / P) - x^64
+ *   crc = clmulh(q, poly << 1)           poly = reflected P without x^32
+ * Define CRC_USE_CLMUL=1 to exercise it with the portable clmul fallback.
+ */
+#ifndef CRC_USE_CLMUL
+#if defined(BITMANIP_HAS_ZBC) || defined(BITMANIP_HAS_PCLMUL)
+#define CRC_USE_CLMUL 1
+#else
+#define CRC_USE_CLMUL 0
+#endif
+#endif
+
+#define CRC32_IEEE_POLY 0xEDB88320u
+#define CRC32C_POLY     0x82F63B78u
+
+typedef struct {
+    uint32_t poly;              /* reflected polynomial */
+    uint64_t barrett_mu;
+    uint64_t barrett_poly;
+    uint64_t fold_hi;           /* x^191 mod P, reflected */
+    uint64_t fold_lo;           /* x^127 mod P, reflected */
+    uint32_t table[8][256];
+} CrcEngine;
+
+static CrcEngine crc32_ieee_engine;
+static CrcEngine crc32c_engine;
+
+/* x^n mod P, bit-reversed into the 64-bit layout of the fold multiplies */
+static uint64_t crc_xpow_mod(uint64_t normal_poly, int n) {
+    uint64_t rem = 1;
+    for (int i = 0; i < n; i++) {
+        rem <<= 1;
+        if (rem & (1ULL << 32)) rem ^= normal_poly;
+    }
+    return bit_reverse64(rem);
+}
+
+static void crc_engine_init(CrcEngine *e, uint32_t poly) {
+    e->poly = poly;
+
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (poly & (0u - (crc & 1)));
+        }
+        e->table[0][i] = crc;
+    }
+    for (int k = 1; k < 8; k++) {
+        for (int i = 0; i < 256; i++) {
+            uint32_t prev = e->table[k - 1][i];
+            e->table[k][i] = (prev >> 8) ^ e->table[0][prev & 0xff];
+        }
+    }
+
+    // floor(x^96 / P) by long division in the normal (unreflected) domain
+    uint64_t normal_poly = (1ULL << 32) | (bit_reverse64(poly) >> 32);
+    uint64_t rem = 0;
+    uint64_t quotient = 0;
+    for (int i = 96; i >= 0; i--) {
+        rem = (rem << 1) | (i == 96);
+        if (rem & (1ULL << 32)) {
+            rem ^= normal_poly;
+            if (i < 64) quotient |= 1ULL << i;      // the x^64 term is implicit
+        }
+    }
+    e->barrett_mu = bit_reverse64(quotient);
+    e->barrett_poly = (uint64_t)poly << 1;
+    e->fold_hi = crc_xpow_mod(normal_poly, 191);
+    e->fold_lo = crc_xpow_mod(normal_poly, 127);
+}
+
+__attribute__((constructor))
+static void crc_engines_init(void) {
+    crc_engine_init(&crc32_ieee_engine, CRC32_IEEE_POLY);
+    crc_engine_init(&crc32c_engine, CRC32C_POLY);
+}
+
+static inline uint32_t crc_byte(const CrcEngine *e, uint32_t crc, unsigned char byte) {
+    return e->table[0][(crc ^ byte) & 0xff] ^ (crc >> 8);
+}
+
+#if CRC_USE_CLMUL
+static inline uint32_t crc_barrett_word(const CrcEngine *e, uint64_t w) {
+    uint64_t q = w ^ (bit_clmul(w, e->barrett_mu) << 1);
+    return (uint32_t)bit_clmulh(q, e->barrett_poly);
+}
+#endif
+
+static uint32_t crc_engine_update(const CrcEngine *e, uint32_t crc,
+                                  const unsigned char *p, size_t length) {
+    // Align so the word loop issues aligned loads
+    while (length && ((uintptr_t)p & 7)) {
+        crc = crc_byte(e, crc, *p++);
+        length--;
+    }
+
+#if CRC_USE_CLMUL
+    if (length >= 32) {
+        uint64_t s0 = bit_load64_aligned(p) ^ crc;
+        uint64_t s1 = bit_load64_aligned(p + 8);
+        for (p += 16, length -= 16; length >= 16; p += 16, length -= 16) {
+            uint64_t n0 = bit_load64_aligned(p) ^
+                          bit_clmul(s0, e->fold_hi) ^ bit_clmul(s1, e->fold_lo);
+            uint64_t n1 = bit_load64_aligned(p + 8) ^
+                          bit_clmulh(s0, e->fold_hi) ^ bit_clmulh(s1, e->fold_lo);
+            s0 = n0;
+            s1 = n1;
+        }
+        // The remainder is a 16-byte message of its own, reduced from crc = 0
+        crc = crc_barrett_word(e, s0);
+        crc = crc_barrett_word(e, s1 ^ crc);
+    }
+#endif
+
+    for (; length >= 8; p += 8, length -= 8) {
+        uint64_t w = bit_load64_aligned(p) ^ crc;
+#if CRC_USE_CLMUL
+        crc = crc_barrett_word(e, w);
+#else
+        crc = e->table[7][w & 0xff] ^ e->table[6][(w >> 8) & 0xff] ^
+              e->table[5][(w >> 16) & 0xff] ^ e->table[4][(w >> 24) & 0xff] ^
+              e->table[3][(w >> 32) & 0xff] ^ e->table[2][(w >> 40) & 0xff] ^
+              e->table[1][(w >> 48) & 0xff] ^ e->table[0][w >> 56];
+#endif
+    }
+
+    while (length--) {
+        crc = crc_byte(e, crc, *p++);
+    }
+    return crc;
+}
+
+uint32_t crc32_ieee(uint32_t crc, const void *data, size_t length) {
+    REGION_SCOPE(REGION_CRC32);
+    if (!data) return crc;
+    return ~crc_engine_update(&crc32_ieee_engine, ~crc, data, length);
+}
+
+#ifdef CRC32C_USE_SSE42
+/* The SSE4.2 crc32 instruction implements exactly the Castagnoli polynomial */
+static uint32_t crc32c_sse42_update(uint32_t crc, const unsigned char *p, size_t length) {
+    while (length && ((uintptr_t)p & 7)) {
+        crc = _mm_crc32_u8(crc, *p++);
+        length--;
+    }
+
+    uint64_t crc64 = crc;
+    for (; length >= 8; p += 8, length -= 8) {
+        crc64 = _mm_crc32_u64(crc64, bit_load64_aligned(p));
+    }
+    crc = (uint32_t)crc64;
+
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t length) {
+    REGION_SCOPE(REGION_CRC32C);
+    if (!data) return crc;
+#ifdef CRC32C_USE_SSE42
+    return ~crc32c_sse42_update(~crc, data, length);
+#else
+    return ~crc_engine_update(&crc32c_engine, ~crc, data, length);
+#endif
+}
+
+static uint32_t crc_bitwise(uint32_t poly, uint32_t crc, const void *data, size_t length) {
+    const unsigned char *p = data;
+    if (!p) return crc;
+
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (poly & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+uint32_t crc32_ieee_reference(uint32_t crc, const void *data, size_t length) {
+    return crc_bitwise(CRC32_IEEE_POLY, crc, data, length);
+}
+
+uint32_t crc32c_reference(uint32_t crc, const void *data, size_t length) {
+    return crc_bitwise(CRC32C_POLY, crc, data, length);
+}
+
+static void compare_crc_variant(const char *name, const char *method,
+                                uint32_t (*reference)(uint32_t, const void *, size_t),
+                                uint32_t (*optimized)(uint32_t, const void *, size_t),
+                                const unsigned char *buffer, size_t size) {
+    Timer timer;
+    timer_start(&timer);
+    uint32_t expected = reference(0, buffer, size);
+    timer_stop(&timer);
+    double time_reference = timer_elapsed_ms(&timer);
+
+    timer_start(&timer);
+    uint32_t actual = optimized(0, buffer, size);
+    timer_stop(&timer);
+    double time_fast = timer_elapsed_ms(&timer);
+
+    double mb = (double)size / (1024.0 * 1024.0);
+    printf("%s (%s):\n", name, method);
+    printf("  Bitwise reference: %.3f ms (%.1f MB/s)\n", time_reference,
+           time_reference > 0 ? mb / (time_reference / 1000.0) : 0.0);
+    printf("  Optimized:         %.3f ms (%.1f MB/s, %.2fx)\n", time_fast,
+           time_fast > 0 ? mb / (time_fast / 1000.0) : 0.0,
+           time_fast > 0 ? time_reference / time_fast : 0.0);
+    printf("  Result verification: %s\n", expected == actual ? "PASS" : "FAIL");
+}
+
+void compare_crc_algorithms(size_t size) {
+    const char *engine = CRC_USE_CLMUL ? "carry-less multiply folding" : "slice-by-8";
+
+    printf("CRC Comparison [%zu bytes]\n", size);
+    printf("=========================================\n");
+
+    unsigned char *buffer = malloc(size);
+    if (!buffer) {
+        printf("Failed to allocate buffer\n");
+        return;
+    }
+    for (size_t i = 0; i < size; i++) {
+        buffer[i] = (unsigned char)rand();
+    }
+
+    compare_crc_variant("CRC-32", engine, crc32_ieee_reference, crc32_ieee, buffer, size);
+#ifdef CRC32C_USE_SSE42
+    compare_crc_variant("CRC-32C", "SSE4.2 crc32", crc32c_reference, crc32c, buffer, size);
+#else
+    compare_crc_variant("CRC-32C", engine, crc32c_reference, crc32c, buffer, size);
+#endif
+
+    free(buffer);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+static void *crc_bench_setup(const BenchmarkParams *params) {
+    unsigned char *buffer = malloc(params->size);
+    if (!buffer) return NULL;
+    for (size_t i = 0; i < params->size; i++) {
+        buffer[i] = (unsigned char)rand();
+    }
+    return buffer;
+}
+
+static void crc_bench_teardown(void *state) {
+    free(state);
+}
+
+static double bench_crc32(void *state, const BenchmarkParams *params) {
+    return (double)crc32_ieee(0, state, params->size);
+}
+
+static double bench_crc32c(void *state, const BenchmarkParams *params) {
+    return (double)crc32c(0, state, params->size);
+}
+
+static const BenchmarkParams crc_sizes[] = { {4096, 0, 0}, {1 << 20, 0, 0} };
+
+BENCHMARK_REGISTER(hash_crc32, "hash/crc32", crc_bench_setup, bench_crc32, crc_bench_teardown, crc_sizes)
+BENCHMARK_REGISTER(hash_crc32c, "hash/crc32c", crc_bench_setup, bench_crc32c, crc_bench_teardown, crc_sizes)
@@ -0,0 +1,281 @@
+#include "hash_ops.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "region_marker.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Non-cryptographic 64-bit hash in the wyhash/xxh3 family (not bit-compatible
+ * with either):
+ *   <= 16 bytes   two overlapping loads, one 64x64->128 multiply-fold
+ *   <= 256 bytes  one multiply-fold per 16 bytes (wyhash-style)
+ *   longer        eight independent 64-bit lanes per 64-byte stripe
+ *                 (xxh3-style 32x32->64 multiply-accumulate), scrambled
+ *                 every 1 KiB and folded together at the end; like xxh3,
+ *                 each stripe of a block takes its keys from the secret
+ *                 shifted by one word per stripe, so a stripe's
+ *                 contribution depends on its position
+ * The lane loop has no cross-iteration dependency, so it auto-vectorizes
+ * to pmuludq on x86 and vwmulu on RVV builds.
+ */
+
+#define HASH_LANES          8
+#define HASH_STRIPE         (HASH_LANES * 8)
+#define HASH_BLOCK_STRIPES  16
+#define HASH_LONG_THRESHOLD 256
+#define HASH_KEY_WORDS      (HASH_LANES + HASH_BLOCK_STRIPES)   /* stripe keys, then scramble keys */
+#define HASH_LAST_KEY_BYTE  121     /* unaligned, so the last stripe's keys match no block stripe */
+
+static const uint64_t hash_secret[HASH_LANES + 4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL,
+    0x1d8e4e27c47d124fULL, 0x9e3779b185ebca87ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL,
+    0xd6e8feb86659fd93ULL, 0x27d4eb2f165667c5ULL, 0x85ebca77c2b2ae63ULL, 0xff51afd7ed558ccdULL
+};
+
+static const uint64_t hash_stripe_secret[HASH_KEY_WORDS] = {
+    0xba8894fa3be59747ULL, 0x069945dea82460daULL, 0xf2b5717db02809eaULL, 0x4604208f575a097aULL,
+    0x9b2af0a33458f9d3ULL, 0x0036c74e48fed613ULL, 0x250924992b7b8fb9ULL, 0x11c2dd5402147e8bULL,
+    0xa150217aa00ce50fULL, 0x1b08078cdca13467ULL, 0x0ba8d4827c1ac113ULL, 0x10f3ff5b71bb3208ULL,
+    0x378ae3c511f071f3ULL, 0x2edc5bbc191f9c16ULL, 0x8f4870d0d2ffeacaULL, 0x0bdfe62b0dad52f6ULL,
+    0x81b330eb8eb7f693ULL, 0xde7c4e8eb1d4ec36ULL, 0x5a3a88dd3d4ce484ULL, 0xac4ee57bbf8f82b3ULL,
+    0x8aa01872aaa66025ULL, 0xf994dede4ff35e16ULL, 0xe9e99704acc43221ULL, 0xf77540e67c5ce006ULL
+};
+
+/* 64x64 -> 128 multiply, folded back to 64 bits */
+static inline uint64_t hash_mum(uint64_t a, uint64_t b) {
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+static inline uint64_t hash_load32(const unsigned char *p) {
+    uint32_t w;
+    memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+static inline uint64_t hash_avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= 0x165667919e3779f9ULL;
+    return h ^ (h >> 32);
+}
+
+/* Accumulate whole stripes, stripe s keyed by key[s..s+7]; aligned is a constant after inlining */
+static inline __attribute__((always_inline))
+void hash_accumulate(uint64_t *restrict acc, const uint64_t *restrict key,
+                     const unsigned char *p, size_t stripes, int aligned) {
+    for (size_t s = 0; s < stripes; s++, p += HASH_STRIPE) {
+        for (int i = 0; i < HASH_LANES; i++) {
+            uint64_t d = aligned ? bit_load64_aligned(p + 8 * i) : bit_load64(p + 8 * i);
+            uint64_t dk = d ^ key[s + i];
+            // The neighbouring lane also takes the raw data, so a zero
+            // product cannot erase input
+            acc[i ^ 1] += d;
+            acc[i] += (dk & 0xffffffffULL) * (dk >> 32);
+        }
+    }
+}
+
+static inline void hash_scramble(uint64_t *acc, const uint64_t *key) {
+    for (int i = 0; i < HASH_LANES; i++) {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= key[i];
+        acc[i] = a * 0x9e3779b1ULL;
+    }
+}
+
+static uint64_t hash64_long(const unsigned char *p, size_t length, uint64_t seed) {
+    uint64_t acc[HASH_LANES];
+    uint64_t key[HASH_KEY_WORDS];
+    uint64_t last_key[HASH_LANES];
+    for (int i = 0; i < HASH_KEY_WORDS; i++) {
+        key[i] = (i & 1) ? hash_stripe_secret[i] - seed : hash_stripe_secret[i] + seed;
+    }
+    for (int i = 0; i < HASH_LANES; i++) acc[i] = hash_secret[(i + 4) % (HASH_LANES + 4)];
+    memcpy(last_key, (const unsigned char *)key + HASH_LAST_KEY_BYTE, sizeof(last_key));
+    const uint64_t *scramble_key = key + HASH_BLOCK_STRIPES;
+
+    const size_t block = (size_t)HASH_STRIPE * HASH_BLOCK_STRIPES;
+    const unsigned char *q = p;
+    size_t remaining = length;
+
+    // Aligned input lets RISC-V use plain ld instead of byte loads
+    if (((uintptr_t)p & 7) == 0) {
+        for (; remaining > block; q += block, remaining -= block) {
+            hash_accumulate(acc, key, q, HASH_BLOCK_STRIPES, 1);
+            hash_scramble(acc, scramble_key);
+        }
+        hash_accumulate(acc, key, q, (remaining - 1) / HASH_STRIPE, 1);
+    } else {
+        for (; remaining > block; q += block, remaining -= block) {
+            hash_accumulate(acc, key, q, HASH_BLOCK_STRIPES, 0);
+            hash_scramble(acc, scramble_key);
+        }
+        hash_accumulate(acc, key, q, (remaining - 1) / HASH_STRIPE, 0);
+    }
+
+    // The last stripe always ends at the end of the input (it may overlap)
+    hash_accumulate(acc, last_key, p + length - HASH_STRIPE, 1, 0);
+
+    uint64_t h = length * 0x9e3779b185ebca87ULL;
+    for (int i = 0; i < HASH_LANES; i += 2) {
+        h += hash_mum(acc[i] ^ hash_secret[i + 1], acc[i + 1] ^ hash_secret[i + 4]);
+    }
+    return hash_avalanche(h);
+}
+
+uint64_t hash64(const void *data, size_t length, uint64_t seed) {
+    REGION_SCOPE(REGION_HASH64);
+    const unsigned char *p = data;
+    if (!p) length = 0;
+
+    if (length > HASH_LONG_THRESHOLD) {
+        return hash64_long(p, length, seed);
+    }
+
+    seed ^= hash_mum(seed ^ hash_secret[0], hash_secret[1]);
+    uint64_t a, b;
+
+    if (length <= 16) {
+        if (length >= 8) {
+            a = bit_load64(p);
+            b = bit_load64(p + length - 8);
+        } else if (length >= 4) {
+            a = hash_load32(p);
+            b = hash_load32(p + length - 4);
+        } else if (length > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = length;
+        for (; i > 16; i -= 16, p += 16) {
+            seed = hash_mum(bit_load64(p) ^ hash_secret[1], bit_load64(p + 8) ^ seed);
+        }
+        // The final 16 bytes overlap the last full chunk
+        a = bit_load64(p + i - 16);
+        b = bit_load64(p + i - 8);
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    __uint128_t r = (__uint128_t)a * b;
+    return hash_mum((uint64_t)r ^ hash_secret[0] ^ length, (uint64_t)(r >> 64) ^ hash_secret[1]);
+}
+
+uint64_t hash64_string(const char *str) {
+    if (!str) return 0;
+    const char *end = str;
+    while (*end) end++;
+    return hash64(str, (size_t)(end - str), 0);
+}
+
+/* FNV-1a: the byte-at-a-time baseline */
+uint64_t hash64_fnv1a(const void *data, size_t length) {
+    const unsigned char *p = data;
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < length; i++) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+void compare_hash_algorithms(size_t size) {
+    printf("64-bit Hash Comparison [%zu bytes]\n", size);
+    printf("=========================================\n");
+
+    unsigned char *buffer = malloc(size + 1);
+    if (!buffer) {
+        printf("Failed to allocate buffer\n");
+        return;
+    }
+    for (size_t i = 0; i < size + 1; i++) {
+        buffer[i] = (unsigned char)rand();
+    }
+
+    Timer timer;
+    double mb = (double)size / (1024.0 * 1024.0);
+
+    // Average a few calls: one pass over 1 MiB is shorter than the clock ramp
+    // of wide vector units
+    const int reps = 8;
+    volatile uint64_t sink = 0;
+
+    timer_start(&timer);
+    for (int r = 0; r < reps; r++) sink += hash64_fnv1a(buffer, size);
+    timer_stop(&timer);
+    double time_fnv = timer_elapsed_ms(&timer) / reps;
+
+    timer_start(&timer);
+    for (int r = 0; r < reps; r++) sink += hash64(buffer, size, r);
+    timer_stop(&timer);
+    double time_aligned = timer_elapsed_ms(&timer) / reps;
+
+    timer_start(&timer);
+    for (int r = 0; r < reps; r++) sink += hash64(buffer + 1, size, r);
+    timer_stop(&timer);
+    double time_unaligned = timer_elapsed_ms(&timer) / reps;
+    (void)sink;
+
+    printf("FNV-1a (bytewise):     %.3f ms (%.1f MB/s)\n", time_fnv,
+           time_fnv > 0 ? mb / (time_fnv / 1000.0) : 0.0);
+    printf("hash64 (aligned):      %.3f ms (%.1f MB/s, %.2fx)\n", time_aligned,
+           time_aligned > 0 ? mb / (time_aligned / 1000.0) : 0.0,
+           time_aligned > 0 ? time_fnv / time_aligned : 0.0);
+    printf("hash64 (unaligned):    %.3f ms (%.1f MB/s)\n", time_unaligned,
+           time_unaligned > 0 ? mb / (time_unaligned / 1000.0) : 0.0);
+
+    // Flipping any input bit should flip about half of the output bits
+    unsigned char key[64];
+    for (int i = 0; i < 64; i++) key[i] = (unsigned char)(i * 37 + 11);
+    int lengths[] = {3, 8, 16, 40, 64};
+    double flipped = 0;
+    int trials = 0;
+    for (int l = 0; l < 5; l++) {
+        uint64_t base = hash64(key, lengths[l], 0);
+        for (int bit = 0; bit < lengths[l] * 8; bit++) {
+            key[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            flipped += __builtin_popcountll(base ^ hash64(key, lengths[l], 0));
+            key[bit / 8] ^= (unsigned char)(1u << (bit % 8));
+            trials++;
+        }
+    }
+    double avalanche = flipped / trials;
+    printf("Avalanche: %.2f of 64 output bits per flipped input bit\n", avalanche);
+
+    int ok = avalanche > 28.0 && avalanche < 36.0;
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    free(buffer);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+static void *hash_bench_setup(const BenchmarkParams *params) {
+    unsigned char *buffer = malloc(params->size);
+    if (!buffer) return NULL;
+    for (size_t i = 0; i < params->size; i++) {
+        buffer[i] = (unsigned char)rand();
+    }
+    return buffer;
+}
+
+static void hash_bench_teardown(void *state) {
+    free(state);
+}
+
+static double bench_hash64(void *state, const BenchmarkParams *params) {
+    return (double)hash64(state, params->size, 0);
+}
+
+static double bench_fnv1a(void *state, const BenchmarkParams *params) {
+    return (double)hash64_fnv1a(state, params->size);
+}
+
+static const BenchmarkParams hash_sizes[] = { {16, 0, 0}, {4096, 0, 0}, {1 << 20, 0, 0} };
+
+BENCHMARK_REGISTER(hash_hash64, "hash/hash64", hash_bench_setup, bench_hash64, hash_bench_teardown, hash_sizes)
+BENCHMARK_REGISTER(hash_fnv1a, "hash/fnv1a", hash_bench_setup, bench_fnv1a, hash_bench_teardown, hash_sizes)
@@ -2,10 +2,25 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <math.h>
 #include "matrix_ops.h"
+#include "sparse_matrix.h"
+#include "float_text.h"
+#include "string_codec.h"
+#include "string_filter.h"
+#include "lz_compress.h"
+#include "chunking.h"
 #include "string_ops.h"
+#include "string_map.h"
+#include "log_stats.h"
+#include "line_index.h"
+#include "string_builder.h"
+#include "string_regex.h"
+#include "sequence_align.h"
 #include "math_ops.h"
+#include "hash_ops.h"
 #include "benchmark.h"
+#include "trace.h"
 
 /* Function prototypes */
 void print_usage(const char *program_name);
@@ -18,11 +33,13 @@ void demonstrate_features(void);
 void test_matrix_operations(void);
 void test_string_operations(void);
 void test_math_operations(void);
+void test_hash_operations(void);
 
 /* Benchmark functions */
 void benchmark_matrix_performance(void);
 void benchmark_string_performance(void);
 void benchmark_math_performance(void);
+void benchmark_hash_performance(void);
 
 int main(int argc, char *argv[]) {
     printf("RISC-V Performance Optimizer\n");
@@ -36,8 +53,66 @@ int main(int argc, char *argv[]) {
         return 0;
     }
     
+    const char *trace_path = NULL;
+    const char *logstats_path = NULL;
+    const char *lines_path = NULL;
+    const char *chunks_path = NULL;
+    const char *lz_path = NULL;
+    BenchmarkRunOptions bench_options;
+    int list_benchmarks = 0;
+    int run_registry = 0;
+    
+    benchmark_run_options_init(&bench_options);
+    
+    // Placement options apply before any action runs, wherever they appear
+    const char *pin_list = NULL;
+    int raise_priority = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            pin_list = argv[++i];
+        } else if (strcmp(argv[i], "--priority") == 0) {
+            raise_priority = 1;
+        }
+    }
+    if (pin_list && benchmark_pin_cpus(pin_list) != 0) return 1;
+    if (raise_priority) benchmark_raise_priority();
+    
     for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "--test") == 0) {
+        if (strcmp(argv[i], "--list") == 0) {
+            list_benchmarks = 1;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            bench_options.filter = argv[++i];
+            run_registry = 1;
+        } else if (strcmp(argv[i], "--run") == 0) {
+            run_registry = 1;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            bench_options.overrides.size = (size_t)strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--pattern-length") == 0 && i + 1 < argc) {
+            bench_options.overrides.pattern_length = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            bench_options.overrides.threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            bench_options.repetitions = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pin") == 0 && i + 1 < argc) {
+            i++;                            // applied above
+        } else if (strcmp(argv[i], "--priority") == 0) {
+            // applied above
+        } else if (strcmp(argv[i], "--logstats") == 0 && i + 1 < argc) {
+            logstats_path = argv[++i];
+        } else if (strcmp(argv[i], "--lines") == 0 && i + 1 < argc) {
+            lines_path = argv[++i];
+        } else if (strcmp(argv[i], "--chunks") == 0 && i + 1 < argc) {
+            chunks_path = argv[++i];
+        } else if (strcmp(argv[i], "--lz") == 0 && i + 1 < argc) {
+            lz_path = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+#ifdef ENABLE_TRACING
+            trace_enable();
+#else
+            printf("Warning: built without ENABLE_TRACING; use 'make trace'\n");
+#endif
+        } else if (strcmp(argv[i], "--test") == 0) {
             run_all_tests();
         } else if (strcmp(argv[i], "--benchmark") == 0) {
             run_all_benchmarks();
@@ -50,6 +125,9 @@ int main(int argc, char *argv[]) {
         } else if (strcmp(argv[i], "--math") == 0) {
             test_math_operations();
             benchmark_math_performance();
+        } else if (strcmp(argv[i], "--hash") == 0) {
+            test_hash_operations();
+            benchmark_hash_performance();
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             print_usage(argv[0]);
         } else {
@@ -59,6 +137,30 @@ int main(int argc, char *argv[]) {
         }
     }
     
+    // Registry actions run after all options are parsed so their order doesn't matter
+    if (logstats_path) {
+        if (log_stats_file(logstats_path, bench_options.overrides.threads) != 0) return 1;
+    }
+    if (lines_path) {
+        if (line_index_file(lines_path, bench_options.overrides.threads) != 0) return 1;
+    }
+    if (chunks_path) {
+        if (cdc_chunk_file(chunks_path, bench_options.overrides.threads) != 0) return 1;
+    }
+    if (lz_path) {
+        if (lz_compress_file(lz_path) != 0) return 1;
+    }
+    if (list_benchmarks) {
+        benchmark_registry_list(bench_options.filter);
+    } else if (run_registry) {
+        if (benchmark_registry_run(&bench_options) < 0) return 1;
+    }
+    
+    if (trace_path && trace_is_enabled()) {
+        trace_disable();
+        trace_export_chrome(trace_path);
+    }
+    
     return 0;
 }
 
@@ -70,8 +172,30 @@ void print_usage(const char *program_name) {
     printf("  --matrix      Test and benchmark matrix operations\n");
     printf("  --string      Test and benchmark string operations\n");
     printf("  --math        Test and benchmark mathematical operations\n");
+    printf("  --hash        Test and benchmark hashing (CRC-32, CRC-32C, hash64)\n");
+    printf("  --logstats FILE  Count clients, paths, status codes or words of a log file\n");
+    printf("                   in parallel (honours --threads) and report GB/s and lines/s\n");
+    printf("  --lines FILE     Count and index the lines of a file in parallel (wc -l style,\n");
+    printf("                   honours --threads) and report GB/s\n");
+    printf("  --chunks FILE    Split a file into content-defined chunks (FastCDC, honours\n");
+    printf("                   --threads) and report GB/s, chunk sizes and duplicate bytes\n");
+    printf("  --lz FILE        Compress a file at LZ levels 0, 4 and 9 and report the ratio\n");
+    printf("                   and compress/decompress MB/s\n");
+    printf("  --trace FILE  Record trace zones to FILE (Chrome JSON, needs 'make trace')\n");
     printf("  --help, -h    Show this help message\n\n");
-    printf("With no arguments, runs a demonstration of all features.\n");
+    printf("Registered benchmarks:\n");
+    printf("  --list                List benchmark instances (honours --filter)\n");
+    printf("  --run                 Run all registered benchmarks\n");
+    printf("  --filter REGEX        Run benchmarks whose instance name matches REGEX\n");
+    printf("  --size N              Override the problem size of every instance\n");
+    printf("  --pattern-length N    Override the search pattern length\n");
+    printf("  --threads N           Override the thread count of threaded benchmarks\n");
+    printf("  --repeat N            Timed repetitions per instance (default 5)\n");
+    printf("  --pin CPUS            Pin to CPUS (e.g. 2,3 or 4-7); worker N runs on the Nth CPU\n");
+    printf("  --priority            Raise scheduling priority (needs CAP_SYS_NICE)\n");
+    printf("\nWith no arguments, runs a demonstration of all features.\n");
+    printf("Set RVOPT_THREADS to limit the worker count of parallel kernels.\n");
+    printf("Set RVOPT_MISALIGNED=fast|slow to override misaligned-load detection.\n");
 }
 
 void print_system_info(void) {
@@ -80,6 +204,12 @@ void print_system_info(void) {
     printf("  CPU Cores:    %d\n", get_cpu_core_count());
     printf("  CPU Freq:     %.1f GHz\n", get_cpu_frequency_ghz());
     
+    const MisalignedAccessInfo *misaligned = string_misaligned_access();
+    printf("  Misaligned:   %s (%s", misaligned->fast ? "fast, native loads" : "slow, shift-and-merge",
+           misaligned->source);
+    if (misaligned->ratio > 0) printf(", %.2fx aligned", misaligned->ratio);
+    printf(")\n");
+    
 #ifdef __riscv
     printf("  RISC-V Features:\n");
     #ifdef __riscv_vector
@@ -94,6 +224,16 @@ void print_system_info(void) {
     printf("    - Compressed Instructions (RVC): Not available\n");
     #endif
     
+    #ifdef __riscv_zba
+    printf("    - Address Generation (Zba): Enabled\n");
+    #endif
+    #ifdef __riscv_zbb
+    printf("    - Basic Bit-Manipulation (Zbb): Enabled\n");
+    #endif
+    #ifdef __riscv_zbc
+    printf("    - Carry-less Multiply (Zbc): Enabled\n");
+    #endif
+    
     printf("    - XLEN: %d-bit\n", __riscv_xlen);
 #endif
     
@@ -156,13 +296,21 @@ void run_all_tests(void) {
     test_matrix_operations();
     test_string_operations();
     test_math_operations();
+    test_hash_operations();
 }
 
 void run_all_benchmarks(void) {
     printf("=== RUNNING ALL BENCHMARKS ===\n\n");
+    
+    BenchmarkEnvironment env;
+    benchmark_environment_detect(&env);
+    benchmark_environment_print(&env);
+    printf("\n");
+    
     benchmark_matrix_performance();
     benchmark_string_performance();
     benchmark_math_performance();
+    benchmark_hash_performance();
 }
 
 void test_matrix_operations(void) {
@@ -181,6 +329,29 @@ void test_matrix_operations(void) {
         matrix_destroy(m);
     }
     
+    // Test the cache-bypassing paths by forcing them on for small inputs
+    matrix_set_streaming_threshold(1);
+    Matrix *ident = matrix_create(33, 33);
+    Matrix *rect = matrix_create(37, 45);
+    if (ident && rect) {
+        matrix_fill_identity(ident);
+        printf("✓ Streaming identity sum: %.1f (expected: 33.0)\n", matrix_sum(ident));
+        
+        matrix_fill_random(rect);
+        Matrix *t = matrix_transpose_copy(rect);
+        int ok = t && t->rows == rect->cols && t->cols == rect->rows;
+        for (size_t i = 0; ok && i < rect->rows; i++) {
+            for (size_t j = 0; j < rect->cols; j++) {
+                if (t->data[j * t->cols + i] != rect->data[i * rect->cols + j]) ok = 0;
+            }
+        }
+        printf("✓ Streaming transpose copy (37x45): %s\n", ok ? "PASS" : "FAIL");
+        matrix_destroy(t);
+    }
+    matrix_destroy(ident);
+    matrix_destroy(rect);
+    matrix_set_streaming_threshold(MATRIX_STREAMING_THRESHOLD);
+    
     // Test matrix multiplication
     Matrix *a = matrix_create(2, 3);
     Matrix *b = matrix_create(3, 2);
@@ -199,6 +370,126 @@ void test_matrix_operations(void) {
         matrix_destroy(b);
     }
     
+    // Test sparse products against the dense reference
+    SparseMatrix *sa = sparse_matrix_random(40, 30, 0.1);
+    SparseMatrix *sb = sparse_matrix_random(30, 20, 0.1);
+    Matrix *da = sparse_matrix_to_dense(sa);
+    Matrix *db = sparse_matrix_to_dense(sb);
+    
+    if (sa && sb && da && db) {
+        Matrix *expected = matrix_multiply_naive(da, db);
+        Matrix *spmm = sparse_multiply_dense(sa, db, 4);
+        SparseMatrix *spgemm = sparse_multiply_sparse(sa, sb, 4);
+        Matrix *spgemm_dense = sparse_matrix_to_dense(spgemm);
+        
+        // Only the summation order differs; entries are up to 100, so products reach 1e4
+        const double sparse_tolerance = 1e-9;
+        double max_err_spmm = 0.0, max_err_spgemm = 0.0;
+        int sparse_ok = expected && spmm && spgemm_dense;
+        if (sparse_ok) {
+            for (size_t i = 0; i < expected->rows * expected->cols; i++) {
+                max_err_spmm = fmax(max_err_spmm, fabs(expected->data[i] - spmm->data[i]));
+                max_err_spgemm = fmax(max_err_spgemm, fabs(expected->data[i] - spgemm_dense->data[i]));
+            }
+        }
+        printf("✓ Sparse x dense (SpMM) max error %.2e: %s\n", max_err_spmm,
+               sparse_ok && max_err_spmm <= sparse_tolerance ? "PASS" : "FAIL");
+        printf("✓ Sparse x sparse (SpGEMM) max error %.2e (nnz %zu): %s\n", max_err_spgemm,
+               spgemm ? spgemm->nnz : 0, sparse_ok && max_err_spgemm <= sparse_tolerance ? "PASS" : "FAIL");
+        
+        matrix_destroy(expected);
+        matrix_destroy(spmm);
+        matrix_destroy(spgemm_dense);
+        sparse_matrix_destroy(spgemm);
+    }
+    
+    sparse_matrix_destroy(sa);
+    sparse_matrix_destroy(sb);
+    matrix_destroy(da);
+    matrix_destroy(db);
+    
+    // Text I/O: exact parsing, shortest round-trip formatting, CSV and Matrix Market
+    const char *parse_cases[] = {
+        "0", "-0", "0.1", "1e23", "4.9e-324", "2.2250738585072011e-308", "9007199254740993",
+        "1.7976931348623157e308", "1e400", "123456789012345678901234567890", ".5e-3", "-inf"
+    };
+    int text_ok = 1;
+    for (size_t i = 0; i < sizeof(parse_cases) / sizeof(parse_cases[0]); i++) {
+        const char *end = parse_cases[i] + strlen(parse_cases[i]);
+        double expected = strtod(parse_cases[i], NULL), parsed = 0.0;
+        text_ok = text_ok && float_text_parse(parse_cases[i], end, &parsed) == end &&
+                  memcmp(&parsed, &expected, sizeof(double)) == 0;
+    }
+    struct { double value; const char *text; } format_cases[] = {
+        { 0.1, "0.1" }, { -0.0, "-0" }, { 100.0, "100" }, { 1e23, "1e23" }, { 5e-324, "5e-324" },
+        { 1.5e-7, "1.5e-7" }, { 123.456, "123.456" }, { 0.000123, "0.000123" }
+    };
+    char shortest[FLOAT_TEXT_MAX];
+    for (size_t i = 0; i < sizeof(format_cases) / sizeof(format_cases[0]); i++) {
+        float_text_format(format_cases[i].value, shortest);
+        text_ok = text_ok && strcmp(shortest, format_cases[i].text) == 0;
+    }
+    unsigned long long float_seed = 0x9E3779B97F4A7C15ULL;
+    for (int i = 0; i < 20000 && text_ok; i++) {
+        float_seed ^= float_seed << 13;
+        float_seed ^= float_seed >> 7;
+        float_seed ^= float_seed << 17;
+        double value, parsed = 0.0;
+        memcpy(&value, &float_seed, sizeof(value));
+        if (value != value) continue;
+        size_t length = float_text_format(value, shortest);
+        text_ok = float_text_parse(shortest, shortest + length, &parsed) == shortest + length &&
+                  memcmp(&parsed, &value, sizeof(double)) == 0 && strtod(shortest, NULL) == value;
+    }
+    printf("✓ Float text parse/format (exact, shortest round-trip): %s\n", text_ok ? "PASS" : "FAIL");
+    
+    Matrix *io = matrix_create(37, 23);
+    int io_ok = io != NULL;
+    if (io) {
+        matrix_fill_random(io);
+        io->data[0] = -0.0;
+        io->data[1] = 5e-324;
+        io->data[2] = -1.7976931348623157e308;
+        size_t length = 0;
+        char *csv = matrix_format_csv(io, 4, &length);
+        Matrix *from_csv = csv ? matrix_parse_csv(csv, length, 4) : NULL;
+        char *market = matrix_format_market(io, 4, &length);
+        Matrix *from_market = market ? matrix_parse_market(market, length, 4) : NULL;
+        io_ok = from_csv && from_market && from_csv->rows == 37 && from_csv->cols == 23 &&
+                from_market->rows == 37 && from_market->cols == 23 &&
+                memcmp(from_csv->data, io->data, 37 * 23 * sizeof(double)) == 0 &&
+                memcmp(from_market->data, io->data, 37 * 23 * sizeof(double)) == 0;
+        free(csv);
+        free(market);
+        matrix_destroy(from_csv);
+        matrix_destroy(from_market);
+        matrix_destroy(io);
+    }
+    const char *coordinate = "%%MatrixMarket matrix coordinate real symmetric\n% lower triangle\n"
+                             "3 3 3\n1 1 2.5\n3 1 -1\n2 2 4e0\n";
+    Matrix *sym = matrix_parse_market(coordinate, strlen(coordinate), 2);
+    io_ok = io_ok && sym && sym->data[0] == 2.5 && sym->data[2] == -1.0 && sym->data[6] == -1.0 &&
+            sym->data[4] == 4.0 && matrix_sum(sym) == 4.5;
+    matrix_destroy(sym);
+    // Headers whose size wraps size_t (or a single index past it) are rejected before allocating
+    const char *oversized[] = {
+        "%%MatrixMarket matrix coordinate real general\n4294967296 4294967296 1\n1 1 1\n",
+        "%%MatrixMarket matrix array real general\n4294967296 4294967296\n1\n",
+        "%%MatrixMarket matrix coordinate real general\n99999999999999999999999 1 1\n1 1 1\n"
+    };
+    for (int k = 0; k < 3; k++) {
+        Matrix *huge = matrix_parse_market(oversized[k], strlen(oversized[k]), 1);
+        io_ok = io_ok && !huge;
+        matrix_destroy(huge);
+    }
+    const char *ragged_csv = "1,2\n3\n", *crlf_csv = "1, 2\r\n3 ,4e1\r\n\r\n";
+    Matrix *ragged = matrix_parse_csv(ragged_csv, strlen(ragged_csv), 1);
+    Matrix *crlf = matrix_parse_csv(crlf_csv, strlen(crlf_csv), 1);
+    io_ok = io_ok && !ragged && crlf && crlf->rows == 2 && crlf->cols == 2 && matrix_sum(crlf) == 46.0;
+    matrix_destroy(ragged);
+    matrix_destroy(crlf);
+    printf("✓ Matrix CSV/Matrix Market round trip (chunked): %s\n", io_ok ? "PASS" : "FAIL");
+    
     printf("Matrix operations test completed.\n\n");
 }
 
@@ -211,6 +502,115 @@ void test_string_operations(void) {
     // Test basic operations
     printf("✓ String length: %d\n", string_length(test_str));
     
+    // Word-at-a-time length must agree at every alignment
+    char aligned_buf[64];
+    int length_ok = 1;
+    for (int offset = 0; offset < 8; offset++) {
+        for (int len = 0; len + offset < (int)sizeof(aligned_buf) - 1; len++) {
+            memset(aligned_buf, 'x', sizeof(aligned_buf));
+            aligned_buf[offset + len] = '\0';
+            if (string_length(aligned_buf + offset) != len) length_ok = 0;
+        }
+    }
+    printf("✓ String length at all alignments: %s\n", length_ok ? "PASS" : "FAIL");
+    
+    // Word-at-a-time scanners against byte loops at every alignment
+    char scan_a[48], scan_b[48];
+    int scan_ok = 1;
+    for (int offset = 0; offset < 8; offset++) {
+        for (int len = 0; len + offset < (int)sizeof(scan_a) - 1; len++) {
+            for (int i = 0; i < len; i++) scan_a[offset + i] = (char)('a' + (i * 7) % 26);
+            scan_a[offset + len] = '\0';
+            const char *s = scan_a + offset;
+            const char *expect = NULL;
+            for (int i = 0; i < len && !expect; i++) {
+                if (s[i] == 'q') expect = s + i;
+            }
+            if (string_find_char(s, 'q') != expect) scan_ok = 0;
+            if (string_memchr(s, 'q', len) != (const void *)expect) scan_ok = 0;
+            if (string_find_char(s, '\0') != s + len) scan_ok = 0;
+            
+            // Same and different alignments, equal strings and one change
+            for (int shift = 0; shift < 2; shift++) {
+                char *t = scan_b + offset + shift;
+                if (offset + shift + len >= (int)sizeof(scan_b)) continue;
+                for (int i = 0; i <= len; i++) t[i] = s[i];
+                if (string_compare_optimized(s, t) != string_compare(s, t)) scan_ok = 0;
+                if (len > 0) {
+                    t[len - 1] = (char)(t[len - 1] + 1);
+                    if (string_compare_optimized(s, t) != string_compare(s, t)) scan_ok = 0;
+                    t[len - 1] = '\0';
+                    if (string_compare_optimized(s, t) != string_compare(s, t)) scan_ok = 0;
+                }
+            }
+        }
+    }
+    printf("✓ Word-at-a-time memchr/find_char/compare: %s\n", scan_ok ? "PASS" : "FAIL");
+    
+    // Copy, equality and compare with both misaligned-stream strategies
+    char src_buf[80], dst_buf[80];
+    int misaligned_ok = 1;
+    for (int fast = 0; fast <= 1; fast++) {
+        string_set_misaligned_access(fast);
+        for (int src_off = 0; src_off < 8; src_off++) {
+            for (int dst_off = 0; dst_off < 8; dst_off++) {
+                for (int len = 0; len <= 40; len++) {
+                    char *src = src_buf + src_off;
+                    char *dst = dst_buf + dst_off;
+                    for (int i = 0; i < len; i++) src[i] = (char)('A' + (i * 5 + src_off) % 26);
+                    src[len] = '\0';
+                    memset(dst_buf, '#', sizeof(dst_buf));
+                    string_memcpy(dst, src, len + 1);
+                    if (!string_bytes_equal(dst, src, len + 1) || dst[len + 1] != '#') misaligned_ok = 0;
+                    if (dst_off > 0 && dst[-1] != '#') misaligned_ok = 0;
+                    if (string_compare_optimized(dst, src) != 0) misaligned_ok = 0;
+                    if (len > 0) {
+                        dst[len / 2] = (char)(dst[len / 2] + 1);
+                        if (string_bytes_equal(dst, src, len)) misaligned_ok = 0;
+                        if (string_compare_optimized(dst, src) != string_compare(dst, src) ||
+                            string_compare_optimized(src, dst) != string_compare(src, dst)) misaligned_ok = 0;
+                    }
+                }
+            }
+        }
+    }
+    string_set_misaligned_access(-1);
+    printf("✓ Misaligned-stream copy/compare (merge and native loads): %s\n",
+           misaligned_ok ? "PASS" : "FAIL");
+
+    // Case-insensitive search: every byte pair through the word compare, then whole searches
+    char fold_a[32], fold_b[33];
+    int nocase_ok = 1;
+    for (int fast = 0; fast <= 1; fast++) {
+        string_set_misaligned_access(fast);
+        for (int a = 0; a < 256; a++) {
+            for (int b = 0; b < 256; b++) {
+                for (int i = 0; i < 32; i++) fold_a[i] = fold_b[i + 1] = (char)("aBcD"[i & 3] ^ (i & 0x20));
+                fold_a[19] = (char)a;
+                fold_b[20] = (char)b;
+                int letter = ((a | 0x20) >= 'a' && (a | 0x20) <= 'z');
+                int expected = a == b || (letter && (a | 0x20) == (b | 0x20));
+                if (string_bytes_equal_nocase(fold_a, fold_b + 1, 32) != expected) nocase_ok = 0;
+            }
+        }
+    }
+    string_set_misaligned_access(-1);
+    const char *nocase_text = "GET /Index.HTML 200 [Warn] a@b";
+    nocase_ok = nocase_ok && string_find_nocase(nocase_text, "index.html") == 5 &&
+                string_find_nocase(nocase_text, "[WARN]") == 20 &&
+                string_find_nocase(nocase_text, "`") == -1 &&           // '@' | 0x20
+                string_find_nocase(nocase_text, "get /index.html 200 [warn] A@B") == 0 &&
+                string_find_nocase(nocase_text, "") == 0 &&
+                string_memchr_nocase(nocase_text, 'h', 30) == nocase_text + 11;
+    printf("✓ Case-insensitive search (folded word compares): %s\n", nocase_ok ? "PASS" : "FAIL");
+
+    int part_count = 0;
+    char **parts = string_split("alpha,beta,,gamma", ',', &part_count);
+    int split_ok = parts && part_count == 4 && string_compare(parts[0], "alpha") == 0 &&
+                   string_compare(parts[2], "") == 0 && string_compare(parts[3], "gamma") == 0;
+    string_array_free(parts, part_count);
+    printf("✓ String split: %s\n", split_ok ? "PASS" : "FAIL");
+    
     char *copy = string_copy(test_str);
     if (copy) {
         printf("✓ String copy successful\n");
@@ -237,6 +637,434 @@ void test_string_operations(void) {
     printf("  - Boyer-Moore: %d\n", boyer_moore_search(text, pattern));
     printf("  - Rabin-Karp: %d\n", rabin_karp_search(text, pattern));
     
+    // String map: counting, lookups of non-terminated spans, erase, and
+    // growth through several rehashes
+    StringMap *map = string_map_create(0);
+    int map_ok = map != NULL;
+    if (map) {
+        const char *words = "to be or not to be that is the question";
+        for (const char *w = words; *w; ) {
+            const char *space = string_find_char(w, ' ');
+            size_t len = space ? (size_t)(space - w) : (size_t)string_length(w);
+            uint64_t *count = string_map_upsert(map, w, len);
+            if (count) (*count)++;
+            w += space ? len + 1 : len;
+        }
+        uint64_t *to = string_map_find(map, "to be", 2);
+        uint64_t *be = string_map_find(map, "be", 2);
+        map_ok = map->size == 8 && to && *to == 2 && be && *be == 2 &&
+                 !string_map_find(map, "tobe", 4);
+        
+        map_ok = map_ok && string_map_erase(map, "be", 2) && !string_map_erase(map, "be", 2) &&
+                 !string_map_find(map, "be", 2) && map->size == 7;
+        
+        char key[32];
+        for (int i = 0; i < 5000; i++) {
+            int len = snprintf(key, sizeof(key), "key-%d", i);
+            uint64_t *value = string_map_upsert(map, key, (size_t)len);
+            if (value) *value = (uint64_t)i;
+            if (i % 3 == 0) string_map_erase(map, key, (size_t)len);
+        }
+        for (int i = 0; i < 5000; i++) {
+            int len = snprintf(key, sizeof(key), "key-%d", i);
+            uint64_t *value = string_map_find(map, key, (size_t)len);
+            if (i % 3 == 0 ? value != NULL : (!value || *value != (uint64_t)i)) map_ok = 0;
+        }
+        map_ok = map_ok && map->size == 7 + 5000 - 1667;
+        string_map_destroy(map);
+    }
+    printf("✓ String map upsert/find/erase: %s\n", map_ok ? "PASS" : "FAIL");
+    
+    // Log statistics: known counts on a small log, and identical tables
+    // whether a synthetic log is processed by one worker or split into
+    // line-aligned chunks across four
+    const char *log_text =
+        "10.0.0.1 - - [18/Oct/2026:10:00:00 +0000] \"GET /index.html HTTP/1.1\" 200 512\n"
+        "10.0.0.2 - - [18/Oct/2026:10:00:01 +0000] \"GET /index.html HTTP/1.1\" 304 0\r\n"
+        "disk full on /var\n"
+        "10.0.0.1 - - [18/Oct/2026:10:00:02 +0000] \"POST /login HTTP/1.1\" 500 17";
+    LogStats small;
+    int log_ok = log_stats_init(&small) == 0;
+    if (log_ok) {
+        log_ok = log_stats_process(log_text, string_length(log_text), 1, &small) == 0;
+        uint64_t *client = string_map_find(small.clients, "10.0.0.1", 8);
+        uint64_t *index = string_map_find(small.paths, "/index.html", 11);
+        uint64_t *server_error = string_map_find(small.statuses, "500", 3);
+        log_ok = log_ok && small.lines == 4 && client && *client == 2 && index && *index == 2 &&
+                 server_error && *server_error == 1 && small.tokens->size == 4;
+        log_stats_free(&small);
+    }
+    
+    size_t synthetic_length = 0;
+    char *synthetic = log_stats_synthetic(1 << 18, &synthetic_length);
+    LogStats serial, split;
+    if (synthetic && log_stats_init(&serial) == 0) {
+        if (log_stats_init(&split) == 0) {
+            log_stats_process(synthetic, synthetic_length, 1, &serial);
+            log_stats_process(synthetic, synthetic_length, 4, &split);
+            size_t newlines = 0;
+            for (size_t i = 0; i < synthetic_length; i++) newlines += synthetic[i] == '\n';
+            log_ok = log_ok && serial.lines == newlines && split.lines == newlines &&
+                     serial.clients->size == split.clients->size &&
+                     serial.paths->size == split.paths->size &&
+                     serial.tokens->size == split.tokens->size;
+            uint64_t *ok_serial = string_map_find(serial.statuses, "200", 3);
+            uint64_t *ok_split = string_map_find(split.statuses, "200", 3);
+            log_ok = log_ok && ok_serial && ok_split && *ok_serial == *ok_split;
+            log_stats_free(&split);
+        } else {
+            log_ok = 0;
+        }
+        log_stats_free(&serial);
+    } else {
+        log_ok = 0;
+    }
+    free(synthetic);
+    printf("✓ Log statistics (single and chunked): %s\n", log_ok ? "PASS" : "FAIL");
+    
+    // Line counting and indexing: edge cases, then a multi-chunk buffer against a byte loop
+    struct { const char *text; size_t lines; } line_cases[] = {
+        { "", 0 }, { "a", 1 }, { "a\n", 1 }, { "a\nb", 2 }, { "\n\n", 2 }, { "one\n\nthree\n", 3 },
+    };
+    int lines_ok = 1;
+    for (size_t i = 0; i < sizeof(line_cases) / sizeof(line_cases[0]); i++) {
+        LineIndex index;
+        size_t length = strlen(line_cases[i].text);
+        lines_ok = lines_ok && line_index_build(&index, line_cases[i].text, length, 1) == 0 &&
+                   line_index_lines(&index) == line_cases[i].lines;
+        line_index_free(&index);
+    }
+    size_t line_text_size = (1 << 20) + 37;
+    char *line_text = malloc(line_text_size);
+    if (line_text) {
+        unsigned line_seed = 7;
+        size_t expected = 0;
+        for (size_t i = 0; i < line_text_size; i++) {
+            line_seed = line_seed * 1103515245u + 12345u;
+            line_text[i] = (line_seed >> 16) % 61 == 0 ? '\n' : (char)('a' + (line_seed >> 20) % 26);
+            expected += line_text[i] == '\n';
+        }
+        size_t head = (line_text[0] == '\n') + (line_text[1] == '\n') + (line_text[2] == '\n');
+        LineIndex index;
+        lines_ok = lines_ok && line_count_newlines(line_text + 3, line_text_size - 3) == expected - head &&
+                   line_count_newlines_parallel(line_text, line_text_size, 4) == expected &&
+                   line_index_build(&index, line_text, line_text_size, 4) == 0 && index.count == expected;
+        for (size_t i = 0, k = 0; lines_ok && i < line_text_size; i++) {
+            if (line_text[i] == '\n') lines_ok = index.newlines[k++] == i;
+        }
+        const char *line_start = NULL;
+        size_t line_length = 0;
+        size_t last_line = line_index_lines(&index) - 1;
+        lines_ok = lines_ok && line_index_line_of(&index, index.newlines[10]) == 10 &&
+                   line_index_line_of(&index, index.newlines[10] + 1) == 11 &&
+                   line_index_line(&index, 11, &line_start, &line_length) == 0 &&
+                   line_start == line_text + index.newlines[10] + 1 &&
+                   line_length == index.newlines[11] - index.newlines[10] - 1 &&
+                   line_index_line_of(&index, line_text_size - 1) == last_line &&
+                   line_index_line(&index, last_line + 1, NULL, NULL) == -1;
+        line_index_free(&index);
+        free(line_text);
+    } else {
+        lines_ok = 0;
+    }
+    printf("✓ Line counting and index (vector, chunked): %s\n", lines_ok ? "PASS" : "FAIL");
+    
+    // Base64/hex codecs: RFC 4648 vectors, vector path against scalar, malformed input
+    struct { const char *plain; const char *encoded; } base64_cases[] = {
+        { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" },
+    };
+    char codec_text[1024];
+    unsigned char codec_bytes[512];
+    size_t codec_length = 0;
+    int codec_ok = 1;
+    for (size_t i = 0; i < sizeof(base64_cases) / sizeof(base64_cases[0]); i++) {
+        size_t plain = strlen(base64_cases[i].plain);
+        size_t encoded = strlen(base64_cases[i].encoded);
+        codec_ok = codec_ok && base64_encode(base64_cases[i].plain, plain, codec_text, BASE64_STANDARD) == encoded &&
+                   memcmp(codec_text, base64_cases[i].encoded, encoded) == 0 &&
+                   base64_decode(codec_text, encoded, codec_bytes, &codec_length, BASE64_STANDARD) == 0 &&
+                   codec_length == plain && memcmp(codec_bytes, base64_cases[i].plain, plain) == 0;
+    }
+    codec_ok = codec_ok && base64_encode("\xfb\xff", 2, codec_text, BASE64_URL) == 3 && memcmp(codec_text, "-_8", 3) == 0 &&
+               base64_decode("-_8", 3, codec_bytes, &codec_length, BASE64_URL) == 0 && codec_length == 2 &&
+               base64_decode("-_8", 3, codec_bytes, &codec_length, BASE64_STANDARD) == -1;
+    const char *bad_base64[] = { "Zm9v!", "Zg=", "Z===", "Zh==", "Z", "Zm=v" };
+    for (size_t i = 0; i < sizeof(bad_base64) / sizeof(bad_base64[0]); i++) {
+        codec_ok = codec_ok && base64_decode(bad_base64[i], strlen(bad_base64[i]), codec_bytes, NULL, BASE64_STANDARD) == -1;
+    }
+    unsigned codec_seed = 11;
+    unsigned char codec_data[300];
+    char codec_reference[1024];
+    for (size_t length = 0; codec_ok && length <= sizeof(codec_data); length++) {
+        for (size_t i = 0; i < length; i++) {
+            codec_seed = codec_seed * 1103515245u + 12345u;
+            codec_data[i] = (unsigned char)(codec_seed >> 16);
+        }
+        for (int alphabet = BASE64_STANDARD; alphabet <= BASE64_URL; alphabet++) {
+            size_t encoded = base64_encode(codec_data, length, codec_text, (Base64Alphabet)alphabet);
+            codec_ok = codec_ok && encoded == base64_encoded_length(length, (Base64Alphabet)alphabet) &&
+                       base64_encode_scalar(codec_data, length, codec_reference, (Base64Alphabet)alphabet) == encoded &&
+                       memcmp(codec_text, codec_reference, encoded) == 0 &&
+                       base64_decode(codec_text, encoded, codec_bytes, &codec_length, (Base64Alphabet)alphabet) == 0 &&
+                       codec_length == length && memcmp(codec_bytes, codec_data, length) == 0;
+            if (encoded > 4) {
+                codec_text[encoded / 2] = '*';
+                codec_ok = codec_ok && base64_decode(codec_text, encoded, codec_bytes, NULL, (Base64Alphabet)alphabet) == -1;
+            }
+        }
+        codec_ok = codec_ok && hex_encode(codec_data, length, codec_text) == 2 * length &&
+                   hex_encode_scalar(codec_data, length, codec_reference) == 2 * length &&
+                   memcmp(codec_text, codec_reference, 2 * length) == 0 &&
+                   hex_decode(codec_text, 2 * length, codec_bytes) == 0 && memcmp(codec_bytes, codec_data, length) == 0;
+        if (length > 0) {
+            codec_text[length] = 'g';
+            codec_ok = codec_ok && hex_decode(codec_text, 2 * length, codec_bytes) == -1;
+        }
+    }
+    codec_ok = codec_ok && hex_decode("deadBEEF", 8, codec_bytes) == 0 && codec_bytes[0] == 0xde && codec_bytes[3] == 0xef &&
+               hex_decode("abc", 3, codec_bytes) == -1;
+    printf("✓ Base64/hex codecs (vector, scalar, validation): %s\n", codec_ok ? "PASS" : "FAIL");
+    
+    // Bloom/cuckoo filters: no false negatives, bounded false positives, removal; then the key set scanner
+    BloomFilter bloom = {0};
+    CuckooFilter cuckoo = {0};
+    int filter_ok = bloom_filter_init(&bloom, 10000, 10.0) == 0 && cuckoo_filter_init(&cuckoo, 10000) == 0;
+    size_t bloom_false = 0, cuckoo_false = 0, cuckoo_kept = 0;
+    for (uint64_t i = 0; filter_ok && i < 10000; i++) {
+        bloom_filter_add(&bloom, hash64(&i, sizeof(i), 1));
+        filter_ok = cuckoo_filter_add(&cuckoo, hash64(&i, sizeof(i), 1)) == 0;
+    }
+    for (uint64_t i = 0; filter_ok && i < 10000; i++) {
+        filter_ok = bloom_filter_contains(&bloom, hash64(&i, sizeof(i), 1)) &&
+                    cuckoo_filter_contains(&cuckoo, hash64(&i, sizeof(i), 1)) &&
+                    (i % 2 || cuckoo_filter_remove(&cuckoo, hash64(&i, sizeof(i), 1)) == 1);
+    }
+    for (uint64_t i = 10000; filter_ok && i < 110000; i++) {
+        bloom_false += bloom_filter_contains(&bloom, hash64(&i, sizeof(i), 1));
+        cuckoo_false += cuckoo_filter_contains(&cuckoo, hash64(&i, sizeof(i), 1));
+    }
+    for (uint64_t i = 1; filter_ok && i < 10000; i += 2) {
+        cuckoo_kept += cuckoo_filter_contains(&cuckoo, hash64(&i, sizeof(i), 1));
+    }
+    filter_ok = filter_ok && bloom_false < 2000 && cuckoo_false < 100 && cuckoo_kept == 5000 && cuckoo.count == 5000;
+    bloom_filter_free(&bloom);
+    cuckoo_filter_free(&cuckoo);
+    filter_ok = filter_ok && cuckoo_filter_init(&cuckoo, 64) == 0;
+    int cuckoo_full = 0;
+    for (uint64_t i = 0; filter_ok && i < 1000 && !cuckoo_full; i++) {
+        cuckoo_full = cuckoo_filter_add(&cuckoo, hash64(&i, sizeof(i), 2)) == -1;
+    }
+    filter_ok = filter_ok && cuckoo_full;
+    cuckoo_filter_free(&cuckoo);
+    
+    const char *filter_keys[] = { "needle", "needles", "hay", "stack" };
+    size_t filter_lengths[] = { 6, 7, 3, 5 };
+    const char *haystack = "a haystack full of needles";
+    for (int mode = STRING_PREFILTER_NONE; mode <= STRING_PREFILTER_CUCKOO; mode++) {
+        StringKeySet *set = string_key_set_create(filter_keys, filter_lengths, 4, (StringPrefilter)mode);
+        size_t key = 0;
+        filter_ok = filter_ok && set && string_key_set_find(set, haystack, strlen(haystack), &key) == haystack + 2 &&
+                    key == 2 && string_key_set_count(set, haystack, strlen(haystack), NULL) == 4 &&
+                    string_key_set_find(set, "xxneedl", 7, &key) == NULL &&
+                    string_key_set_find(set, "xxneedle", 8, &key) != NULL && key == 0 &&
+                    string_key_set_find(set, "ha", 2, &key) == NULL;
+        string_key_set_destroy(set);
+    }
+    printf("✓ Bloom/cuckoo filters and prefiltered key set scan: %s\n", filter_ok ? "PASS" : "FAIL");
+    
+    // LZ blocks: round trips per level and at tiny sizes, malformed input, then a frame fed in pieces
+    size_t lz_size = 200000;
+    unsigned char *lz_data = malloc(lz_size);
+    unsigned char *lz_packed = malloc(lz_compress_bound(lz_size));
+    unsigned char *lz_unpacked = malloc(lz_size);
+    int lz_ok = lz_data && lz_packed && lz_unpacked;
+    for (size_t i = 0; lz_ok && i < lz_size; i++) {
+        lz_data[i] = (unsigned char)(i % 7 == 0 ? i * 31 / 7 : (size_t)(unsigned char)"abcabcabd"[i % 9]);
+    }
+    const int lz_levels[] = { 0, 1, 4, LZ_MAX_LEVEL };
+    for (int l = 0; lz_ok && l < 4; l++) {
+        for (size_t size = 0; lz_ok && size <= 40; size++) {
+            size_t packed = lz_compress(lz_data, size, lz_packed, lz_compress_bound(size), lz_levels[l]);
+            size_t decoded = 0;
+            lz_ok = packed > 0 && lz_decompress(lz_packed, packed, lz_unpacked, size, &decoded) == 0 &&
+                    decoded == size && memcmp(lz_unpacked, lz_data, size) == 0;
+        }
+        size_t packed = lz_compress(lz_data, lz_size, lz_packed, lz_compress_bound(lz_size), lz_levels[l]);
+        size_t decoded = 0, reference = 0;
+        lz_ok = lz_ok && packed > 0 && packed < lz_size / 3 &&
+                lz_decompress(lz_packed, packed, lz_unpacked, lz_size, &decoded) == 0 && decoded == lz_size &&
+                memcmp(lz_unpacked, lz_data, lz_size) == 0 &&
+                lz_decompress_reference(lz_packed, packed, lz_unpacked, lz_size, &reference) == 0 &&
+                reference == lz_size && memcmp(lz_unpacked, lz_data, lz_size) == 0 &&
+                lz_compress(lz_data, lz_size, lz_packed, packed - 1, lz_levels[l]) == 0;
+        // Truncations and a zero offset must be rejected, never overrun
+        for (size_t cut = 1; lz_ok && cut < 64; cut++) {
+            lz_ok = lz_decompress(lz_packed, packed - cut, lz_unpacked, lz_size, &decoded) == -1 &&
+                    lz_decompress(lz_packed, packed, lz_unpacked, lz_size - cut, &decoded) == -1;
+        }
+    }
+    const unsigned char lz_bad[] = { 0x14, 'a', 0, 0, 0x10, 'b' };
+    lz_ok = lz_ok && lz_decompress(lz_bad, sizeof(lz_bad), lz_unpacked, lz_size, NULL) == -1 &&
+            lz_decompress_reference(lz_bad, sizeof(lz_bad), lz_unpacked, lz_size, NULL) == -1;
+    
+    LzFrameEncoder lz_encoder;
+    LzFrameDecoder lz_decoder;
+    lz_ok = lz_frame_encoder_init(&lz_encoder, 4, 1 << 16) == 0 && lz_ok;
+    lz_ok = lz_frame_decoder_init(&lz_decoder) == 0 && lz_ok;
+    for (size_t pos = 0, piece = 1; lz_ok && pos < lz_size; pos += piece, piece = piece * 3 + 1) {
+        if (piece > lz_size - pos) piece = lz_size - pos;
+        lz_ok = lz_frame_encoder_update(&lz_encoder, lz_data + pos, piece) == 0;
+    }
+    lz_ok = lz_ok && lz_frame_encoder_finish(&lz_encoder) == 0;
+    for (size_t pos = 0; lz_ok && pos < lz_encoder.output.length; pos += 1000) {
+        size_t piece = lz_encoder.output.length - pos < 1000 ? lz_encoder.output.length - pos : 1000;
+        lz_ok = lz_frame_decoder_update(&lz_decoder, lz_encoder.output.data + pos, piece) == 0;
+    }
+    lz_ok = lz_ok && lz_frame_decoder_finish(&lz_decoder) == 0 && lz_decoder.output.length == lz_size &&
+            memcmp(lz_decoder.output.data, lz_data, lz_size) == 0 &&
+            lz_frame_decoder_update(&lz_decoder, "x", 1) == -1;
+    lz_frame_decoder_free(&lz_decoder);
+    // A flipped payload byte fails the block checksum
+    if (lz_ok) lz_encoder.output.data[20] ^= 1;
+    lz_ok = lz_ok && lz_frame_decoder_init(&lz_decoder) == 0 &&
+            lz_frame_decoder_update(&lz_decoder, lz_encoder.output.data, lz_encoder.output.length) == -1;
+    lz_frame_decoder_free(&lz_decoder);
+    lz_frame_encoder_free(&lz_encoder);
+    free(lz_data);
+    free(lz_packed);
+    free(lz_unpacked);
+    printf("✓ LZ block/frame compression (levels, malformed input, streaming): %s\n", lz_ok ? "PASS" : "FAIL");
+    
+    // String builder: growth from zero capacity, formatted appends, ownership hand-off
+    StringBuilder builder;
+    int builder_ok = string_builder_init(&builder, 0) == 0;
+    for (int i = 0; builder_ok && i < 1000; i++) {
+        builder_ok = string_builder_appendf(&builder, "%d,", i) == 0;
+    }
+    builder_ok = builder_ok && string_builder_append_char(&builder, '!') == 0;
+    size_t built_length = 0;
+    char *built = builder_ok ? string_builder_finish(&builder, &built_length) : NULL;
+    builder_ok = built && built_length == 3891 && built[built_length] == '\0' &&
+                 strncmp(built, "0,1,2,", 6) == 0 && strcmp(built + built_length - 5, "999,!") == 0;
+    free(built);
+    string_builder_free(&builder);
+    printf("✓ String builder: %s\n", builder_ok ? "PASS" : "FAIL");
+    
+    // Rope: split at every position of a multi-leaf rope and join the halves
+    // back; the source rope is shared and must be unchanged
+    char rope_text[2000];
+    for (int i = 0; i < (int)sizeof(rope_text); i++) rope_text[i] = (char)('a' + i % 23);
+    Rope *rope = rope_from_string("", 0);
+    for (size_t off = 0; rope && off < sizeof(rope_text); off += 7) {
+        size_t len = sizeof(rope_text) - off < 7 ? sizeof(rope_text) - off : 7;
+        Rope *next = rope_append(rope, rope_text + off, len);
+        rope_release(rope);
+        rope = next;
+    }
+    int rope_ok = rope && rope_length(rope) == sizeof(rope_text) && rope_height(rope) <= 6 &&
+                  rope_char_at(rope, 1234) == rope_text[1234];
+    for (size_t pos = 0; rope_ok && pos <= sizeof(rope_text); pos += 13) {
+        Rope *left = NULL, *right = NULL;
+        rope_ok = rope_split(rope, pos, &left, &right) == 0 &&
+                  rope_length(left) == pos && rope_char_at(right, 0) == rope_text[pos % sizeof(rope_text)];
+        Rope *joined = rope_ok ? rope_concat(right, left) : NULL;     // rotate by pos
+        size_t rotated_length = 0;
+        char *rotated = rope_flatten(joined, &rotated_length);
+        rope_ok = rope_ok && rotated && rotated_length == sizeof(rope_text) &&
+                  memcmp(rotated, rope_text + pos, sizeof(rope_text) - pos) == 0 &&
+                  memcmp(rotated + sizeof(rope_text) - pos, rope_text, pos) == 0;
+        free(rotated);
+        rope_release(joined);
+        rope_release(left);
+        rope_release(right);
+    }
+    char *whole = rope_flatten(rope, NULL);
+    rope_ok = rope_ok && whole && memcmp(whole, rope_text, sizeof(rope_text)) == 0;
+    free(whole);
+    rope_release(rope);
+    printf("✓ Rope append/split/concat/flatten: %s\n", rope_ok ? "PASS" : "FAIL");
+    
+    // Regex: line semantics, anchors, classes, bounded repeats, literal extraction
+    const char *regex_text = "GET /index.html 200\nPOST /login 500\n\nGET /api/v2/users 404\nerror 42";
+    size_t regex_length = string_length(regex_text);
+    struct { const char *pattern; size_t lines; const char *literal; } regex_cases[] = {
+        { "GET",                       2, "GET" },
+        { "^(GET|POST) /[a-z]+ 5\\d\\d$", 1, " 5" },
+        { "/api/v[0-9]+/users",        1, "/api/v" },
+        { "\\d{3}$",                  3, "" },
+        { "^$",                        1, "" },
+        { "[^ ]+ 42",                  1, " 42" },
+        { "x*",                        5, "" },
+    };
+    int regex_ok = 1;
+    for (size_t i = 0; i < sizeof(regex_cases) / sizeof(regex_cases[0]); i++) {
+        StringRegex *regex = string_regex_compile(regex_cases[i].pattern);
+        size_t literal_length = 0;
+        if (!regex || string_regex_count_lines(regex, regex_text, regex_length) != regex_cases[i].lines ||
+            strcmp(string_regex_literal(regex, &literal_length), regex_cases[i].literal) != 0) {
+            printf("  - /%s/ failed\n", regex_cases[i].pattern);
+            regex_ok = 0;
+        }
+        string_regex_free(regex);
+    }
+    StringRegex *regex = string_regex_compile("v[0-9]/u");
+    size_t match_end = 0;
+    regex_ok = regex_ok && regex && string_regex_search(regex, regex_text, regex_length, &match_end) == 1 &&
+               match_end == (size_t)(strstr(regex_text, "v2/u") - regex_text) + 3;
+    string_regex_free(regex);
+    regex_ok = regex_ok && !string_regex_compile("a(b") && !string_regex_compile("[z-a]") &&
+               !string_regex_compile("*a") &&
+               !string_regex_compile("a{256}") && !string_regex_compile("a{1,99999999999999999999}");
+    printf("✓ Regex (lazy DFA with literal prefilter): %s\n", regex_ok ? "PASS" : "FAIL");
+
+    // Alignment: known scores, 8-bit overflow promotion, striped and batch vs scalar
+    const AlignScoring *scoring = &align_default_scoring;
+    AlignResult aligned;
+    int align_ok = align_sequences("ACGTACGT", 8, "TTACGTACGTTT", 12, scoring, ALIGN_LOCAL, &aligned) == 0 &&
+                   aligned.score == 16 && aligned.query_end == 7 && aligned.ref_end == 9;
+    align_ok = align_ok && align_sequences("ACGT", 4, "AGT", 3, scoring, ALIGN_GLOBAL, &aligned) == 0 &&
+               aligned.score == 6 - scoring->gap_open;
+    char long_read[300];
+    for (size_t i = 0; i < sizeof(long_read); i++) long_read[i] = "ACGT"[(i * 7 + i / 5) & 3];
+    align_ok = align_ok && align_sequences(long_read, sizeof(long_read), long_read, sizeof(long_read),
+                                           scoring, ALIGN_LOCAL, &aligned) == 0 &&
+               aligned.score == 2 * (int)sizeof(long_read) && aligned.width == ALIGN_WIDTH_16;
+
+    enum { ALIGN_TEST_PAIRS = 64 };
+    char align_seqs[ALIGN_TEST_PAIRS][2][96];
+    AlignPair align_pairs[ALIGN_TEST_PAIRS];
+    AlignResult align_batched[ALIGN_TEST_PAIRS];
+    unsigned align_seed = 12345;
+    for (int p = 0; p < ALIGN_TEST_PAIRS; p++) {
+        size_t lengths[2];
+        for (int s = 0; s < 2; s++) {
+            align_seed = align_seed * 1103515245u + 12345u;
+            lengths[s] = 1 + (align_seed >> 16) % 95;
+            for (size_t i = 0; i < lengths[s]; i++) {
+                // Mostly a shared motif so alignments have structure; some N
+                align_seed = align_seed * 1103515245u + 12345u;
+                int r = (align_seed >> 16) % 16;
+                align_seqs[p][s][i] = r == 0 ? 'N' : r < 10 ? "ACGT"[(i * 3 + p) & 3] : "ACGT"[r & 3];
+            }
+        }
+        align_pairs[p] = (AlignPair){ align_seqs[p][0], lengths[0], align_seqs[p][1], lengths[1] };
+    }
+    for (int mode = ALIGN_LOCAL; mode <= ALIGN_GLOBAL && align_ok; mode++) {
+        align_ok = align_batch(align_pairs, ALIGN_TEST_PAIRS, scoring, (AlignMode)mode, 2, align_batched) == 0;
+        for (int p = 0; p < ALIGN_TEST_PAIRS && align_ok; p++) {
+            AlignResult expected, striped;
+            const AlignPair *pair = &align_pairs[p];
+            align_ok = align_scalar(pair->query, pair->query_length, pair->ref, pair->ref_length,
+                                    scoring, (AlignMode)mode, &expected) == 0 &&
+                       align_sequences(pair->query, pair->query_length, pair->ref, pair->ref_length,
+                                       scoring, (AlignMode)mode, &striped) == 0 &&
+                       striped.score == expected.score && striped.query_end == expected.query_end &&
+                       striped.ref_end == expected.ref_end && align_batched[p].score == expected.score;
+        }
+    }
+    printf("✓ Sequence alignment (striped Smith-Waterman/Needleman-Wunsch): %s\n", align_ok ? "PASS" : "FAIL");
+
     printf("String operations test completed.\n\n");
 }
 
@@ -296,6 +1124,161 @@ void test_math_operations(void) {
     printf("Mathematical operations test completed.\n\n");
 }
 
+void test_hash_operations(void) {
+    printf("Testing Hash Operations...\n");
+    printf("--------------------------\n");
+    
+    uint32_t check = crc32_ieee(0, "123456789", 9);
+    printf("✓ CRC-32 check value: 0x%08X (%s)\n", check,
+           check == 0xCBF43926u ? "PASS" : "FAIL");
+    
+    // Unaligned heads, the word loop and byte tails against the reference
+    unsigned char data[256];
+    for (int i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (unsigned char)(i * 131 + 7);
+    }
+    int crc_ok = 1;
+    for (int offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len + offset <= sizeof(data); len += 3) {
+            if (crc32_ieee(0, data + offset, len) != crc32_ieee_reference(0, data + offset, len)) {
+                crc_ok = 0;
+            }
+        }
+    }
+    uint32_t streamed = crc32_ieee(crc32_ieee(0, data, 100), data + 100, 156);
+    printf("✓ CRC-32 matches reference: %s\n", crc_ok ? "PASS" : "FAIL");
+    printf("✓ CRC-32 streaming: %s\n",
+           streamed == crc32_ieee(0, data, sizeof(data)) ? "PASS" : "FAIL");
+    
+    uint32_t check_c = crc32c(0, "123456789", 9);
+    int crc32c_ok = check_c == 0xE3069283u;
+    for (int offset = 0; offset < 8; offset++) {
+        for (size_t len = 0; len + offset <= sizeof(data); len += 5) {
+            if (crc32c(1, data + offset, len) != crc32c_reference(1, data + offset, len)) {
+                crc32c_ok = 0;
+            }
+        }
+    }
+    printf("✓ CRC-32C check value 0x%08X and reference: %s\n", check_c,
+           crc32c_ok ? "PASS" : "FAIL");
+    
+    // hash64: identical results from aligned and unaligned copies of the
+    // input on every length path, distinct results for distinct prefixes
+    static unsigned char hash_buf[1200 + 8];
+    for (int i = 0; i < (int)sizeof(hash_buf); i++) {
+        hash_buf[i] = (unsigned char)(i * 73 + (i >> 3));
+    }
+    static unsigned char shifted[1200 + 8];
+    int hash_ok = 1;
+    uint64_t previous = 0;
+    for (size_t len = 0; len <= 1200; len += (len < 300 ? 1 : 37)) {
+        memcpy(shifted + 3, hash_buf, len);
+        uint64_t h = hash64(hash_buf, len, 42);
+        if (h != hash64(shifted + 3, len, 42)) hash_ok = 0;
+        if (h == previous || h == hash64(hash_buf, len, 43)) hash_ok = 0;
+        previous = h;
+    }
+    printf("✓ hash64 alignment independence and prefix uniqueness: %s\n",
+           hash_ok ? "PASS" : "FAIL");
+    
+    // hash64 long inputs: a stripe's contribution depends on its position, so
+    // swapping two 64-byte stripes or moving a byte to another stripe changes the hash
+    static unsigned char stripe_a[2048], stripe_b[2048];
+    int stripe_ok = 1;
+    for (size_t i = 0; i < sizeof(stripe_a); i++) stripe_a[i] = (unsigned char)(i * 131 + (i >> 6));
+    const size_t stripe_lengths[] = { 320, 512, 1024, 2048 };
+    for (int l = 0; l < 4; l++) {
+        size_t len = stripe_lengths[l];
+        uint64_t h = hash64(stripe_a, len, 0);
+        for (size_t x = 0; x + 64 <= len; x += 64) {
+            for (size_t y = x + 64; y + 64 <= len; y += 64) {
+                memcpy(stripe_b, stripe_a, len);
+                memcpy(stripe_b + x, stripe_a + y, 64);
+                memcpy(stripe_b + y, stripe_a + x, 64);
+                if (hash64(stripe_b, len, 0) == h) stripe_ok = 0;
+            }
+        }
+        memset(stripe_b, 0, len);
+        stripe_b[3] = 1;
+        uint64_t single = hash64(stripe_b, len, 0);
+        for (size_t x = 67; x < len; x += 64) {
+            memset(stripe_b, 0, len);
+            stripe_b[x] = 1;
+            if (hash64(stripe_b, len, 0) == single) stripe_ok = 0;
+        }
+    }
+    printf("✓ hash64 stripe swaps and moved bytes change the hash: %s\n", stripe_ok ? "PASS" : "FAIL");
+    printf("✓ hash64_string(\"RISC-V\"): 0x%016llX\n",
+           (unsigned long long)hash64_string("RISC-V"));
+    
+    // Content-defined chunking: size limits, threaded and streamed runs against the serial one
+    CdcParams cdc;
+    int cdc_ok = cdc_params_init(&cdc, 1000, 2) == -1 && cdc_params_init(&cdc, 1024, 2) == 0 &&
+                 cdc.min_size == 256 && cdc.max_size == 8192;
+    size_t cdc_size = (1 << 22) + 333;
+    unsigned char *cdc_data = malloc(cdc_size);
+    if (cdc_data) {
+        unsigned cdc_seed = 3;
+        for (size_t i = 0; i < cdc_size; i++) {
+            cdc_seed = cdc_seed * 1103515245u + 12345u;
+            // Runs of zeros force max_size cuts; the rest is random
+            cdc_data[i] = (i / 100000) % 7 == 3 ? 0 : (unsigned char)(cdc_seed >> 16);
+        }
+        CdcChunkList serial = { NULL, 0, 0 }, threaded = { NULL, 0, 0 };
+        cdc_ok = cdc_ok && cdc_chunk_buffer(&cdc, cdc_data, cdc_size, 1, &serial) == 0 &&
+                 cdc_chunk_buffer(&cdc, cdc_data, cdc_size, 4, &threaded) == 0 && serial.count == threaded.count;
+        uint64_t covered = 0;
+        for (size_t i = 0; cdc_ok && i < serial.count; i++) {
+            const CdcChunk *chunk = &serial.chunks[i];
+            cdc_ok = chunk->offset == covered && chunk->length <= cdc.max_size &&
+                     (chunk->length > cdc.min_size || i + 1 == serial.count) &&
+                     chunk->fingerprint == hash64(cdc_data + chunk->offset, chunk->length, 0) &&
+                     chunk->offset == threaded.chunks[i].offset && chunk->length == threaded.chunks[i].length;
+            covered += chunk->length;
+        }
+        cdc_ok = cdc_ok && covered == cdc_size;
+        CdcStream stream;
+        cdc_ok = cdc_stream_init(&stream, &cdc) == 0 && cdc_ok;
+        for (size_t pos = 0, piece = 1; cdc_ok && pos < cdc_size; pos += piece, piece = piece * 3 % 10007 + 1) {
+            if (piece > cdc_size - pos) piece = cdc_size - pos;
+            cdc_ok = cdc_stream_update(&stream, cdc_data + pos, piece) == 0;
+        }
+        cdc_ok = cdc_ok && cdc_stream_finish(&stream) == 0 && stream.chunks.count == serial.count;
+        for (size_t i = 0; cdc_ok && i < serial.count; i++) {
+            cdc_ok = stream.chunks.chunks[i].offset == serial.chunks[i].offset &&
+                     stream.chunks.chunks[i].fingerprint == serial.chunks[i].fingerprint;
+        }
+        cdc_stream_free(&stream);
+        cdc_chunk_list_free(&serial);
+        cdc_chunk_list_free(&threaded);
+        free(cdc_data);
+    } else {
+        cdc_ok = 0;
+    }
+    // Duplicate bytes: a copy counts, content that differs only by 64-byte stripe order does not,
+    // even when the fingerprints are forced equal
+    static unsigned char dedup_data[3072];
+    for (size_t i = 0; i < 1024; i++) dedup_data[i] = (unsigned char)(i * 197 + (i >> 5));
+    memcpy(dedup_data + 1024, dedup_data, 1024);
+    memcpy(dedup_data + 2048, dedup_data, 1024);
+    memcpy(dedup_data + 2048, dedup_data + 64, 64);
+    memcpy(dedup_data + 2048 + 64, dedup_data, 64);
+    CdcChunk dedup_chunks[3];
+    for (int c = 0; c < 3; c++) {
+        dedup_chunks[c].offset = (uint64_t)c * 1024;
+        dedup_chunks[c].length = 1024;
+        dedup_chunks[c].fingerprint = hash64(dedup_data + c * 1024, 1024, 0);
+    }
+    CdcChunkList dedup = { dedup_chunks, 3, 3 };
+    cdc_ok = cdc_ok && dedup_chunks[2].fingerprint != dedup_chunks[0].fingerprint &&
+             cdc_duplicate_bytes(&dedup, dedup_data) == 1024;
+    dedup_chunks[2].fingerprint = dedup_chunks[0].fingerprint;
+    cdc_ok = cdc_ok && cdc_duplicate_bytes(&dedup, dedup_data) == 1024;
+    printf("✓ Content-defined chunking (FastCDC, threaded, streaming): %s\n", cdc_ok ? "PASS" : "FAIL");
+    
+    printf("Hash operations test completed.\n\n");
+}
+
 void benchmark_matrix_performance(void) {
     printf("Matrix Performance Benchmarks\n");
     printf("=============================\n");
@@ -307,6 +1290,13 @@ void benchmark_matrix_performance(void) {
         printf("\nMatrix size: %zux%zu\n", sizes[i], sizes[i]);
         compare_matrix_algorithms(sizes[i]);
     }
+    
+    printf("\n");
+    compare_streaming_kernels(2048);
+    printf("\n");
+    compare_sparse_algorithms(512, 0.02);
+    printf("\n");
+    compare_matrix_io(1024, 1024);
     printf("\n");
 }
 
@@ -330,6 +1320,20 @@ void benchmark_string_performance(void) {
         double time = benchmark_string_operations(test_texts[i], 1000);
         printf("Basic string ops: %.6f ms per iteration\n", time);
     }
+    
+    printf("\n");
+    compare_string_map_algorithms(200000, 20000);
+    printf("\n");
+    compare_string_building(1 << 18, 32);
+    printf("\n");
+    compare_regex_algorithms(1 << 20);
+    printf("\n");
+    compare_alignment_algorithms(256, 150);
+    printf("\n");
+    compare_line_counting(1 << 24);
+    compare_codec_algorithms(1 << 24);
+    compare_prefilter_algorithms(1 << 20, 1 << 24);
+    compare_lz_algorithms(1 << 24);
     printf("\n");
 }
 
@@ -343,3 +1347,15 @@ void benchmark_math_performance(void) {
     compare_math_algorithms();
     printf("\n");
 }
+
+void benchmark_hash_performance(void) {
+    printf("Hash Performance Benchmarks\n");
+    printf("===========================\n");
+    
+    compare_crc_algorithms(1 << 20);
+    printf("\n");
+    compare_hash_algorithms(1 << 20);
+    printf("\n");
+    compare_chunking_algorithms(1 << 26);
+    printf("\n");
+}
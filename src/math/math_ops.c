@@ -1,5 +1,6 @@
 #include "math_ops.h"
 #include "benchmark.h"
+#include "region_marker.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -128,6 +129,7 @@ double fibonacci_optimized(int n) {
 
 /* Check if number is prime */
 int is_prime(long long n) {
+    REGION_SCOPE(REGION_IS_PRIME);
     if (n <= 1) return 0;
     if (n <= 3) return 1;
     if (n % 2 == 0 || n % 3 == 0) return 0;
@@ -262,3 +264,54 @@ void compare_math_algorithms(void) {
     printf("exp:  %.6f vs %.6f (stdlib)\n", fast_exp(x), exp(x));
     printf("log:  %.6f vs %.6f (stdlib)\n", fast_log(x), log(x));
 }
+
+/*
+ * Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h). The
+ * small approximations are marked around their benchmark loops rather
+ * than inside, where the marker would sit in every caller's hot loop.
+ */
+static double bench_fast_sin(void *state, const BenchmarkParams *params) {
+    REGION_SCOPE(REGION_FAST_SIN);
+    (void)state;
+    double sum = 0.0;
+    for (size_t i = 0; i < params->size; i++) {
+        sum += fast_sin(i * 0.01);
+    }
+    return sum;
+}
+
+static double bench_fast_exp(void *state, const BenchmarkParams *params) {
+    REGION_SCOPE(REGION_FAST_EXP);
+    (void)state;
+    double sum = 0.0;
+    for (size_t i = 0; i < params->size; i++) {
+        sum += fast_exp(i * 0.001);
+    }
+    return sum;
+}
+
+static double bench_fast_sqrt(void *state, const BenchmarkParams *params) {
+    REGION_SCOPE(REGION_FAST_SQRT);
+    (void)state;
+    double sum = 0.0;
+    for (size_t i = 0; i < params->size; i++) {
+        sum += fast_sqrt(i + 1.0);
+    }
+    return sum;
+}
+
+static double bench_is_prime(void *state, const BenchmarkParams *params) {
+    (void)state;
+    double count = 0.0;
+    for (size_t i = 0; i < params->size; i++) {
+        count += is_prime((long long)i + 1000000);
+    }
+    return count;
+}
+
+static const BenchmarkParams math_counts[] = { {10000, 0, 0} };
+
+BENCHMARK_REGISTER(math_sin, "math/fast_sin", NULL, bench_fast_sin, NULL, math_counts)
+BENCHMARK_REGISTER(math_exp, "math/fast_exp", NULL, bench_fast_exp, NULL, math_counts)
+BENCHMARK_REGISTER(math_sqrt, "math/fast_sqrt", NULL, bench_fast_sqrt, NULL, math_counts)
+BENCHMARK_REGISTER(math_prime, "math/is_prime", NULL, bench_is_prime, NULL, math_counts)
@@ -0,0 +1,633 @@
+#define _GNU_SOURCE
+#include "matrix_ops.h"
+#include "benchmark.h"
+#include "float_text.h"
+#include "line_index.h"
+#include "parallel.h"
+#include "region_marker.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MATRIX_IO_GRAIN         64          /* lines per parallel_for chunk when parsing */
+#define MATRIX_IO_CHUNK_BYTES   (1 << 20)   /* approximate text per formatting chunk */
+
+static inline int io_is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char* io_skip_blank(const char *p, const char *end) {
+    while (p < end && io_is_blank(*p)) p++;
+    return p;
+}
+
+/* Unsigned decimal integer at p; returns the byte after it, or NULL when empty or past SIZE_MAX */
+static const char* io_parse_index(const char *p, const char *end, size_t *value) {
+    size_t v = 0;
+    const char *start = p;
+    for (; p < end && (unsigned char)(*p - '0') < 10; p++) {
+        size_t digit = (size_t)(*p - '0');
+        if (v > (SIZE_MAX - digit) / 10) return NULL;
+        v = v * 10 + digit;
+    }
+    *value = v;
+    return p > start ? p : NULL;
+}
+
+/* Next blank-separated token of [*p, end); 0 when none is left */
+static int io_token(const char **p, const char *end, const char **token, size_t *length) {
+    const char *start = io_skip_blank(*p, end);
+    const char *stop = start;
+    while (stop < end && !io_is_blank(*stop)) stop++;
+    *token = start;
+    *length = (size_t)(stop - start);
+    *p = stop;
+    return stop > start;
+}
+
+/* Case-insensitive token compare against a lowercase word */
+static int io_token_is(const char *token, size_t length, const char *word) {
+    if (strlen(word) != length) return 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = token[i] >= 'A' && token[i] <= 'Z' ? (char)(token[i] | 0x20) : token[i];
+        if (c != word[i]) return 0;
+    }
+    return 1;
+}
+
+/* Lines that hold data: trailing blank lines are dropped */
+static size_t io_data_lines(const LineIndex *index) {
+    size_t lines = line_index_lines(index);
+    while (lines > 0) {
+        const char *start;
+        size_t length;
+        if (line_index_line(index, lines - 1, &start, &length) != 0 ||
+            io_skip_blank(start, start + length) != start + length) break;
+        lines--;
+    }
+    return lines;
+}
+
+enum { IO_GENERAL, IO_SYMMETRIC, IO_SKEW_SYMMETRIC };
+
+typedef struct {
+    const LineIndex *index;
+    Matrix *matrix;
+    int symmetry;           /* Matrix Market coordinate entries */
+    int pattern;            /* entries carry no value: 1.0 */
+    int *failed;            /* per thread */
+} ParseJob;
+
+static void parse_csv_rows(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_MATRIX_CSV_PARSE);
+    const ParseJob *job = arg;
+    size_t cols = job->matrix->cols;
+    for (size_t r = begin; r < end && !job->failed[thread_id]; r++) {
+        const char *p;
+        size_t length;
+        if (line_index_line(job->index, r, &p, &length) != 0) {
+            job->failed[thread_id] = 1;
+            break;
+        }
+        const char *line_end = p + length;
+        double *row = job->matrix->data + r * cols;
+        for (size_t c = 0; p && c < cols; c++) {
+            p = float_text_parse(io_skip_blank(p, line_end), line_end, &row[c]);
+            if (!p) break;
+            p = io_skip_blank(p, line_end);
+            if (c + 1 < cols) p = p < line_end && *p == ',' ? p + 1 : NULL;
+        }
+        if (p != line_end) job->failed[thread_id] = 1;
+    }
+}
+
+static void parse_market_array(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_MATRIX_CSV_PARSE);
+    const ParseJob *job = arg;
+    Matrix *matrix = job->matrix;
+    for (size_t k = begin; k < end && !job->failed[thread_id]; k++) {
+        const char *p;
+        size_t length;
+        if (line_index_line(job->index, k, &p, &length) != 0) {
+            job->failed[thread_id] = 1;
+            break;
+        }
+        const char *line_end = p + length;
+        // Column-major: entry k is (k % rows, k / rows)
+        double *cell = &matrix->data[(k % matrix->rows) * matrix->cols + k / matrix->rows];
+        p = float_text_parse(io_skip_blank(p, line_end), line_end, cell);
+        if (!p || io_skip_blank(p, line_end) != line_end) job->failed[thread_id] = 1;
+    }
+}
+
+static void parse_market_coordinate(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_MATRIX_CSV_PARSE);
+    const ParseJob *job = arg;
+    Matrix *matrix = job->matrix;
+    for (size_t k = begin; k < end && !job->failed[thread_id]; k++) {
+        const char *p;
+        size_t length;
+        if (line_index_line(job->index, k, &p, &length) != 0) {
+            job->failed[thread_id] = 1;
+            break;
+        }
+        const char *line_end = p + length;
+        size_t i = 0, j = 0;
+        double value = 1.0;
+        p = io_parse_index(io_skip_blank(p, line_end), line_end, &i);
+        if (p) p = io_parse_index(io_skip_blank(p, line_end), line_end, &j);
+        if (p && !job->pattern) p = float_text_parse(io_skip_blank(p, line_end), line_end, &value);
+        if (!p || io_skip_blank(p, line_end) != line_end ||
+            i == 0 || j == 0 || i > matrix->rows || j > matrix->cols) {
+            job->failed[thread_id] = 1;
+            break;
+        }
+        // 1-based; symmetric files store one triangle
+        matrix->data[(i - 1) * matrix->cols + (j - 1)] = value;
+        if (job->symmetry != IO_GENERAL && i != j) {
+            matrix->data[(j - 1) * matrix->cols + (i - 1)] = job->symmetry == IO_SYMMETRIC ? value : -value;
+        }
+    }
+}
+
+/* Run func over items lines with per-thread failure flags; 0 or -1 */
+static int io_parse_parallel(ParseJob *job, size_t items, ParallelRangeFunc func, int threads) {
+    job->failed = calloc((size_t)threads, sizeof(int));
+    if (!job->failed) return -1;
+    parallel_for(items, MATRIX_IO_GRAIN, threads, func, job);
+    int status = 0;
+    for (int t = 0; t < threads; t++) {
+        if (job->failed[t]) status = -1;
+    }
+    free(job->failed);
+    job->failed = NULL;
+    return status;
+}
+
+Matrix* matrix_parse_csv(const char *text, size_t size, int threads) {
+    if (!text) return NULL;
+    threads = parallel_resolve_threads(threads);
+
+    // The newline index gives every worker random access to its rows
+    LineIndex index;
+    if (line_index_build(&index, text, size, threads) != 0) return NULL;
+    size_t rows = io_data_lines(&index);
+    Matrix *matrix = NULL;
+    const char *start;
+    size_t length;
+    if (rows > 0 && line_index_line(&index, 0, &start, &length) == 0) {
+        size_t cols = 1;
+        for (const char *p = start; (p = memchr(p, ',', (size_t)(start + length - p))) != NULL; p++) {
+            cols++;
+        }
+        matrix = matrix_create(rows, cols);
+        ParseJob job = { &index, matrix, IO_GENERAL, 0, NULL };
+        if (matrix && io_parse_parallel(&job, rows, parse_csv_rows, threads) != 0) {
+            matrix_destroy(matrix);
+            matrix = NULL;
+        }
+    }
+    line_index_free(&index);
+    return matrix;
+}
+
+Matrix* matrix_parse_market(const char *text, size_t size, int threads) {
+    if (!text) return NULL;
+    threads = parallel_resolve_threads(threads);
+    const char *end = text + size;
+
+    // Banner: %%MatrixMarket matrix <array|coordinate> <field> <symmetry>
+    const char *line = text;
+    const char *line_end = memchr(line, '\n', size);
+    if (!line_end) line_end = end;
+    const char *p = line, *token[5];
+    size_t length[5];
+    for (int t = 0; t < 5; t++) {
+        if (!io_token(&p, line_end, &token[t], &length[t])) return NULL;
+    }
+    if (!io_token_is(token[0], length[0], "%%matrixmarket") || !io_token_is(token[1], length[1], "matrix")) {
+        return NULL;
+    }
+    int coordinate = io_token_is(token[2], length[2], "coordinate");
+    if (!coordinate && !io_token_is(token[2], length[2], "array")) return NULL;
+    int pattern = io_token_is(token[3], length[3], "pattern");
+    if (!pattern && !io_token_is(token[3], length[3], "real") && !io_token_is(token[3], length[3], "double") &&
+        !io_token_is(token[3], length[3], "integer")) {
+        return NULL;
+    }
+    int symmetry = IO_GENERAL;
+    if (io_token_is(token[4], length[4], "symmetric")) {
+        symmetry = IO_SYMMETRIC;
+    } else if (io_token_is(token[4], length[4], "skew-symmetric")) {
+        symmetry = IO_SKEW_SYMMETRIC;
+    } else if (!io_token_is(token[4], length[4], "general")) {
+        return NULL;
+    }
+    if (!coordinate && (pattern || symmetry != IO_GENERAL)) return NULL;
+
+    // Comments and blank lines, then "rows cols" or "rows cols entries"
+    for (;;) {
+        line = line_end < end ? line_end + 1 : end;
+        if (line >= end) return NULL;
+        line_end = memchr(line, '\n', (size_t)(end - line));
+        if (!line_end) line_end = end;
+        p = io_skip_blank(line, line_end);
+        if (p < line_end && *p != '%') break;
+    }
+    size_t rows = 0, cols = 0, entries = 0;
+    p = io_parse_index(p, line_end, &rows);
+    if (p) p = io_parse_index(io_skip_blank(p, line_end), line_end, &cols);
+    if (p && coordinate) p = io_parse_index(io_skip_blank(p, line_end), line_end, &entries);
+    if (!p || io_skip_blank(p, line_end) != line_end || rows == 0 || cols == 0) return NULL;
+    // Untrusted header: rows * cols doubles must not wrap before matrix_create allocates them
+    if (cols > SIZE_MAX / sizeof(double) / rows) return NULL;
+    if (!coordinate) entries = rows * cols;
+
+    const char *body = line_end < end ? line_end + 1 : end;
+    LineIndex index;
+    if (line_index_build(&index, body, (size_t)(end - body), threads) != 0) return NULL;
+    Matrix *matrix = NULL;
+    if (io_data_lines(&index) == entries) {
+        matrix = matrix_create(rows, cols);
+        ParseJob job = { &index, matrix, symmetry, pattern, NULL };
+        if (matrix && io_parse_parallel(&job, entries, coordinate ? parse_market_coordinate : parse_market_array,
+                                        threads) != 0) {
+            matrix_destroy(matrix);
+            matrix = NULL;
+        }
+    }
+    line_index_free(&index);
+    return matrix;
+}
+
+typedef struct {
+    const Matrix *matrix;
+    int market;             /* column-major, one value per line */
+    size_t per_chunk;       /* rows (CSV) or columns (Matrix Market) per chunk */
+    size_t chunks;
+    char **buffers;
+    size_t *lengths;
+} FormatJob;
+
+static void format_chunks(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_MATRIX_CSV_FORMAT);
+    const FormatJob *job = arg;
+    const Matrix *matrix = job->matrix;
+    size_t outer = job->market ? matrix->cols : matrix->rows;
+    size_t inner = job->market ? matrix->rows : matrix->cols;
+    (void)thread_id;
+    for (size_t c = begin; c < end; c++) {
+        size_t first = c * job->per_chunk;
+        size_t last = first + job->per_chunk < outer ? first + job->per_chunk : outer;
+        // Every value fits FLOAT_TEXT_MAX with its separator
+        char *out = malloc((last - first) * inner * FLOAT_TEXT_MAX);
+        job->buffers[c] = out;
+        if (!out) continue;
+        char *p = out;
+        for (size_t o = first; o < last; o++) {
+            for (size_t i = 0; i < inner; i++) {
+                double value = job->market ? matrix->data[i * matrix->cols + o] : matrix->data[o * matrix->cols + i];
+                p += float_text_format(value, p);
+                *p++ = job->market || i + 1 == inner ? '\n' : ',';
+            }
+        }
+        job->lengths[c] = (size_t)(p - out);
+    }
+}
+
+static void io_format_free(FormatJob *job) {
+    for (size_t c = 0; job->buffers && c < job->chunks; c++) free(job->buffers[c]);
+    free(job->buffers);
+    free(job->lengths);
+}
+
+/* Format matrix into job->chunks buffers across threads; 0 or -1 */
+static int io_format(const Matrix *matrix, int market, int threads, FormatJob *job) {
+    memset(job, 0, sizeof(*job));
+    if (!matrix || !matrix->data) return -1;
+    job->matrix = matrix;
+    job->market = market;
+    size_t outer = market ? matrix->cols : matrix->rows;
+    size_t inner = market ? matrix->rows : matrix->cols;
+    if (outer == 0 || inner == 0) return 0;
+
+    // Roughly MATRIX_IO_CHUNK_BYTES of text per chunk at ~20 bytes per value
+    job->per_chunk = MATRIX_IO_CHUNK_BYTES / (inner * 20);
+    if (job->per_chunk == 0) job->per_chunk = 1;
+    job->chunks = (outer + job->per_chunk - 1) / job->per_chunk;
+    job->buffers = calloc(job->chunks, sizeof(char *));
+    job->lengths = calloc(job->chunks, sizeof(size_t));
+    if (!job->buffers || !job->lengths) {
+        io_format_free(job);
+        return -1;
+    }
+    parallel_for(job->chunks, 1, parallel_resolve_threads(threads), format_chunks, job);
+    for (size_t c = 0; c < job->chunks; c++) {
+        if (!job->buffers[c]) {
+            io_format_free(job);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Concatenate header and chunks into one terminated string */
+static char* io_join(const FormatJob *job, const char *header, size_t *length) {
+    size_t header_length = strlen(header);
+    size_t total = header_length;
+    for (size_t c = 0; c < job->chunks; c++) total += job->lengths[c];
+    char *text = malloc(total + 1);
+    if (!text) return NULL;
+    memcpy(text, header, header_length);
+    char *p = text + header_length;
+    for (size_t c = 0; c < job->chunks; c++) {
+        memcpy(p, job->buffers[c], job->lengths[c]);
+        p += job->lengths[c];
+    }
+    *p = '\0';
+    if (length) *length = total;
+    return text;
+}
+
+static int io_write(const FormatJob *job, const char *header, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+    int status = fputs(header, file) < 0 ? -1 : 0;
+    for (size_t c = 0; status == 0 && c < job->chunks; c++) {
+        if (fwrite(job->buffers[c], 1, job->lengths[c], file) != job->lengths[c]) status = -1;
+    }
+    if (fclose(file) != 0) status = -1;
+    if (status != 0) perror(path);
+    return status;
+}
+
+static void io_market_header(const Matrix *matrix, char *header, size_t size) {
+    snprintf(header, size, "%%%%MatrixMarket matrix array real general\n%zu %zu\n", matrix->rows, matrix->cols);
+}
+
+char* matrix_format_csv(const Matrix *matrix, int threads, size_t *length) {
+    FormatJob job;
+    if (io_format(matrix, 0, threads, &job) != 0) return NULL;
+    char *text = io_join(&job, "", length);
+    io_format_free(&job);
+    return text;
+}
+
+char* matrix_format_market(const Matrix *matrix, int threads, size_t *length) {
+    FormatJob job;
+    if (io_format(matrix, 1, threads, &job) != 0) return NULL;
+    char header[96];
+    io_market_header(matrix, header, sizeof(header));
+    char *text = io_join(&job, header, length);
+    io_format_free(&job);
+    return text;
+}
+
+int matrix_write_csv(const Matrix *matrix, const char *path, int threads) {
+    FormatJob job;
+    if (!path || io_format(matrix, 0, threads, &job) != 0) return -1;
+    int status = io_write(&job, "", path);
+    io_format_free(&job);
+    return status;
+}
+
+int matrix_write_market(const Matrix *matrix, const char *path, int threads) {
+    FormatJob job;
+    if (!path || io_format(matrix, 1, threads, &job) != 0) return -1;
+    char header[96];
+    io_market_header(matrix, header, sizeof(header));
+    int status = io_write(&job, header, path);
+    io_format_free(&job);
+    return status;
+}
+
+/* mmap path and hand it to parse */
+static Matrix* io_read(const char *path, int threads, Matrix* (*parse)(const char *, size_t, int)) {
+    if (!path) return NULL;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)st.st_size;
+    Matrix *matrix = NULL;
+    if (size > 0) {
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            perror("mmap");
+            close(fd);
+            return NULL;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        matrix = parse(mapped, size, threads);
+        munmap(mapped, size);
+    }
+    close(fd);
+
+    if (!matrix) fprintf(stderr, "%s: not a readable numeric matrix\n", path);
+    return matrix;
+}
+
+Matrix* matrix_read_csv(const char *path, int threads) {
+    return io_read(path, threads, matrix_parse_csv);
+}
+
+Matrix* matrix_read_market(const char *path, int threads) {
+    return io_read(path, threads, matrix_parse_market);
+}
+
+/* libc baselines: snprintf("%.17g") round-trips but prints every digit */
+static char* format_csv_printf(const Matrix *matrix, size_t *length) {
+    size_t count = matrix->rows * matrix->cols;
+    char *text = malloc(count * FLOAT_TEXT_MAX + 1);
+    if (!text) return NULL;
+    char *p = text;
+    for (size_t i = 0; i < count; i++) {
+        p += snprintf(p, FLOAT_TEXT_MAX, "%.17g", matrix->data[i]);
+        *p++ = (i + 1) % matrix->cols == 0 ? '\n' : ',';
+    }
+    *p = '\0';
+    *length = (size_t)(p - text);
+    return text;
+}
+
+static int parse_csv_strtod(const char *text, Matrix *matrix) {
+    const char *p = text;
+    size_t count = matrix->rows * matrix->cols;
+    for (size_t i = 0; i < count; i++) {
+        char *next;
+        matrix->data[i] = strtod(p, &next);
+        if (next == p || (*next != ',' && *next != '\n')) return -1;
+        p = next + 1;
+    }
+    return 0;
+}
+
+static int matrices_identical(const Matrix *a, const Matrix *b) {
+    return a && b && a->rows == b->rows && a->cols == b->cols &&
+           memcmp(a->data, b->data, a->rows * a->cols * sizeof(double)) == 0;
+}
+
+void compare_matrix_io(size_t rows, size_t cols) {
+    Matrix *matrix = matrix_create(rows, cols);
+    Matrix *parsed = matrix_create(rows, cols);
+    if (!matrix || !parsed) {
+        printf("Failed to allocate matrices for I/O comparison\n");
+        matrix_destroy(matrix);
+        matrix_destroy(parsed);
+        return;
+    }
+    matrix_fill_random(matrix);
+
+    int threads = parallel_resolve_threads(0);
+    double values = (double)(rows * cols) / 1e6;
+    printf("Matrix Text I/O [%zux%zu, %d threads]\n", rows, cols, threads);
+    printf("=========================================\n");
+
+    Timer timer;
+    size_t printf_length = 0, length = 0;
+    timer_start(&timer);
+    char *printf_text = format_csv_printf(matrix, &printf_length);
+    timer_stop(&timer);
+    double printf_ms = timer_elapsed_ms(&timer);
+    printf("Format, printf %%.17g:    %9.3f ms (%6.1f Mvalues/s, %zu bytes)\n",
+           printf_ms, values / (printf_ms / 1000.0), printf_length);
+
+    char *text = NULL;
+    int thread_counts[] = { 1, threads };
+    for (int t = 0; t < 2; t++) {
+        free(text);
+        timer_start(&timer);
+        text = matrix_format_csv(matrix, thread_counts[t], &length);
+        timer_stop(&timer);
+        double ms = timer_elapsed_ms(&timer);
+        printf("Format, shortest %2d thr: %9.3f ms (%6.1f Mvalues/s, %zu bytes, %.1fx)\n",
+               thread_counts[t], ms, values / (ms / 1000.0), length, printf_ms / ms);
+    }
+
+    int ok = printf_text && text;
+    double strtod_ms = 0.0;
+    if (ok) {
+        timer_start(&timer);
+        ok = parse_csv_strtod(text, parsed) == 0;
+        timer_stop(&timer);
+        strtod_ms = timer_elapsed_ms(&timer);
+        ok = ok && matrices_identical(matrix, parsed);
+        printf("Parse, strtod:           %9.3f ms (%6.1f MB/s)\n", strtod_ms, length / 1e3 / strtod_ms);
+    }
+    for (int t = 0; ok && t < 2; t++) {
+        timer_start(&timer);
+        Matrix *result = matrix_parse_csv(text, length, thread_counts[t]);
+        timer_stop(&timer);
+        double ms = timer_elapsed_ms(&timer);
+        printf("Parse, Eisel-Lemire %2d:  %9.3f ms (%6.1f MB/s, %.1fx)\n",
+               thread_counts[t], ms, length / 1e3 / ms, strtod_ms / ms);
+        ok = matrices_identical(matrix, result);
+        matrix_destroy(result);
+    }
+
+    // The Matrix Market writer and reader round-trip too
+    if (ok) {
+        size_t market_length = 0;
+        char *market = matrix_format_market(matrix, threads, &market_length);
+        Matrix *result = market ? matrix_parse_market(market, market_length, threads) : NULL;
+        ok = matrices_identical(matrix, result);
+        matrix_destroy(result);
+        free(market);
+    }
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    free(printf_text);
+    free(text);
+    matrix_destroy(matrix);
+    matrix_destroy(parsed);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    Matrix *matrix;
+    Matrix *parsed;
+    char *text;
+    size_t length;
+} MatrixIoBenchState;
+
+static void *io_bench_setup(const BenchmarkParams *params) {
+    MatrixIoBenchState *state = calloc(1, sizeof(MatrixIoBenchState));
+    if (!state) return NULL;
+    state->matrix = matrix_create(params->size, params->size);
+    state->parsed = matrix_create(params->size, params->size);
+    if (state->matrix) {
+        matrix_fill_random(state->matrix);
+        state->text = matrix_format_csv(state->matrix, 0, &state->length);
+    }
+    if (!state->parsed || !state->text) {
+        matrix_destroy(state->matrix);
+        matrix_destroy(state->parsed);
+        free(state->text);
+        free(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void io_bench_teardown(void *p) {
+    MatrixIoBenchState *state = p;
+    matrix_destroy(state->matrix);
+    matrix_destroy(state->parsed);
+    free(state->text);
+    free(state);
+}
+
+static double bench_csv_format_printf(void *p, const BenchmarkParams *params) {
+    MatrixIoBenchState *state = p;
+    size_t length = 0;
+    (void)params;
+    free(format_csv_printf(state->matrix, &length));
+    return (double)length;
+}
+
+static double bench_csv_format(void *p, const BenchmarkParams *params) {
+    MatrixIoBenchState *state = p;
+    size_t length = 0;
+    free(matrix_format_csv(state->matrix, params->threads, &length));
+    return (double)length;
+}
+
+static double bench_csv_parse_strtod(void *p, const BenchmarkParams *params) {
+    MatrixIoBenchState *state = p;
+    (void)params;
+    if (parse_csv_strtod(state->text, state->parsed) != 0) return 0.0;
+    return matrix_sum(state->parsed);
+}
+
+static double bench_csv_parse(void *p, const BenchmarkParams *params) {
+    MatrixIoBenchState *state = p;
+    Matrix *result = matrix_parse_csv(state->text, state->length, params->threads);
+    double sum = matrix_sum(result);
+    matrix_destroy(result);
+    return sum;
+}
+
+static const BenchmarkParams io_baseline_sizes[] = { {1024, 0, 0} };
+static const BenchmarkParams io_sizes[] = { {1024, 0, 1}, {1024, 0, 4} };
+
+BENCHMARK_REGISTER(matrix_csv_format_printf, "matrix/csv_format_printf", io_bench_setup, bench_csv_format_printf, io_bench_teardown, io_baseline_sizes)
+BENCHMARK_REGISTER(matrix_csv_format, "matrix/csv_format", io_bench_setup, bench_csv_format, io_bench_teardown, io_sizes)
+BENCHMARK_REGISTER(matrix_csv_parse_strtod, "matrix/csv_parse_strtod", io_bench_setup, bench_csv_parse_strtod, io_bench_teardown, io_baseline_sizes)
+BENCHMARK_REGISTER(matrix_csv_parse, "matrix/csv_parse", io_bench_setup, bench_csv_parse, io_bench_teardown, io_sizes)
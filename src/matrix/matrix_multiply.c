@@ -1,14 +1,22 @@
 #include "matrix_ops.h"
+#include "memory_hints.h"
+#include "trace.h"
+#include "region_marker.h"
 #include <stdlib.h>
 #include <string.h>
 
 /* Naive matrix multiplication - O(n^3) */
 Matrix* matrix_multiply_naive(const Matrix *a, const Matrix *b) {
+    REGION_SCOPE(REGION_GEMM_NAIVE);
     if (!a || !b || a->cols != b->rows) return NULL;
     
+    TRACE_BEGIN("gemm_naive_alloc");
     Matrix *result = matrix_create(a->rows, b->cols);
+    TRACE_END("gemm_naive_alloc");
     if (!result) return NULL;
     
+    TRACE_ZONE("gemm_naive_compute");
+    
     for (size_t i = 0; i < a->rows; i++) {
         for (size_t j = 0; j < b->cols; j++) {
             double sum = 0.0;
@@ -24,15 +32,21 @@ Matrix* matrix_multiply_naive(const Matrix *a, const Matrix *b) {
 
 /* Cache-optimized matrix multiplication with loop tiling */
 Matrix* matrix_multiply_optimized(const Matrix *a, const Matrix *b) {
+    REGION_SCOPE(REGION_GEMM_BLOCKED);
     if (!a || !b || a->cols != b->rows) return NULL;
     
+    TRACE_BEGIN("gemm_blocked_alloc");
     Matrix *result = matrix_create(a->rows, b->cols);
+    TRACE_END("gemm_blocked_alloc");
     if (!result) return NULL;
     
-    // Initialize result matrix to zero
-    memset(result->data, 0, result->rows * result->cols * sizeof(double));
+    TRACE_ZONE("gemm_blocked_compute");
+    
+    // matrix_create() hands back zeroed storage; large results come straight
+    // from fresh zero pages, so clearing again would only add write traffic
     
     const size_t BLOCK_SIZE = 64; // Cache-friendly block size
+    const size_t pf = matrix_prefetch_distance(b->rows * b->cols * sizeof(double));
     
     // Blocked matrix multiplication for better cache locality
     for (size_t i = 0; i < a->rows; i += BLOCK_SIZE) {
@@ -46,8 +60,14 @@ Matrix* matrix_multiply_optimized(const Matrix *a, const Matrix *b) {
                 
                 for (size_t ii = i; ii < i_end; ii++) {
                     for (size_t jj = j; jj < j_end; jj++) {
+                        // The first row sweep pulls the B block in; prefetch one
+                        // line per 8 columns ahead of the reduction index
+                        const int warm = pf && ii == i && ((jj - j) & 7) == 0;
                         double sum = result->data[ii * result->cols + jj];
                         for (size_t kk = k; kk < k_end; kk++) {
+                            if (warm && kk + pf < k_end) {
+                                PREFETCH_READ(&b->data[(kk + pf) * b->cols + jj]);
+                            }
                             sum += a->data[ii * a->cols + kk] * b->data[kk * b->cols + jj];
                         }
                         result->data[ii * result->cols + jj] = sum;
@@ -62,17 +82,23 @@ Matrix* matrix_multiply_optimized(const Matrix *a, const Matrix *b) {
 
 /* RISC-V specific optimized matrix multiplication */
 Matrix* matrix_multiply_riscv_optimized(const Matrix *a, const Matrix *b) {
+    REGION_SCOPE(REGION_GEMM_RISCV);
     if (!a || !b || a->cols != b->rows) return NULL;
     
+    TRACE_BEGIN("gemm_riscv_alloc");
     Matrix *result = matrix_create(a->rows, b->cols);
+    TRACE_END("gemm_riscv_alloc");
     if (!result) return NULL;
     
-    // Initialize result matrix
-    memset(result->data, 0, result->rows * result->cols * sizeof(double));
+    TRACE_ZONE("gemm_riscv_compute");
+    
+    // Result storage is already zeroed by matrix_create()
     
     const size_t BLOCK_SIZE = 32; // Optimized for RISC-V cache hierarchy
     
 #ifdef __riscv
+    const size_t pf = matrix_prefetch_distance(b->rows * b->cols * sizeof(double));
+    
     // RISC-V specific optimizations
     // Use vector extensions if available (RVV)
     #ifdef __riscv_vector
@@ -98,6 +124,14 @@ Matrix* matrix_multiply_riscv_optimized(const Matrix *a, const Matrix *b) {
                         double a_val = a_row[kk];
                         const double *b_row = &b->data[kk * b->cols];
                         
+                        // Prefetch the B row segment needed pf iterations ahead
+                        if (pf && kk + pf < a->cols) {
+                            const double *b_next = &b->data[(kk + pf) * b->cols];
+                            for (size_t jp = j; jp < j_end; jp += 8) {
+                                PREFETCH_READ(&b_next[jp]);
+                            }
+                        }
+                        
                         // Manual loop unrolling (4x)
                         size_t jj = j;
                         for (; jj + 3 < j_end; jj += 4) {
@@ -0,0 +1,549 @@
+#include "sparse_matrix.h"
+#include "parallel.h"
+#include "benchmark.h"
+#include "trace.h"
+#include "region_marker.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#define SPARSE_ROW_GRAIN 32     /* rows per work item handed to a thread */
+#define HASH_EMPTY SIZE_MAX
+
+/* Create a CSR matrix with room for nnz entries (row_ptr zeroed) */
+SparseMatrix* sparse_matrix_create(size_t rows, size_t cols, size_t nnz) {
+    SparseMatrix *matrix = malloc(sizeof(SparseMatrix));
+    if (!matrix) return NULL;
+
+    matrix->row_ptr = calloc(rows + 1, sizeof(size_t));
+    matrix->values = malloc((nnz ? nnz : 1) * sizeof(double));
+    matrix->col_indices = malloc((nnz ? nnz : 1) * sizeof(size_t));
+    if (!matrix->row_ptr || !matrix->values || !matrix->col_indices) {
+        sparse_matrix_destroy(matrix);
+        return NULL;
+    }
+
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->nnz = nnz;
+    return matrix;
+}
+
+/* Free sparse matrix memory */
+void sparse_matrix_destroy(SparseMatrix *matrix) {
+    if (matrix) {
+        free(matrix->values);
+        free(matrix->col_indices);
+        free(matrix->row_ptr);
+        free(matrix);
+    }
+}
+
+static int compare_size_t(const void *a, const void *b) {
+    size_t x = *(const size_t *)a;
+    size_t y = *(const size_t *)b;
+    return (x > y) - (x < y);
+}
+
+/* Random CSR matrix with roughly density * cols entries per row */
+SparseMatrix* sparse_matrix_random(size_t rows, size_t cols, double density) {
+    if (rows == 0 || cols == 0 || density <= 0.0) return NULL;
+    if (density > 1.0) density = 1.0;
+
+    size_t per_row = (size_t)(density * cols + 0.5);
+    if (per_row == 0) per_row = 1;
+
+    SparseMatrix *matrix = sparse_matrix_create(rows, cols, rows * per_row);
+    if (!matrix) return NULL;
+
+    // Draw per_row columns, then sort and drop duplicates in place
+    size_t nnz = 0;
+    for (size_t i = 0; i < rows; i++) {
+        size_t *row_cols = &matrix->col_indices[nnz];
+        for (size_t k = 0; k < per_row; k++) {
+            row_cols[k] = (((size_t)rand() << 16) ^ (size_t)rand()) % cols;
+        }
+        qsort(row_cols, per_row, sizeof(size_t), compare_size_t);
+
+        size_t unique = 0;
+        for (size_t k = 0; k < per_row; k++) {
+            if (unique == 0 || row_cols[unique - 1] != row_cols[k]) {
+                row_cols[unique] = row_cols[k];
+                matrix->values[nnz + unique] = (double)rand() / RAND_MAX * 100.0;
+                unique++;
+            }
+        }
+        nnz += unique;
+        matrix->row_ptr[i + 1] = nnz;
+    }
+
+    matrix->nnz = nnz;
+    return matrix;
+}
+
+/* Convert dense matrix to CSR, dropping entries with |x| <= tolerance */
+SparseMatrix* sparse_matrix_from_dense(const Matrix *dense, double tolerance) {
+    if (!dense || !dense->data) return NULL;
+
+    size_t nnz = 0;
+    for (size_t i = 0; i < dense->rows * dense->cols; i++) {
+        if (fabs(dense->data[i]) > tolerance) nnz++;
+    }
+
+    SparseMatrix *sparse = sparse_matrix_create(dense->rows, dense->cols, nnz);
+    if (!sparse) return NULL;
+
+    size_t p = 0;
+    for (size_t i = 0; i < dense->rows; i++) {
+        const double *row = &dense->data[i * dense->cols];
+        for (size_t j = 0; j < dense->cols; j++) {
+            if (fabs(row[j]) > tolerance) {
+                sparse->values[p] = row[j];
+                sparse->col_indices[p] = j;
+                p++;
+            }
+        }
+        sparse->row_ptr[i + 1] = p;
+    }
+
+    return sparse;
+}
+
+/* Expand CSR matrix into a dense Matrix */
+Matrix* sparse_matrix_to_dense(const SparseMatrix *sparse) {
+    if (!sparse) return NULL;
+
+    Matrix *dense = matrix_create(sparse->rows, sparse->cols);
+    if (!dense) return NULL;
+
+    for (size_t i = 0; i < sparse->rows; i++) {
+        for (size_t p = sparse->row_ptr[i]; p < sparse->row_ptr[i + 1]; p++) {
+            dense->data[i * dense->cols + sparse->col_indices[p]] += sparse->values[p];
+        }
+    }
+
+    return dense;
+}
+
+/* Calculate sum of all stored elements */
+double sparse_matrix_sum(const SparseMatrix *matrix) {
+    if (!matrix) return 0.0;
+
+    double sum = 0.0;
+    for (size_t p = 0; p < matrix->nnz; p++) {
+        sum += matrix->values[p];
+    }
+    return sum;
+}
+
+/* ------------------------------------------------------------------ */
+/* SpMM: C = A (CSR) x B (dense)                                        */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    const SparseMatrix *a;
+    const Matrix *b;
+    Matrix *c;
+} SpmmJob;
+
+/*
+ * Each output row is a linear combination of rows of B. Two non-zeros
+ * are folded per pass so every C row element is loaded/stored half as
+ * often; the contiguous j loop vectorizes across the dense columns.
+ */
+static void spmm_rows(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_SPMM);
+    const SpmmJob *job = arg;
+    const SparseMatrix *a = job->a;
+    const size_t n = job->b->cols;
+    (void)thread_id;
+
+    for (size_t i = begin; i < end; i++) {
+        double *restrict c_row = &job->c->data[i * n];
+        size_t p = a->row_ptr[i];
+        const size_t p_end = a->row_ptr[i + 1];
+
+        for (; p + 1 < p_end; p += 2) {
+            const double v0 = a->values[p];
+            const double v1 = a->values[p + 1];
+            const double *restrict b0 = &job->b->data[a->col_indices[p] * n];
+            const double *restrict b1 = &job->b->data[a->col_indices[p + 1] * n];
+
+            for (size_t j = 0; j < n; j++) {
+                c_row[j] += v0 * b0[j] + v1 * b1[j];
+            }
+        }
+
+        if (p < p_end) {
+            const double v = a->values[p];
+            const double *restrict b_row = &job->b->data[a->col_indices[p] * n];
+            for (size_t j = 0; j < n; j++) {
+                c_row[j] += v * b_row[j];
+            }
+        }
+    }
+}
+
+Matrix* sparse_multiply_dense(const SparseMatrix *a, const Matrix *b, int threads) {
+    if (!a || !b || a->cols != b->rows) return NULL;
+
+    Matrix *result = matrix_create(a->rows, b->cols);
+    if (!result) return NULL;
+
+    TRACE_ZONE("spmm");
+    SpmmJob job = { a, b, result };
+    parallel_for(a->rows, SPARSE_ROW_GRAIN, threads, spmm_rows, &job);
+
+    return result;
+}
+
+/* ------------------------------------------------------------------ */
+/* SpGEMM: C = A (CSR) x B (CSR)                                        */
+/* ------------------------------------------------------------------ */
+
+/* Per-thread open-addressing accumulator keyed by column index */
+typedef struct {
+    size_t *keys;
+    double *vals;
+    size_t *used;       /* slots touched by the current row */
+    size_t used_count;
+    size_t capacity;    /* power of two */
+} HashAccumulator;
+
+static size_t next_pow2(size_t x) {
+    size_t p = 16;
+    while (p < x) p <<= 1;
+    return p;
+}
+
+static int accumulator_reserve(HashAccumulator *acc, size_t distinct) {
+    size_t needed = next_pow2(distinct * 2);
+    if (needed <= acc->capacity) return 1;
+
+    free(acc->keys);
+    free(acc->vals);
+    free(acc->used);
+    acc->keys = malloc(needed * sizeof(size_t));
+    acc->vals = malloc(needed * sizeof(double));
+    acc->used = malloc(needed * sizeof(size_t));
+    if (!acc->keys || !acc->vals || !acc->used) {
+        acc->capacity = 0;
+        return 0;
+    }
+
+    for (size_t s = 0; s < needed; s++) {
+        acc->keys[s] = HASH_EMPTY;
+    }
+    acc->capacity = needed;
+    acc->used_count = 0;
+    return 1;
+}
+
+static inline size_t accumulator_slot(const HashAccumulator *acc, size_t key) {
+    size_t mask = acc->capacity - 1;
+    size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 17) & mask;
+
+    while (acc->keys[slot] != HASH_EMPTY && acc->keys[slot] != key) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static inline void accumulator_add(HashAccumulator *acc, size_t key, double value) {
+    size_t slot = accumulator_slot(acc, key);
+    if (acc->keys[slot] == HASH_EMPTY) {
+        acc->keys[slot] = key;
+        acc->vals[slot] = value;
+        acc->used[acc->used_count++] = slot;
+    } else {
+        acc->vals[slot] += value;
+    }
+}
+
+static inline void accumulator_clear(HashAccumulator *acc) {
+    for (size_t u = 0; u < acc->used_count; u++) {
+        acc->keys[acc->used[u]] = HASH_EMPTY;
+    }
+    acc->used_count = 0;
+}
+
+typedef struct {
+    const SparseMatrix *a;
+    const SparseMatrix *b;
+    SparseMatrix *c;            /* NULL during the symbolic pass */
+    size_t *row_nnz;            /* symbolic pass output */
+    HashAccumulator *accs;      /* one per thread */
+    int failed;                 /* set by any worker, atomically */
+} SpgemmJob;
+
+/* Upper bound on distinct columns in row i of A x B */
+static size_t spgemm_row_bound(const SparseMatrix *a, const SparseMatrix *b, size_t i) {
+    size_t flops = 0;
+    for (size_t p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+        size_t k = a->col_indices[p];
+        flops += b->row_ptr[k + 1] - b->row_ptr[k];
+    }
+    return (flops < b->cols) ? flops : b->cols;
+}
+
+/* Symbolic pass: count distinct output columns per row */
+static void spgemm_symbolic(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_SPGEMM_SYMBOLIC);
+    SpgemmJob *job = arg;
+    HashAccumulator *acc = &job->accs[thread_id];
+    const SparseMatrix *a = job->a;
+    const SparseMatrix *b = job->b;
+
+    for (size_t i = begin; i < end; i++) {
+        if (!accumulator_reserve(acc, spgemm_row_bound(a, b, i))) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+
+        for (size_t p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+            size_t k = a->col_indices[p];
+            for (size_t q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++) {
+                accumulator_add(acc, b->col_indices[q], 0.0);
+            }
+        }
+
+        job->row_nnz[i] = acc->used_count;
+        accumulator_clear(acc);
+    }
+}
+
+/* Numeric pass: accumulate values and emit column-sorted rows */
+static void spgemm_numeric(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_SPGEMM_NUMERIC);
+    SpgemmJob *job = arg;
+    HashAccumulator *acc = &job->accs[thread_id];
+    const SparseMatrix *a = job->a;
+    const SparseMatrix *b = job->b;
+    SparseMatrix *c = job->c;
+
+    for (size_t i = begin; i < end; i++) {
+        if (!accumulator_reserve(acc, spgemm_row_bound(a, b, i))) {
+            __atomic_store_n(&job->failed, 1, __ATOMIC_RELAXED);
+            return;
+        }
+
+        for (size_t p = a->row_ptr[i]; p < a->row_ptr[i + 1]; p++) {
+            const double a_val = a->values[p];
+            const size_t k = a->col_indices[p];
+            for (size_t q = b->row_ptr[k]; q < b->row_ptr[k + 1]; q++) {
+                accumulator_add(acc, b->col_indices[q], a_val * b->values[q]);
+            }
+        }
+
+        size_t out = c->row_ptr[i];
+        size_t count = acc->used_count;
+        for (size_t u = 0; u < count; u++) {
+            c->col_indices[out + u] = acc->keys[acc->used[u]];
+        }
+        qsort(&c->col_indices[out], count, sizeof(size_t), compare_size_t);
+        for (size_t u = 0; u < count; u++) {
+            size_t slot = accumulator_slot(acc, c->col_indices[out + u]);
+            c->values[out + u] = acc->vals[slot];
+        }
+
+        accumulator_clear(acc);
+    }
+}
+
+SparseMatrix* sparse_multiply_sparse(const SparseMatrix *a, const SparseMatrix *b, int threads) {
+    if (!a || !b || a->cols != b->rows) return NULL;
+
+    threads = parallel_resolve_threads(threads);
+
+    SpgemmJob job;
+    job.a = a;
+    job.b = b;
+    job.c = NULL;
+    job.failed = 0;
+    job.row_nnz = malloc((a->rows ? a->rows : 1) * sizeof(size_t));
+    job.accs = calloc(threads, sizeof(HashAccumulator));
+    if (!job.row_nnz || !job.accs) {
+        free(job.row_nnz);
+        free(job.accs);
+        return NULL;
+    }
+
+    TRACE_BEGIN("spgemm_symbolic");
+    parallel_for(a->rows, SPARSE_ROW_GRAIN, threads, spgemm_symbolic, &job);
+    TRACE_END("spgemm_symbolic");
+
+    SparseMatrix *result = NULL;
+    if (!__atomic_load_n(&job.failed, __ATOMIC_RELAXED)) {
+        size_t nnz = 0;
+        for (size_t i = 0; i < a->rows; i++) {
+            nnz += job.row_nnz[i];
+        }
+
+        result = sparse_matrix_create(a->rows, b->cols, nnz);
+        if (result) {
+            for (size_t i = 0; i < a->rows; i++) {
+                result->row_ptr[i + 1] = result->row_ptr[i] + job.row_nnz[i];
+            }
+
+            job.c = result;
+            TRACE_BEGIN("spgemm_numeric");
+            parallel_for(a->rows, SPARSE_ROW_GRAIN, threads, spgemm_numeric, &job);
+            TRACE_END("spgemm_numeric");
+            if (__atomic_load_n(&job.failed, __ATOMIC_RELAXED)) {
+                sparse_matrix_destroy(result);
+                result = NULL;
+            }
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        free(job.accs[t].keys);
+        free(job.accs[t].vals);
+        free(job.accs[t].used);
+    }
+    free(job.accs);
+    free(job.row_nnz);
+
+    return result;
+}
+
+/* Compare dense GEMM against SpMM and SpGEMM on the same operands */
+void compare_sparse_algorithms(size_t size, double density) {
+    printf("Sparse Algorithm Comparison [%zu x %zu, density %.3f]\n", size, size, density);
+    printf("=========================================\n");
+
+    SparseMatrix *a = sparse_matrix_random(size, size, density);
+    SparseMatrix *b = sparse_matrix_random(size, size, density);
+    Matrix *a_dense = sparse_matrix_to_dense(a);
+    Matrix *b_dense = sparse_matrix_to_dense(b);
+
+    if (!a || !b || !a_dense || !b_dense) {
+        printf("Failed to allocate matrices\n");
+        sparse_matrix_destroy(a);
+        sparse_matrix_destroy(b);
+        matrix_destroy(a_dense);
+        matrix_destroy(b_dense);
+        return;
+    }
+
+    Timer timer;
+    int threads = parallel_default_threads();
+
+    timer_start(&timer);
+    Matrix *dense_result = matrix_multiply_optimized(a_dense, b_dense);
+    timer_stop(&timer);
+    double time_dense = timer_elapsed_ms(&timer);
+
+    timer_start(&timer);
+    Matrix *spmm_single = sparse_multiply_dense(a, b_dense, 1);
+    timer_stop(&timer);
+    double time_spmm_single = timer_elapsed_ms(&timer);
+
+    timer_start(&timer);
+    Matrix *spmm_parallel = sparse_multiply_dense(a, b_dense, threads);
+    timer_stop(&timer);
+    double time_spmm_parallel = timer_elapsed_ms(&timer);
+
+    timer_start(&timer);
+    SparseMatrix *spgemm_result = sparse_multiply_sparse(a, b, threads);
+    timer_stop(&timer);
+    double time_spgemm = timer_elapsed_ms(&timer);
+
+    printf("Dense Optimized:     %.3f ms\n", time_dense);
+    printf("SpMM (1 thread):     %.3f ms (%.2fx speedup)\n",
+           time_spmm_single, time_dense / time_spmm_single);
+    printf("SpMM (%d threads):   %.3f ms (%.2fx speedup)\n",
+           threads, time_spmm_parallel, time_dense / time_spmm_parallel);
+    printf("SpGEMM (%d threads): %.3f ms (%.2fx speedup, nnz %zu)\n",
+           threads, time_spgemm, time_dense / time_spgemm,
+           spgemm_result ? spgemm_result->nnz : 0);
+
+    double sum1 = matrix_sum(dense_result);
+    double sum2 = matrix_sum(spmm_parallel);
+    double sum3 = sparse_matrix_sum(spgemm_result);
+    double tolerance = 1e-9 * fabs(sum1) + 1e-6;
+
+    printf("Result verification: %.6f %.6f %.6f %s\n",
+           sum1, sum2, sum3,
+           (fabs(sum1 - sum2) < tolerance && fabs(sum1 - sum3) < tolerance) ? "PASS" : "FAIL");
+
+    sparse_matrix_destroy(a);
+    sparse_matrix_destroy(b);
+    sparse_matrix_destroy(spgemm_result);
+    matrix_destroy(a_dense);
+    matrix_destroy(b_dense);
+    matrix_destroy(dense_result);
+    matrix_destroy(spmm_single);
+    matrix_destroy(spmm_parallel);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+#define SPARSE_BENCH_DENSITY 0.01
+
+typedef struct {
+    SparseMatrix *a;
+    SparseMatrix *b;
+    Matrix *b_dense;
+} SparseBenchState;
+
+static void sparse_bench_teardown(void *p);
+
+static void *sparse_bench_setup(const BenchmarkParams *params) {
+    SparseBenchState *state = calloc(1, sizeof(SparseBenchState));
+    if (!state) return NULL;
+
+    state->a = sparse_matrix_random(params->size, params->size, SPARSE_BENCH_DENSITY);
+    state->b = sparse_matrix_random(params->size, params->size, SPARSE_BENCH_DENSITY);
+    if (!state->a || !state->b) {
+        sparse_bench_teardown(state);
+        return NULL;
+    }
+    return state;
+}
+
+/* SpMM additionally needs B in dense form */
+static void *spmm_bench_setup(const BenchmarkParams *params) {
+    SparseBenchState *state = sparse_bench_setup(params);
+    if (!state) return NULL;
+
+    state->b_dense = sparse_matrix_to_dense(state->b);
+    if (!state->b_dense) {
+        sparse_bench_teardown(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void sparse_bench_teardown(void *p) {
+    SparseBenchState *state = p;
+    sparse_matrix_destroy(state->a);
+    sparse_matrix_destroy(state->b);
+    matrix_destroy(state->b_dense);
+    free(state);
+}
+
+static double bench_spmm(void *p, const BenchmarkParams *params) {
+    SparseBenchState *state = p;
+    Matrix *c = sparse_multiply_dense(state->a, state->b_dense, params->threads);
+    double check = c ? c->data[0] : 0.0;
+    matrix_destroy(c);
+    return check;
+}
+
+static double bench_spgemm(void *p, const BenchmarkParams *params) {
+    SparseBenchState *state = p;
+    SparseMatrix *c = sparse_multiply_sparse(state->a, state->b, params->threads);
+    double check = c ? (double)c->nnz : 0.0;
+    sparse_matrix_destroy(c);
+    return check;
+}
+
+static const BenchmarkParams spmm_params[] = { {512, 0, 1}, {512, 0, 4}, {1024, 0, 4} };
+static const BenchmarkParams spgemm_params[] = { {2048, 0, 1}, {2048, 0, 4}, {8192, 0, 4} };
+
+BENCHMARK_REGISTER(sparse_spmm, "sparse/spmm",
+                   spmm_bench_setup, bench_spmm, sparse_bench_teardown, spmm_params)
+BENCHMARK_REGISTER(sparse_spgemm, "sparse/spgemm",
+                   sparse_bench_setup, bench_spgemm, sparse_bench_teardown, spgemm_params)
@@ -0,0 +1,34 @@
+#define _GNU_SOURCE
+#include "memory_hints.h"
+#if defined(__riscv) && defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Zicboz block size as reported by the kernel. The hwprobe key is only
+ * defined since Linux 6.7; older kernels mark it unknown and callers fall
+ * back to regular stores.
+ */
+static size_t cbo_zero_probe(void) {
+#if defined(__riscv) && defined(__linux__)
+#ifndef __NR_riscv_hwprobe
+#define __NR_riscv_hwprobe 258
+#endif
+    struct { int64_t key; uint64_t value; } pair = { 12, 0 };   /* RISCV_HWPROBE_KEY_ZICBOZ_BLOCK_SIZE */
+    if (syscall(__NR_riscv_hwprobe, &pair, 1, 0, NULL, 0) == 0 && pair.key != -1) {
+        return (size_t)pair.value;
+    }
+#endif
+    return 0;
+}
+
+size_t memory_cbo_zero_block_size(void) {
+    static size_t block_size = (size_t)-1;
+    size_t size = __atomic_load_n(&block_size, __ATOMIC_RELAXED);
+    if (size == (size_t)-1) {
+        size = cbo_zero_probe();
+        __atomic_store_n(&block_size, size, __ATOMIC_RELAXED);
+    }
+    return size;
+}
@@ -0,0 +1,124 @@
+#define _GNU_SOURCE
+#include "parallel.h"
+#include "benchmark.h"
+#include "trace.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+typedef struct {
+    size_t count;
+    size_t grain;
+    size_t next;            /* next unclaimed index, advanced atomically */
+    ParallelRangeFunc func;
+    void *arg;
+} ParallelJob;
+
+typedef struct {
+    ParallelJob *job;
+    int thread_id;
+} ParallelWorker;
+
+static int affinity_cpus[BENCH_MAX_CPUS];
+static int affinity_count = 0;
+
+void parallel_set_cpu_affinity(const int *cpus, int count) {
+    if (!cpus || count <= 0) {
+        affinity_count = 0;
+        return;
+    }
+    if (count > BENCH_MAX_CPUS) count = BENCH_MAX_CPUS;
+    for (int i = 0; i < count; i++) {
+        affinity_cpus[i] = cpus[i];
+    }
+    affinity_count = count;
+}
+
+static void pin_current_thread(int thread_id) {
+    if (affinity_count == 0) return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(affinity_cpus[thread_id % affinity_count], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+int parallel_default_threads(void) {
+    const char *env = getenv("RVOPT_THREADS");
+    if (env) {
+        int n = atoi(env);
+        if (n > 0) return n;
+    }
+    return get_cpu_core_count();
+}
+
+int parallel_resolve_threads(int threads) {
+    return (threads > 0) ? threads : parallel_default_threads();
+}
+
+/* Claim chunks until the range is exhausted */
+static void *parallel_worker_main(void *p) {
+    ParallelWorker *worker = p;
+    ParallelJob *job = worker->job;
+
+    pin_current_thread(worker->thread_id);
+
+    for (;;) {
+        size_t begin = __atomic_fetch_add(&job->next, job->grain, __ATOMIC_RELAXED);
+        if (begin >= job->count) break;
+
+        size_t end = (begin + job->grain < job->count) ? begin + job->grain : job->count;
+        TRACE_BEGIN("parallel_chunk");
+        job->func(begin, end, worker->thread_id, job->arg);
+        TRACE_END("parallel_chunk");
+    }
+    return NULL;
+}
+
+void parallel_for(size_t count, size_t grain, int threads,
+                  ParallelRangeFunc func, void *arg) {
+    if (!func || count == 0) return;
+    if (grain == 0) grain = 1;
+
+    threads = parallel_resolve_threads(threads);
+    size_t chunks = (count + grain - 1) / grain;
+    if ((size_t)threads > chunks) threads = (int)chunks;
+
+    if (threads <= 1) {
+        TRACE_ZONE("parallel_inline");
+        func(0, count, 0, arg);
+        return;
+    }
+
+    ParallelJob job = { count, grain, 0, func, arg };
+    pthread_t *handles = malloc(threads * sizeof(pthread_t));
+    ParallelWorker *workers = malloc(threads * sizeof(ParallelWorker));
+    if (!handles || !workers) {
+        free(handles);
+        free(workers);
+        func(0, count, 0, arg);
+        return;
+    }
+
+    // The calling thread acts as worker 0
+    int started = 1;
+    for (int t = 0; t < threads; t++) {
+        workers[t].job = &job;
+        workers[t].thread_id = t;
+    }
+    for (int t = 1; t < threads; t++) {
+        if (pthread_create(&handles[t], NULL, parallel_worker_main, &workers[t]) != 0) {
+            break;
+        }
+        started++;
+    }
+
+    parallel_worker_main(&workers[0]);
+
+    for (int t = 1; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    free(handles);
+    free(workers);
+}
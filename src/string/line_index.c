@@ -0,0 +1,403 @@
+#define _GNU_SOURCE
+#include "line_index.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "log_stats.h"
+#include "parallel.h"
+#include "region_marker.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define LINE_BLOCK      64
+#define LINE_CHUNK_MIN  (256 * 1024)
+#define LINE_CHUNK_MAX  (8 * 1024 * 1024)
+
+/* Bit i set when p[i] == '\n', for the 64 bytes at p */
+static inline uint64_t newline_mask64(const unsigned char *p) {
+#if defined(__AVX2__)
+    const __m256i nl = _mm256_set1_epi8('\n');
+    uint32_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), nl));
+    uint32_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 32)), nl));
+    return lo | (uint64_t)hi << 32;
+#elif defined(__SSE2__)
+    const __m128i nl = _mm_set1_epi8('\n');
+    uint64_t mask = 0;
+    for (int v = 0; v < 4; v++) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(p + 16 * v));
+        mask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, nl)) << (16 * v);
+    }
+    return mask;
+#else
+    // SWAR (orc.b on Zbb): one 8-bit mask per word
+    uint64_t mask = 0;
+    for (int w = 0; w < 8; w++) {
+        mask |= (uint64_t)bit_byte_mask(bit_match_bytes(bit_load64(p + 8 * w), '\n')) << (8 * w);
+    }
+    return mask;
+#endif
+}
+
+static size_t count_range(const char *data, size_t size) {
+    REGION_SCOPE(REGION_LINE_COUNT);
+    const unsigned char *p = (const unsigned char *)data;
+    size_t count = 0;
+    size_t pos = 0;
+    for (; pos + LINE_BLOCK <= size; pos += LINE_BLOCK) {
+        count += (size_t)bit_popcount64(newline_mask64(p + pos));
+    }
+    for (; pos < size; pos++) {
+        count += p[pos] == '\n';
+    }
+    return count;
+}
+
+/* Write the offsets of every '\n' in [begin, end) to out; returns the end of out */
+static size_t* index_range(const char *data, size_t begin, size_t end, size_t *out) {
+    REGION_SCOPE(REGION_LINE_INDEX);
+    const unsigned char *p = (const unsigned char *)data;
+    size_t pos = begin;
+    for (; pos + LINE_BLOCK <= end; pos += LINE_BLOCK) {
+        // Compact the hit mask: one ctz per newline, none per byte
+        uint64_t mask = newline_mask64(p + pos);
+        while (mask) {
+            *out++ = pos + (size_t)bit_ctz64(mask);
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < end; pos++) {
+        if (p[pos] == '\n') *out++ = pos;
+    }
+    return out;
+}
+
+size_t line_count_newlines(const char *data, size_t size) {
+    if (!data) return 0;
+    return count_range(data, size);
+}
+
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t chunk;
+    size_t *counts;         /* per chunk; offsets into newlines for the index pass */
+    size_t *newlines;
+} LineJob;
+
+static void count_chunks(size_t begin, size_t end, int thread_id, void *arg) {
+    const LineJob *job = arg;
+    (void)thread_id;
+    for (size_t c = begin; c < end; c++) {
+        size_t start = c * job->chunk;
+        size_t stop = start + job->chunk < job->size ? start + job->chunk : job->size;
+        job->counts[c] = count_range(job->data + start, stop - start);
+    }
+}
+
+static void index_chunks(size_t begin, size_t end, int thread_id, void *arg) {
+    const LineJob *job = arg;
+    (void)thread_id;
+    for (size_t c = begin; c < end; c++) {
+        size_t start = c * job->chunk;
+        size_t stop = start + job->chunk < job->size ? start + job->chunk : job->size;
+        index_range(job->data, start, stop, job->newlines + job->counts[c]);
+    }
+}
+
+/* About eight chunks per worker, within cache- and scheduling-friendly bounds */
+static size_t line_chunk_size(size_t size, int threads) {
+    size_t chunk = size / ((size_t)threads * 8);
+    if (chunk < LINE_CHUNK_MIN) chunk = LINE_CHUNK_MIN;
+    if (chunk > LINE_CHUNK_MAX) chunk = LINE_CHUNK_MAX;
+    return chunk & ~(size_t)(LINE_BLOCK - 1);
+}
+
+size_t line_count_newlines_parallel(const char *data, size_t size, int threads) {
+    if (!data) return 0;
+    threads = parallel_resolve_threads(threads);
+    size_t chunk = line_chunk_size(size, threads);
+    size_t chunks = (size + chunk - 1) / chunk;
+    if (threads == 1 || chunks <= 1) return count_range(data, size);
+
+    size_t *counts = malloc(chunks * sizeof(size_t));
+    if (!counts) return count_range(data, size);
+
+    LineJob job = { data, size, chunk, counts, NULL };
+    parallel_for(chunks, 1, threads, count_chunks, &job);
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++) total += counts[c];
+    free(counts);
+    return total;
+}
+
+int line_index_build(LineIndex *index, const char *data, size_t size, int threads) {
+    if (!index || (!data && size)) return -1;
+    memset(index, 0, sizeof(*index));
+    index->data = data;
+    index->size = size;
+    if (size == 0) return 0;
+
+    threads = parallel_resolve_threads(threads);
+    size_t chunk = line_chunk_size(size, threads);
+    size_t chunks = (size + chunk - 1) / chunk;
+    size_t *counts = malloc(chunks * sizeof(size_t));
+    if (!counts) return -1;
+
+    // Pass 1 sizes each chunk's slice, pass 2 fills the slices in place
+    LineJob job = { data, size, chunk, counts, NULL };
+    parallel_for(chunks, 1, threads, count_chunks, &job);
+    size_t total = 0;
+    for (size_t c = 0; c < chunks; c++) {
+        size_t n = counts[c];
+        counts[c] = total;
+        total += n;
+    }
+
+    job.newlines = malloc((total ? total : 1) * sizeof(size_t));
+    if (!job.newlines) {
+        free(counts);
+        return -1;
+    }
+    parallel_for(chunks, 1, threads, index_chunks, &job);
+    free(counts);
+
+    index->newlines = job.newlines;
+    index->count = total;
+    return 0;
+}
+
+void line_index_free(LineIndex *index) {
+    if (!index) return;
+    free(index->newlines);
+    memset(index, 0, sizeof(*index));
+}
+
+size_t line_index_lines(const LineIndex *index) {
+    if (!index || index->size == 0) return 0;
+    int unterminated = index->data[index->size - 1] != '\n';
+    return index->count + (size_t)unterminated;
+}
+
+int line_index_line(const LineIndex *index, size_t line, const char **start, size_t *length) {
+    if (!index || line >= line_index_lines(index)) return -1;
+    size_t begin = line == 0 ? 0 : index->newlines[line - 1] + 1;
+    size_t end = line < index->count ? index->newlines[line] : index->size;
+    if (start) *start = index->data + begin;
+    if (length) *length = end - begin;
+    return 0;
+}
+
+size_t line_index_line_of(const LineIndex *index, size_t offset) {
+    if (!index) return 0;
+    // Newlines before offset: lower bound of offset in the sorted array
+    size_t lo = 0, hi = index->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->newlines[mid] < offset) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+int line_index_file(const char *path, int threads) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char *data = NULL;
+    if (size > 0) {
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            perror("mmap");
+            close(fd);
+            return -1;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = mapped;
+    }
+    close(fd);
+
+    threads = parallel_resolve_threads(threads);
+    Timer timer;
+    timer_start(&timer);
+    size_t newlines = line_count_newlines_parallel(data, size, threads);
+    timer_stop(&timer);
+    double count_seconds = timer_elapsed_ms(&timer) / 1000.0;
+
+    LineIndex index;
+    timer_start(&timer);
+    int status = line_index_build(&index, data, size, threads);
+    timer_stop(&timer);
+    double index_seconds = timer_elapsed_ms(&timer) / 1000.0;
+
+    if (status == 0) {
+        printf("Lines in %s [%zu bytes, %d threads]\n", path, size, threads);
+        printf("=========================================\n");
+        printf("Newlines: %zu (%zu lines)\n", newlines, line_index_lines(&index));
+        printf("Count: %.3f ms (%.3f GB/s)\n", count_seconds * 1000.0,
+               count_seconds > 0 ? (double)size / 1e9 / count_seconds : 0.0);
+        printf("Index: %.3f ms (%.3f GB/s, %.1f MB of offsets)\n", index_seconds * 1000.0,
+               index_seconds > 0 ? (double)size / 1e9 / index_seconds : 0.0,
+               index.count * sizeof(size_t) / 1e6);
+    } else {
+        printf("Out of memory while indexing %s\n", path);
+    }
+
+    line_index_free(&index);
+    if (data) munmap((void *)data, size);
+    return status;
+}
+
+// Keep GCC from turning the reference loop into a library call
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+#endif
+static size_t count_bytewise(const char *data, size_t size) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] == '\n') count++;
+    }
+    return count;
+}
+
+void compare_line_counting(size_t size) {
+    size_t length = 0;
+    char *text = log_stats_synthetic(size, &length);
+    if (!text) {
+        printf("Failed to allocate log text\n");
+        return;
+    }
+    const int threads = parallel_default_threads();
+    const double gb = length / 1e9;
+    printf("Line Counting and Indexing [%zu bytes, %d threads]\n", length, threads);
+    printf("=========================================\n");
+
+    // Average a few passes; the text stays cache-cold at this size anyway
+    const int reps = 4;
+    Timer timer;
+    size_t counts[3] = {0, 0, 0};
+    double times[3];
+    for (int method = 0; method < 3; method++) {
+        timer_start(&timer);
+        for (int r = 0; r < reps; r++) {
+            counts[method] = method == 0 ? count_bytewise(text, length) :
+                             method == 1 ? line_count_newlines(text, length) :
+                                           line_count_newlines_parallel(text, length, threads);
+        }
+        timer_stop(&timer);
+        times[method] = timer_elapsed_ms(&timer) / reps;
+    }
+    printf("Count, bytewise:     %9.3f ms (%6.2f GB/s)\n", times[0], times[0] > 0 ? gb / (times[0] / 1000.0) : 0.0);
+    printf("Count, vector:       %9.3f ms (%6.2f GB/s, %.1fx)\n", times[1],
+           times[1] > 0 ? gb / (times[1] / 1000.0) : 0.0, times[1] > 0 ? times[0] / times[1] : 0.0);
+    printf("Count, %2d threads:   %9.3f ms (%6.2f GB/s, %.1fx)\n", threads, times[2],
+           times[2] > 0 ? gb / (times[2] / 1000.0) : 0.0, times[2] > 0 ? times[0] / times[2] : 0.0);
+
+    LineIndex index;
+    timer_start(&timer);
+    int ok = line_index_build(&index, text, length, threads) == 0;
+    timer_stop(&timer);
+    double time_index = timer_elapsed_ms(&timer);
+    printf("Index build:         %9.3f ms (%6.2f GB/s, %zu offsets)\n", time_index,
+           time_index > 0 ? gb / (time_index / 1000.0) : 0.0, ok ? index.count : 0);
+
+    ok = ok && counts[1] == counts[0] && counts[2] == counts[0] && index.count == counts[0];
+    for (size_t i = 0; ok && i < index.count; i++) {
+        ok = text[index.newlines[i]] == '\n' && (i == 0 || index.newlines[i] > index.newlines[i - 1]);
+    }
+
+    // Random lookups: line of an offset, and the line's span contains it
+    size_t lookups = 1000;
+    unsigned seed = 1;
+    timer_start(&timer);
+    for (size_t q = 0; ok && q < lookups; q++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t offset = ((size_t)seed << 16 ^ seed) % length;
+        size_t line = line_index_line_of(&index, offset);
+        const char *start = NULL;
+        size_t line_length = 0;
+        ok = line_index_line(&index, line, &start, &line_length) == 0 &&
+             (size_t)(start - text) <= offset && offset <= (size_t)(start - text) + line_length;
+    }
+    timer_stop(&timer);
+    printf("Line lookups:        %9.3f us per offset -> line -> span\n",
+           timer_elapsed_us(&timer) / lookups);
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    line_index_free(&index);
+    free(text);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    char *text;
+    size_t length;
+} LineBenchState;
+
+static void *line_bench_setup(const BenchmarkParams *params) {
+    LineBenchState *state = malloc(sizeof(LineBenchState));
+    if (!state) return NULL;
+    state->text = log_stats_synthetic(params->size, &state->length);
+    if (!state->text) {
+        free(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void line_bench_teardown(void *p) {
+    LineBenchState *state = p;
+    free(state->text);
+    free(state);
+}
+
+static double bench_count_bytewise(void *p, const BenchmarkParams *params) {
+    LineBenchState *state = p;
+    (void)params;
+    return (double)count_bytewise(state->text, state->length);
+}
+
+static double bench_count_lines(void *p, const BenchmarkParams *params) {
+    LineBenchState *state = p;
+    return (double)line_count_newlines_parallel(state->text, state->length, params->threads);
+}
+
+static double bench_line_index(void *p, const BenchmarkParams *params) {
+    LineBenchState *state = p;
+    LineIndex index;
+    if (line_index_build(&index, state->text, state->length, params->threads) != 0) return 0.0;
+    double count = (double)index.count;
+    line_index_free(&index);
+    return count;
+}
+
+static const BenchmarkParams line_bytewise_sizes[] = { {1 << 24, 0, 0} };
+static const BenchmarkParams line_sizes[] = { {1 << 24, 0, 1}, {1 << 24, 0, 4} };
+
+BENCHMARK_REGISTER(string_count_lines_bytewise, "string/count_lines_bytewise", line_bench_setup, bench_count_bytewise, line_bench_teardown, line_bytewise_sizes)
+BENCHMARK_REGISTER(string_count_lines, "string/count_lines", line_bench_setup, bench_count_lines, line_bench_teardown, line_sizes)
+BENCHMARK_REGISTER(string_line_index, "string/line_index", line_bench_setup, bench_line_index, line_bench_teardown, line_sizes)
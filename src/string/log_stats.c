@@ -0,0 +1,365 @@
+#define _GNU_SOURCE
+#include "log_stats.h"
+#include "benchmark.h"
+#include "parallel.h"
+#include "region_marker.h"
+#include "string_ops.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * The input is cut into fixed-size chunks handed out by parallel_for.
+ * A chunk owns every line that starts inside it: it skips the partial
+ * line at its start (owned by the previous chunk) and finishes the line
+ * that crosses its end. Fields are (pointer, length) spans into the
+ * mapped file; the only copies are first occurrences of a key, made by
+ * the worker's own maps. Worker maps are merged once at the end.
+ */
+
+#define LOG_CHUNK_MIN  (64 * 1024)
+#define LOG_CHUNK_MAX  (4 * 1024 * 1024)
+
+int log_stats_init(LogStats *stats) {
+    if (!stats) return -1;
+    memset(stats, 0, sizeof(*stats));
+    stats->clients = string_map_create(1024);
+    stats->paths = string_map_create(1024);
+    stats->statuses = string_map_create(16);
+    stats->tokens = string_map_create(1024);
+    if (!stats->clients || !stats->paths || !stats->statuses || !stats->tokens) {
+        log_stats_free(stats);
+        return -1;
+    }
+    return 0;
+}
+
+void log_stats_free(LogStats *stats) {
+    if (!stats) return;
+    string_map_destroy(stats->clients);
+    string_map_destroy(stats->paths);
+    string_map_destroy(stats->statuses);
+    string_map_destroy(stats->tokens);
+    memset(stats, 0, sizeof(*stats));
+}
+
+static inline const char* span_find(const char *p, const char *end, char c) {
+    return p < end ? string_memchr(p, c, (size_t)(end - p)) : NULL;
+}
+
+static inline void count_key(StringMap *map, const char *key, size_t length) {
+    uint64_t *count = string_map_upsert(map, key, length);
+    if (count) (*count)++;
+}
+
+/* client ident user [time] "METHOD target PROTOCOL" status bytes ... */
+static int count_access_line(LogStats *stats, const char *p, const char *end) {
+    const char *client_end = span_find(p, end, ' ');
+    if (!client_end || client_end == p) return 0;
+
+    const char *request = span_find(client_end, end, '"');
+    if (!request) return 0;
+    const char *method_end = span_find(request + 1, end, ' ');
+    if (!method_end) return 0;
+    const char *target = method_end + 1;
+    const char *target_end = span_find(target, end, ' ');
+    const char *request_end = span_find(target, end, '"');
+    if (!request_end) return 0;
+    if (!target_end || target_end > request_end) target_end = request_end;   // HTTP/0.9: no protocol
+
+    const char *status = request_end + 2;
+    if (status + 3 > end || request_end[1] != ' ' ||
+        (unsigned)(status[0] - '1') > 4 || (unsigned)(status[1] - '0') > 9 ||
+        (unsigned)(status[2] - '0') > 9) {
+        return 0;
+    }
+
+    count_key(stats->clients, p, (size_t)(client_end - p));
+    count_key(stats->paths, target, (size_t)(target_end - target));
+    count_key(stats->statuses, status, 3);
+    return 1;
+}
+
+static void count_tokens(LogStats *stats, const char *p, const char *end) {
+    while (p < end) {
+        const char *space = span_find(p, end, ' ');
+        const char *stop = space ? space : end;
+        if (stop > p) count_key(stats->tokens, p, (size_t)(stop - p));
+        p = stop + 1;
+    }
+}
+
+typedef struct {
+    const char *data;
+    size_t size;
+    size_t chunk;
+    LogStats *workers;
+} LogJob;
+
+static void log_chunks(size_t begin, size_t end, int thread_id, void *arg) {
+    REGION_SCOPE(REGION_LOG_STATS);
+    const LogJob *job = arg;
+    LogStats *stats = &job->workers[thread_id];
+    const char *limit = job->data + job->size;
+
+    for (size_t c = begin; c < end; c++) {
+        const char *p = job->data + c * job->chunk;
+        const char *chunk_end = c * job->chunk + job->chunk < job->size ? p + job->chunk : limit;
+
+        if (c > 0 && p[-1] != '\n') {
+            const char *nl = span_find(p, limit, '\n');
+            p = nl ? nl + 1 : limit;
+        }
+
+        while (p < chunk_end) {
+            const char *nl = span_find(p, limit, '\n');
+            const char *eol = nl ? nl : limit;
+            const char *line_end = (eol > p && eol[-1] == '\r') ? eol - 1 : eol;
+
+            if (!count_access_line(stats, p, line_end)) count_tokens(stats, p, line_end);
+            stats->lines++;
+            p = nl ? nl + 1 : limit;
+        }
+    }
+}
+
+typedef struct {
+    StringMap *target;
+    int failed;
+} MergeContext;
+
+static void merge_entry(const StringMapEntry *entry, void *arg) {
+    MergeContext *ctx = arg;
+    uint64_t *count = string_map_upsert(ctx->target, entry->key, entry->length);
+    if (count) {
+        *count += entry->value;
+    } else {
+        ctx->failed = 1;
+    }
+}
+
+static int merge_map(StringMap *target, const StringMap *source) {
+    MergeContext ctx = { target, 0 };
+    string_map_foreach(source, merge_entry, &ctx);
+    return ctx.failed ? -1 : 0;
+}
+
+int log_stats_process(const char *data, size_t size, int threads, LogStats *stats) {
+    if (!stats || (!data && size)) return -1;
+    if (size == 0) return 0;
+
+    threads = parallel_resolve_threads(threads);
+    LogStats *workers = calloc((size_t)threads, sizeof(LogStats));
+    if (!workers) return -1;
+
+    int status = 0;
+    for (int t = 0; t < threads; t++) {
+        if (log_stats_init(&workers[t]) != 0) status = -1;
+    }
+
+    // About eight chunks per worker for balance, within cache-friendly bounds
+    size_t chunk = size / ((size_t)threads * 8);
+    if (chunk < LOG_CHUNK_MIN) chunk = LOG_CHUNK_MIN;
+    if (chunk > LOG_CHUNK_MAX) chunk = LOG_CHUNK_MAX;
+
+    if (status == 0) {
+        LogJob job = { data, size, chunk, workers };
+        parallel_for((size + chunk - 1) / chunk, 1, threads, log_chunks, &job);
+
+        for (int t = 0; t < threads && status == 0; t++) {
+            if (merge_map(stats->clients, workers[t].clients) != 0 ||
+                merge_map(stats->paths, workers[t].paths) != 0 ||
+                merge_map(stats->statuses, workers[t].statuses) != 0 ||
+                merge_map(stats->tokens, workers[t].tokens) != 0) {
+                status = -1;
+            }
+            stats->lines += workers[t].lines;
+        }
+        stats->bytes += size;
+    }
+
+    for (int t = 0; t < threads; t++) {
+        log_stats_free(&workers[t]);
+    }
+    free(workers);
+    return status;
+}
+
+typedef struct {
+    const StringMapEntry **entries;
+    size_t count;
+} EntryList;
+
+static void collect_entry(const StringMapEntry *entry, void *arg) {
+    EntryList *list = arg;
+    list->entries[list->count++] = entry;
+}
+
+static int compare_by_count(const void *a, const void *b) {
+    const StringMapEntry *x = *(const StringMapEntry * const *)a;
+    const StringMapEntry *y = *(const StringMapEntry * const *)b;
+    if (x->value != y->value) return x->value < y->value ? 1 : -1;
+    return strcmp(x->key, y->key);
+}
+
+static void print_top(const char *title, const StringMap *map, size_t top) {
+    if (map->size == 0) return;
+
+    EntryList list = { malloc(map->size * sizeof(StringMapEntry *)), 0 };
+    if (!list.entries) return;
+    string_map_foreach(map, collect_entry, &list);
+    qsort(list.entries, list.count, sizeof(StringMapEntry *), compare_by_count);
+
+    printf("Top %s (%zu distinct):\n", title, map->size);
+    for (size_t i = 0; i < list.count && i < top; i++) {
+        printf("  %12llu  %.*s\n", (unsigned long long)list.entries[i]->value,
+               (int)(list.entries[i]->length > 96 ? 96 : list.entries[i]->length),
+               list.entries[i]->key);
+    }
+    free(list.entries);
+}
+
+void log_stats_print(const LogStats *stats, size_t top) {
+    if (!stats) return;
+    print_top("clients", stats->clients, top);
+    print_top("request paths", stats->paths, top);
+    print_top("status codes", stats->statuses, top);
+    print_top("tokens", stats->tokens, top);
+}
+
+int log_stats_file(const char *path, int threads) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    const char *data = NULL;
+    if (size > 0) {
+        void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            perror("mmap");
+            close(fd);
+            return -1;
+        }
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = mapped;
+    }
+    close(fd);
+
+    LogStats stats;
+    if (log_stats_init(&stats) != 0) {
+        if (data) munmap((void *)data, size);
+        return -1;
+    }
+
+    threads = parallel_resolve_threads(threads);
+    Timer timer;
+    timer_start(&timer);
+    int status = log_stats_process(data, size, threads, &stats);
+    timer_stop(&timer);
+    double seconds = timer_elapsed_ms(&timer) / 1000.0;
+
+    if (status == 0) {
+        printf("Log statistics for %s [%zu bytes, %d threads]\n", path, size, threads);
+        printf("=========================================\n");
+        log_stats_print(&stats, 10);
+        printf("Lines: %zu\n", stats.lines);
+        printf("Time: %.3f ms (%.3f GB/s, %.2f Mlines/s)\n", seconds * 1000.0,
+               seconds > 0 ? (double)size / 1e9 / seconds : 0.0,
+               seconds > 0 ? (double)stats.lines / 1e6 / seconds : 0.0);
+    } else {
+        printf("Out of memory while processing %s\n", path);
+    }
+
+    log_stats_free(&stats);
+    if (data) munmap((void *)data, size);
+    return status;
+}
+
+char* log_stats_synthetic(size_t bytes, size_t *length) {
+    static const char *methods[] = {"GET", "GET", "GET", "POST", "HEAD"};
+    static const char *statuses[] = {"200", "200", "200", "200", "304", "404", "500", "301"};
+    static const char *sections[] = {"api/v1/users", "static/css", "static/js", "images", "blog", "api/v2/search"};
+
+    char *text = malloc(bytes + 512);
+    if (!text) return NULL;
+
+    size_t pos = 0;
+    size_t line = 0;
+    while (pos < bytes) {
+        // Skewed picks (u^2) so a few clients and paths dominate, as in real logs
+        double u = (double)rand() / RAND_MAX;
+        unsigned client = (unsigned)(u * u * 4096);
+        u = (double)rand() / RAND_MAX;
+        unsigned page = (unsigned)(u * u * 2048);
+
+        int n;
+        if (++line % 64 == 0) {
+            n = snprintf(text + pos, 512, "[error] upstream timed out while reading response header from client %u\n",
+                         client);
+        } else {
+            n = snprintf(text + pos, 512,
+                         "10.%u.%u.%u - - [18/Oct/2026:%02u:%02u:%02u +0000] \"%s /%s/%u HTTP/1.1\" %s %u \"-\" "
+                         "\"Mozilla/5.0 (X11; Linux riscv64)\"\n",
+                         client >> 8, client & 0xff, (unsigned)rand() % 4,
+                         (unsigned)(line / 3600) % 24, (unsigned)(line / 60) % 60, (unsigned)line % 60,
+                         methods[rand() % 5], sections[page % 6], page,
+                         statuses[rand() % 8], 200 + (unsigned)rand() % 50000);
+        }
+        pos += (size_t)n;
+    }
+
+    *length = pos;
+    return text;
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    char *text;
+    size_t length;
+} LogBenchState;
+
+static void *log_bench_setup(const BenchmarkParams *params) {
+    LogBenchState *state = malloc(sizeof(LogBenchState));
+    if (!state) return NULL;
+    state->text = log_stats_synthetic(params->size, &state->length);
+    if (!state->text) {
+        free(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void log_bench_teardown(void *p) {
+    LogBenchState *state = p;
+    free(state->text);
+    free(state);
+}
+
+static double bench_log_stats(void *p, const BenchmarkParams *params) {
+    LogBenchState *state = p;
+    LogStats stats;
+    if (log_stats_init(&stats) != 0) return 0.0;
+    log_stats_process(state->text, state->length, params->threads, &stats);
+    double lines = (double)stats.lines;
+    log_stats_free(&stats);
+    return lines;
+}
+
+static const BenchmarkParams log_params[] = { {1 << 24, 0, 1}, {1 << 24, 0, 4} };
+
+BENCHMARK_REGISTER(string_log_stats, "string/logstats",
+                   log_bench_setup, bench_log_stats, log_bench_teardown, log_params)
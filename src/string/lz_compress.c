@@ -0,0 +1,793 @@
+#define _GNU_SOURCE
+#include "lz_compress.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "hash_ops.h"
+#include "region_marker.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LZ_MIN_MATCH        4
+#define LZ_LAST_LITERALS    5       /* the block always ends in this many literals */
+#define LZ_MATCH_LIMIT      12      /* no match starts in the last 12 bytes */
+#define LZ_MAX_OFFSET       65535
+#define LZ_MAX_INPUT        0x7E000000u
+#define LZ_HASH_LOG         16
+#define LZ_HASH_SIZE        (1u << LZ_HASH_LOG)
+#define LZ_CHAIN_SIZE       65536u  /* covers the whole offset window */
+#define LZ_SKIP_TRIGGER     6       /* level 0: step grows by one every 64 misses */
+#define LZ_RUN_MASK         15
+#define LZ_COPY_SLACK       16      /* bytes a wide copy may write past the sequence */
+
+#define LZ_FRAME_HEADER     6
+#define LZ_BLOCK_HEADER     4
+#define LZ_BLOCK_RAW        0x80000000u
+#define LZ_FLAG_CHECKSUMS   1
+#define LZ_MIN_BLOCK_LOG    16
+#define LZ_MAX_BLOCK_LOG    22
+
+/*
+ * Match finder tables. Positions are stored as base + offset in the
+ * current block, so advancing base invalidates every older entry without
+ * clearing the 256 KiB hash table between frame blocks.
+ */
+typedef struct {
+    uint32_t table[LZ_HASH_SIZE];
+    uint32_t chain[LZ_CHAIN_SIZE];  /* previous position with the same hash */
+    uint32_t base;
+} LzMatchState;
+
+static inline uint32_t lz_read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t lz_hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - LZ_HASH_LOG);
+}
+
+/* Length of the common prefix of p and match, reading p no further than limit */
+static inline size_t lz_count(const unsigned char *p, const unsigned char *match, const unsigned char *limit) {
+    const unsigned char *start = p;
+    while (p + 8 <= limit) {
+        uint64_t diff = bit_load64(p) ^ bit_load64(match);
+        if (diff) return (size_t)(p - start) + (size_t)(bit_ctz64(diff) >> 3);
+        p += 8;
+        match += 8;
+    }
+    while (p < limit && *p == *match) {
+        p++;
+        match++;
+    }
+    return (size_t)(p - start);
+}
+
+static LzMatchState* lz_state_create(void) {
+    LzMatchState *state = malloc(sizeof(LzMatchState));
+    if (!state) return NULL;
+    memset(state->table, 0, sizeof(state->table));
+    state->base = 1;
+    return state;
+}
+
+/* Make room for a block of size bytes after the previous one */
+static void lz_state_next_block(LzMatchState *state, size_t size) {
+    if (state->base > UINT32_MAX - LZ_CHAIN_SIZE - size) {
+        memset(state->table, 0, sizeof(state->table));
+        state->base = 1;
+    }
+}
+
+static inline unsigned char* lz_write_length(unsigned char *op, size_t length) {
+    for (; length >= 255; length -= 255) *op++ = 255;
+    *op++ = (unsigned char)length;
+    return op;
+}
+
+/* Token, literals, offset and match length; NULL when it does not fit before oend */
+static inline unsigned char* lz_emit(unsigned char *op, unsigned char *oend, const unsigned char *literals,
+                                     size_t literal_length, size_t offset, size_t match_length) {
+    size_t code = match_length - LZ_MIN_MATCH;
+    size_t needed = 1 + literal_length / 255 + 1 + literal_length + 2 + code / 255 + 1;
+    if (needed > (size_t)(oend - op)) return NULL;
+    unsigned char *token = op++;
+    if (literal_length >= LZ_RUN_MASK) {
+        *token = LZ_RUN_MASK << 4;
+        op = lz_write_length(op, literal_length - LZ_RUN_MASK);
+    } else {
+        *token = (unsigned char)(literal_length << 4);
+    }
+    memcpy(op, literals, literal_length);
+    op += literal_length;
+    *op++ = (unsigned char)offset;
+    *op++ = (unsigned char)(offset >> 8);
+    if (code >= LZ_RUN_MASK) {
+        *token |= LZ_RUN_MASK;
+        op = lz_write_length(op, code - LZ_RUN_MASK);
+    } else {
+        *token |= (unsigned char)code;
+    }
+    return op;
+}
+
+static size_t lz_compress_block(LzMatchState *state, const unsigned char *src, size_t size,
+                                unsigned char *dst, size_t capacity, int level) {
+    REGION_SCOPE(REGION_LZ_COMPRESS);
+    lz_state_next_block(state, size);
+    const uint32_t base = state->base;
+    // Advance before anything can fail so no entry from this block is ever taken as the next one's
+    state->base = base + (uint32_t)size + LZ_CHAIN_SIZE;
+    const unsigned char *ip = src;
+    const unsigned char *anchor = src;
+    const unsigned char *const iend = src + size;
+    const unsigned char *const match_end = iend - (size >= LZ_LAST_LITERALS ? LZ_LAST_LITERALS : size);
+    unsigned char *op = dst;
+    unsigned char *const oend = dst + capacity;
+    const unsigned depth = level > 0 ? 1u << (level > LZ_MAX_LEVEL ? LZ_MAX_LEVEL : level) : 0;
+    size_t next_insert = 0;
+
+    if (size > LZ_MATCH_LIMIT) {
+        const unsigned char *const match_start_limit = iend - LZ_MATCH_LIMIT;
+        unsigned misses = 0;
+        state->table[lz_hash(lz_read32(ip))] = base;
+        next_insert = 1;
+        ip++;
+
+        while (ip <= match_start_limit) {
+            size_t pos = (size_t)(ip - src);
+            uint32_t sequence = lz_read32(ip);
+            const unsigned char *match = NULL;
+            size_t length = 0;
+
+            if (depth == 0) {
+                // One probe; replace the slot with the current position either way
+                uint32_t *slot = &state->table[lz_hash(sequence)];
+                uint32_t candidate = *slot;
+                *slot = base + (uint32_t)pos;
+                if (candidate >= base && base + pos - candidate <= LZ_MAX_OFFSET &&
+                    lz_read32(src + (candidate - base)) == sequence) {
+                    match = src + (candidate - base);
+                    length = LZ_MIN_MATCH + lz_count(ip + LZ_MIN_MATCH, match + LZ_MIN_MATCH, match_end);
+                }
+            } else {
+                // Insert every position up to here, then walk the chain for the longest match
+                for (; next_insert <= pos; next_insert++) {
+                    uint32_t *slot = &state->table[lz_hash(lz_read32(src + next_insert))];
+                    state->chain[(base + next_insert) & (LZ_CHAIN_SIZE - 1)] = *slot;
+                    *slot = base + (uint32_t)next_insert;
+                }
+                uint32_t current = base + (uint32_t)pos;
+                uint32_t candidate = state->chain[current & (LZ_CHAIN_SIZE - 1)];
+                for (unsigned probe = 0; probe < depth; probe++) {
+                    if (candidate < base || candidate >= current || current - candidate > LZ_MAX_OFFSET) break;
+                    const unsigned char *ref = src + (candidate - base);
+                    // A longer match must agree at the byte that would extend the best one
+                    if (ref[length] == ip[length] && lz_read32(ref) == sequence) {
+                        size_t candidate_length = LZ_MIN_MATCH + lz_count(ip + LZ_MIN_MATCH, ref + LZ_MIN_MATCH,
+                                                                          match_end);
+                        if (candidate_length > length) {
+                            length = candidate_length;
+                            match = ref;
+                            if (ip + length >= match_end) break;
+                        }
+                    }
+                    uint32_t previous = state->chain[candidate & (LZ_CHAIN_SIZE - 1)];
+                    if (previous >= candidate) break;
+                    candidate = previous;
+                }
+            }
+
+            if (!match) {
+                ip += depth == 0 ? 1 + (misses++ >> LZ_SKIP_TRIGGER) : 1;
+                continue;
+            }
+            misses = 0;
+
+            // Pull the match start back over equal literals
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+                length++;
+            }
+
+            op = lz_emit(op, oend, anchor, (size_t)(ip - anchor), (size_t)(ip - match), length);
+            if (!op) return 0;
+            ip += length;
+            anchor = ip;
+            if (depth == 0 && ip <= match_start_limit) {
+                state->table[lz_hash(lz_read32(ip - 2))] = base + (uint32_t)(ip - 2 - src);
+            }
+        }
+    }
+
+    // Trailing literals
+    size_t literal_length = (size_t)(iend - anchor);
+    if (1 + literal_length / 255 + 1 + literal_length > (size_t)(oend - op)) return 0;
+    if (literal_length >= LZ_RUN_MASK) {
+        *op++ = LZ_RUN_MASK << 4;
+        op = lz_write_length(op, literal_length - LZ_RUN_MASK);
+    } else {
+        *op++ = (unsigned char)(literal_length << 4);
+    }
+    memcpy(op, anchor, literal_length);
+    op += literal_length;
+    return (size_t)(op - dst);
+}
+
+size_t lz_compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t lz_compress(const void *src, size_t size, void *dst, size_t capacity, int level) {
+    if ((!src && size) || !dst || size > LZ_MAX_INPUT) return 0;
+    LzMatchState *state = lz_state_create();
+    if (!state) return 0;
+    size_t written = lz_compress_block(state, src, size, dst, capacity, level);
+    free(state);
+    return written;
+}
+
+/* Extension bytes of a length field; SIZE_MAX when the input ends inside it */
+static inline size_t lz_read_length(const unsigned char **ip, const unsigned char *iend) {
+    size_t length = 0;
+    unsigned char byte;
+    do {
+        if (*ip >= iend) return SIZE_MAX;
+        byte = *(*ip)++;
+        length += byte;
+    } while (byte == 255);
+    return length;
+}
+
+int lz_decompress(const void *src, size_t size, void *dst, size_t capacity, size_t *decoded) {
+    REGION_SCOPE(REGION_LZ_DECOMPRESS);
+    if (!src || !dst) return -1;
+    const unsigned char *ip = src;
+    const unsigned char *const iend = ip + size;
+    unsigned char *const ostart = dst;
+    unsigned char *op = ostart;
+    unsigned char *const oend = op + capacity;
+
+    for (;;) {
+        if (ip >= iend) return -1;
+        unsigned token = *ip++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == LZ_RUN_MASK) {
+            size_t extra = lz_read_length(&ip, iend);
+            if (extra == SIZE_MAX) return -1;
+            literal_length += extra;
+        }
+        if (literal_length > (size_t)(iend - ip) || literal_length > (size_t)(oend - op)) return -1;
+        // Short literal runs: one 16-byte copy when both buffers have the slack
+        if (literal_length <= LZ_COPY_SLACK && (size_t)(iend - ip) >= LZ_COPY_SLACK &&
+            (size_t)(oend - op) >= LZ_COPY_SLACK) {
+            memcpy(op, ip, LZ_COPY_SLACK);
+        } else {
+            memcpy(op, ip, literal_length);
+        }
+        ip += literal_length;
+        op += literal_length;
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return -1;
+        size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - ostart)) return -1;
+
+        size_t match_length = token & LZ_RUN_MASK;
+        if (match_length == LZ_RUN_MASK) {
+            size_t extra = lz_read_length(&ip, iend);
+            if (extra == SIZE_MAX) return -1;
+            match_length += extra;
+        }
+        match_length += LZ_MIN_MATCH;
+        if (match_length > (size_t)(oend - op)) return -1;
+
+        const unsigned char *match = op - offset;
+        if ((size_t)(oend - op) - match_length >= LZ_COPY_SLACK) {
+            if (offset >= 8) {
+                // Each 8-byte step reads only bytes already written
+                for (size_t i = 0; i < match_length; i += 8) memcpy(op + i, match + i, 8);
+            } else {
+                // Short period: lay down 8 bytes, then copy from a multiple of offset >= 8 back
+                for (int i = 0; i < 8; i++) op[i] = match[i];
+                size_t distance = offset * ((8 + offset - 1) / offset);
+                for (size_t i = 8; i < match_length; i += 8) memcpy(op + i, op + i - distance, 8);
+            }
+        } else {
+            for (size_t i = 0; i < match_length; i++) op[i] = match[i];
+        }
+        op += match_length;
+    }
+
+    if (decoded) *decoded = (size_t)(op - ostart);
+    return 0;
+}
+
+int lz_decompress_reference(const void *src, size_t size, void *dst, size_t capacity, size_t *decoded) {
+    if (!src || !dst) return -1;
+    const unsigned char *ip = src;
+    const unsigned char *const iend = ip + size;
+    unsigned char *const ostart = dst;
+    unsigned char *op = ostart;
+    unsigned char *const oend = op + capacity;
+
+    for (;;) {
+        if (ip >= iend) return -1;
+        unsigned token = *ip++;
+        size_t literal_length = token >> 4;
+        if (literal_length == LZ_RUN_MASK) {
+            size_t extra = lz_read_length(&ip, iend);
+            if (extra == SIZE_MAX) return -1;
+            literal_length += extra;
+        }
+        if (literal_length > (size_t)(iend - ip) || literal_length > (size_t)(oend - op)) return -1;
+        for (size_t i = 0; i < literal_length; i++) *op++ = *ip++;
+        if (ip == iend) break;
+
+        if (iend - ip < 2) return -1;
+        size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - ostart)) return -1;
+        size_t match_length = token & LZ_RUN_MASK;
+        if (match_length == LZ_RUN_MASK) {
+            size_t extra = lz_read_length(&ip, iend);
+            if (extra == SIZE_MAX) return -1;
+            match_length += extra;
+        }
+        match_length += LZ_MIN_MATCH;
+        if (match_length > (size_t)(oend - op)) return -1;
+        for (size_t i = 0; i < match_length; i++, op++) *op = *(op - offset);
+    }
+
+    if (decoded) *decoded = (size_t)(op - ostart);
+    return 0;
+}
+
+static inline void lz_store32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static inline uint32_t lz_load32_le(const unsigned char *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+int lz_frame_encoder_init(LzFrameEncoder *encoder, int level, size_t block_size) {
+    if (!encoder) return -1;
+    memset(encoder, 0, sizeof(*encoder));
+    int block_log = 0;
+    while (block_log < 63 && ((size_t)1 << block_log) < block_size) block_log++;
+    if (((size_t)1 << block_log) != block_size || block_log < LZ_MIN_BLOCK_LOG || block_log > LZ_MAX_BLOCK_LOG ||
+        level < 0 || level > LZ_MAX_LEVEL) {
+        return -1;
+    }
+    encoder->level = level;
+    encoder->block_size = block_size;
+    encoder->block = malloc(block_size);
+    encoder->scratch = malloc(block_size);
+    encoder->state = lz_state_create();
+    if (!encoder->block || !encoder->scratch || !encoder->state ||
+        string_builder_init(&encoder->output, block_size + LZ_FRAME_HEADER) != 0) {
+        lz_frame_encoder_free(encoder);
+        return -1;
+    }
+    char header[LZ_FRAME_HEADER] = { 'R', 'V', 'L', 'Z', (char)block_log, LZ_FLAG_CHECKSUMS };
+    return string_builder_append(&encoder->output, header, sizeof(header));
+}
+
+/* Compress one block into the output, storing it raw when that is not smaller */
+static int lz_frame_write_block(LzFrameEncoder *encoder, const unsigned char *data, size_t size) {
+    size_t compressed = lz_compress_block(encoder->state, data, size, encoder->scratch, size - 1, encoder->level);
+    unsigned char header[LZ_BLOCK_HEADER], checksum[4];
+    const unsigned char *payload = compressed ? encoder->scratch : data;
+    size_t payload_size = compressed ? compressed : size;
+    lz_store32(header, (uint32_t)payload_size | (compressed ? 0 : LZ_BLOCK_RAW));
+    lz_store32(checksum, crc32c(0, data, size));
+    if (string_builder_append(&encoder->output, (const char *)header, sizeof(header)) != 0 ||
+        string_builder_append(&encoder->output, (const char *)payload, payload_size) != 0 ||
+        string_builder_append(&encoder->output, (const char *)checksum, sizeof(checksum)) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int lz_frame_encoder_update(LzFrameEncoder *encoder, const void *data, size_t size) {
+    if (!encoder || !encoder->block || (!data && size)) return -1;
+    const unsigned char *p = data;
+    while (size > 0) {
+        // Whole blocks straight from the caller's buffer when nothing is pending
+        if (encoder->block_fill == 0 && size >= encoder->block_size) {
+            if (lz_frame_write_block(encoder, p, encoder->block_size) != 0) return -1;
+            p += encoder->block_size;
+            size -= encoder->block_size;
+            continue;
+        }
+        size_t take = encoder->block_size - encoder->block_fill;
+        if (take > size) take = size;
+        memcpy(encoder->block + encoder->block_fill, p, take);
+        encoder->block_fill += take;
+        p += take;
+        size -= take;
+        if (encoder->block_fill == encoder->block_size) {
+            if (lz_frame_write_block(encoder, encoder->block, encoder->block_size) != 0) return -1;
+            encoder->block_fill = 0;
+        }
+    }
+    return 0;
+}
+
+int lz_frame_encoder_finish(LzFrameEncoder *encoder) {
+    if (!encoder || !encoder->block) return -1;
+    if (encoder->block_fill > 0) {
+        if (lz_frame_write_block(encoder, encoder->block, encoder->block_fill) != 0) return -1;
+        encoder->block_fill = 0;
+    }
+    unsigned char end[LZ_BLOCK_HEADER] = { 0, 0, 0, 0 };
+    return string_builder_append(&encoder->output, (const char *)end, sizeof(end));
+}
+
+void lz_frame_encoder_free(LzFrameEncoder *encoder) {
+    if (!encoder) return;
+    free(encoder->block);
+    free(encoder->scratch);
+    free(encoder->state);
+    string_builder_free(&encoder->output);
+    memset(encoder, 0, sizeof(*encoder));
+}
+
+int lz_frame_decoder_init(LzFrameDecoder *decoder) {
+    if (!decoder) return -1;
+    memset(decoder, 0, sizeof(*decoder));
+    return string_builder_init(&decoder->output, 1 << LZ_MIN_BLOCK_LOG);
+}
+
+int lz_frame_decoder_update(LzFrameDecoder *decoder, const void *data, size_t size) {
+    if (!decoder || !decoder->output.data || (!data && size)) return -1;
+    if (size == 0) return 0;
+    if (decoder->done) return -1;
+
+    if (decoder->pending_size + size > decoder->pending_capacity) {
+        size_t capacity = decoder->pending_capacity ? decoder->pending_capacity : 4096;
+        while (capacity < decoder->pending_size + size) capacity *= 2;
+        unsigned char *pending = realloc(decoder->pending, capacity);
+        if (!pending) return -1;
+        decoder->pending = pending;
+        decoder->pending_capacity = capacity;
+    }
+    memcpy(decoder->pending + decoder->pending_size, data, size);
+    decoder->pending_size += size;
+
+    const unsigned char *p = decoder->pending;
+    size_t left = decoder->pending_size;
+    int status = 0;
+    if (decoder->block_size == 0 && left >= LZ_FRAME_HEADER) {
+        if (memcmp(p, "RVLZ", 4) != 0 || p[4] < LZ_MIN_BLOCK_LOG || p[4] > LZ_MAX_BLOCK_LOG || (p[5] & ~LZ_FLAG_CHECKSUMS)) {
+            return -1;
+        }
+        decoder->block_size = (size_t)1 << p[4];
+        decoder->checksums = p[5] & LZ_FLAG_CHECKSUMS;
+        p += LZ_FRAME_HEADER;
+        left -= LZ_FRAME_HEADER;
+    }
+
+    // Decode every block that is complete
+    while (status == 0 && decoder->block_size && !decoder->done && left >= LZ_BLOCK_HEADER) {
+        uint32_t header = lz_load32_le(p);
+        if (header == 0) {
+            decoder->done = 1;
+            p += LZ_BLOCK_HEADER;
+            left -= LZ_BLOCK_HEADER;
+            break;
+        }
+        size_t payload = header & ~LZ_BLOCK_RAW;
+        size_t checksum_size = decoder->checksums ? 4 : 0;
+        if (payload > decoder->block_size) {
+            status = -1;
+            break;
+        }
+        if (left < LZ_BLOCK_HEADER + payload + checksum_size) break;
+
+        const unsigned char *block = p + LZ_BLOCK_HEADER;
+        size_t produced = payload;
+        if (string_builder_reserve(&decoder->output, decoder->block_size) != 0) {
+            status = -1;
+            break;
+        }
+        unsigned char *out = (unsigned char *)decoder->output.data + decoder->output.length;
+        if (header & LZ_BLOCK_RAW) {
+            memcpy(out, block, payload);
+        } else if (lz_decompress(block, payload, out, decoder->block_size, &produced) != 0) {
+            status = -1;
+            break;
+        }
+        if (checksum_size && crc32c(0, out, produced) != lz_load32_le(block + payload)) {
+            status = -1;
+            break;
+        }
+        decoder->output.length += produced;
+        decoder->output.data[decoder->output.length] = '\0';
+        p += LZ_BLOCK_HEADER + payload + checksum_size;
+        left -= LZ_BLOCK_HEADER + payload + checksum_size;
+    }
+
+    if (decoder->done && left > 0) status = -1;
+    memmove(decoder->pending, p, left);
+    decoder->pending_size = left;
+    return status;
+}
+
+int lz_frame_decoder_finish(LzFrameDecoder *decoder) {
+    return decoder && decoder->done && decoder->pending_size == 0 ? 0 : -1;
+}
+
+void lz_frame_decoder_free(LzFrameDecoder *decoder) {
+    if (!decoder) return;
+    free(decoder->pending);
+    string_builder_free(&decoder->output);
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+/* Compress at level, then decode with both decoders; 0 when everything round-trips */
+typedef struct {
+    size_t compressed;
+    double compress_ms;
+    double decompress_ms;
+    double reference_ms;
+} LzRun;
+
+static int lz_measure(const unsigned char *data, size_t size, int level, unsigned char *packed,
+                      unsigned char *unpacked, int iterations, LzRun *run) {
+    Timer timer;
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) {
+        run->compressed = lz_compress(data, size, packed, lz_compress_bound(size), level);
+    }
+    timer_stop(&timer);
+    run->compress_ms = timer_elapsed_ms(&timer) / iterations;
+    if (run->compressed == 0) return -1;
+
+    size_t decoded = 0;
+    int ok = 1;
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) {
+        ok = ok && lz_decompress(packed, run->compressed, unpacked, size, &decoded) == 0;
+    }
+    timer_stop(&timer);
+    run->decompress_ms = timer_elapsed_ms(&timer) / iterations;
+    ok = ok && decoded == size && memcmp(unpacked, data, size) == 0;
+
+    memset(unpacked, 0, size);
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) {
+        ok = ok && lz_decompress_reference(packed, run->compressed, unpacked, size, &decoded) == 0;
+    }
+    timer_stop(&timer);
+    run->reference_ms = timer_elapsed_ms(&timer) / iterations;
+    ok = ok && decoded == size && memcmp(unpacked, data, size) == 0;
+    return ok ? 0 : -1;
+}
+
+int lz_compress_file(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = (size_t)st.st_size;
+    if (size == 0 || size > LZ_MAX_INPUT) {
+        printf("%s: size %zu is outside 1..%u bytes\n", path, size, LZ_MAX_INPUT);
+        close(fd);
+        return -1;
+    }
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    unsigned char *packed = malloc(lz_compress_bound(size));
+    unsigned char *unpacked = malloc(size);
+    int status = packed && unpacked ? 0 : -1;
+    if (status == 0) {
+        printf("LZ compression of %s [%zu bytes]\n", path, size);
+        printf("=========================================\n");
+        const int levels[] = { 0, 4, LZ_MAX_LEVEL };
+        for (size_t l = 0; status == 0 && l < sizeof(levels) / sizeof(levels[0]); l++) {
+            LzRun run;
+            status = lz_measure(mapped, size, levels[l], packed, unpacked, 1, &run);
+            if (status != 0) break;
+            printf("Level %d: ratio %.3f, compress %.1f MB/s, decompress %.1f MB/s\n", levels[l],
+                   (double)size / run.compressed, size / 1e3 / run.compress_ms, size / 1e3 / run.decompress_ms);
+        }
+        if (status != 0) printf("Round trip failed for %s\n", path);
+    } else {
+        printf("Out of memory while compressing %s\n", path);
+    }
+
+    free(packed);
+    free(unpacked);
+    munmap(mapped, size);
+    return status;
+}
+
+typedef enum { LZ_DATA_LOG, LZ_DATA_RECORDS, LZ_DATA_RANDOM } LzDataKind;
+
+/* Synthetic access log lines, fixed-layout binary records, or random bytes */
+static void lz_fill(unsigned char *data, size_t size, LzDataKind kind, unsigned seed) {
+    static const char *paths[] = { "/api/v1/items", "/api/v1/users", "/static/app.js", "/health", "/login" };
+    size_t pos = 0;
+    while (pos < size) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        char line[160];
+        int n;
+        if (kind == LZ_DATA_LOG) {
+            n = snprintf(line, sizeof(line), "10.0.%u.%u - - [18/Oct/2026:12:%02u:%02u] \"GET %s/%u HTTP/1.1\" %u %u\n",
+                         r % 4, r % 200, (r >> 4) % 60, (r >> 10) % 60, paths[r % 5], r % 1000,
+                         r % 17 ? 200 : 404, 200 + r % 5000);
+        } else if (kind == LZ_DATA_RECORDS) {
+            uint32_t record[4] = { (uint32_t)(pos / 16), r % 100, 1000000u + r % 1000, 7 };
+            memcpy(line, record, sizeof(record));
+            n = (int)sizeof(record);
+        } else {
+            uint32_t x = (seed ^ (seed >> 15)) * 0x2c1b3c6du;
+            x ^= x >> 12;
+            memcpy(line, &x, sizeof(x));
+            n = (int)sizeof(x);
+        }
+        size_t take = (size_t)n < size - pos ? (size_t)n : size - pos;
+        memcpy(data + pos, line, take);
+        pos += take;
+    }
+}
+
+void compare_lz_algorithms(size_t size) {
+    unsigned char *data = malloc(size);
+    unsigned char *packed = malloc(lz_compress_bound(size));
+    unsigned char *unpacked = malloc(size);
+    if (!data || !packed || !unpacked) {
+        printf("Failed to allocate buffers for LZ comparison\n");
+        free(data);
+        free(packed);
+        free(unpacked);
+        return;
+    }
+
+    printf("LZ Compression [%zu bytes per data set]\n", size);
+    printf("=========================================\n");
+    printf("%-8s %5s %7s %12s %12s %12s\n", "Data", "Level", "Ratio", "Comp MB/s", "Dec MB/s", "Bytewise");
+
+    static const char *names[] = { "log", "records", "random" };
+    const int levels[] = { 0, 4, LZ_MAX_LEVEL };
+    int ok = 1;
+    for (int kind = LZ_DATA_LOG; kind <= LZ_DATA_RANDOM; kind++) {
+        lz_fill(data, size, (LzDataKind)kind, 42);
+        for (size_t l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+            LzRun run;
+            if (lz_measure(data, size, levels[l], packed, unpacked, 3, &run) != 0) {
+                ok = 0;
+                continue;
+            }
+            printf("%-8s %5d %7.3f %12.1f %12.1f %12.1f\n", names[kind], levels[l], (double)size / run.compressed,
+                   size / 1e3 / run.compress_ms, size / 1e3 / run.decompress_ms, size / 1e3 / run.reference_ms);
+        }
+    }
+
+    // Frame round trip fed in uneven pieces, random data stored raw
+    lz_fill(data, size, LZ_DATA_LOG, 7);
+    lz_fill(data + size / 2, size - size / 2, LZ_DATA_RANDOM, 7);
+    LzFrameEncoder encoder;
+    LzFrameDecoder decoder;
+    int frame_ok = lz_frame_encoder_init(&encoder, 0, 1 << 16) == 0;
+    frame_ok = lz_frame_decoder_init(&decoder) == 0 && frame_ok;
+    unsigned seed = 3;
+    for (size_t pos = 0; frame_ok && pos < size;) {
+        seed = seed * 1103515245u + 12345u;
+        size_t piece = 1 + (seed >> 8) % 200000;
+        if (piece > size - pos) piece = size - pos;
+        frame_ok = lz_frame_encoder_update(&encoder, data + pos, piece) == 0;
+        pos += piece;
+    }
+    frame_ok = frame_ok && lz_frame_encoder_finish(&encoder) == 0;
+    for (size_t pos = 0; frame_ok && pos < encoder.output.length; pos += 4093) {
+        size_t piece = encoder.output.length - pos < 4093 ? encoder.output.length - pos : 4093;
+        frame_ok = lz_frame_decoder_update(&decoder, encoder.output.data + pos, piece) == 0;
+    }
+    frame_ok = frame_ok && lz_frame_decoder_finish(&decoder) == 0 && decoder.output.length == size &&
+               memcmp(decoder.output.data, data, size) == 0;
+    printf("Frame (64 KiB blocks, half random): %zu -> %zu bytes, streamed round trip %s\n", size,
+           encoder.output.length, frame_ok ? "ok" : "failed");
+    lz_frame_encoder_free(&encoder);
+    lz_frame_decoder_free(&decoder);
+    printf("Result verification: %s\n", ok && frame_ok ? "PASS" : "FAIL");
+
+    free(data);
+    free(packed);
+    free(unpacked);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    unsigned char *data;
+    unsigned char *packed;
+    unsigned char *unpacked;
+    size_t compressed;
+} LzBenchState;
+
+static void *lz_bench_setup(const BenchmarkParams *params) {
+    LzBenchState *state = calloc(1, sizeof(LzBenchState));
+    if (!state) return NULL;
+    state->data = malloc(params->size);
+    state->packed = malloc(lz_compress_bound(params->size));
+    state->unpacked = malloc(params->size);
+    if (!state->data || !state->packed || !state->unpacked) {
+        free(state->data);
+        free(state->packed);
+        free(state->unpacked);
+        free(state);
+        return NULL;
+    }
+    lz_fill(state->data, params->size, LZ_DATA_LOG, 7);
+    state->compressed = lz_compress(state->data, params->size, state->packed, lz_compress_bound(params->size), 0);
+    return state;
+}
+
+static void lz_bench_teardown(void *p) {
+    LzBenchState *state = p;
+    free(state->data);
+    free(state->packed);
+    free(state->unpacked);
+    free(state);
+}
+
+static double bench_lz_compress_fast(void *p, const BenchmarkParams *params) {
+    LzBenchState *state = p;
+    return (double)lz_compress(state->data, params->size, state->unpacked, params->size, 0);
+}
+
+static double bench_lz_compress_chain(void *p, const BenchmarkParams *params) {
+    LzBenchState *state = p;
+    return (double)lz_compress(state->data, params->size, state->unpacked, params->size, 4);
+}
+
+static double bench_lz_decompress(void *p, const BenchmarkParams *params) {
+    LzBenchState *state = p;
+    size_t decoded = 0;
+    lz_decompress(state->packed, state->compressed, state->unpacked, params->size, &decoded);
+    return (double)decoded;
+}
+
+static double bench_lz_decompress_reference(void *p, const BenchmarkParams *params) {
+    LzBenchState *state = p;
+    size_t decoded = 0;
+    lz_decompress_reference(state->packed, state->compressed, state->unpacked, params->size, &decoded);
+    return (double)decoded;
+}
+
+static const BenchmarkParams lz_sizes[] = { {1 << 24, 0, 0} };
+
+BENCHMARK_REGISTER(string_lz_compress_fast, "string/lz_compress_fast", lz_bench_setup, bench_lz_compress_fast, lz_bench_teardown, lz_sizes)
+BENCHMARK_REGISTER(string_lz_compress_chain, "string/lz_compress_chain", lz_bench_setup, bench_lz_compress_chain, lz_bench_teardown, lz_sizes)
+BENCHMARK_REGISTER(string_lz_decompress, "string/lz_decompress", lz_bench_setup, bench_lz_decompress, lz_bench_teardown, lz_sizes)
+BENCHMARK_REGISTER(string_lz_decompress_reference, "string/lz_decompress_reference", lz_bench_setup, bench_lz_decompress_reference, lz_bench_teardown, lz_sizes)
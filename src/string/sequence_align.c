@@ -0,0 +1,907 @@
+#define _POSIX_C_SOURCE 200112L
+#include "sequence_align.h"
+#include "benchmark.h"
+#include "parallel.h"
+#include "region_marker.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ALIGN_VEC_BYTES 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ALIGN_VEC_BYTES 16
+#else
+#define ALIGN_VEC_BYTES 16
+#endif
+
+#define LANES8  ALIGN_VEC_BYTES
+#define LANES16 (ALIGN_VEC_BYTES / 2)
+
+#define ALIGN_BASES 5               /* A C G T, everything else */
+#define ALIGN_NEG16 INT16_MIN       /* "minus infinity" for saturating 16-bit lanes */
+#define ALIGN_NEG32 (INT_MIN / 2)
+
+/*
+ * Striped layout: with L lanes and seg = ceil(m / L) segments, query
+ * position i lives in lane i / seg of vector i % seg. One pass over the
+ * segments computes a whole column: the diagonal dependency becomes a
+ * one-lane shift of the previous column's last vector, and the vertical
+ * gap (F) is carried from segment to segment, then across lanes by the
+ * lazy-F pass, which usually stops after one or two vectors. Padding
+ * positions past the query end only feed later padding positions, so
+ * they never change a real cell.
+ *
+ * 8-bit local scores are unsigned with the profile biased by -mismatch;
+ * the saturating subtract doubles as the max(0, ...) of Smith-Waterman.
+ */
+
+const AlignScoring align_default_scoring = { 2, -3, 5, 2 };
+
+/* Base code + 1, so the zero default marks "not ACGT" */
+static const uint8_t base_code[256] = {
+    ['A'] = 1, ['C'] = 2, ['G'] = 3, ['T'] = 4,
+    ['a'] = 1, ['c'] = 2, ['g'] = 3, ['t'] = 4,
+};
+
+static inline int base_of(unsigned char c) {
+    return base_code[c] ? base_code[c] - 1 : 4;
+}
+
+static inline int pair_score(const AlignScoring *s, int q, int r) {
+    return (q == r && q < 4) ? s->match : s->mismatch;
+}
+
+static int scoring_valid(const AlignScoring *s) {
+    return s && s->match > 0 && s->mismatch <= 0 && s->gap_extend > 0 &&
+           s->gap_open >= s->gap_extend;
+}
+
+/* ------------------------------------------------------------------ */
+/* Vector primitives                                                  */
+/* ------------------------------------------------------------------ */
+
+#if defined(__AVX2__)
+
+typedef __m256i AlignVec;
+
+static inline AlignVec u8_set1(int v) { return _mm256_set1_epi8((char)v); }
+static inline AlignVec u8_adds(AlignVec a, AlignVec b) { return _mm256_adds_epu8(a, b); }
+static inline AlignVec u8_subs(AlignVec a, AlignVec b) { return _mm256_subs_epu8(a, b); }
+static inline AlignVec u8_max(AlignVec a, AlignVec b) { return _mm256_max_epu8(a, b); }
+static inline AlignVec u8_shift(AlignVec a) {
+    return _mm256_alignr_epi8(a, _mm256_permute2x128_si256(a, a, 0x08), 15);
+}
+static inline int u8_any_gt(AlignVec a, AlignVec b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_subs_epu8(a, b), _mm256_setzero_si256())) != -1;
+}
+
+static inline AlignVec i16_set1(int v) { return _mm256_set1_epi16((short)v); }
+static inline AlignVec i16_adds(AlignVec a, AlignVec b) { return _mm256_adds_epi16(a, b); }
+static inline AlignVec i16_subs(AlignVec a, AlignVec b) { return _mm256_subs_epi16(a, b); }
+static inline AlignVec i16_max(AlignVec a, AlignVec b) { return _mm256_max_epi16(a, b); }
+static inline AlignVec i16_shift(AlignVec a, int fill) {
+    AlignVec v = _mm256_alignr_epi8(a, _mm256_permute2x128_si256(a, a, 0x08), 14);
+    return _mm256_insert_epi16(v, (short)fill, 0);
+}
+static inline int i16_any_gt(AlignVec a, AlignVec b) {
+    return _mm256_movemask_epi8(_mm256_cmpgt_epi16(a, b)) != 0;
+}
+
+#elif defined(__SSE2__)
+
+typedef __m128i AlignVec;
+
+static inline AlignVec u8_set1(int v) { return _mm_set1_epi8((char)v); }
+static inline AlignVec u8_adds(AlignVec a, AlignVec b) { return _mm_adds_epu8(a, b); }
+static inline AlignVec u8_subs(AlignVec a, AlignVec b) { return _mm_subs_epu8(a, b); }
+static inline AlignVec u8_max(AlignVec a, AlignVec b) { return _mm_max_epu8(a, b); }
+static inline AlignVec u8_shift(AlignVec a) { return _mm_slli_si128(a, 1); }
+static inline int u8_any_gt(AlignVec a, AlignVec b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_subs_epu8(a, b), _mm_setzero_si128())) != 0xffff;
+}
+
+static inline AlignVec i16_set1(int v) { return _mm_set1_epi16((short)v); }
+static inline AlignVec i16_adds(AlignVec a, AlignVec b) { return _mm_adds_epi16(a, b); }
+static inline AlignVec i16_subs(AlignVec a, AlignVec b) { return _mm_subs_epi16(a, b); }
+static inline AlignVec i16_max(AlignVec a, AlignVec b) { return _mm_max_epi16(a, b); }
+static inline AlignVec i16_shift(AlignVec a, int fill) {
+    return _mm_insert_epi16(_mm_slli_si128(a, 2), fill, 0);
+}
+static inline int i16_any_gt(AlignVec a, AlignVec b) {
+    return _mm_movemask_epi8(_mm_cmpgt_epi16(a, b)) != 0;
+}
+
+#else
+
+/*
+ * Portable lanes: fixed-length loops with no cross-lane dependency
+ * except the shifts, which GCC and Clang auto-vectorize (RVV with
+ * -march=rv64gcv, NEON, ...) and which stay correct as scalar code.
+ */
+typedef union {
+    uint8_t u8[LANES8];
+    int16_t i16[LANES16];
+} __attribute__((aligned(ALIGN_VEC_BYTES))) AlignVec;
+
+static inline AlignVec u8_set1(int v) {
+    AlignVec r;
+    for (int k = 0; k < LANES8; k++) r.u8[k] = (uint8_t)v;
+    return r;
+}
+static inline AlignVec u8_adds(AlignVec a, AlignVec b) {
+    AlignVec r;
+    for (int k = 0; k < LANES8; k++) {
+        unsigned s = (unsigned)a.u8[k] + b.u8[k];
+        r.u8[k] = (uint8_t)(s > 255 ? 255 : s);
+    }
+    return r;
+}
+static inline AlignVec u8_subs(AlignVec a, AlignVec b) {
+    AlignVec r;
+    for (int k = 0; k < LANES8; k++) r.u8[k] = (uint8_t)(a.u8[k] > b.u8[k] ? a.u8[k] - b.u8[k] : 0);
+    return r;
+}
+static inline AlignVec u8_max(AlignVec a, AlignVec b) {
+    AlignVec r;
+    for (int k = 0; k < LANES8; k++) r.u8[k] = a.u8[k] > b.u8[k] ? a.u8[k] : b.u8[k];
+    return r;
+}
+static inline AlignVec u8_shift(AlignVec a) {
+    AlignVec r;
+    r.u8[0] = 0;
+    for (int k = 1; k < LANES8; k++) r.u8[k] = a.u8[k - 1];
+    return r;
+}
+static inline int u8_any_gt(AlignVec a, AlignVec b) {
+    int any = 0;
+    for (int k = 0; k < LANES8; k++) any |= a.u8[k] > b.u8[k];
+    return any;
+}
+
+static inline AlignVec i16_set1(int v) {
+    AlignVec r;
+    for (int k = 0; k < LANES16; k++) r.i16[k] = (int16_t)v;
+    return r;
+}
+static inline int16_t sat16(int v) {
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v);
+}
+static inline AlignVec i16_adds(AlignVec a, AlignVec b) {
+    AlignVec r;
+    for (int k = 0; k < LANES16; k++) r.i16[k] = sat16(a.i16[k] + b.i16[k]);
+    return r;
+}
+static inline AlignVec i16_subs(AlignVec a, AlignVec b) {
+    AlignVec r;
+    for (int k = 0; k < LANES16; k++) r.i16[k] = sat16(a.i16[k] - b.i16[k]);
+    return r;
+}
+static inline AlignVec i16_max(AlignVec a, AlignVec b) {
+    AlignVec r;
+    for (int k = 0; k < LANES16; k++) r.i16[k] = a.i16[k] > b.i16[k] ? a.i16[k] : b.i16[k];
+    return r;
+}
+static inline AlignVec i16_shift(AlignVec a, int fill) {
+    AlignVec r;
+    r.i16[0] = (int16_t)fill;
+    for (int k = 1; k < LANES16; k++) r.i16[k] = a.i16[k - 1];
+    return r;
+}
+static inline int i16_any_gt(AlignVec a, AlignVec b) {
+    int any = 0;
+    for (int k = 0; k < LANES16; k++) any |= a.i16[k] > b.i16[k];
+    return any;
+}
+
+#endif
+
+/* Lane reads go through memcpy: vector types may not be read as int16_t */
+static inline int u8_lane(const AlignVec *v, int k) {
+    uint8_t lanes[LANES8];
+    memcpy(lanes, v, sizeof(lanes));
+    return lanes[k];
+}
+
+static inline int i16_lane(const AlignVec *v, int k) {
+    int16_t lanes[LANES16];
+    memcpy(lanes, v, sizeof(lanes));
+    return lanes[k];
+}
+
+static int u8_hmax(AlignVec v) {
+    uint8_t lanes[LANES8];
+    memcpy(lanes, &v, sizeof(lanes));
+    int best = 0;
+    for (int k = 0; k < LANES8; k++) if (lanes[k] > best) best = lanes[k];
+    return best;
+}
+
+static int i16_hmax(AlignVec v) {
+    int16_t lanes[LANES16];
+    memcpy(lanes, &v, sizeof(lanes));
+    int best = INT16_MIN;
+    for (int k = 0; k < LANES16; k++) if (lanes[k] > best) best = lanes[k];
+    return best;
+}
+
+int align_vector_bytes(void) {
+    return ALIGN_VEC_BYTES;
+}
+
+/* ------------------------------------------------------------------ */
+/* Scalar reference                                                   */
+/* ------------------------------------------------------------------ */
+
+static int align_scalar_codes(const uint8_t *query, size_t m, const char *ref, size_t n,
+                              const AlignScoring *s, AlignMode mode, AlignResult *result) {
+    REGION_SCOPE(REGION_ALIGN_SCALAR);
+    int *h = malloc((m + 1) * sizeof(int));
+    int *e = malloc((m + 1) * sizeof(int));
+    if (!h || !e) {
+        free(h);
+        free(e);
+        return -1;
+    }
+
+    const int local = mode == ALIGN_LOCAL;
+    h[0] = 0;
+    for (size_t i = 1; i <= m; i++) {
+        h[i] = local ? 0 : -(s->gap_open + (int)(i - 1) * s->gap_extend);
+        e[i] = ALIGN_NEG32;
+    }
+
+    int best = 0;
+    size_t best_query = 0, best_ref = 0;
+    for (size_t j = 1; j <= n; j++) {
+        const int r = base_of((unsigned char)ref[j - 1]);
+        int diag = h[0];
+        h[0] = local ? 0 : -(s->gap_open + (int)(j - 1) * s->gap_extend);
+        int f = ALIGN_NEG32;
+
+        for (size_t i = 1; i <= m; i++) {
+            int ei = e[i] - s->gap_extend;
+            if (h[i] - s->gap_open > ei) ei = h[i] - s->gap_open;
+            e[i] = ei;
+            f -= s->gap_extend;
+            if (h[i - 1] - s->gap_open > f) f = h[i - 1] - s->gap_open;
+
+            int v = diag + pair_score(s, query[i - 1], r);
+            if (ei > v) v = ei;
+            if (f > v) v = f;
+            if (local && v < 0) v = 0;
+            diag = h[i];
+            h[i] = v;
+
+            if (local && v > best) {
+                best = v;
+                best_query = i - 1;
+                best_ref = j - 1;
+            }
+        }
+    }
+
+    if (local) {
+        result->score = best;
+        result->query_end = best_query;
+        result->ref_end = best_ref;
+    } else {
+        result->score = h[m];
+        result->query_end = m ? m - 1 : 0;
+        result->ref_end = n ? n - 1 : 0;
+    }
+    result->width = ALIGN_WIDTH_32;
+    free(h);
+    free(e);
+    return 0;
+}
+
+int align_scalar(const char *query, size_t query_length, const char *ref, size_t ref_length,
+                 const AlignScoring *scoring, AlignMode mode, AlignResult *result) {
+    if (!scoring_valid(scoring) || !result || (!query && query_length) || (!ref && ref_length)) return -1;
+
+    uint8_t *codes = malloc(query_length + 1);
+    if (!codes) return -1;
+    for (size_t i = 0; i < query_length; i++) codes[i] = (uint8_t)base_of((unsigned char)query[i]);
+    int status = align_scalar_codes(codes, query_length, ref, ref_length, scoring, mode, result);
+    free(codes);
+    return status;
+}
+
+/* ------------------------------------------------------------------ */
+/* Striped profile                                                    */
+/* ------------------------------------------------------------------ */
+
+struct AlignProfile {
+    AlignScoring scoring;
+    uint8_t *query;             /* base codes, for the scalar fallback */
+    size_t length;
+    size_t seg8;
+    size_t seg16;
+    int bias;                   /* -mismatch, added to every 8-bit profile entry */
+    int use8;                   /* scores small enough for 8-bit lanes */
+    int use16;
+    AlignVec *profile8;         /* ALIGN_BASES * seg8 vectors */
+    AlignVec *profile16;        /* ALIGN_BASES * seg16 vectors */
+    AlignVec *work;             /* H store, H load, E, best column: 4 * seg16 */
+};
+
+static AlignVec* vec_alloc(size_t count) {
+    void *p = NULL;
+    if (posix_memalign(&p, ALIGN_VEC_BYTES, (count ? count : 1) * sizeof(AlignVec)) != 0) return NULL;
+    return p;
+}
+
+AlignProfile* align_profile_create(const char *query, size_t length, const AlignScoring *scoring) {
+    if (!scoring_valid(scoring) || (!query && length)) return NULL;
+
+    AlignProfile *p = calloc(1, sizeof(AlignProfile));
+    if (!p) return NULL;
+    p->scoring = *scoring;
+    p->length = length;
+    p->seg8 = (length + LANES8 - 1) / LANES8;
+    p->seg16 = (length + LANES16 - 1) / LANES16;
+    p->bias = -scoring->mismatch;
+    p->use8 = scoring->match + p->bias < 255 && scoring->gap_open < 255;
+    p->use16 = scoring->match - scoring->mismatch < INT16_MAX / 4 && scoring->gap_open < INT16_MAX / 4;
+
+    p->query = malloc(length + 1);
+    p->profile8 = vec_alloc(ALIGN_BASES * p->seg8);
+    p->profile16 = vec_alloc(ALIGN_BASES * p->seg16);
+    p->work = vec_alloc(4 * p->seg16);
+    if (!p->query || !p->profile8 || !p->profile16 || !p->work) {
+        align_profile_free(p);
+        return NULL;
+    }
+    for (size_t i = 0; i < length; i++) p->query[i] = (uint8_t)base_of((unsigned char)query[i]);
+
+    for (int base = 0; base < ALIGN_BASES; base++) {
+        uint8_t *row8 = (uint8_t *)(p->profile8 + base * p->seg8);
+        for (size_t j = 0; j < p->seg8; j++) {
+            for (int k = 0; k < LANES8; k++) {
+                size_t i = (size_t)k * p->seg8 + j;
+                int score = i < length ? pair_score(scoring, p->query[i], base) : 0;
+                row8[j * LANES8 + k] = p->use8 ? (uint8_t)(score + p->bias) : 0;
+            }
+        }
+        int16_t *row16 = (int16_t *)(p->profile16 + base * p->seg16);
+        for (size_t j = 0; j < p->seg16; j++) {
+            for (int k = 0; k < LANES16; k++) {
+                size_t i = (size_t)k * p->seg16 + j;
+                row16[j * LANES16 + k] = (int16_t)(i < length ? pair_score(scoring, p->query[i], base) : 0);
+            }
+        }
+    }
+    return p;
+}
+
+void align_profile_free(AlignProfile *profile) {
+    if (!profile) return;
+    free(profile->query);
+    free(profile->profile8);
+    free(profile->profile16);
+    free(profile->work);
+    free(profile);
+}
+
+/* Smallest query position holding `best` in a saved striped column */
+static size_t column_find_u8(const AlignVec *column, size_t seg, size_t length, int best) {
+    for (size_t i = 0; i < length; i++) {
+        if (u8_lane(&column[i % seg], (int)(i / seg)) == best) return i;
+    }
+    return 0;
+}
+
+static size_t column_find_i16(const AlignVec *column, size_t seg, size_t length, int best) {
+    for (size_t i = 0; i < length; i++) {
+        if (i16_lane(&column[i % seg], (int)(i / seg)) == best) return i;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Striped kernels                                                    */
+/* ------------------------------------------------------------------ */
+
+/* Returns 1 when a score may have saturated (rerun wider) */
+static int local_striped8(AlignProfile *p, const char *ref, size_t n, AlignResult *result) {
+    REGION_SCOPE(REGION_ALIGN_STRIPED);
+    const size_t seg = p->seg8;
+    AlignVec *hstore = p->work;
+    AlignVec *hload = hstore + seg;
+    AlignVec *e = hload + seg;
+    AlignVec *best_column = e + seg;
+
+    const AlignVec zero = u8_set1(0);
+    const AlignVec gap_open = u8_set1(p->scoring.gap_open);
+    const AlignVec gap_extend = u8_set1(p->scoring.gap_extend);
+    const AlignVec bias = u8_set1(p->bias);
+    for (size_t i = 0; i < seg; i++) hstore[i] = hload[i] = e[i] = zero;
+
+    int best = 0;
+    size_t best_ref = 0;
+    for (size_t j = 0; j < n; j++) {
+        const AlignVec *vp = p->profile8 + (size_t)base_of((unsigned char)ref[j]) * seg;
+        AlignVec vf = zero;
+        AlignVec vmax = zero;
+        AlignVec vh = u8_shift(hstore[seg - 1]);
+        AlignVec *swap = hload;
+        hload = hstore;
+        hstore = swap;
+
+        for (size_t i = 0; i < seg; i++) {
+            vh = u8_subs(u8_adds(vh, vp[i]), bias);
+            AlignVec ve = e[i];
+            vh = u8_max(vh, ve);
+            vh = u8_max(vh, vf);
+            vmax = u8_max(vmax, vh);
+            hstore[i] = vh;
+
+            vh = u8_subs(vh, gap_open);
+            e[i] = u8_max(u8_subs(ve, gap_extend), vh);
+            vf = u8_max(u8_subs(vf, gap_extend), vh);
+            vh = hload[i];
+        }
+
+        // Lazy F: carry the vertical gap across lanes until it stops mattering
+        vf = u8_shift(vf);
+        size_t i = 0;
+        while (u8_any_gt(vf, u8_subs(hstore[i], gap_open))) {
+            AlignVec vh2 = u8_max(hstore[i], vf);
+            hstore[i] = vh2;
+            vmax = u8_max(vmax, vh2);
+            e[i] = u8_max(e[i], u8_subs(vh2, gap_open));
+            vf = u8_subs(vf, gap_extend);
+            if (++i == seg) {
+                i = 0;
+                vf = u8_shift(vf);
+            }
+        }
+
+        int column_max = u8_hmax(vmax);
+        if (column_max > best) {
+            best = column_max;
+            best_ref = j;
+            memcpy(best_column, hstore, seg * sizeof(AlignVec));
+        }
+    }
+
+    // Saturated adds clamp at 255 - bias, so anything below it is exact
+    if (best + p->bias >= 255) return 1;
+    result->score = best;
+    result->ref_end = best ? best_ref : 0;
+    result->query_end = best ? column_find_u8(best_column, seg, p->length, best) : 0;
+    result->width = ALIGN_WIDTH_8;
+    return 0;
+}
+
+static int local_striped16(AlignProfile *p, const char *ref, size_t n, AlignResult *result) {
+    REGION_SCOPE(REGION_ALIGN_STRIPED);
+    const size_t seg = p->seg16;
+    AlignVec *hstore = p->work;
+    AlignVec *hload = hstore + seg;
+    AlignVec *e = hload + seg;
+    AlignVec *best_column = e + seg;
+
+    const AlignVec zero = i16_set1(0);
+    const AlignVec neg = i16_set1(ALIGN_NEG16);
+    const AlignVec gap_open = i16_set1(p->scoring.gap_open);
+    const AlignVec gap_extend = i16_set1(p->scoring.gap_extend);
+    for (size_t i = 0; i < seg; i++) {
+        hstore[i] = hload[i] = zero;
+        e[i] = neg;
+    }
+
+    int best = 0;
+    size_t best_ref = 0;
+    for (size_t j = 0; j < n; j++) {
+        const AlignVec *vp = p->profile16 + (size_t)base_of((unsigned char)ref[j]) * seg;
+        AlignVec vf = neg;
+        AlignVec vmax = zero;
+        AlignVec vh = i16_shift(hstore[seg - 1], 0);
+        AlignVec *swap = hload;
+        hload = hstore;
+        hstore = swap;
+
+        for (size_t i = 0; i < seg; i++) {
+            vh = i16_max(i16_adds(vh, vp[i]), zero);
+            AlignVec ve = e[i];
+            vh = i16_max(vh, ve);
+            vh = i16_max(vh, vf);
+            vmax = i16_max(vmax, vh);
+            hstore[i] = vh;
+
+            vh = i16_subs(vh, gap_open);
+            e[i] = i16_max(i16_subs(ve, gap_extend), vh);
+            vf = i16_max(i16_subs(vf, gap_extend), vh);
+            vh = hload[i];
+        }
+
+        vf = i16_shift(vf, ALIGN_NEG16);
+        size_t i = 0;
+        while (i16_any_gt(vf, i16_subs(hstore[i], gap_open))) {
+            AlignVec vh2 = i16_max(hstore[i], vf);
+            hstore[i] = vh2;
+            vmax = i16_max(vmax, vh2);
+            e[i] = i16_max(e[i], i16_subs(vh2, gap_open));
+            vf = i16_subs(vf, gap_extend);
+            if (++i == seg) {
+                i = 0;
+                vf = i16_shift(vf, ALIGN_NEG16);
+            }
+        }
+
+        int column_max = i16_hmax(vmax);
+        if (column_max > best) {
+            best = column_max;
+            best_ref = j;
+            memcpy(best_column, hstore, seg * sizeof(AlignVec));
+        }
+    }
+
+    if (best >= INT16_MAX) return 1;
+    result->score = best;
+    result->ref_end = best ? best_ref : 0;
+    result->query_end = best ? column_find_i16(best_column, seg, p->length, best) : 0;
+    result->width = ALIGN_WIDTH_16;
+    return 0;
+}
+
+/* Global scores go negative; callers check the 16-bit range up front */
+static void global_striped16(AlignProfile *p, const char *ref, size_t n, AlignResult *result) {
+    REGION_SCOPE(REGION_ALIGN_STRIPED);
+    const size_t seg = p->seg16;
+    const int open = p->scoring.gap_open;
+    const int extend = p->scoring.gap_extend;
+    AlignVec *hstore = p->work;
+    AlignVec *hload = hstore + seg;
+    AlignVec *e = hload + seg;
+
+    const AlignVec neg = i16_set1(ALIGN_NEG16);
+    const AlignVec gap_open = i16_set1(open);
+    const AlignVec gap_extend = i16_set1(extend);
+
+    // Column 0: a leading gap of length i + 1 in the reference
+    int16_t *h0 = (int16_t *)hstore;
+    int16_t *e0 = (int16_t *)e;
+    for (size_t j = 0; j < seg; j++) {
+        for (int k = 0; k < LANES16; k++) {
+            size_t i = (size_t)k * seg + j;
+            int h = i < p->length ? -(open + (int)i * extend) : ALIGN_NEG16;
+            h0[j * LANES16 + k] = (int16_t)h;
+            e0[j * LANES16 + k] = (int16_t)(i < p->length ? h - open : ALIGN_NEG16);
+        }
+    }
+
+    int top = 0;                // H[0][j], the leading gap in the query
+    for (size_t j = 0; j < n; j++) {
+        const AlignVec *vp = p->profile16 + (size_t)base_of((unsigned char)ref[j]) * seg;
+        const int next_top = -(open + (int)j * extend);
+        AlignVec vf = i16_shift(neg, next_top - open);
+        AlignVec vh = i16_shift(hstore[seg - 1], top);
+        AlignVec *swap = hload;
+        hload = hstore;
+        hstore = swap;
+
+        for (size_t i = 0; i < seg; i++) {
+            vh = i16_adds(vh, vp[i]);
+            AlignVec ve = e[i];
+            vh = i16_max(vh, ve);
+            vh = i16_max(vh, vf);
+            hstore[i] = vh;
+
+            vh = i16_subs(vh, gap_open);
+            e[i] = i16_max(i16_subs(ve, gap_extend), vh);
+            vf = i16_max(i16_subs(vf, gap_extend), vh);
+            vh = hload[i];
+        }
+
+        vf = i16_shift(vf, ALIGN_NEG16);
+        size_t i = 0;
+        while (i16_any_gt(vf, i16_subs(hstore[i], gap_open))) {
+            AlignVec vh2 = i16_max(hstore[i], vf);
+            hstore[i] = vh2;
+            e[i] = i16_max(e[i], i16_subs(vh2, gap_open));
+            vf = i16_subs(vf, gap_extend);
+            if (++i == seg) {
+                i = 0;
+                vf = i16_shift(vf, ALIGN_NEG16);
+            }
+        }
+        top = next_top;
+    }
+
+    const size_t last = p->length - 1;
+    result->score = i16_lane(&hstore[last % seg], (int)(last / seg));
+    result->query_end = last;
+    result->ref_end = n - 1;
+    result->width = ALIGN_WIDTH_16;
+}
+
+int align_striped(AlignProfile *profile, const char *ref, size_t ref_length,
+                  AlignMode mode, AlignResult *result) {
+    if (!profile || !result || (!ref && ref_length)) return -1;
+    const AlignScoring *s = &profile->scoring;
+    const size_t m = profile->length;
+
+    if (m > 0 && ref_length > 0 && profile->use16) {
+        if (mode == ALIGN_LOCAL) {
+            if (profile->use8 && local_striped8(profile, ref, ref_length, result) == 0) return 0;
+            if (local_striped16(profile, ref, ref_length, result) == 0) return 0;
+        } else {
+            // |H| grows by at most one step cost per cell along any path
+            int step = s->match > -s->mismatch ? s->match : -s->mismatch;
+            if (s->gap_open > step) step = s->gap_open;
+            if ((double)(m + ref_length + 2) * (step + s->gap_extend) < INT16_MAX - 1024) {
+                global_striped16(profile, ref, ref_length, result);
+                return 0;
+            }
+        }
+    }
+    return align_scalar_codes(profile->query, m, ref, ref_length, s, mode, result);
+}
+
+int align_sequences(const char *query, size_t query_length, const char *ref, size_t ref_length,
+                    const AlignScoring *scoring, AlignMode mode, AlignResult *result) {
+    AlignProfile *profile = align_profile_create(query, query_length, scoring);
+    if (!profile) return -1;
+    int status = align_striped(profile, ref, ref_length, mode, result);
+    align_profile_free(profile);
+    return status;
+}
+
+/* ------------------------------------------------------------------ */
+/* Batch mode                                                         */
+/* ------------------------------------------------------------------ */
+
+#define ALIGN_BATCH_GRAIN 4
+
+typedef struct {
+    const AlignPair *pairs;
+    const AlignScoring *scoring;
+    AlignMode mode;
+    AlignResult *results;
+    int *failed;                /* per worker */
+} AlignJob;
+
+static void align_pairs(size_t begin, size_t end, int thread_id, void *arg) {
+    const AlignJob *job = arg;
+    AlignProfile *profile = NULL;
+    const char *profile_query = NULL;
+    size_t profile_length = 0;
+
+    for (size_t i = begin; i < end; i++) {
+        const AlignPair *pair = &job->pairs[i];
+        // Consecutive pairs sharing a query (one read vs many targets) reuse its profile
+        if (!profile || pair->query != profile_query || pair->query_length != profile_length) {
+            align_profile_free(profile);
+            profile = align_profile_create(pair->query, pair->query_length, job->scoring);
+            profile_query = pair->query;
+            profile_length = pair->query_length;
+        }
+        if (!profile || align_striped(profile, pair->ref, pair->ref_length, job->mode, &job->results[i]) != 0) {
+            job->failed[thread_id] = 1;
+        }
+    }
+    align_profile_free(profile);
+}
+
+int align_batch(const AlignPair *pairs, size_t count, const AlignScoring *scoring,
+                AlignMode mode, int threads, AlignResult *results) {
+    if (!scoring_valid(scoring) || (!pairs && count) || (!results && count)) return -1;
+    if (count == 0) return 0;
+
+    threads = parallel_resolve_threads(threads);
+    int *failed = calloc((size_t)threads, sizeof(int));
+    if (!failed) return -1;
+
+    AlignJob job = { pairs, scoring, mode, results, failed };
+    parallel_for(count, ALIGN_BATCH_GRAIN, threads, align_pairs, &job);
+
+    int status = 0;
+    for (int t = 0; t < threads; t++) {
+        if (failed[t]) status = -1;
+    }
+    free(failed);
+    return status;
+}
+
+/* ------------------------------------------------------------------ */
+/* Comparison                                                         */
+/* ------------------------------------------------------------------ */
+
+/*
+ * Read-like pairs: the reference is a mutated copy of the query
+ * (substitutions and short indels) embedded in random flanks, so local
+ * alignments score high and global ones pay for the flanks.
+ */
+static char* make_pair_sequences(size_t pairs, size_t length, AlignPair *out) {
+    static const char bases[] = "ACGT";
+    const size_t ref_capacity = length * 2 + 32;
+    char *buffer = malloc(pairs * (length + ref_capacity));
+    if (!buffer) return NULL;
+
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    char *cursor = buffer;
+    for (size_t p = 0; p < pairs; p++) {
+        char *query = cursor;
+        char *ref = cursor + length;
+        for (size_t i = 0; i < length; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            query[i] = bases[state >> 62];
+        }
+
+        size_t r = 0;
+        const size_t flank = length / 4;
+        for (size_t i = 0; i < flank; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            ref[r++] = bases[state >> 62];
+        }
+        for (size_t i = 0; i < length && r < ref_capacity - flank - 4; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            unsigned roll = (unsigned)(state >> 56);
+            if (roll < 8) continue;                                  // deletion
+            if (roll < 16) ref[r++] = bases[(state >> 40) & 3];      // insertion
+            ref[r++] = roll < 28 ? bases[(state >> 44) & 3] : query[i];
+        }
+        for (size_t i = 0; i < flank; i++) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            ref[r++] = bases[state >> 62];
+        }
+
+        out[p].query = query;
+        out[p].query_length = length;
+        out[p].ref = ref;
+        out[p].ref_length = r;
+        cursor += length + ref_capacity;
+    }
+    return buffer;
+}
+
+static int results_equal(const AlignResult *a, const AlignResult *b) {
+    return a->score == b->score && a->query_end == b->query_end && a->ref_end == b->ref_end;
+}
+
+void compare_alignment_algorithms(size_t pairs, size_t length) {
+    printf("Sequence Alignment Comparison [%zu pairs, %zu bp reads, %d-byte vectors]\n",
+           pairs, length, ALIGN_VEC_BYTES);
+    printf("=========================================\n");
+
+    AlignPair *list = malloc(pairs * sizeof(AlignPair));
+    AlignResult *scalar = malloc(pairs * sizeof(AlignResult));
+    AlignResult *striped = malloc(pairs * sizeof(AlignResult));
+    AlignResult *batched = malloc(pairs * sizeof(AlignResult));
+    char *buffer = list ? make_pair_sequences(pairs, length, list) : NULL;
+    if (!buffer || !scalar || !striped || !batched) {
+        printf("Failed to allocate sequences\n");
+        free(buffer);
+        free(list);
+        free(scalar);
+        free(striped);
+        free(batched);
+        return;
+    }
+
+    const AlignScoring *s = &align_default_scoring;
+    const int threads = parallel_default_threads();
+    int all_ok = 1;
+    size_t cells = 0;
+    for (size_t p = 0; p < pairs; p++) cells += list[p].query_length * list[p].ref_length;
+    const double gcells = cells / 1e9;
+
+    for (int mode = ALIGN_LOCAL; mode <= ALIGN_GLOBAL; mode++) {
+        Timer timer;
+        int ok = 1;
+        timer_start(&timer);
+        for (size_t p = 0; p < pairs; p++) {
+            ok &= align_scalar(list[p].query, list[p].query_length, list[p].ref, list[p].ref_length,
+                               s, (AlignMode)mode, &scalar[p]) == 0;
+        }
+        timer_stop(&timer);
+        double time_scalar = timer_elapsed_ms(&timer);
+
+        timer_start(&timer);
+        for (size_t p = 0; p < pairs; p++) {
+            ok &= align_sequences(list[p].query, list[p].query_length, list[p].ref, list[p].ref_length,
+                                  s, (AlignMode)mode, &striped[p]) == 0;
+        }
+        timer_stop(&timer);
+        double time_striped = timer_elapsed_ms(&timer);
+
+        timer_start(&timer);
+        ok &= align_batch(list, pairs, s, (AlignMode)mode, threads, batched) == 0;
+        timer_stop(&timer);
+        double time_batch = timer_elapsed_ms(&timer);
+
+        size_t widths[3] = {0, 0, 0};
+        for (size_t p = 0; p < pairs && ok; p++) {
+            ok = results_equal(&scalar[p], &striped[p]) && results_equal(&scalar[p], &batched[p]);
+            widths[striped[p].width]++;
+        }
+        all_ok &= ok;
+
+        printf("%s:\n", mode == ALIGN_LOCAL ? "Smith-Waterman (local)" : "Needleman-Wunsch (global)");
+        printf("  Scalar Gotoh:      %9.3f ms (%6.3f GCUPS)\n", time_scalar,
+               time_scalar > 0 ? gcells / (time_scalar / 1000.0) : 0.0);
+        printf("  Striped SIMD:      %9.3f ms (%6.3f GCUPS, %.1fx)\n", time_striped,
+               time_striped > 0 ? gcells / (time_striped / 1000.0) : 0.0,
+               time_striped > 0 ? time_scalar / time_striped : 0.0);
+        printf("  Batch, %2d threads: %9.3f ms (%6.3f GCUPS, %.1fx)\n", threads, time_batch,
+               time_batch > 0 ? gcells / (time_batch / 1000.0) : 0.0,
+               time_batch > 0 ? time_scalar / time_batch : 0.0);
+        printf("  Score widths: %zu x 8-bit, %zu x 16-bit, %zu x 32-bit\n",
+               widths[ALIGN_WIDTH_8], widths[ALIGN_WIDTH_16], widths[ALIGN_WIDTH_32]);
+    }
+    printf("Result verification: %s\n", all_ok ? "PASS" : "FAIL");
+
+    free(buffer);
+    free(list);
+    free(scalar);
+    free(striped);
+    free(batched);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    char *buffer;
+    AlignPair *pairs;
+    AlignResult *results;
+    size_t count;
+} AlignBenchState;
+
+static void align_bench_teardown(void *p) {
+    AlignBenchState *state = p;
+    free(state->buffer);
+    free(state->pairs);
+    free(state->results);
+    free(state);
+}
+
+/* size = number of pairs, pattern_length = read length */
+static void *align_bench_setup(const BenchmarkParams *params) {
+    AlignBenchState *state = calloc(1, sizeof(AlignBenchState));
+    if (!state) return NULL;
+    state->count = params->size;
+    state->pairs = malloc(state->count * sizeof(AlignPair));
+    state->results = malloc(state->count * sizeof(AlignResult));
+    state->buffer = state->pairs ? make_pair_sequences(state->count, params->pattern_length, state->pairs) : NULL;
+    if (!state->buffer || !state->results) {
+        align_bench_teardown(state);
+        return NULL;
+    }
+    return state;
+}
+
+static double bench_align_scalar(void *p, const BenchmarkParams *params) {
+    AlignBenchState *state = p;
+    (void)params;
+    double total = 0;
+    for (size_t i = 0; i < state->count; i++) {
+        const AlignPair *pair = &state->pairs[i];
+        if (align_scalar(pair->query, pair->query_length, pair->ref, pair->ref_length,
+                         &align_default_scoring, ALIGN_LOCAL, &state->results[i]) == 0) {
+            total += state->results[i].score;
+        }
+    }
+    return total;
+}
+
+static double bench_align_striped(void *p, const BenchmarkParams *params) {
+    AlignBenchState *state = p;
+    double total = 0;
+    if (align_batch(state->pairs, state->count, &align_default_scoring, ALIGN_LOCAL,
+                    params->threads, state->results) == 0) {
+        for (size_t i = 0; i < state->count; i++) total += state->results[i].score;
+    }
+    return total;
+}
+
+static const BenchmarkParams align_scalar_sizes[] = { {256, 150, 0} };
+static const BenchmarkParams align_striped_sizes[] = { {256, 150, 1}, {256, 150, 4} };
+
+BENCHMARK_REGISTER(string_align_scalar, "string/align_scalar", align_bench_setup, bench_align_scalar, align_bench_teardown, align_scalar_sizes)
+BENCHMARK_REGISTER(string_align_striped, "string/align_striped", align_bench_setup, bench_align_striped, align_bench_teardown, align_striped_sizes)
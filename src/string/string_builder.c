@@ -0,0 +1,536 @@
+#include "string_builder.h"
+#include "benchmark.h"
+#include "region_marker.h"
+#include "string_ops.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BUILDER_MIN_CAPACITY 16
+
+int string_builder_init(StringBuilder *builder, size_t capacity) {
+    if (!builder) return -1;
+    builder->data = malloc(capacity + 1);
+    if (!builder->data) return -1;
+    builder->data[0] = '\0';
+    builder->length = 0;
+    builder->capacity = capacity;
+    return 0;
+}
+
+void string_builder_free(StringBuilder *builder) {
+    if (!builder) return;
+    free(builder->data);
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+}
+
+/* Geometric growth keeps the total copying of n appended bytes O(n) */
+int string_builder_reserve(StringBuilder *builder, size_t additional) {
+    if (!builder || additional > SIZE_MAX / 2 - builder->length) return -1;
+
+    size_t needed = builder->length + additional;
+    if (builder->data && needed <= builder->capacity) return 0;
+
+    size_t capacity = builder->capacity < BUILDER_MIN_CAPACITY ? BUILDER_MIN_CAPACITY : builder->capacity;
+    while (capacity < needed) capacity *= 2;
+
+    char *data = realloc(builder->data, capacity + 1);
+    if (!data) return -1;
+    if (!builder->data) data[0] = '\0';
+    builder->data = data;
+    builder->capacity = capacity;
+    return 0;
+}
+
+int string_builder_append(StringBuilder *builder, const char *data, size_t length) {
+    REGION_SCOPE(REGION_STRING_BUILDER);
+    if (!data && length) return -1;
+    if (string_builder_reserve(builder, length) != 0) return -1;
+
+    if (length) string_memcpy(builder->data + builder->length, data, length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+    return 0;
+}
+
+int string_builder_append_str(StringBuilder *builder, const char *str) {
+    if (!str) return -1;
+    return string_builder_append(builder, str, (size_t)string_length(str));
+}
+
+int string_builder_append_char(StringBuilder *builder, char c) {
+    if (string_builder_reserve(builder, 1) != 0) return -1;
+    builder->data[builder->length++] = c;
+    builder->data[builder->length] = '\0';
+    return 0;
+}
+
+int string_builder_appendf(StringBuilder *builder, const char *format, ...) {
+    if (!format || string_builder_reserve(builder, 0) != 0) return -1;
+
+    // Format straight into the spare capacity; retry once if it was too small
+    va_list args;
+    va_start(args, format);
+    size_t spare = builder->capacity - builder->length;
+    int n = vsnprintf(builder->data + builder->length, spare + 1, format, args);
+    va_end(args);
+    if (n < 0) {
+        builder->data[builder->length] = '\0';
+        return -1;
+    }
+
+    if ((size_t)n > spare) {
+        if (string_builder_reserve(builder, (size_t)n) != 0) {
+            builder->data[builder->length] = '\0';
+            return -1;
+        }
+        va_start(args, format);
+        vsnprintf(builder->data + builder->length, (size_t)n + 1, format, args);
+        va_end(args);
+    }
+    builder->length += (size_t)n;
+    return 0;
+}
+
+char* string_builder_finish(StringBuilder *builder, size_t *length) {
+    if (!builder) return NULL;
+    if (!builder->data && string_builder_reserve(builder, 0) != 0) return NULL;
+
+    char *data = builder->data;
+    if (length) *length = builder->length;
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = 0;
+    return data;
+}
+
+/*
+ * Rope nodes. Leaves hold up to ROPE_LEAF_MAX bytes inline; two leaves
+ * that fit together are merged on concatenation, so appending small
+ * pieces fills leaves instead of growing a tree of tiny ones. Internal
+ * nodes cache the total length and the AVL height (leaves are height 0).
+ */
+#define ROPE_LEAF_MAX 256
+
+struct RopeNode {
+    size_t length;
+    int height;
+    int refs;
+    Rope *left;
+    Rope *right;
+    char data[];
+};
+
+static Rope* rope_leaf_alloc(size_t length) {
+    Rope *leaf = malloc(sizeof(Rope) + length);
+    if (!leaf) return NULL;
+    leaf->length = length;
+    leaf->height = 0;
+    leaf->refs = 1;
+    leaf->left = NULL;
+    leaf->right = NULL;
+    return leaf;
+}
+
+static Rope* rope_leaf(const char *data, size_t length) {
+    Rope *leaf = rope_leaf_alloc(length);
+    if (leaf && length) memcpy(leaf->data, data, length);
+    return leaf;
+}
+
+Rope* rope_retain(Rope *rope) {
+    if (rope) rope->refs++;
+    return rope;
+}
+
+void rope_release(Rope *rope) {
+    while (rope && --rope->refs == 0) {
+        Rope *right = rope->right;
+        rope_release(rope->left);
+        free(rope);
+        rope = right;       // tail call by hand
+    }
+}
+
+size_t rope_length(const Rope *rope) {
+    return rope ? rope->length : 0;
+}
+
+int rope_height(const Rope *rope) {
+    return rope ? rope->height : 0;
+}
+
+/*
+ * Internal helpers take ownership of their Rope* arguments (the caller's
+ * references are consumed even on failure), which keeps error paths flat.
+ */
+static Rope* rope_node(Rope *left, Rope *right) {
+    Rope *node = (left && right) ? malloc(sizeof(Rope)) : NULL;
+    if (!node) {
+        rope_release(left);
+        rope_release(right);
+        return NULL;
+    }
+    node->length = left->length + right->length;
+    node->height = 1 + (left->height > right->height ? left->height : right->height);
+    node->refs = 1;
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+/* Node over left and right whose heights differ by at most 2 */
+static Rope* rope_balance(Rope *left, Rope *right) {
+    if (!left || !right) return rope_node(left, right);
+
+    if (left->height > right->height + 1) {
+        Rope *ll = rope_retain(left->left);
+        Rope *lr = rope_retain(left->right);
+        rope_release(left);
+        if (ll->height >= lr->height) {
+            return rope_node(ll, rope_node(lr, right));
+        }
+        Rope *lrl = rope_retain(lr->left);
+        Rope *lrr = rope_retain(lr->right);
+        rope_release(lr);
+        return rope_node(rope_node(ll, lrl), rope_node(lrr, right));
+    }
+
+    if (right->height > left->height + 1) {
+        Rope *rl = rope_retain(right->left);
+        Rope *rr = rope_retain(right->right);
+        rope_release(right);
+        if (rr->height >= rl->height) {
+            return rope_node(rope_node(left, rl), rr);
+        }
+        Rope *rll = rope_retain(rl->left);
+        Rope *rlr = rope_retain(rl->right);
+        rope_release(rl);
+        return rope_node(rope_node(left, rll), rope_node(rlr, rr));
+    }
+
+    return rope_node(left, right);
+}
+
+/* AVL join: descend the taller tree's inner spine to the other's height */
+static Rope* rope_join(Rope *left, Rope *right) {
+    if (!left || !right) {
+        rope_release(left);
+        rope_release(right);
+        return NULL;
+    }
+    if (left->length == 0) {
+        rope_release(left);
+        return right;
+    }
+    if (right->length == 0) {
+        rope_release(right);
+        return left;
+    }
+
+    if (left->height == 0 && right->height == 0) {
+        if (left->length + right->length > ROPE_LEAF_MAX) return rope_node(left, right);
+
+        Rope *leaf = rope_leaf_alloc(left->length + right->length);
+        if (leaf) {
+            memcpy(leaf->data, left->data, left->length);
+            memcpy(leaf->data + left->length, right->data, right->length);
+        }
+        rope_release(left);
+        rope_release(right);
+        return leaf;
+    }
+
+    // A leaf keeps descending so it can merge with the neighbouring leaf
+    if (left->height > right->height + 1 || (right->height == 0 && left->height > 0)) {
+        Rope *ll = rope_retain(left->left);
+        Rope *lr = rope_retain(left->right);
+        rope_release(left);
+        return rope_balance(ll, rope_join(lr, right));
+    }
+    if (right->height > left->height + 1 || (left->height == 0 && right->height > 0)) {
+        Rope *rl = rope_retain(right->left);
+        Rope *rr = rope_retain(right->right);
+        rope_release(right);
+        return rope_balance(rope_join(left, rl), rr);
+    }
+    return rope_node(left, right);
+}
+
+/* Balanced tree over whole ROPE_LEAF_MAX leaves */
+static Rope* rope_build(const char *data, size_t length) {
+    if (length <= ROPE_LEAF_MAX) return rope_leaf(data, length);
+
+    size_t leaves = (length + ROPE_LEAF_MAX - 1) / ROPE_LEAF_MAX;
+    size_t mid = leaves / 2 * ROPE_LEAF_MAX;
+    return rope_node(rope_build(data, mid), rope_build(data + mid, length - mid));
+}
+
+Rope* rope_from_string(const char *data, size_t length) {
+    if (!data && length) return NULL;
+    return rope_build(data, length);
+}
+
+char rope_char_at(const Rope *rope, size_t index) {
+    if (!rope || index >= rope->length) return '\0';
+    while (rope->height > 0) {
+        if (index < rope->left->length) {
+            rope = rope->left;
+        } else {
+            index -= rope->left->length;
+            rope = rope->right;
+        }
+    }
+    return rope->data[index];
+}
+
+Rope* rope_concat(Rope *left, Rope *right) {
+    REGION_SCOPE(REGION_ROPE);
+    if (!left || !right) return NULL;
+    return rope_join(rope_retain(left), rope_retain(right));
+}
+
+Rope* rope_append(Rope *rope, const char *data, size_t length) {
+    REGION_SCOPE(REGION_ROPE);
+    if (!rope || (!data && length)) return NULL;
+    return rope_join(rope_retain(rope), rope_build(data, length));
+}
+
+/* Borrows rope; left and right are new references */
+static int rope_split_at(Rope *rope, size_t position, Rope **left, Rope **right) {
+    if (rope->height == 0) {
+        *left = rope_leaf(rope->data, position);
+        *right = rope_leaf(rope->data + position, rope->length - position);
+    } else if (position == rope->left->length) {
+        *left = rope_retain(rope->left);
+        *right = rope_retain(rope->right);
+    } else if (position < rope->left->length) {
+        Rope *inner_right = NULL;
+        if (rope_split_at(rope->left, position, left, &inner_right) != 0) return -1;
+        *right = rope_join(inner_right, rope_retain(rope->right));
+    } else {
+        Rope *inner_left = NULL;
+        if (rope_split_at(rope->right, position - rope->left->length, &inner_left, right) != 0) return -1;
+        *left = rope_join(rope_retain(rope->left), inner_left);
+    }
+
+    if (!*left || !*right) {
+        rope_release(*left);
+        rope_release(*right);
+        *left = *right = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+int rope_split(Rope *rope, size_t position, Rope **left, Rope **right) {
+    REGION_SCOPE(REGION_ROPE);
+    if (!rope || !left || !right || position > rope->length) return -1;
+    return rope_split_at(rope, position, left, right);
+}
+
+static char* rope_copy_out(const Rope *rope, char *out) {
+    while (rope->height > 0) {
+        out = rope_copy_out(rope->left, out);
+        rope = rope->right;
+    }
+    memcpy(out, rope->data, rope->length);
+    return out + rope->length;
+}
+
+char* rope_flatten(const Rope *rope, size_t *length) {
+    if (!rope) return NULL;
+
+    char *text = malloc(rope->length + 1);
+    if (!text) return NULL;
+    rope_copy_out(rope, text);
+    text[rope->length] = '\0';
+    if (length) *length = rope->length;
+    return text;
+}
+
+/* Pieces of text as separate NUL-terminated strings, as a caller would hold them */
+static char** make_pieces(const char *text, size_t total, size_t piece, size_t *count) {
+    size_t n = (total + piece - 1) / piece;
+    char **pieces = malloc(n * sizeof(char *));
+    if (!pieces) return NULL;
+
+    for (size_t i = 0; i < n; i++) {
+        size_t len = (i + 1) * piece <= total ? piece : total - i * piece;
+        pieces[i] = malloc(len + 1);
+        if (!pieces[i]) {
+            while (i--) free(pieces[i]);
+            free(pieces);
+            return NULL;
+        }
+        memcpy(pieces[i], text + i * piece, len);
+        pieces[i][len] = '\0';
+    }
+    *count = n;
+    return pieces;
+}
+
+static void free_pieces(char **pieces, size_t count) {
+    for (size_t i = 0; i < count; i++) free(pieces[i]);
+    free(pieces);
+}
+
+static char* build_by_concatenate(char **pieces, size_t count) {
+    char *result = string_copy("");
+    for (size_t i = 0; i < count && result; i++) {
+        char *next = string_concatenate(result, pieces[i]);
+        free(result);
+        result = next;
+    }
+    return result;
+}
+
+static char* build_by_builder(char **pieces, size_t count) {
+    StringBuilder builder;
+    if (string_builder_init(&builder, 0) != 0) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (string_builder_append_str(&builder, pieces[i]) != 0) {
+            string_builder_free(&builder);
+            return NULL;
+        }
+    }
+    return string_builder_finish(&builder, NULL);
+}
+
+static char* build_by_rope(char **pieces, size_t count, int *height) {
+    Rope *rope = rope_from_string("", 0);
+    for (size_t i = 0; i < count && rope; i++) {
+        Rope *next = rope_append(rope, pieces[i], (size_t)string_length(pieces[i]));
+        rope_release(rope);
+        rope = next;
+    }
+    if (height) *height = rope_height(rope);
+    char *text = rope_flatten(rope, NULL);
+    rope_release(rope);
+    return text;
+}
+
+static char* make_text(size_t total) {
+    char *text = malloc(total + 1);
+    if (!text) return NULL;
+    for (size_t i = 0; i < total; i++) {
+        text[i] = (char)('a' + rand() % 26);
+    }
+    text[total] = '\0';
+    return text;
+}
+
+void compare_string_building(size_t total, size_t piece) {
+    printf("String Building Comparison [%zu bytes in %zu-byte pieces]\n", total, piece);
+    printf("=========================================\n");
+
+    size_t count = 0;
+    char *text = make_text(total);
+    char **pieces = text && piece ? make_pieces(text, total, piece, &count) : NULL;
+    if (!pieces) {
+        printf("Failed to allocate pieces\n");
+        free(text);
+        return;
+    }
+
+    Timer timer;
+    timer_start(&timer);
+    char *chained = build_by_concatenate(pieces, count);
+    timer_stop(&timer);
+    double time_concat = timer_elapsed_ms(&timer);
+
+    timer_start(&timer);
+    char *built = build_by_builder(pieces, count);
+    timer_stop(&timer);
+    double time_builder = timer_elapsed_ms(&timer);
+
+    int height = 0;
+    timer_start(&timer);
+    char *flattened = build_by_rope(pieces, count, &height);
+    timer_stop(&timer);
+    double time_rope = timer_elapsed_ms(&timer);
+
+    printf("Chained string_concatenate: %.3f ms\n", time_concat);
+    printf("StringBuilder:              %.3f ms (%.1fx)\n", time_builder,
+           time_builder > 0 ? time_concat / time_builder : 0.0);
+    printf("Rope + flatten:             %.3f ms (%.1fx, height %d)\n", time_rope,
+           time_rope > 0 ? time_concat / time_rope : 0.0, height);
+
+    int ok = chained && built && flattened &&
+             memcmp(chained, text, total + 1) == 0 &&
+             memcmp(built, text, total + 1) == 0 &&
+             memcmp(flattened, text, total + 1) == 0;
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    free(chained);
+    free(built);
+    free(flattened);
+    free_pieces(pieces, count);
+    free(text);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+#define BUILD_BENCH_PIECE 32
+
+typedef struct {
+    char *text;
+    char **pieces;
+    size_t count;
+} BuildBenchState;
+
+static void *build_bench_setup(const BenchmarkParams *params) {
+    BuildBenchState *state = malloc(sizeof(BuildBenchState));
+    if (!state) return NULL;
+    state->text = make_text(params->size);
+    state->pieces = state->text ? make_pieces(state->text, params->size, BUILD_BENCH_PIECE, &state->count) : NULL;
+    if (!state->pieces) {
+        free(state->text);
+        free(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void build_bench_teardown(void *p) {
+    BuildBenchState *state = p;
+    free_pieces(state->pieces, state->count);
+    free(state->text);
+    free(state);
+}
+
+static double bench_build_concatenate(void *p, const BenchmarkParams *params) {
+    BuildBenchState *state = p;
+    (void)params;
+    char *text = build_by_concatenate(state->pieces, state->count);
+    double check = text ? (double)text[0] : 0.0;
+    free(text);
+    return check;
+}
+
+static double bench_build_builder(void *p, const BenchmarkParams *params) {
+    BuildBenchState *state = p;
+    (void)params;
+    char *text = build_by_builder(state->pieces, state->count);
+    double check = text ? (double)text[0] : 0.0;
+    free(text);
+    return check;
+}
+
+static double bench_build_rope(void *p, const BenchmarkParams *params) {
+    BuildBenchState *state = p;
+    (void)params;
+    char *text = build_by_rope(state->pieces, state->count, NULL);
+    double check = text ? (double)text[0] : 0.0;
+    free(text);
+    return check;
+}
+
+static const BenchmarkParams build_sizes[] = { {1 << 14, 0, 0}, {1 << 18, 0, 0} };
+
+BENCHMARK_REGISTER(string_build_concatenate, "string/build_concatenate", build_bench_setup, bench_build_concatenate, build_bench_teardown, build_sizes)
+BENCHMARK_REGISTER(string_build_builder, "string/build_builder", build_bench_setup, bench_build_builder, build_bench_teardown, build_sizes)
+BENCHMARK_REGISTER(string_build_rope, "string/build_rope", build_bench_setup, bench_build_rope, build_bench_teardown, build_sizes)
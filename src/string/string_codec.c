@@ -0,0 +1,732 @@
+#include "string_codec.h"
+#include "benchmark.h"
+#include "region_marker.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+static const char base64_chars[2][65] = {
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+};
+
+static const char hex_chars[] = "0123456789abcdef";
+
+/* Character values for the scalar decoders, -1 outside the alphabet */
+static const signed char base64_values[2][256] = {
+    {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    },
+    {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    }
+};
+
+static const signed char hex_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+size_t base64_encoded_length(size_t length, Base64Alphabet alphabet) {
+    if (alphabet == BASE64_STANDARD) return (length + 2) / 3 * 4;
+    return length / 3 * 4 + (length % 3 ? length % 3 + 1 : 0);
+}
+
+size_t base64_decoded_max(size_t length) {
+    return (length + 3) / 4 * 3;
+}
+
+/* Scalar encoder, also used for the tail after the vector blocks */
+static size_t encode_scalar(const unsigned char *in, size_t length, char *out, Base64Alphabet alphabet) {
+    const char *chars = base64_chars[alphabet];
+    char *p = out;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16 | (uint32_t)in[i + 1] << 8 | in[i + 2];
+        p[0] = chars[v >> 18];
+        p[1] = chars[v >> 12 & 63];
+        p[2] = chars[v >> 6 & 63];
+        p[3] = chars[v & 63];
+        p += 4;
+    }
+    if (i < length) {
+        uint32_t v = (uint32_t)in[i] << 16 | (i + 1 < length ? (uint32_t)in[i + 1] << 8 : 0);
+        *p++ = chars[v >> 18];
+        *p++ = chars[v >> 12 & 63];
+        if (i + 1 < length) {
+            *p++ = chars[v >> 6 & 63];
+        } else if (alphabet == BASE64_STANDARD) {
+            *p++ = '=';
+        }
+        if (alphabet == BASE64_STANDARD) *p++ = '=';
+    }
+    return (size_t)(p - out);
+}
+
+/* Unpadded length of text, or -1 when its padding or length is malformed */
+static int base64_body(const char *text, size_t length, size_t *body) {
+    size_t pad = 0;
+    while (length > 0 && pad < 2 && text[length - 1] == '=') {
+        length--;
+        pad++;
+    }
+    if ((pad && (length + pad) % 4 != 0) || length % 4 == 1) return -1;
+    *body = length;
+    return 0;
+}
+
+/* Scalar decoder over an unpadded body; the final partial quantum must end in zero bits */
+static int decode_scalar(const unsigned char *in, size_t length, unsigned char *out, Base64Alphabet alphabet) {
+    const signed char *values = base64_values[alphabet];
+    size_t i = 0;
+    int invalid = 0;
+    for (; i + 4 <= length; i += 4) {
+        int a = values[in[i]], b = values[in[i + 1]];
+        int c = values[in[i + 2]], d = values[in[i + 3]];
+        invalid |= a | b | c | d;
+        uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6 | (uint32_t)d;
+        out[0] = (unsigned char)(v >> 16);
+        out[1] = (unsigned char)(v >> 8);
+        out[2] = (unsigned char)v;
+        out += 3;
+    }
+    size_t rest = length - i;
+    if (rest >= 2) {
+        int a = values[in[i]], b = values[in[i + 1]];
+        int c = rest == 3 ? values[in[i + 2]] : 0;
+        invalid |= a | b | c;
+        uint32_t v = (uint32_t)a << 18 | (uint32_t)b << 12 | (uint32_t)c << 6;
+        out[0] = (unsigned char)(v >> 16);
+        if (rest == 3) out[1] = (unsigned char)(v >> 8);
+        if (invalid >= 0 && (v & (rest == 3 ? 0xFFu : 0xFFFFu)) != 0) return -1;
+    }
+    return invalid < 0 ? -1 : 0;
+}
+
+static size_t base64_decoded_size(size_t body) {
+    return body / 4 * 3 + (body % 4 ? body % 4 - 1 : 0);
+}
+
+size_t base64_encode_scalar(const void *data, size_t length, char *out, Base64Alphabet alphabet) {
+    if (!data || !out) return 0;
+    return encode_scalar(data, length, out, alphabet);
+}
+
+int base64_decode_scalar(const char *text, size_t length, void *out, size_t *decoded, Base64Alphabet alphabet) {
+    size_t body;
+    if (!text || !out || base64_body(text, length, &body) != 0) return -1;
+    if (decode_scalar((const unsigned char *)text, body, out, alphabet) != 0) return -1;
+    if (decoded) *decoded = base64_decoded_size(body);
+    return 0;
+}
+
+#if defined(__AVX2__)
+
+/* 24 input bytes (two 12-byte halves, one per lane) to 32 six-bit indices */
+static inline __m256i base64_indices256(__m256i in) {
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    // Move each 6-bit field into its own byte with per-lane 16-bit shifts
+    __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)),
+                                    _mm256_set1_epi32(0x04000040));
+    __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)),
+                                    _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(ac, bd);
+}
+
+/* Six-bit indices to ASCII: classify into ranges, then one pshufb of offsets */
+static inline __m256i base64_ascii256(__m256i indices, __m256i offsets) {
+    __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+    __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+    range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+    return _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range));
+}
+
+static inline __m256i in_range256(__m256i c, char low, char count) {
+    __m256i x = _mm256_sub_epi8(c, _mm256_set1_epi8(low));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8((char)(count - 1))), x);
+}
+
+static size_t encode_vector(const unsigned char *in, size_t length, char *out, char c62, char c63) {
+    const __m256i offsets = _mm256_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, (char)(c62 - 62), (char)(c63 - 63), 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, (char)(c62 - 62), (char)(c63 - 63), 'A', 0, 0);
+    size_t i = 0;
+    // Two 16-byte loads per 24 consumed bytes: stop while 28 are readable
+    for (; i + 28 <= length; i += 24) {
+        __m256i bytes = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(in + i))),
+            _mm_loadu_si128((const __m128i *)(in + i + 12)), 1);
+        _mm256_storeu_si256((__m256i *)(out + i / 3 * 4), base64_ascii256(base64_indices256(bytes), offsets));
+    }
+    return i;
+}
+
+static size_t decode_vector(const unsigned char *in, size_t length, unsigned char *out, char c62, char c63) {
+    size_t i = 0;
+    // 32 characters give 24 bytes but store 32: keep 11 characters of slack
+    for (; i + 44 <= length; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i upper = in_range256(c, 'A', 26);
+        __m256i lower = in_range256(c, 'a', 26);
+        __m256i digit = in_range256(c, '0', 10);
+        __m256i e62 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(c62));
+        __m256i e63 = _mm256_cmpeq_epi8(c, _mm256_set1_epi8(c63));
+        __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(e62, e63)));
+        if ((uint32_t)_mm256_movemask_epi8(valid) != 0xFFFFFFFFu) break;
+
+        __m256i roll = _mm256_or_si256(
+            _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                            _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a'))),
+            _mm256_or_si256(_mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')),
+                            _mm256_or_si256(_mm256_and_si256(e62, _mm256_set1_epi8((char)(62 - c62))),
+                                            _mm256_and_si256(e63, _mm256_set1_epi8((char)(63 - c63))))));
+        __m256i values = _mm256_add_epi8(c, roll);
+
+        // Pack 4 x 6 bits into 3 bytes: multiply-add pairs, then quads, then gather the bytes
+        __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i quads = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        __m256i packed = _mm256_shuffle_epi8(quads, _mm256_setr_epi8(
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        packed = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7));
+        _mm256_storeu_si256((__m256i *)(out + i / 4 * 3), packed);
+    }
+    return i;
+}
+
+static size_t hex_encode_vector(const unsigned char *in, size_t length, char *out) {
+    const __m256i digits = _mm256_setr_epi8(
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+        '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i *)(in + i));
+        __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_nibble));
+        __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, low_nibble));
+        // Interleave within lanes, then put the lane halves back in order
+        __m256i first = _mm256_unpacklo_epi8(hi, lo);
+        __m256i second = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(out + 2 * i), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + 2 * i + 32), _mm256_permute2x128_si256(first, second, 0x31));
+    }
+    return i;
+}
+
+/* Nibble values of 32 hex characters; valid is all-ones where the character is hex */
+static inline __m256i hex_values256(__m256i c, __m256i *valid) {
+    __m256i digit = in_range256(c, '0', 10);
+    __m256i folded = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+    __m256i letter = in_range256(folded, 'a', 6);
+    *valid = _mm256_or_si256(digit, letter);
+    return _mm256_or_si256(_mm256_and_si256(digit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+                           _mm256_and_si256(letter, _mm256_sub_epi8(folded, _mm256_set1_epi8('a' - 10))));
+}
+
+static size_t hex_decode_vector(const unsigned char *in, size_t length, unsigned char *out) {
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        __m256i valid0, valid1;
+        __m256i v0 = hex_values256(_mm256_loadu_si256((const __m256i *)(in + i)), &valid0);
+        __m256i v1 = hex_values256(_mm256_loadu_si256((const __m256i *)(in + i + 32)), &valid1);
+        if ((uint32_t)_mm256_movemask_epi8(_mm256_and_si256(valid0, valid1)) != 0xFFFFFFFFu) break;
+        // high * 16 + low per 16-bit pair, then narrow and undo the lane interleave
+        __m256i w0 = _mm256_maddubs_epi16(v0, _mm256_set1_epi16(0x0110));
+        __m256i w1 = _mm256_maddubs_epi16(v1, _mm256_set1_epi16(0x0110));
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(w0, w1), 0xD8);
+        _mm256_storeu_si256((__m256i *)(out + i / 2), packed);
+    }
+    return i;
+}
+
+#elif defined(__SSSE3__)
+
+static inline __m128i in_range128(__m128i c, char low, char count) {
+    __m128i x = _mm_sub_epi8(c, _mm_set1_epi8(low));
+    return _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8((char)(count - 1))), x);
+}
+
+static size_t encode_vector(const unsigned char *in, size_t length, char *out, char c62, char c63) {
+    const __m128i offsets = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, (char)(c62 - 62), (char)(c63 - 63), 'A', 0, 0);
+    size_t i = 0;
+    // One 16-byte load per 12 consumed bytes
+    for (; i + 16 <= length; i += 12) {
+        __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(in + i)),
+                                         _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m128i ac = _mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        __m128i bd = _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(ac, bd);
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+        _mm_storeu_si128((__m128i *)(out + i / 3 * 4), _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range)));
+    }
+    return i;
+}
+
+static size_t decode_vector(const unsigned char *in, size_t length, unsigned char *out, char c62, char c63) {
+    size_t i = 0;
+    // 16 characters give 12 bytes but store 16: keep 8 characters of slack
+    for (; i + 24 <= length; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i upper = in_range128(c, 'A', 26);
+        __m128i lower = in_range128(c, 'a', 26);
+        __m128i digit = in_range128(c, '0', 10);
+        __m128i e62 = _mm_cmpeq_epi8(c, _mm_set1_epi8(c62));
+        __m128i e63 = _mm_cmpeq_epi8(c, _mm_set1_epi8(c63));
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(e62, e63)));
+        if (_mm_movemask_epi8(valid) != 0xFFFF) break;
+
+        __m128i roll = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+            _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                         _mm_or_si128(_mm_and_si128(e62, _mm_set1_epi8((char)(62 - c62))),
+                                      _mm_and_si128(e63, _mm_set1_epi8((char)(63 - c63))))));
+        __m128i values = _mm_add_epi8(c, roll);
+        __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        __m128i packed = _mm_shuffle_epi8(quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storeu_si128((__m128i *)(out + i / 4 * 3), packed);
+    }
+    return i;
+}
+
+static size_t hex_encode_vector(const unsigned char *in, size_t length, char *out) {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i low_nibble = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble));
+        __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, low_nibble));
+        _mm_storeu_si128((__m128i *)(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+    return i;
+}
+
+static inline __m128i hex_values128(__m128i c, __m128i *valid) {
+    __m128i digit = in_range128(c, '0', 10);
+    __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i letter = in_range128(folded, 'a', 6);
+    *valid = _mm_or_si128(digit, letter);
+    return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                        _mm_and_si128(letter, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+}
+
+static size_t hex_decode_vector(const unsigned char *in, size_t length, unsigned char *out) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m128i valid0, valid1;
+        __m128i v0 = hex_values128(_mm_loadu_si128((const __m128i *)(in + i)), &valid0);
+        __m128i v1 = hex_values128(_mm_loadu_si128((const __m128i *)(in + i + 16)), &valid1);
+        if (_mm_movemask_epi8(_mm_and_si128(valid0, valid1)) != 0xFFFF) break;
+        __m128i w0 = _mm_maddubs_epi16(v0, _mm_set1_epi16(0x0110));
+        __m128i w1 = _mm_maddubs_epi16(v1, _mm_set1_epi16(0x0110));
+        _mm_storeu_si128((__m128i *)(out + i / 2), _mm_packus_epi16(w0, w1));
+    }
+    return i;
+}
+
+#else
+
+/*
+ * Portable lanes: fixed 48-byte / 64-character blocks with branch-free
+ * per-byte arithmetic, the shape RVV auto-vectorizers turn into strided
+ * segment loads, compares and merges.
+ */
+static size_t encode_vector(const unsigned char *in, size_t length, char *out, char c62, char c63) {
+    const unsigned char d62 = (unsigned char)(c62 - ('0' + 10)), d63 = (unsigned char)(c63 - ('0' + 11));
+    size_t i = 0;
+    for (; i + 48 <= length; i += 48) {
+        const unsigned char *s = in + i;
+        unsigned char idx[64];
+        for (int g = 0; g < 16; g++) {
+            idx[4 * g] = s[3 * g] >> 2;
+            idx[4 * g + 1] = (unsigned char)((s[3 * g] & 3) << 4 | s[3 * g + 1] >> 4);
+            idx[4 * g + 2] = (unsigned char)((s[3 * g + 1] & 15) << 2 | s[3 * g + 2] >> 6);
+            idx[4 * g + 3] = s[3 * g + 2] & 63;
+        }
+        char *o = out + i / 3 * 4;
+        for (int k = 0; k < 64; k++) {
+            unsigned char v = idx[k];
+            unsigned char c = (unsigned char)(v + 'A');
+            c += v >= 26 ? 6 : 0;
+            c -= v >= 52 ? 75 : 0;
+            c += v == 62 ? d62 : 0;
+            c += v == 63 ? d63 : 0;
+            o[k] = (char)c;
+        }
+    }
+    return i;
+}
+
+static size_t decode_vector(const unsigned char *in, size_t length, unsigned char *out, char c62, char c63) {
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        const unsigned char *s = in + i;
+        unsigned char v[64];
+        unsigned char invalid = 0;
+        for (int k = 0; k < 64; k++) {
+            unsigned char c = s[k];
+            unsigned char upper = (unsigned char)(c - 'A') < 26, lower = (unsigned char)(c - 'a') < 26;
+            unsigned char digit = (unsigned char)(c - '0') < 10;
+            unsigned char e62 = c == (unsigned char)c62, e63 = c == (unsigned char)c63;
+            unsigned char roll = (unsigned char)((upper ? -'A' : 0) + (lower ? 26 - 'a' : 0) + (digit ? 52 - '0' : 0) +
+                                                 (e62 ? 62 - c62 : 0) + (e63 ? 63 - c63 : 0));
+            v[k] = (unsigned char)(c + roll);
+            invalid |= !(upper | lower | digit | e62 | e63);
+        }
+        if (invalid) break;
+        unsigned char *o = out + i / 4 * 3;
+        for (int g = 0; g < 16; g++) {
+            o[3 * g] = (unsigned char)(v[4 * g] << 2 | v[4 * g + 1] >> 4);
+            o[3 * g + 1] = (unsigned char)(v[4 * g + 1] << 4 | v[4 * g + 2] >> 2);
+            o[3 * g + 2] = (unsigned char)(v[4 * g + 2] << 6 | v[4 * g + 3]);
+        }
+    }
+    return i;
+}
+
+static size_t hex_encode_vector(const unsigned char *in, size_t length, char *out) {
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        char *o = out + 2 * i;
+        for (int k = 0; k < 32; k++) {
+            unsigned char hi = in[i + k] >> 4, lo = in[i + k] & 15;
+            o[2 * k] = (char)(hi + '0' + (hi > 9 ? 'a' - '0' - 10 : 0));
+            o[2 * k + 1] = (char)(lo + '0' + (lo > 9 ? 'a' - '0' - 10 : 0));
+        }
+    }
+    return i;
+}
+
+static size_t hex_decode_vector(const unsigned char *in, size_t length, unsigned char *out) {
+    size_t i = 0;
+    for (; i + 64 <= length; i += 64) {
+        unsigned char v[64];
+        unsigned char invalid = 0;
+        for (int k = 0; k < 64; k++) {
+            unsigned char c = in[i + k];
+            unsigned char digit = (unsigned char)(c - '0'), letter = (unsigned char)((c | 0x20) - 'a');
+            v[k] = digit < 10 ? digit : (unsigned char)(letter + 10);
+            invalid |= digit >= 10 && letter >= 6;
+        }
+        if (invalid) break;
+        for (int k = 0; k < 32; k++) out[i / 2 + k] = (unsigned char)(v[2 * k] << 4 | v[2 * k + 1]);
+    }
+    return i;
+}
+
+#endif
+
+size_t base64_encode(const void *data, size_t length, char *out, Base64Alphabet alphabet) {
+    REGION_SCOPE(REGION_BASE64_ENCODE);
+    if (!data || !out) return 0;
+    const unsigned char *in = data;
+    const char *chars = base64_chars[alphabet];
+    size_t done = encode_vector(in, length, out, chars[62], chars[63]);
+    return done / 3 * 4 + encode_scalar(in + done, length - done, out + done / 3 * 4, alphabet);
+}
+
+int base64_decode(const char *text, size_t length, void *out, size_t *decoded, Base64Alphabet alphabet) {
+    REGION_SCOPE(REGION_BASE64_DECODE);
+    size_t body;
+    if (!text || !out || base64_body(text, length, &body) != 0) return -1;
+    const unsigned char *in = (const unsigned char *)text;
+    unsigned char *bytes = out;
+    const char *chars = base64_chars[alphabet];
+    // The vector loop stops at the first invalid block; the scalar pass reports it
+    size_t done = decode_vector(in, body, bytes, chars[62], chars[63]);
+    if (decode_scalar(in + done, body - done, bytes + done / 4 * 3, alphabet) != 0) return -1;
+    if (decoded) *decoded = base64_decoded_size(body);
+    return 0;
+}
+
+size_t hex_encode_scalar(const void *data, size_t length, char *out) {
+    if (!data || !out) return 0;
+    const unsigned char *in = data;
+    for (size_t i = 0; i < length; i++) {
+        out[2 * i] = hex_chars[in[i] >> 4];
+        out[2 * i + 1] = hex_chars[in[i] & 15];
+    }
+    return 2 * length;
+}
+
+int hex_decode_scalar(const char *text, size_t length, void *out) {
+    if (!text || !out || length % 2) return -1;
+    unsigned char *bytes = out;
+    int invalid = 0;
+    for (size_t i = 0; i < length; i += 2) {
+        int hi = hex_values[(unsigned char)text[i]], lo = hex_values[(unsigned char)text[i + 1]];
+        invalid |= hi | lo;
+        bytes[i / 2] = (unsigned char)((unsigned)hi << 4 | (unsigned)lo);
+    }
+    return invalid < 0 ? -1 : 0;
+}
+
+size_t hex_encode(const void *data, size_t length, char *out) {
+    REGION_SCOPE(REGION_HEX_ENCODE);
+    if (!data || !out) return 0;
+    size_t done = hex_encode_vector(data, length, out);
+    hex_encode_scalar((const unsigned char *)data + done, length - done, out + 2 * done);
+    return 2 * length;
+}
+
+int hex_decode(const char *text, size_t length, void *out) {
+    REGION_SCOPE(REGION_HEX_DECODE);
+    if (!text || !out || length % 2) return -1;
+    size_t done = hex_decode_vector((const unsigned char *)text, length, out);
+    return hex_decode_scalar(text + done, length - done, (unsigned char *)out + done / 2);
+}
+
+static void fill_random_bytes(unsigned char *data, size_t size, unsigned seed) {
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (unsigned char)(seed >> 16);
+    }
+}
+
+void compare_codec_algorithms(size_t size) {
+    unsigned char *data = malloc(size);
+    unsigned char *decoded = malloc(size + 64);
+    char *text = malloc(base64_encoded_length(size, BASE64_STANDARD) + 2 * size);
+    char *reference = malloc(base64_encoded_length(size, BASE64_STANDARD) + 2 * size);
+    if (!data || !decoded || !text || !reference) {
+        printf("Failed to allocate buffers for codec comparison\n");
+        free(data);
+        free(decoded);
+        free(text);
+        free(reference);
+        return;
+    }
+    fill_random_bytes(data, size, 42);
+
+    printf("Base64 and Hex Codecs [%zu bytes]\n", size);
+    printf("=========================================\n");
+
+    const int iterations = 20;
+    Timer timer;
+    double ms[2];
+    size_t length = 0, reference_length = 0, bytes = 0;
+    int ok = 1;
+
+    for (int alphabet = BASE64_STANDARD; alphabet <= BASE64_URL; alphabet++) {
+        const char *name = alphabet == BASE64_STANDARD ? "base64" : "base64url";
+        timer_start(&timer);
+        for (int it = 0; it < iterations; it++) {
+            reference_length = base64_encode_scalar(data, size, reference, (Base64Alphabet)alphabet);
+        }
+        timer_stop(&timer);
+        ms[0] = timer_elapsed_ms(&timer) / iterations;
+        timer_start(&timer);
+        for (int it = 0; it < iterations; it++) length = base64_encode(data, size, text, (Base64Alphabet)alphabet);
+        timer_stop(&timer);
+        ms[1] = timer_elapsed_ms(&timer) / iterations;
+        ok = ok && length == reference_length && memcmp(text, reference, length) == 0;
+        printf("%-9s encode: scalar %6.2f GB/s, vector %6.2f GB/s (%.1fx)\n", name,
+               size / 1e6 / ms[0], size / 1e6 / ms[1], ms[0] / ms[1]);
+
+        timer_start(&timer);
+        for (int it = 0; it < iterations; it++) {
+            ok = ok && base64_decode_scalar(text, length, decoded, &bytes, (Base64Alphabet)alphabet) == 0;
+        }
+        timer_stop(&timer);
+        ms[0] = timer_elapsed_ms(&timer) / iterations;
+        ok = ok && bytes == size && memcmp(decoded, data, size) == 0;
+        memset(decoded, 0, size);
+        timer_start(&timer);
+        for (int it = 0; it < iterations; it++) {
+            ok = ok && base64_decode(text, length, decoded, &bytes, (Base64Alphabet)alphabet) == 0;
+        }
+        timer_stop(&timer);
+        ms[1] = timer_elapsed_ms(&timer) / iterations;
+        ok = ok && bytes == size && memcmp(decoded, data, size) == 0;
+        printf("%-9s decode: scalar %6.2f GB/s, vector %6.2f GB/s (%.1fx)\n", name,
+               size / 1e6 / ms[0], size / 1e6 / ms[1], ms[0] / ms[1]);
+    }
+
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) hex_encode_scalar(data, size, reference);
+    timer_stop(&timer);
+    ms[0] = timer_elapsed_ms(&timer) / iterations;
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) hex_encode(data, size, text);
+    timer_stop(&timer);
+    ms[1] = timer_elapsed_ms(&timer) / iterations;
+    ok = ok && memcmp(text, reference, 2 * size) == 0;
+    printf("hex       encode: scalar %6.2f GB/s, vector %6.2f GB/s (%.1fx)\n",
+           size / 1e6 / ms[0], size / 1e6 / ms[1], ms[0] / ms[1]);
+
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) ok = ok && hex_decode_scalar(text, 2 * size, decoded) == 0;
+    timer_stop(&timer);
+    ms[0] = timer_elapsed_ms(&timer) / iterations;
+    memset(decoded, 0, size);
+    timer_start(&timer);
+    for (int it = 0; it < iterations; it++) ok = ok && hex_decode(text, 2 * size, decoded) == 0;
+    timer_stop(&timer);
+    ms[1] = timer_elapsed_ms(&timer) / iterations;
+    ok = ok && memcmp(decoded, data, size) == 0;
+    printf("hex       decode: scalar %6.2f GB/s, vector %6.2f GB/s (%.1fx)\n",
+           size / 1e6 / ms[0], size / 1e6 / ms[1], ms[0] / ms[1]);
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    free(data);
+    free(decoded);
+    free(text);
+    free(reference);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    unsigned char *data;
+    unsigned char *decoded;
+    char *base64;
+    char *hex;
+    size_t base64_length;
+} CodecBenchState;
+
+static void *codec_bench_setup(const BenchmarkParams *params) {
+    CodecBenchState *state = calloc(1, sizeof(CodecBenchState));
+    if (!state) return NULL;
+    state->data = malloc(params->size);
+    state->decoded = malloc(base64_decoded_max(base64_encoded_length(params->size, BASE64_STANDARD)));
+    state->base64 = malloc(base64_encoded_length(params->size, BASE64_STANDARD));
+    state->hex = malloc(2 * params->size);
+    if (!state->data || !state->decoded || !state->base64 || !state->hex) {
+        free(state->data);
+        free(state->decoded);
+        free(state->base64);
+        free(state->hex);
+        free(state);
+        return NULL;
+    }
+    fill_random_bytes(state->data, params->size, 7);
+    state->base64_length = base64_encode(state->data, params->size, state->base64, BASE64_STANDARD);
+    hex_encode(state->data, params->size, state->hex);
+    return state;
+}
+
+static void codec_bench_teardown(void *p) {
+    CodecBenchState *state = p;
+    free(state->data);
+    free(state->decoded);
+    free(state->base64);
+    free(state->hex);
+    free(state);
+}
+
+static double bench_base64_encode_scalar(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    return (double)base64_encode_scalar(state->data, params->size, state->base64, BASE64_STANDARD);
+}
+
+static double bench_base64_encode(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    return (double)base64_encode(state->data, params->size, state->base64, BASE64_STANDARD);
+}
+
+static double bench_base64_decode_scalar(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    size_t bytes = 0;
+    (void)params;
+    base64_decode_scalar(state->base64, state->base64_length, state->decoded, &bytes, BASE64_STANDARD);
+    return (double)bytes;
+}
+
+static double bench_base64_decode(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    size_t bytes = 0;
+    (void)params;
+    base64_decode(state->base64, state->base64_length, state->decoded, &bytes, BASE64_STANDARD);
+    return (double)bytes;
+}
+
+static double bench_hex_encode_scalar(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    return (double)hex_encode_scalar(state->data, params->size, state->hex);
+}
+
+static double bench_hex_encode(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    return (double)hex_encode(state->data, params->size, state->hex);
+}
+
+static double bench_hex_decode_scalar(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    return (double)hex_decode_scalar(state->hex, 2 * params->size, state->decoded);
+}
+
+static double bench_hex_decode(void *p, const BenchmarkParams *params) {
+    CodecBenchState *state = p;
+    return (double)hex_decode(state->hex, 2 * params->size, state->decoded);
+}
+
+static const BenchmarkParams codec_sizes[] = { {1 << 20, 0, 0} };
+
+BENCHMARK_REGISTER(string_base64_encode_scalar, "string/base64_encode_scalar", codec_bench_setup, bench_base64_encode_scalar, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_base64_encode, "string/base64_encode", codec_bench_setup, bench_base64_encode, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_base64_decode_scalar, "string/base64_decode_scalar", codec_bench_setup, bench_base64_decode_scalar, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_base64_decode, "string/base64_decode", codec_bench_setup, bench_base64_decode, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_hex_encode_scalar, "string/hex_encode_scalar", codec_bench_setup, bench_hex_encode_scalar, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_hex_encode, "string/hex_encode", codec_bench_setup, bench_hex_encode, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_hex_decode_scalar, "string/hex_decode_scalar", codec_bench_setup, bench_hex_decode_scalar, codec_bench_teardown, codec_sizes)
+BENCHMARK_REGISTER(string_hex_decode, "string/hex_decode", codec_bench_setup, bench_hex_decode, codec_bench_teardown, codec_sizes)
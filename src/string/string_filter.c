@@ -0,0 +1,591 @@
+#define _POSIX_C_SOURCE 200112L
+#include "string_filter.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "memory_hints.h"
+#include "region_marker.h"
+#include "string_map.h"
+#include "string_ops.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#define BLOOM_BLOCK_WORDS       8       /* 64-byte block */
+#define BLOOM_BLOCK_BYTES       64
+#define CUCKOO_BUCKET_SLOTS     4
+#define CUCKOO_LOAD_FACTOR      0.95
+#define CUCKOO_MAX_KICKS        500
+#define KEYSET_MAX_WINDOW       8
+#define KEYSET_BLOOM_BITS       12.0
+#define KEYSET_BATCH            16      /* positions hashed and prefetched together */
+#define KEYSET_NONE             SIZE_MAX
+
+/* Odd multipliers, one per block word (as in split block Bloom filters) */
+static const uint32_t bloom_salts[BLOOM_BLOCK_WORDS] = {
+    0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+    0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+};
+
+static inline size_t bloom_block(const BloomFilter *filter, uint64_t hash) {
+    return (size_t)(((hash >> 32) * (uint64_t)filter->block_count) >> 32);
+}
+
+int bloom_filter_init(BloomFilter *filter, size_t keys, double bits_per_key) {
+    if (!filter) return -1;
+    memset(filter, 0, sizeof(*filter));
+    if (bits_per_key <= 0.0) return -1;
+    double bits = (double)(keys ? keys : 1) * bits_per_key;
+    size_t block_count = (size_t)(bits / (BLOOM_BLOCK_BYTES * 8)) + 1;
+    void *p = NULL;
+    if (posix_memalign(&p, BLOOM_BLOCK_BYTES, block_count * BLOOM_BLOCK_BYTES) != 0) return -1;
+    memset(p, 0, block_count * BLOOM_BLOCK_BYTES);
+    filter->blocks = p;
+    filter->block_count = block_count;
+    return 0;
+}
+
+void bloom_filter_free(BloomFilter *filter) {
+    if (!filter) return;
+    free(filter->blocks);
+    filter->blocks = NULL;
+    filter->block_count = 0;
+}
+
+void bloom_filter_add(BloomFilter *filter, uint64_t hash) {
+    uint64_t *block = filter->blocks + bloom_block(filter, hash) * BLOOM_BLOCK_WORDS;
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        block[i] |= 1ULL << (((uint32_t)hash * bloom_salts[i]) >> 26);
+    }
+}
+
+int bloom_filter_contains(const BloomFilter *filter, uint64_t hash) {
+    const uint64_t *block = filter->blocks + bloom_block(filter, hash) * BLOOM_BLOCK_WORDS;
+#if defined(__AVX2__)
+    // Eight bit positions at once, widened to one 64-bit lane per block word
+    __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)(uint32_t)hash),
+                                                        _mm256_loadu_si256((const __m256i *)bloom_salts)), 26);
+    const __m256i one = _mm256_set1_epi64x(1);
+    __m256i lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bits)));
+    __m256i hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bits, 1)));
+    return _mm256_testc_si256(_mm256_load_si256((const __m256i *)block), lo) &
+           _mm256_testc_si256(_mm256_load_si256((const __m256i *)(block + 4)), hi);
+#else
+    uint64_t missing = 0;
+    for (int i = 0; i < BLOOM_BLOCK_WORDS; i++) {
+        missing |= ~block[i] & (1ULL << (((uint32_t)hash * bloom_salts[i]) >> 26));
+    }
+    return missing == 0;
+#endif
+}
+
+#define CUCKOO_LANES_LOW    0x0001000100010001ULL
+#define CUCKOO_LANES_HIGH   0x8000800080008000ULL
+
+static inline uint16_t cuckoo_fingerprint(uint64_t hash) {
+    uint16_t fingerprint = (uint16_t)(hash >> 48);
+    return fingerprint ? fingerprint : 1;
+}
+
+static inline size_t cuckoo_bucket(const CuckooFilter *filter, uint64_t hash) {
+    return (size_t)(((uint64_t)(uint32_t)hash * filter->bucket_count) >> 32);
+}
+
+/* (c(fingerprint) - bucket) mod bucket_count: applying it twice returns the original bucket */
+static inline size_t cuckoo_alternate(const CuckooFilter *filter, size_t bucket, uint16_t fingerprint) {
+    size_t c = (size_t)(((uint64_t)(uint32_t)(fingerprint * 0x5bd1e995u) * filter->bucket_count) >> 32);
+    return c >= bucket ? c - bucket : c + filter->bucket_count - bucket;
+}
+
+/* High bit of every 16-bit lane that is zero (exact for the lowest such lane) */
+static inline uint64_t cuckoo_zero_lanes(uint64_t word) {
+    return (word - CUCKOO_LANES_LOW) & ~word & CUCKOO_LANES_HIGH;
+}
+
+static inline int cuckoo_bucket_has(uint64_t word, uint16_t fingerprint) {
+    return cuckoo_zero_lanes(word ^ (fingerprint * CUCKOO_LANES_LOW)) != 0;
+}
+
+static int cuckoo_bucket_put(CuckooFilter *filter, size_t bucket, uint16_t fingerprint) {
+    uint64_t word = filter->buckets[bucket];
+    uint64_t empty = cuckoo_zero_lanes(word);
+    if (!empty) return 0;
+    int shift = bit_ctz64(empty) - 15;
+    filter->buckets[bucket] = word | (uint64_t)fingerprint << shift;
+    return 1;
+}
+
+int cuckoo_filter_init(CuckooFilter *filter, size_t keys) {
+    if (!filter) return -1;
+    memset(filter, 0, sizeof(*filter));
+    size_t bucket_count = (size_t)((double)keys / (CUCKOO_BUCKET_SLOTS * CUCKOO_LOAD_FACTOR)) + 1;
+    filter->buckets = calloc(bucket_count, sizeof(uint64_t));
+    if (!filter->buckets) return -1;
+    filter->bucket_count = bucket_count;
+    return 0;
+}
+
+void cuckoo_filter_free(CuckooFilter *filter) {
+    if (!filter) return;
+    free(filter->buckets);
+    memset(filter, 0, sizeof(*filter));
+}
+
+int cuckoo_filter_add(CuckooFilter *filter, uint64_t hash) {
+    if (filter->victim) return -1;
+    uint16_t fingerprint = cuckoo_fingerprint(hash);
+    size_t bucket = cuckoo_bucket(filter, hash);
+    size_t other = cuckoo_alternate(filter, bucket, fingerprint);
+    if (cuckoo_bucket_put(filter, bucket, fingerprint) || cuckoo_bucket_put(filter, other, fingerprint)) {
+        filter->count++;
+        return 0;
+    }
+
+    // Both buckets full: evict residents along their alternate buckets
+    uint32_t state = (uint32_t)hash | 1;
+    bucket = (hash >> 40) & 1 ? other : bucket;
+    for (int kick = 0; kick < CUCKOO_MAX_KICKS; kick++) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        int shift = (int)(state & 3) * 16;
+        uint16_t evicted = (uint16_t)(filter->buckets[bucket] >> shift);
+        filter->buckets[bucket] = (filter->buckets[bucket] & ~(0xFFFFULL << shift)) | (uint64_t)fingerprint << shift;
+        fingerprint = evicted;
+        bucket = cuckoo_alternate(filter, bucket, fingerprint);
+        if (cuckoo_bucket_put(filter, bucket, fingerprint)) {
+            filter->count++;
+            return 0;
+        }
+    }
+
+    // The new key is stored; the last evicted fingerprint waits in the victim slot
+    filter->victim = fingerprint;
+    filter->victim_bucket = bucket;
+    filter->count++;
+    return -1;
+}
+
+int cuckoo_filter_contains(const CuckooFilter *filter, uint64_t hash) {
+    uint16_t fingerprint = cuckoo_fingerprint(hash);
+    size_t bucket = cuckoo_bucket(filter, hash);
+    size_t other = cuckoo_alternate(filter, bucket, fingerprint);
+    if (cuckoo_bucket_has(filter->buckets[bucket], fingerprint) ||
+        cuckoo_bucket_has(filter->buckets[other], fingerprint)) {
+        return 1;
+    }
+    return filter->victim == fingerprint && (filter->victim_bucket == bucket || filter->victim_bucket == other);
+}
+
+static int cuckoo_bucket_remove(CuckooFilter *filter, size_t bucket, uint16_t fingerprint) {
+    uint64_t match = cuckoo_zero_lanes(filter->buckets[bucket] ^ (fingerprint * CUCKOO_LANES_LOW));
+    if (!match) return 0;
+    int shift = bit_ctz64(match) - 15;
+    filter->buckets[bucket] &= ~(0xFFFFULL << shift);
+    return 1;
+}
+
+int cuckoo_filter_remove(CuckooFilter *filter, uint64_t hash) {
+    uint16_t fingerprint = cuckoo_fingerprint(hash);
+    size_t bucket = cuckoo_bucket(filter, hash);
+    size_t other = cuckoo_alternate(filter, bucket, fingerprint);
+    if (filter->victim == fingerprint && (filter->victim_bucket == bucket || filter->victim_bucket == other)) {
+        filter->victim = 0;
+        filter->count--;
+        return 1;
+    }
+    if (!cuckoo_bucket_remove(filter, bucket, fingerprint) && !cuckoo_bucket_remove(filter, other, fingerprint)) {
+        return 0;
+    }
+    filter->count--;
+
+    // A freed slot may take the victim back
+    if (filter->victim) {
+        size_t victim_other = cuckoo_alternate(filter, filter->victim_bucket, filter->victim);
+        if (cuckoo_bucket_put(filter, filter->victim_bucket, filter->victim) ||
+            cuckoo_bucket_put(filter, victim_other, filter->victim)) {
+            filter->victim = 0;
+        }
+    }
+    return 1;
+}
+
+struct StringKeySet {
+    size_t window;              /* bytes hashed per text position */
+    uint64_t window_mask;
+    size_t count;
+    char *key_bytes;            /* all keys back to back */
+    size_t *key_offsets;
+    size_t *key_lengths;
+    size_t *next;               /* next key with the same prefix, KEYSET_NONE at the end */
+    StringMap *prefixes;        /* window-byte prefix -> first key index + 1 */
+    StringPrefilter prefilter;
+    BloomFilter bloom;
+    CuckooFilter cuckoo;
+};
+
+/* Two multiply-xorshift rounds over the window bytes (little-endian word) */
+static inline uint64_t window_hash(uint64_t word) {
+    word *= 0x9e3779b97f4a7c15ULL;
+    word ^= word >> 32;
+    word *= 0xd6e8feb86659fd93ULL;
+    word ^= word >> 32;
+    return word;
+}
+
+static inline uint64_t window_word(const char *p, size_t window) {
+    uint64_t word = 0;
+    memcpy(&word, p, window);
+    return word;
+}
+
+StringKeySet* string_key_set_create(const char *const *keys, const size_t *lengths, size_t count,
+                                    StringPrefilter prefilter) {
+    if (!keys || !lengths || count == 0) return NULL;
+    size_t total = 0, window = KEYSET_MAX_WINDOW;
+    for (size_t i = 0; i < count; i++) {
+        if (!keys[i] || lengths[i] == 0) return NULL;
+        if (lengths[i] < window) window = lengths[i];
+        total += lengths[i];
+    }
+
+    StringKeySet *set = calloc(1, sizeof(StringKeySet));
+    if (!set) return NULL;
+    set->window = window;
+    set->window_mask = window == 8 ? ~0ULL : (1ULL << (8 * window)) - 1;
+    set->count = count;
+    set->prefilter = prefilter;
+    set->key_bytes = malloc(total);
+    set->key_offsets = malloc(count * sizeof(size_t));
+    set->key_lengths = malloc(count * sizeof(size_t));
+    set->next = malloc(count * sizeof(size_t));
+    set->prefixes = string_map_create(count);
+    int ok = set->key_bytes && set->key_offsets && set->key_lengths && set->next && set->prefixes;
+    if (ok && prefilter == STRING_PREFILTER_BLOOM) ok = bloom_filter_init(&set->bloom, count, KEYSET_BLOOM_BITS) == 0;
+    if (ok && prefilter == STRING_PREFILTER_CUCKOO) ok = cuckoo_filter_init(&set->cuckoo, count) == 0;
+
+    size_t offset = 0;
+    for (size_t i = 0; ok && i < count; i++) {
+        memcpy(set->key_bytes + offset, keys[i], lengths[i]);
+        set->key_offsets[i] = offset;
+        set->key_lengths[i] = lengths[i];
+        offset += lengths[i];
+    }
+
+    // Insert in reverse so every prefix chain lists keys in the order given
+    for (size_t i = count; ok && i-- > 0;) {
+        const char *key = set->key_bytes + set->key_offsets[i];
+        uint64_t *head = string_map_upsert(set->prefixes, key, window);
+        if (!head) {
+            ok = 0;
+            break;
+        }
+        int fresh = *head == 0;
+        set->next[i] = fresh ? KEYSET_NONE : (size_t)*head - 1;
+        *head = i + 1;
+        if (!fresh) continue;
+        uint64_t hash = window_hash(window_word(key, window));
+        if (prefilter == STRING_PREFILTER_BLOOM) bloom_filter_add(&set->bloom, hash);
+        if (prefilter == STRING_PREFILTER_CUCKOO) cuckoo_filter_add(&set->cuckoo, hash);
+    }
+
+    // A full cuckoo table would drop prefixes: fall back to exact lookups rather than miss matches
+    if (ok && prefilter == STRING_PREFILTER_CUCKOO && set->cuckoo.victim) {
+        cuckoo_filter_free(&set->cuckoo);
+        set->prefilter = STRING_PREFILTER_NONE;
+    }
+    if (!ok) {
+        string_key_set_destroy(set);
+        return NULL;
+    }
+    return set;
+}
+
+void string_key_set_destroy(StringKeySet *set) {
+    if (!set) return;
+    free(set->key_bytes);
+    free(set->key_offsets);
+    free(set->key_lengths);
+    free(set->next);
+    if (set->prefixes) string_map_destroy(set->prefixes);
+    bloom_filter_free(&set->bloom);
+    cuckoo_filter_free(&set->cuckoo);
+    free(set);
+}
+
+size_t string_key_set_filter_bytes(const StringKeySet *set) {
+    if (!set) return 0;
+    if (set->prefilter == STRING_PREFILTER_BLOOM) return set->bloom.block_count * BLOOM_BLOCK_BYTES;
+    if (set->prefilter == STRING_PREFILTER_CUCKOO) return set->cuckoo.bucket_count * sizeof(uint64_t);
+    return 0;
+}
+
+/* Keys starting at text + pos; with first_only, stop at the first and store its index */
+static inline size_t verify_position(const StringKeySet *set, const char *text, size_t length, size_t pos,
+                                     int first_only, size_t *key) {
+    const uint64_t *head = string_map_find(set->prefixes, text + pos, set->window);
+    if (!head) return 0;
+    size_t matches = 0;
+    for (size_t k = (size_t)*head - 1; k != KEYSET_NONE; k = set->next[k]) {
+        size_t key_length = set->key_lengths[k];
+        if (key_length <= length - pos &&
+            string_bytes_equal(text + pos, set->key_bytes + set->key_offsets[k], key_length)) {
+            if (first_only) {
+                *key = k;
+                return 1;
+            }
+            matches++;
+        }
+    }
+    return matches;
+}
+
+static inline int prefilter_pass(const StringKeySet *set, StringPrefilter prefilter, uint64_t hash) {
+    if (prefilter == STRING_PREFILTER_BLOOM) return bloom_filter_contains(&set->bloom, hash);
+    if (prefilter == STRING_PREFILTER_CUCKOO) return cuckoo_filter_contains(&set->cuckoo, hash);
+    return 1;
+}
+
+static inline void prefilter_prefetch(const StringKeySet *set, StringPrefilter prefilter, uint64_t hash) {
+    if (prefilter == STRING_PREFILTER_BLOOM) {
+        PREFETCH_READ(set->bloom.blocks + bloom_block(&set->bloom, hash) * BLOOM_BLOCK_WORDS);
+    } else if (prefilter == STRING_PREFILTER_CUCKOO) {
+        size_t bucket = cuckoo_bucket(&set->cuckoo, hash);
+        PREFETCH_READ(set->cuckoo.buckets + bucket);
+        PREFETCH_READ(set->cuckoo.buckets + cuckoo_alternate(&set->cuckoo, bucket, cuckoo_fingerprint(hash)));
+    }
+}
+
+/*
+ * Shared scan loop, specialised per prefilter by the constant argument.
+ * Returns the match count; with first_only, stops at the first match and
+ * stores its position and key.
+ */
+static inline size_t scan_text(const StringKeySet *set, StringPrefilter prefilter, const char *text, size_t length,
+                               int first_only, size_t *first_pos, size_t *key, size_t *candidates) {
+    REGION_SCOPE(REGION_KEY_SET_SCAN);
+    const size_t window = set->window;
+    size_t matches = 0, passed = 0, pos = 0;
+    if (length < window) {
+        if (candidates) *candidates = 0;
+        return 0;
+    }
+    size_t last = length - window;
+
+    // Filter probes miss the cache at random: hash and prefetch a batch before testing it
+    if (prefilter != STRING_PREFILTER_NONE) {
+        uint64_t hashes[KEYSET_BATCH];
+        for (; pos + KEYSET_BATCH + 7 <= length; pos += KEYSET_BATCH) {
+            for (int i = 0; i < KEYSET_BATCH; i++) {
+                hashes[i] = window_hash(bit_load64(text + pos + i) & set->window_mask);
+                prefilter_prefetch(set, prefilter, hashes[i]);
+            }
+            for (int i = 0; i < KEYSET_BATCH; i++) {
+                if (!prefilter_pass(set, prefilter, hashes[i])) continue;
+                passed++;
+                size_t found = verify_position(set, text, length, pos + i, first_only, key);
+                if (found && first_only) {
+                    *first_pos = pos + i;
+                    if (candidates) *candidates = passed;
+                    return 1;
+                }
+                matches += found;
+            }
+        }
+    }
+
+    // Remaining positions one at a time, with exact-width loads near the end
+    for (; pos <= last; pos++) {
+        if (prefilter != STRING_PREFILTER_NONE) {
+            uint64_t word = pos + 8 <= length ? bit_load64(text + pos) & set->window_mask
+                                              : window_word(text + pos, window);
+            if (!prefilter_pass(set, prefilter, window_hash(word))) continue;
+        }
+        passed++;
+        size_t found = verify_position(set, text, length, pos, first_only, key);
+        if (found && first_only) {
+            *first_pos = pos;
+            matches = 1;
+            break;
+        }
+        matches += found;
+    }
+    if (candidates) *candidates = passed;
+    return matches;
+}
+
+static size_t scan_dispatch(const StringKeySet *set, const char *text, size_t length, int first_only,
+                            size_t *first_pos, size_t *key, size_t *candidates) {
+    switch (set->prefilter) {
+    case STRING_PREFILTER_BLOOM:
+        return scan_text(set, STRING_PREFILTER_BLOOM, text, length, first_only, first_pos, key, candidates);
+    case STRING_PREFILTER_CUCKOO:
+        return scan_text(set, STRING_PREFILTER_CUCKOO, text, length, first_only, first_pos, key, candidates);
+    default:
+        return scan_text(set, STRING_PREFILTER_NONE, text, length, first_only, first_pos, key, candidates);
+    }
+}
+
+const char* string_key_set_find(const StringKeySet *set, const char *text, size_t length, size_t *key) {
+    if (!set || !text) return NULL;
+    size_t pos = 0, index = 0;
+    if (!scan_dispatch(set, text, length, 1, &pos, &index, NULL)) return NULL;
+    if (key) *key = index;
+    return text + pos;
+}
+
+size_t string_key_set_count(const StringKeySet *set, const char *text, size_t length, size_t *candidates) {
+    if (!set || !text) {
+        if (candidates) *candidates = 0;
+        return 0;
+    }
+    size_t pos = 0, index = 0;
+    return scan_dispatch(set, text, length, 0, &pos, &index, candidates);
+}
+
+/* Random lowercase keys of 12-20 bytes in one buffer; text of lowercase noise with planted keys */
+typedef struct {
+    char *bytes;
+    const char **keys;
+    size_t *lengths;
+    char *text;
+    size_t planted;
+} KeyWorkload;
+
+static void workload_free(KeyWorkload *w) {
+    free(w->bytes);
+    free(w->keys);
+    free(w->lengths);
+    free(w->text);
+}
+
+static int workload_init(KeyWorkload *w, size_t keys, size_t text_size, unsigned seed) {
+    memset(w, 0, sizeof(*w));
+    w->bytes = malloc(keys * 20);
+    w->keys = malloc(keys * sizeof(char *));
+    w->lengths = malloc(keys * sizeof(size_t));
+    w->text = malloc(text_size);
+    if (!w->bytes || !w->keys || !w->lengths || !w->text) {
+        workload_free(w);
+        return -1;
+    }
+    for (size_t i = 0; i < keys; i++) {
+        seed = seed * 1103515245u + 12345u;
+        w->lengths[i] = 12 + (seed >> 16) % 9;
+        w->keys[i] = w->bytes + i * 20;
+        for (size_t j = 0; j < w->lengths[i]; j++) {
+            seed = seed * 1103515245u + 12345u;
+            w->bytes[i * 20 + j] = (char)('a' + (seed >> 16) % 26);
+        }
+    }
+    for (size_t i = 0; i < text_size; i++) {
+        seed = seed * 1103515245u + 12345u;
+        w->text[i] = (char)('a' + (seed >> 16) % 26);
+    }
+    // One key every 64 KiB, never overlapping
+    for (size_t pos = 1000; pos + 20 < text_size; pos += 65536) {
+        seed = seed * 1103515245u + 12345u;
+        size_t k = (seed >> 8) % keys;
+        memcpy(w->text + pos, w->keys[k], w->lengths[k]);
+        w->planted++;
+    }
+    return 0;
+}
+
+void compare_prefilter_algorithms(size_t keys, size_t text_size) {
+    KeyWorkload w;
+    if (keys == 0 || workload_init(&w, keys, text_size, 42) != 0) {
+        printf("Failed to allocate buffers for prefilter comparison\n");
+        return;
+    }
+
+    printf("Key Set Scan with Prefilters [%zu keys, %zu bytes of text]\n", keys, text_size);
+    printf("=========================================\n");
+
+    struct { const char *name; StringPrefilter prefilter; } modes[] = {
+        { "Exact table only", STRING_PREFILTER_NONE },
+        { "Blocked Bloom", STRING_PREFILTER_BLOOM },
+        { "Cuckoo", STRING_PREFILTER_CUCKOO },
+    };
+    size_t expected = 0;
+    int ok = 1;
+    Timer timer;
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        StringKeySet *set = string_key_set_create(w.keys, w.lengths, keys, modes[m].prefilter);
+        if (!set) {
+            ok = 0;
+            continue;
+        }
+        size_t candidates = 0;
+        timer_start(&timer);
+        size_t matches = string_key_set_count(set, w.text, text_size, &candidates);
+        timer_stop(&timer);
+        double ms = timer_elapsed_ms(&timer);
+        if (m == 0) expected = matches;
+        ok = ok && matches == expected && matches >= w.planted;
+        printf("%-18s %8.2f ms (%5.2f GB/s), %zu matches, %.3f%% of positions looked up, filter %.2f MB\n",
+               modes[m].name, ms, text_size / 1e6 / ms, matches, 100.0 * candidates / text_size,
+               string_key_set_filter_bytes(set) / 1e6);
+        string_key_set_destroy(set);
+    }
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+    workload_free(&w);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+#define KEYSET_BENCH_KEYS (1 << 20)
+
+typedef struct {
+    KeyWorkload workload;
+    StringKeySet *set;
+} KeySetBenchState;
+
+static void *key_set_bench_setup(const BenchmarkParams *params, StringPrefilter prefilter) {
+    KeySetBenchState *state = calloc(1, sizeof(KeySetBenchState));
+    if (!state) return NULL;
+    if (workload_init(&state->workload, KEYSET_BENCH_KEYS, params->size, 7) != 0) {
+        free(state);
+        return NULL;
+    }
+    state->set = string_key_set_create(state->workload.keys, state->workload.lengths, KEYSET_BENCH_KEYS, prefilter);
+    if (!state->set) {
+        workload_free(&state->workload);
+        free(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void *key_set_exact_setup(const BenchmarkParams *params) {
+    return key_set_bench_setup(params, STRING_PREFILTER_NONE);
+}
+
+static void *key_set_bloom_setup(const BenchmarkParams *params) {
+    return key_set_bench_setup(params, STRING_PREFILTER_BLOOM);
+}
+
+static void *key_set_cuckoo_setup(const BenchmarkParams *params) {
+    return key_set_bench_setup(params, STRING_PREFILTER_CUCKOO);
+}
+
+static void key_set_bench_teardown(void *p) {
+    KeySetBenchState *state = p;
+    string_key_set_destroy(state->set);
+    workload_free(&state->workload);
+    free(state);
+}
+
+static double bench_key_set_count(void *p, const BenchmarkParams *params) {
+    KeySetBenchState *state = p;
+    return (double)string_key_set_count(state->set, state->workload.text, params->size, NULL);
+}
+
+static const BenchmarkParams key_set_sizes[] = { {1 << 24, 0, 0} };
+
+BENCHMARK_REGISTER(string_keyset_exact, "string/keyset_exact", key_set_exact_setup, bench_key_set_count, key_set_bench_teardown, key_set_sizes)
+BENCHMARK_REGISTER(string_keyset_bloom, "string/keyset_bloom", key_set_bloom_setup, bench_key_set_count, key_set_bench_teardown, key_set_sizes)
+BENCHMARK_REGISTER(string_keyset_cuckoo, "string/keyset_cuckoo", key_set_cuckoo_setup, bench_key_set_count, key_set_bench_teardown, key_set_sizes)
@@ -0,0 +1,548 @@
+#include "string_map.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "hash_ops.h"
+#include "region_marker.h"
+#include "string_ops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define MAP_GROUP 16
+#else
+#define MAP_GROUP 8
+#endif
+
+#define CTRL_EMPTY   0x80
+#define CTRL_DELETED 0xfe
+
+#define ARENA_CHUNK_SIZE (64 * 1024)
+
+/*
+ * Probing visits whole groups at group-aligned offsets, so control words
+ * are always aligned loads (malloc alignment is at least 16 on the
+ * supported targets) and no cloned tail bytes are needed. A lookup ends
+ * at the first group that still has an empty slot.
+ */
+
+struct StringArenaChunk {
+    StringArenaChunk *next;
+    size_t used;
+    size_t capacity;
+    char data[];
+};
+
+static const char* arena_copy(StringMap *map, const char *key, size_t length) {
+    StringArenaChunk *chunk = map->arena;
+    if (!chunk || chunk->capacity - chunk->used < length + 1) {
+        size_t capacity = length + 1 > ARENA_CHUNK_SIZE ? length + 1 : ARENA_CHUNK_SIZE;
+        chunk = malloc(sizeof(StringArenaChunk) + capacity);
+        if (!chunk) return NULL;
+        chunk->next = map->arena;
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        map->arena = chunk;
+    }
+
+    char *copy = chunk->data + chunk->used;
+    memcpy(copy, key, length);
+    copy[length] = '\0';
+    chunk->used += length + 1;
+    return copy;
+}
+
+/* Group scans: bit masks with one bit per matching slot */
+#if MAP_GROUP == 16
+typedef uint32_t GroupMask;
+
+static inline GroupMask group_match(const uint8_t *ctrl, uint8_t h2) {
+    __m128i group = _mm_load_si128((const __m128i *)ctrl);
+    return (GroupMask)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+static inline GroupMask group_match_empty(const uint8_t *ctrl) {
+    return group_match(ctrl, CTRL_EMPTY);
+}
+
+/* Empty and deleted both have the top bit set */
+static inline GroupMask group_match_free(const uint8_t *ctrl) {
+    return (GroupMask)_mm_movemask_epi8(_mm_load_si128((const __m128i *)ctrl));
+}
+
+static inline int group_first(GroupMask mask) {
+    return bit_ctz64(mask);
+}
+#else
+typedef uint64_t GroupMask;     /* one high bit per byte */
+
+static inline GroupMask group_match(const uint8_t *ctrl, uint8_t h2) {
+    return bit_match_bytes(bit_load64_aligned(ctrl), h2) & BIT_HIGHS;
+}
+
+static inline GroupMask group_match_empty(const uint8_t *ctrl) {
+    return group_match(ctrl, CTRL_EMPTY);
+}
+
+static inline GroupMask group_match_free(const uint8_t *ctrl) {
+    return bit_load64_aligned(ctrl) & BIT_HIGHS;
+}
+
+static inline int group_first(GroupMask mask) {
+    return bit_first_byte(mask);
+}
+#endif
+
+static inline uint8_t hash_h2(uint64_t hash) {
+    return (uint8_t)(hash & 0x7f);
+}
+
+static inline size_t hash_group(const StringMap *map, uint64_t hash) {
+    return (size_t)(hash >> 7) & (map->capacity / MAP_GROUP - 1);
+}
+
+static inline size_t max_load(size_t capacity) {
+    return capacity - capacity / 8;
+}
+
+static int map_allocate(StringMap *map, size_t capacity) {
+    uint8_t *ctrl = malloc(capacity);
+    StringMapEntry *entries = malloc(capacity * sizeof(StringMapEntry));
+    if (!ctrl || !entries) {
+        free(ctrl);
+        free(entries);
+        return -1;
+    }
+    memset(ctrl, CTRL_EMPTY, capacity);
+    map->ctrl = ctrl;
+    map->entries = entries;
+    map->capacity = capacity;
+    map->growth_left = max_load(capacity) - map->size;
+    return 0;
+}
+
+/* First empty or deleted slot on hash's probe sequence */
+static size_t find_free_slot(const StringMap *map, uint64_t hash) {
+    size_t group_mask = map->capacity / MAP_GROUP - 1;
+    size_t group = hash_group(map, hash);
+    for (size_t probe = 1;; probe++) {
+        const uint8_t *ctrl = map->ctrl + group * MAP_GROUP;
+        GroupMask free_slots = group_match_free(ctrl);
+        if (free_slots) return group * MAP_GROUP + group_first(free_slots);
+        group = (group + probe) & group_mask;       // triangular: visits every group
+    }
+}
+
+static int map_rehash(StringMap *map, size_t capacity) {
+    uint8_t *old_ctrl = map->ctrl;
+    StringMapEntry *old_entries = map->entries;
+    size_t old_capacity = map->capacity;
+
+    if (map_allocate(map, capacity) != 0) {
+        map->ctrl = old_ctrl;
+        map->entries = old_entries;
+        return -1;
+    }
+
+    // Stored hashes make this a pure move: no key is rehashed or compared
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] & 0x80) continue;
+        size_t slot = find_free_slot(map, old_entries[i].hash);
+        map->ctrl[slot] = old_ctrl[i];
+        map->entries[slot] = old_entries[i];
+    }
+
+    free(old_ctrl);
+    free(old_entries);
+    return 0;
+}
+
+StringMap* string_map_create(size_t capacity) {
+    StringMap *map = calloc(1, sizeof(StringMap));
+    if (!map) return NULL;
+
+    // Room for capacity keys at the maximum load factor
+    size_t slots = MAP_GROUP;
+    while (max_load(slots) < capacity) slots *= 2;
+
+    if (map_allocate(map, slots) != 0) {
+        free(map);
+        return NULL;
+    }
+    return map;
+}
+
+void string_map_destroy(StringMap *map) {
+    if (!map) return;
+
+    StringArenaChunk *chunk = map->arena;
+    while (chunk) {
+        StringArenaChunk *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(map->ctrl);
+    free(map->entries);
+    free(map);
+}
+
+/* Slot index holding key, or map->capacity */
+static size_t find_slot(const StringMap *map, const char *key, size_t length, uint64_t hash) {
+    uint8_t h2 = hash_h2(hash);
+    size_t group_mask = map->capacity / MAP_GROUP - 1;
+    size_t group = hash_group(map, hash);
+
+    for (size_t probe = 1;; probe++) {
+        const uint8_t *ctrl = map->ctrl + group * MAP_GROUP;
+        for (GroupMask match = group_match(ctrl, h2); match; match &= match - 1) {
+            size_t slot = group * MAP_GROUP + group_first(match);
+            const StringMapEntry *entry = &map->entries[slot];
+            if (entry->hash == hash && entry->length == length &&
+                memcmp(entry->key, key, length) == 0) {
+                return slot;
+            }
+        }
+        if (group_match_empty(ctrl)) return map->capacity;
+        group = (group + probe) & group_mask;
+    }
+}
+
+uint64_t* string_map_find(const StringMap *map, const char *key, size_t length) {
+    if (!map || (!key && length)) return NULL;
+
+    uint64_t hash = hash64(key, length, 0);
+    size_t slot = find_slot(map, key, length, hash);
+    return slot < map->capacity ? &map->entries[slot].value : NULL;
+}
+
+uint64_t* string_map_upsert(StringMap *map, const char *key, size_t length) {
+    REGION_SCOPE(REGION_STRING_MAP);
+    if (!map || (!key && length)) return NULL;
+
+    uint64_t hash = hash64(key, length, 0);
+    size_t slot = find_slot(map, key, length, hash);
+    if (slot < map->capacity) return &map->entries[slot].value;
+
+    slot = find_free_slot(map, hash);
+    if (map->ctrl[slot] == CTRL_EMPTY && map->growth_left == 0) {
+        // Mostly tombstones: rebuild at the same size instead of growing
+        size_t capacity = map->size < max_load(map->capacity) / 2 ? map->capacity : map->capacity * 2;
+        if (map_rehash(map, capacity) != 0) return NULL;
+        slot = find_free_slot(map, hash);
+    }
+
+    const char *copy = arena_copy(map, key, length);
+    if (!copy) return NULL;
+
+    if (map->ctrl[slot] == CTRL_EMPTY) map->growth_left--;
+    map->ctrl[slot] = hash_h2(hash);
+    map->size++;
+
+    StringMapEntry *entry = &map->entries[slot];
+    entry->key = copy;
+    entry->length = length;
+    entry->hash = hash;
+    entry->value = 0;
+    return &entry->value;
+}
+
+int string_map_erase(StringMap *map, const char *key, size_t length) {
+    if (!map || (!key && length)) return 0;
+
+    uint64_t hash = hash64(key, length, 0);
+    size_t slot = find_slot(map, key, length, hash);
+    if (slot == map->capacity) return 0;
+
+    // A group that still has an empty slot ends every probe through it,
+    // so the slot can become empty again; otherwise leave a tombstone
+    const uint8_t *group = map->ctrl + (slot & ~(size_t)(MAP_GROUP - 1));
+    if (group_match_empty(group)) {
+        map->ctrl[slot] = CTRL_EMPTY;
+        map->growth_left++;
+    } else {
+        map->ctrl[slot] = CTRL_DELETED;
+    }
+    map->size--;
+    return 1;
+}
+
+void string_map_foreach(const StringMap *map,
+                        void (*visit)(const StringMapEntry *entry, void *arg), void *arg) {
+    if (!map || !visit) return;
+
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (!(map->ctrl[i] & 0x80)) visit(&map->entries[i], arg);
+    }
+}
+
+/*
+ * Chained-hash baseline: a bucket array of singly linked nodes, one
+ * malloc per key (the layout of a typical textbook or std::unordered_map).
+ */
+typedef struct ChainNode {
+    struct ChainNode *next;
+    uint64_t hash;
+    uint64_t value;
+    size_t length;
+    char key[];
+} ChainNode;
+
+typedef struct {
+    ChainNode **buckets;
+    size_t bucket_count;
+    size_t size;
+} ChainedMap;
+
+static int chained_init(ChainedMap *map, size_t buckets) {
+    map->buckets = calloc(buckets, sizeof(ChainNode *));
+    map->bucket_count = buckets;
+    map->size = 0;
+    return map->buckets ? 0 : -1;
+}
+
+static void chained_free(ChainedMap *map) {
+    for (size_t b = 0; b < map->bucket_count; b++) {
+        ChainNode *node = map->buckets[b];
+        while (node) {
+            ChainNode *next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(map->buckets);
+}
+
+static int chained_grow(ChainedMap *map) {
+    size_t buckets = map->bucket_count * 2;
+    ChainNode **table = calloc(buckets, sizeof(ChainNode *));
+    if (!table) return -1;
+
+    for (size_t b = 0; b < map->bucket_count; b++) {
+        ChainNode *node = map->buckets[b];
+        while (node) {
+            ChainNode *next = node->next;
+            size_t target = node->hash & (buckets - 1);
+            node->next = table[target];
+            table[target] = node;
+            node = next;
+        }
+    }
+    free(map->buckets);
+    map->buckets = table;
+    map->bucket_count = buckets;
+    return 0;
+}
+
+static uint64_t* chained_upsert(ChainedMap *map, const char *key, size_t length) {
+    uint64_t hash = hash64(key, length, 0);
+    for (ChainNode *node = map->buckets[hash & (map->bucket_count - 1)]; node; node = node->next) {
+        if (node->hash == hash && node->length == length && memcmp(node->key, key, length) == 0) {
+            return &node->value;
+        }
+    }
+
+    if (map->size >= map->bucket_count && chained_grow(map) != 0) return NULL;
+
+    ChainNode *node = malloc(sizeof(ChainNode) + length + 1);
+    if (!node) return NULL;
+    memcpy(node->key, key, length);
+    node->key[length] = '\0';
+    node->length = length;
+    node->hash = hash;
+    node->value = 0;
+
+    size_t bucket = hash & (map->bucket_count - 1);
+    node->next = map->buckets[bucket];
+    map->buckets[bucket] = node;
+    map->size++;
+    return &node->value;
+}
+
+/* Space-separated tokens drawn from a skewed vocabulary (rank ~ u^3) */
+static char* make_token_stream(size_t tokens, size_t distinct, size_t *length) {
+    if (distinct == 0) distinct = 1;
+    char (*vocab)[16] = malloc(distinct * sizeof(*vocab));
+    char *text = malloc(tokens * 16 + 1);
+    if (!vocab || !text) {
+        free(vocab);
+        free(text);
+        return NULL;
+    }
+
+    for (size_t w = 0; w < distinct; w++) {
+        int len = 3 + rand() % 10;
+        for (int c = 0; c < len; c++) vocab[w][c] = (char)('a' + rand() % 26);
+        // Make every word unique by suffixing its index in base 26
+        size_t id = w;
+        int c = len;
+        do {
+            vocab[w][c++] = (char)('a' + id % 26);
+            id /= 26;
+        } while (id && c < 15);
+        vocab[w][c] = '\0';
+    }
+
+    size_t pos = 0;
+    for (size_t t = 0; t < tokens; t++) {
+        double u = (double)rand() / RAND_MAX;
+        size_t w = (size_t)(u * u * u * (distinct - 1));
+        size_t len = strlen(vocab[w]);
+        memcpy(text + pos, vocab[w], len);
+        pos += len;
+        text[pos++] = ' ';
+    }
+    text[pos] = '\0';
+    *length = pos;
+
+    free(vocab);
+    return text;
+}
+
+typedef struct {
+    uint64_t total;
+} CountCheck;
+
+static void sum_counts(const StringMapEntry *entry, void *arg) {
+    ((CountCheck *)arg)->total += entry->value;
+}
+
+static StringMap* count_tokens_swiss(const char *text, size_t length) {
+    StringMap *map = string_map_create(1024);
+    if (!map) return NULL;
+
+    const char *p = text;
+    const char *end = text + length;
+    while (p < end) {
+        const char *space = string_memchr(p, ' ', (size_t)(end - p));
+        const char *stop = space ? space : end;
+        uint64_t *count = string_map_upsert(map, p, (size_t)(stop - p));
+        if (count) (*count)++;
+        p = stop + 1;
+    }
+    return map;
+}
+
+static int count_tokens_chained(ChainedMap *map, const char *text, size_t length) {
+    if (chained_init(map, 1024) != 0) return -1;
+
+    const char *p = text;
+    const char *end = text + length;
+    while (p < end) {
+        const char *space = string_memchr(p, ' ', (size_t)(end - p));
+        const char *stop = space ? space : end;
+        uint64_t *count = chained_upsert(map, p, (size_t)(stop - p));
+        if (count) (*count)++;
+        p = stop + 1;
+    }
+    return 0;
+}
+
+void compare_string_map_algorithms(size_t tokens, size_t distinct) {
+    printf("String Map Comparison [%zu tokens, %zu-word vocabulary, group width %d]\n",
+           tokens, distinct, MAP_GROUP);
+    printf("=========================================\n");
+
+    size_t length = 0;
+    char *text = make_token_stream(tokens, distinct, &length);
+    if (!text) {
+        printf("Failed to allocate token stream\n");
+        return;
+    }
+
+    // Average a few builds; the last one of each is kept for verification
+    const int reps = 4;
+    Timer timer;
+    ChainedMap chained;
+    int chained_ok = 0;
+    timer_start(&timer);
+    for (int r = 0; r < reps; r++) {
+        if (chained_ok) chained_free(&chained);
+        chained_ok = count_tokens_chained(&chained, text, length) == 0;
+    }
+    timer_stop(&timer);
+    double time_chained = timer_elapsed_ms(&timer) / reps;
+
+    StringMap *swiss = NULL;
+    timer_start(&timer);
+    for (int r = 0; r < reps; r++) {
+        string_map_destroy(swiss);
+        swiss = count_tokens_swiss(text, length);
+    }
+    timer_stop(&timer);
+    double time_swiss = timer_elapsed_ms(&timer) / reps;
+
+    printf("Chained hash:   %.3f ms (%.1f Mtokens/s)\n", time_chained,
+           time_chained > 0 ? tokens / (time_chained * 1000.0) : 0.0);
+    printf("SwissTable map: %.3f ms (%.1f Mtokens/s, %.2fx)\n", time_swiss,
+           time_swiss > 0 ? tokens / (time_swiss * 1000.0) : 0.0,
+           time_swiss > 0 ? time_chained / time_swiss : 0.0);
+
+    // Same distinct keys, same per-key counts, counts sum to the token count
+    int ok = chained_ok && swiss && swiss->size == chained.size;
+    if (ok) {
+        CountCheck check = {0};
+        string_map_foreach(swiss, sum_counts, &check);
+        ok = check.total == tokens;
+        for (size_t b = 0; ok && b < chained.bucket_count; b++) {
+            for (ChainNode *node = chained.buckets[b]; node; node = node->next) {
+                uint64_t *count = string_map_find(swiss, node->key, node->length);
+                if (!count || *count != node->value) ok = 0;
+            }
+        }
+        printf("Distinct keys: %zu, load factor %.2f\n", swiss->size,
+               (double)swiss->size / swiss->capacity);
+    }
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+
+    if (chained_ok) chained_free(&chained);
+    string_map_destroy(swiss);
+    free(text);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    char *text;
+    size_t length;
+} MapBenchState;
+
+static void *map_bench_setup(const BenchmarkParams *params) {
+    MapBenchState *state = malloc(sizeof(MapBenchState));
+    if (!state) return NULL;
+    state->text = make_token_stream(params->size, params->size / 8, &state->length);
+    if (!state->text) {
+        free(state);
+        return NULL;
+    }
+    return state;
+}
+
+static void map_bench_teardown(void *p) {
+    MapBenchState *state = p;
+    free(state->text);
+    free(state);
+}
+
+static double bench_map_swiss(void *p, const BenchmarkParams *params) {
+    MapBenchState *state = p;
+    (void)params;
+    StringMap *map = count_tokens_swiss(state->text, state->length);
+    double distinct = map ? (double)map->size : 0.0;
+    string_map_destroy(map);
+    return distinct;
+}
+
+static double bench_map_chained(void *p, const BenchmarkParams *params) {
+    MapBenchState *state = p;
+    (void)params;
+    ChainedMap map;
+    if (count_tokens_chained(&map, state->text, state->length) != 0) return 0.0;
+    double distinct = (double)map.size;
+    chained_free(&map);
+    return distinct;
+}
+
+static const BenchmarkParams map_sizes[] = { {1 << 14, 0, 0}, {1 << 18, 0, 0} };
+
+BENCHMARK_REGISTER(string_map_swiss, "string/map_swiss", map_bench_setup, bench_map_swiss, map_bench_teardown, map_sizes)
+BENCHMARK_REGISTER(string_map_chained, "string/map_chained", map_bench_setup, bench_map_chained, map_bench_teardown, map_sizes)
@@ -1,18 +1,28 @@
 #include "string_ops.h"
 #include "benchmark.h"
+#include "bitmanip.h"
+#include "region_marker.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
 
-/* Calculate string length */
+/* Calculate string length (word at a time: orc.b + ctz on Zbb, SWAR elsewhere) */
 int string_length(const char *str) {
     if (!str) return 0;
     
-    int len = 0;
-    while (str[len] != '\0') {
-        len++;
+    const char *p = str;
+    while ((uintptr_t)p & 7) {
+        if (*p == '\0') return (int)(p - str);
+        p++;
     }
-    return len;
+    
+    // Aligned words never cross a page, so reading past the NUL is safe
+    uint64_t zeros;
+    while ((zeros = bit_zero_bytes(bit_load64_aligned(p))) == 0) {
+        p += 8;
+    }
+    return (int)(p - str) + bit_first_byte(zeros);
 }
 
 /* Copy string to new memory */
@@ -23,11 +33,7 @@ char* string_copy(const char *src) {
     char *dest = malloc(len + 1);
     if (!dest) return NULL;
     
-    for (int i = 0; i <= len; i++) {
-        dest[i] = src[i];
-    }
-    
-    return dest;
+    return string_memcpy(dest, src, len + 1);
 }
 
 /* Concatenate two strings */
@@ -40,14 +46,9 @@ char* string_concatenate(const char *str1, const char *str2) {
     char *result = malloc(len1 + len2 + 1);
     if (!result) return NULL;
     
-    int i = 0;
-    for (int j = 0; j < len1; j++) {
-        result[i++] = str1[j];
-    }
-    for (int j = 0; j < len2; j++) {
-        result[i++] = str2[j];
-    }
-    result[i] = '\0';
+    // The second copy starts misaligned unless len1 is a multiple of 8
+    string_memcpy(result, str1, len1);
+    string_memcpy(result + len1, str2, len2 + 1);
     
     return result;
 }
@@ -141,41 +142,40 @@ int string_count_occurrences(const char *text, const char *pattern) {
 char** string_split(const char *str, char delimiter, int *count) {
     if (!str || !count) return NULL;
     
-    // Count delimiters
+    // Count delimiters (a NUL delimiter matches only the terminator)
     int delim_count = 0;
-    int len = string_length(str);
-    for (int i = 0; i < len; i++) {
-        if (str[i] == delimiter) delim_count++;
+    for (const char *p = string_find_char(str, delimiter); p && *p != '\0';
+         p = string_find_char(p + 1, delimiter)) {
+        delim_count++;
     }
     
     *count = delim_count + 1;
     char **result = malloc(*count * sizeof(char*));
     if (!result) return NULL;
     
-    int start = 0;
-    int part = 0;
+    const char *start = str;
     
-    for (int i = 0; i <= len; i++) {
-        if (str[i] == delimiter || str[i] == '\0') {
-            int part_len = i - start;
-            result[part] = malloc(part_len + 1);
-            if (!result[part]) {
-                // Cleanup on error
-                for (int j = 0; j < part; j++) {
-                    free(result[j]);
-                }
-                free(result);
-                return NULL;
-            }
-            
-            for (int j = 0; j < part_len; j++) {
-                result[part][j] = str[start + j];
+    for (int part = 0; part < *count; part++) {
+        const char *end = string_find_char(start, delimiter);
+        if (!end || *end == '\0') end = start + string_length(start);
+        
+        int part_len = (int)(end - start);
+        result[part] = malloc(part_len + 1);
+        if (!result[part]) {
+            // Cleanup on error
+            for (int j = 0; j < part; j++) {
+                free(result[j]);
             }
-            result[part][part_len] = '\0';
-            
-            part++;
-            start = i + 1;
+            free(result);
+            return NULL;
+        }
+        
+        for (int j = 0; j < part_len; j++) {
+            result[part][j] = start[j];
         }
+        result[part][part_len] = '\0';
+        
+        start = end + 1;
     }
     
     return result;
@@ -214,6 +214,47 @@ double benchmark_string_operations(const char *text, int iterations) {
     return timer_elapsed_ms(&timer) / iterations;
 }
 
+/* Byte-at-a-time references for the word-at-a-time scanning kernels */
+#define SCAN_REPETITIONS 1000
+
+// Keep GCC from recognising the reference loops as strlen/memchr calls
+#if defined(__GNUC__) && !defined(__clang__)
+#define SCAN_REFERENCE __attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define SCAN_REFERENCE
+#endif
+
+SCAN_REFERENCE
+static int length_bytewise(const char *str) {
+    int len = 0;
+    while (str[len] != '\0') len++;
+    return len;
+}
+
+SCAN_REFERENCE
+static const void *memchr_bytewise(const void *buf, int c, size_t n) {
+    const unsigned char *p = buf;
+    for (size_t i = 0; i < n; i++) {
+        if (p[i] == (unsigned char)c) return p + i;
+    }
+    return NULL;
+}
+
+SCAN_REFERENCE
+static void copy_bytewise(char *dst, const char *src, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = src[i];
+}
+
+/* What callers did before string_find_nocase: lower both, then search */
+static int find_lowered(const char *text, const char *pattern) {
+    char *lower_text = string_to_lowercase(text);
+    char *lower_pattern = string_to_lowercase(pattern);
+    int result = (lower_text && lower_pattern) ? string_find_optimized(lower_text, lower_pattern) : -1;
+    free(lower_text);
+    free(lower_pattern);
+    return result;
+}
+
 /* Compare different search algorithms */
 void compare_search_algorithms(const char *text, const char *pattern) {
     printf("String Search Algorithm Comparison\n");
@@ -252,4 +293,296 @@ void compare_search_algorithms(const char *text, const char *pattern) {
     result = rabin_karp_search(text, pattern);
     timer_stop(&timer);
     printf("Rabin-Karp:        %.6f ms (found at %d)\n", timer_elapsed_ms(&timer), result);
+    
+    // Word-at-a-time scanning kernels against byte loops (per call, averaged)
+    printf("Word-at-a-time scanning (%s, %d calls):\n",
+#ifdef BITMANIP_HAS_ZBB
+           "Zbb orc.b",
+#else
+           "SWAR",
+#endif
+           SCAN_REPETITIONS);
+    
+    int len = string_length(text);
+    char *copy = string_copy(text);
+    if (!copy) return;
+    int ok = 1;
+    volatile int sink = 0;
+    // Reloaded every call so the compiler cannot hoist pure scans out of the loop
+    const char *volatile input = text;
+    
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) sink += length_bytewise(input);
+    timer_stop(&timer);
+    double t_byte = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) sink += string_length(input);
+    timer_stop(&timer);
+    double t_word = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    ok &= string_length(text) == length_bytewise(text);
+    printf("Length:            %.6f ms bytewise, %.6f ms word (%.2fx)\n",
+           t_byte, t_word, t_word > 0 ? t_byte / t_word : 0.0);
+    
+    // The terminator is never matched, so both scans cover the whole text
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) sink += memchr_bytewise(input, '\n', len) != NULL;
+    timer_stop(&timer);
+    t_byte = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) sink += string_memchr(input, '\n', len) != NULL;
+    timer_stop(&timer);
+    t_word = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    ok &= string_memchr(text, pattern[0], len) == memchr_bytewise(text, pattern[0], len);
+    printf("Memchr:            %.6f ms bytewise, %.6f ms word (%.2fx)\n",
+           t_byte, t_word, t_word > 0 ? t_byte / t_word : 0.0);
+    
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) sink += string_compare(input, copy);
+    timer_stop(&timer);
+    t_byte = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) sink += string_compare_optimized(input, copy);
+    timer_stop(&timer);
+    t_word = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    ok &= string_compare_optimized(text, copy) == string_compare(text, copy);
+    ok &= string_compare_optimized(text, pattern) == string_compare(text, pattern);
+    printf("Compare:           %.6f ms bytewise, %.6f ms word (%.2fx)\n",
+           t_byte, t_word, t_word > 0 ? t_byte / t_word : 0.0);
+    
+    ok &= string_find_char(text, ' ') == memchr_bytewise(text, ' ', len);
+    
+    // Case-insensitive search for a case-flipped pattern: lowered copies vs folded compares
+    char *flipped = string_copy(pattern);
+    if (flipped) {
+        for (char *f = flipped; *f; f++) {
+            if (isalpha((unsigned char)*f)) *f ^= 0x20;
+        }
+        timer_start(&timer);
+        for (int r = 0; r < SCAN_REPETITIONS; r++) sink += find_lowered(input, flipped);
+        timer_stop(&timer);
+        t_byte = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+        timer_start(&timer);
+        for (int r = 0; r < SCAN_REPETITIONS; r++) sink += string_find_nocase(input, flipped);
+        timer_stop(&timer);
+        t_word = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+        ok &= string_find_nocase(text, flipped) == find_lowered(text, flipped);
+        printf("Find (nocase):     %.6f ms lowered copies, %.6f ms folded (%.2fx)\n",
+               t_byte, t_word, t_word > 0 ? t_byte / t_word : 0.0);
+        free(flipped);
+    }
+
+    // Copy from text + 1 into an aligned buffer: the source stream is misaligned
+    timer_start(&timer);
+    for (int r = 0; r < SCAN_REPETITIONS; r++) copy_bytewise(copy, input + 1, len);
+    timer_stop(&timer);
+    t_byte = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+    double t_strategy[2];
+    for (int fast = 0; fast <= 1; fast++) {
+        string_set_misaligned_access(fast);
+        timer_start(&timer);
+        for (int r = 0; r < SCAN_REPETITIONS; r++) string_memcpy(copy, input + 1, len);
+        timer_stop(&timer);
+        t_strategy[fast] = timer_elapsed_ms(&timer) / SCAN_REPETITIONS;
+        ok &= string_bytes_equal(copy, text + 1, len);
+    }
+    string_set_misaligned_access(-1);
+    printf("Copy (src+1):      %.6f ms bytewise, %.6f ms merge, %.6f ms misaligned loads (using %s)\n",
+           t_byte, t_strategy[0], t_strategy[1],
+           string_misaligned_access()->fast ? "misaligned loads" : "merge");
+    printf("Result verification: %s\n", ok ? "PASS" : "FAIL");
+    
+    (void)sink;
+    free(copy);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    char *text;
+    char *copy;
+    char *pattern;
+    char *pattern_upper;    /* the pattern in upper case, for the case-insensitive searches */
+} SearchBenchState;
+
+/*
+ * Random lowercase text with the pattern planted once near the end, so
+ * every searcher scans almost the whole input before matching.
+ */
+static void *search_bench_setup(const BenchmarkParams *params) {
+    size_t size = params->size;
+    size_t plen = (params->pattern_length > 0) ? (size_t)params->pattern_length : 8;
+    if (plen >= size) return NULL;
+    
+    SearchBenchState *state = malloc(sizeof(SearchBenchState));
+    if (!state) return NULL;
+    state->text = malloc(size + 1);
+    state->copy = malloc(size + 1);
+    state->pattern = malloc(plen + 1);
+    state->pattern_upper = malloc(plen + 1);
+    if (!state->text || !state->copy || !state->pattern || !state->pattern_upper) {
+        free(state->text);
+        free(state->copy);
+        free(state->pattern);
+        free(state->pattern_upper);
+        free(state);
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < size; i++) {
+        state->text[i] = 'a' + rand() % 26;
+    }
+    state->text[size] = '\0';
+    for (size_t i = 0; i < plen; i++) {
+        state->pattern[i] = 'a' + rand() % 26;
+        state->pattern_upper[i] = state->pattern[i] - 'a' + 'A';
+    }
+    state->pattern[plen] = '\0';
+    state->pattern_upper[plen] = '\0';
+    
+    size_t at = size - plen - 1;
+    for (size_t i = 0; i < plen; i++) {
+        state->text[at + i] = state->pattern[i];
+    }
+    for (size_t i = 0; i <= size; i++) {
+        state->copy[i] = state->text[i];
+    }
+    return state;
+}
+
+static void search_bench_teardown(void *p) {
+    SearchBenchState *state = p;
+    free(state->text);
+    free(state->copy);
+    free(state->pattern);
+    free(state->pattern_upper);
+    free(state);
+}
+
+static double bench_find_naive(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return string_find(state->text, state->pattern);
+}
+
+static double bench_find_optimized(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return string_find_optimized(state->text, state->pattern);
+}
+
+static double bench_kmp(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return kmp_search(state->text, state->pattern);
+}
+
+static double bench_boyer_moore(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return boyer_moore_search(state->text, state->pattern);
 }
+
+static double bench_rabin_karp(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return rabin_karp_search(state->text, state->pattern);
+}
+
+static double bench_find_lowered(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return find_lowered(state->text, state->pattern_upper);
+}
+
+static double bench_find_nocase(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return string_find_nocase(state->text, state->pattern_upper);
+}
+
+static double bench_length(void *p, const BenchmarkParams *params) {
+    REGION_SCOPE(REGION_STRING_LENGTH);     // marked here: string_length is called from hot loops
+    SearchBenchState *state = p;
+    (void)params;
+    return string_length(state->text);
+}
+
+static double bench_memchr(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    // '#' never occurs in the text, so the whole buffer is scanned
+    return string_memchr(state->text, '#', params->size) != NULL;
+}
+
+static double bench_split(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    int count = 0;
+    char **parts = string_split(state->text, 'e', &count);
+    string_array_free(parts, count);
+    return count;
+}
+
+static double bench_compare(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return string_compare(state->text, state->copy);
+}
+
+static double bench_compare_optimized(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    return string_compare_optimized(state->text, state->copy);
+}
+
+static double bench_copy_misaligned(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    char *copy = string_copy(state->text + 1);
+    double check = copy ? copy[0] : 0.0;
+    free(copy);
+    return check;
+}
+
+static double bench_case_conversion(void *p, const BenchmarkParams *params) {
+    SearchBenchState *state = p;
+    (void)params;
+    char *upper = string_to_uppercase(state->text);
+    char *lower = string_to_lowercase(state->text);
+    double check = (upper && lower) ? upper[0] + lower[0] : 0.0;
+    free(upper);
+    free(lower);
+    return check;
+}
+
+static const BenchmarkParams search_params[] = {
+    {4096, 4, 0}, {4096, 16, 0}, {1 << 20, 4, 0}, {1 << 20, 16, 0}
+};
+static const BenchmarkParams text_sizes[] = { {4096, 0, 0}, {1 << 20, 0, 0} };
+
+BENCHMARK_REGISTER(string_find_naive, "string/find_naive",
+                   search_bench_setup, bench_find_naive, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_find_opt, "string/find_optimized",
+                   search_bench_setup, bench_find_optimized, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_kmp, "string/kmp",
+                   search_bench_setup, bench_kmp, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_boyer_moore, "string/boyer_moore",
+                   search_bench_setup, bench_boyer_moore, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_rabin_karp, "string/rabin_karp",
+                   search_bench_setup, bench_rabin_karp, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_find_lowered, "string/find_lowered",
+                   search_bench_setup, bench_find_lowered, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_find_nocase, "string/find_nocase",
+                   search_bench_setup, bench_find_nocase, search_bench_teardown, search_params)
+BENCHMARK_REGISTER(string_length_scan, "string/length",
+                   search_bench_setup, bench_length, search_bench_teardown, text_sizes)
+BENCHMARK_REGISTER(string_memchr_scan, "string/memchr",
+                   search_bench_setup, bench_memchr, search_bench_teardown, text_sizes)
+BENCHMARK_REGISTER(string_split_scan, "string/split",
+                   search_bench_setup, bench_split, search_bench_teardown, text_sizes)
+BENCHMARK_REGISTER(string_compare_bytes, "string/compare",
+                   search_bench_setup, bench_compare, search_bench_teardown, text_sizes)
+BENCHMARK_REGISTER(string_compare_words, "string/compare_optimized",
+                   search_bench_setup, bench_compare_optimized, search_bench_teardown, text_sizes)
+BENCHMARK_REGISTER(string_copy_misaligned, "string/copy_misaligned",
+                   search_bench_setup, bench_copy_misaligned, search_bench_teardown, text_sizes)
+BENCHMARK_REGISTER(string_case, "string/case_conversion",
+                   search_bench_setup, bench_case_conversion, search_bench_teardown, text_sizes)
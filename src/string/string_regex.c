@@ -0,0 +1,1224 @@
+#define _GNU_SOURCE
+#include "string_regex.h"
+#include "benchmark.h"
+#include "hash_ops.h"
+#include "log_stats.h"
+#include "region_marker.h"
+#include "string_ops.h"
+#include <regex.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REGEX_MAX_NODES    4096     /* AST nodes (and byte sets) per pattern */
+#define REGEX_MAX_STATES   8192     /* NFA states after expanding {m,n} */
+#define REGEX_MAX_REPEAT   255
+#define REGEX_MAX_LITERAL  64
+#define DFA_MAX_STATES     1024     /* cached DFA states before a flush */
+
+/* 256-bit byte set */
+typedef struct {
+    uint64_t bits[4];
+} ByteSet;
+
+static inline void byteset_add(ByteSet *set, unsigned c) {
+    set->bits[c >> 6] |= 1ULL << (c & 63);
+}
+
+static inline int byteset_has(const ByteSet *set, unsigned c) {
+    return (int)((set->bits[c >> 6] >> (c & 63)) & 1);
+}
+
+static void byteset_add_range(ByteSet *set, unsigned lo, unsigned hi) {
+    for (unsigned c = lo; c <= hi; c++) byteset_add(set, c);
+}
+
+static int byteset_count(const ByteSet *set, unsigned *only) {
+    int count = 0;
+    for (unsigned c = 0; c < 256; c++) {
+        if (byteset_has(set, c)) {
+            count++;
+            *only = c;
+        }
+    }
+    return count;
+}
+
+/* Abstract syntax tree */
+enum {
+    AST_SET, AST_EMPTY, AST_CONCAT, AST_ALT, AST_STAR, AST_PLUS, AST_QUEST,
+    AST_REPEAT, AST_BOL, AST_EOL
+};
+
+typedef struct {
+    int type;
+    int left;
+    int right;
+    int set;                /* AST_SET: index into sets */
+    int min, max;           /* AST_REPEAT: max -1 is unbounded */
+} AstNode;
+
+typedef struct {
+    const char *p;
+    AstNode *nodes;
+    int node_count;
+    ByteSet *sets;
+    int set_count;
+    int error;
+} Parser;
+
+/* Thompson NFA */
+enum { NFA_SET, NFA_SPLIT, NFA_JUMP, NFA_BOL, NFA_EOL, NFA_MATCH };
+
+typedef struct {
+    int type;
+    int set;
+    int out;
+    int out1;
+} NfaState;
+
+struct StringRegex {
+    NfaState *nfa;
+    int nfa_count;
+    int nfa_start;
+    ByteSet *sets;
+
+    // Bytes that every byte set treats alike share one DFA column
+    unsigned char byte_class[256];
+    int class_count;
+
+    char literal[REGEX_MAX_LITERAL + 1];
+    size_t literal_length;
+    size_t literal_anchor;  /* rarest byte: the one the prefilter scans for */
+    int pure_literal;       /* the whole pattern is the literal */
+    int prefilter;
+
+    // Lazy DFA; states are referred to by row offset (index * class_count)
+    int *trans;             /* DFA_MAX_STATES rows, -1 = not computed yet */
+    int *set_offset;
+    int *set_length;
+    unsigned char *eol_accept;
+    int dfa_count;
+    int *pool;              /* NFA state lists of all DFA states */
+    size_t pool_length;
+    size_t pool_capacity;
+    int *buckets;           /* open-addressing index of DFA states by set */
+    size_t flushes;
+
+    // Scratch for closures
+    int *stack;
+    int *list;
+    int *marks;
+    int generation;
+    int *restart;           /* closure of the start state away from ^ */
+    int restart_length;
+    int empty_match;        /* every line matches at its start */
+};
+
+#define DFA_DEAD  0
+#define DFA_MATCH 1
+#define DFA_START 2
+#define DFA_BUCKETS (2 * DFA_MAX_STATES)
+#define DFA_LINE_START (-1)         /* leads the start state's set: keeps it distinct */
+
+/* ------------------------------------------------------------------ */
+/* Parser                                                             */
+
+static int ast_new(Parser *ps, int type, int left, int right) {
+    if (ps->error || left < -1 || right < -1) {
+        ps->error = 1;
+        return -2;
+    }
+    if (ps->node_count == REGEX_MAX_NODES) {
+        ps->error = 1;
+        return -2;
+    }
+    AstNode *node = &ps->nodes[ps->node_count];
+    memset(node, 0, sizeof(*node));
+    node->type = type;
+    node->left = left;
+    node->right = right;
+    return ps->node_count++;
+}
+
+static int ast_set(Parser *ps, const ByteSet *set) {
+    if (ps->error || ps->set_count == REGEX_MAX_NODES) {
+        ps->error = 1;
+        return -2;
+    }
+    int node = ast_new(ps, AST_SET, -1, -1);
+    if (node < 0) return node;
+    ps->sets[ps->set_count] = *set;
+    ps->sets[ps->set_count].bits[0] &= ~(1ULL << '\n');      // lines never contain '\n'
+    ps->nodes[node].set = ps->set_count++;
+    return node;
+}
+
+/* \d \w \s and their complements; 0 if c is not a class escape */
+static int escape_class(char c, ByteSet *set) {
+    ByteSet base = {{0}};
+    switch (c | 0x20) {
+    case 'd':
+        byteset_add_range(&base, '0', '9');
+        break;
+    case 'w':
+        byteset_add_range(&base, '0', '9');
+        byteset_add_range(&base, 'a', 'z');
+        byteset_add_range(&base, 'A', 'Z');
+        byteset_add(&base, '_');
+        break;
+    case 's':
+        byteset_add(&base, ' ');
+        byteset_add_range(&base, '\t', '\r');
+        break;
+    default:
+        return 0;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        for (int i = 0; i < 4; i++) base.bits[i] = ~base.bits[i];
+    }
+    for (int i = 0; i < 4; i++) set->bits[i] |= base.bits[i];
+    return 1;
+}
+
+static unsigned escape_char(char c) {
+    switch (c) {
+    case 'n': return '\n';
+    case 't': return '\t';
+    case 'r': return '\r';
+    case 'f': return '\f';
+    case 'v': return '\v';
+    default:  return (unsigned char)c;
+    }
+}
+
+static int parse_class(Parser *ps) {
+    ByteSet set = {{0}};
+    int negate = 0;
+    if (*ps->p == '^') {
+        negate = 1;
+        ps->p++;
+    }
+
+    int first = 1;
+    while (*ps->p && (*ps->p != ']' || first)) {
+        first = 0;
+        unsigned lo;
+        if (*ps->p == '\\') {
+            if (!ps->p[1]) break;
+            if (escape_class(ps->p[1], &set)) {
+                ps->p += 2;
+                continue;
+            }
+            lo = escape_char(ps->p[1]);
+            ps->p += 2;
+        } else {
+            lo = (unsigned char)*ps->p++;
+        }
+
+        unsigned hi = lo;
+        if (ps->p[0] == '-' && ps->p[1] && ps->p[1] != ']') {
+            if (ps->p[1] == '\\' && ps->p[2]) {
+                hi = escape_char(ps->p[2]);
+                ps->p += 3;
+            } else {
+                hi = (unsigned char)ps->p[1];
+                ps->p += 2;
+            }
+            if (hi < lo) {
+                ps->error = 1;
+                return -2;
+            }
+        }
+        byteset_add_range(&set, lo, hi);
+    }
+
+    if (*ps->p != ']') {
+        ps->error = 1;
+        return -2;
+    }
+    ps->p++;
+
+    if (negate) {
+        for (int i = 0; i < 4; i++) set.bits[i] = ~set.bits[i];
+    }
+    return ast_set(ps, &set);
+}
+
+static int parse_alt(Parser *ps);
+
+static int parse_atom(Parser *ps) {
+    ByteSet set = {{0}};
+    char c = *ps->p++;
+
+    switch (c) {
+    case '(': {
+        if (ps->p[0] == '?' && ps->p[1] == ':') ps->p += 2;
+        int inner = parse_alt(ps);
+        if (*ps->p != ')') {
+            ps->error = 1;
+            return -2;
+        }
+        ps->p++;
+        return inner;
+    }
+    case '[':
+        return parse_class(ps);
+    case '.':
+        for (int i = 0; i < 4; i++) set.bits[i] = ~0ULL;
+        return ast_set(ps, &set);
+    case '^':
+        return ast_new(ps, AST_BOL, -1, -1);
+    case '$':
+        return ast_new(ps, AST_EOL, -1, -1);
+    case '*': case '+': case '?':
+        ps->error = 1;
+        return -2;
+    case '\\':
+        if (!*ps->p) {
+            ps->error = 1;
+            return -2;
+        }
+        c = *ps->p++;
+        if (!escape_class(c, &set)) byteset_add(&set, escape_char(c));
+        return ast_set(ps, &set);
+    default:
+        byteset_add(&set, (unsigned char)c);
+        return ast_set(ps, &set);
+    }
+}
+
+static int parse_count(Parser *ps) {
+    if (*ps->p < '0' || *ps->p > '9') return -1;
+    int value = 0;
+    while (*ps->p >= '0' && *ps->p <= '9') {
+        int digit = *ps->p++ - '0';
+        // Stop accumulating past the limit so long digit runs cannot overflow
+        if (value <= REGEX_MAX_REPEAT) value = value * 10 + digit;
+        if (value > REGEX_MAX_REPEAT) ps->error = 1;
+    }
+    return value;
+}
+
+static int parse_repeat(Parser *ps) {
+    int node = parse_atom(ps);
+    for (;;) {
+        char c = *ps->p;
+        if (c == '*' || c == '+' || c == '?') {
+            ps->p++;
+            node = ast_new(ps, c == '*' ? AST_STAR : c == '+' ? AST_PLUS : AST_QUEST, node, -1);
+        } else if (c == '{') {
+            ps->p++;
+            int min = parse_count(ps);
+            int max = min;
+            if (*ps->p == ',') {
+                ps->p++;
+                max = (*ps->p == '}') ? -1 : parse_count(ps);
+                if (max == -1 && *ps->p != '}') ps->error = 1;
+            }
+            if (min < 0 || *ps->p != '}' || (max >= 0 && max < min)) {
+                ps->error = 1;
+                return -2;
+            }
+            ps->p++;
+            node = ast_new(ps, AST_REPEAT, node, -1);
+            if (node >= 0) {
+                ps->nodes[node].min = min;
+                ps->nodes[node].max = max;
+            }
+        } else {
+            return node;
+        }
+    }
+}
+
+static int parse_concat(Parser *ps) {
+    int node = -1;
+    while (*ps->p && *ps->p != '|' && *ps->p != ')' && !ps->error) {
+        int next = parse_repeat(ps);
+        node = node == -1 ? next : ast_new(ps, AST_CONCAT, node, next);
+    }
+    return node == -1 ? ast_new(ps, AST_EMPTY, -1, -1) : node;
+}
+
+static int parse_alt(Parser *ps) {
+    int node = parse_concat(ps);
+    while (*ps->p == '|' && !ps->error) {
+        ps->p++;
+        node = ast_new(ps, AST_ALT, node, parse_concat(ps));
+    }
+    return node;
+}
+
+/* ------------------------------------------------------------------ */
+/* Required literal                                                   */
+
+/*
+ * Per subexpression: whether it matches exactly one string, a prefix
+ * and suffix shared by all of its matches, and the longest string every
+ * match contains. Concatenation also joins the left suffix with the
+ * right prefix, so "abc[0-9]def" yields "abc" and "def", not only "a".
+ */
+typedef struct {
+    int exact;
+    char prefix[REGEX_MAX_LITERAL + 1];
+    char suffix[REGEX_MAX_LITERAL + 1];
+    char required[REGEX_MAX_LITERAL + 1];
+} LiteralInfo;
+
+/* Rough frequency of a byte in text and logs (higher is more common) */
+static int byte_rank(unsigned char c) {
+    static const char common[] = " etaoinsrhldcumfpgwybvkxjqz";
+    if (c == '\n') return 0;
+    const char *hit = strchr(common, c);
+    if (c && hit) return 255 - (int)(hit - common);
+    if (c >= '0' && c <= '9') return 225;
+    if (strchr("/.,-:\"=", c) && c) return 230;
+    if (c >= 'A' && c <= 'Z') return 150;
+    if (c >= 0x20 && c < 0x7f) return 120;
+    return 40;
+}
+
+/* Index of the rarest byte of a literal */
+static size_t literal_rare_index(const char *literal) {
+    size_t best = 0;
+    for (size_t i = 1; literal[i]; i++) {
+        if (byte_rank((unsigned char)literal[i]) < byte_rank((unsigned char)literal[best])) best = i;
+    }
+    return best;
+}
+
+/* Prefer the literal whose rarest byte is rarest, then the longer one */
+static void literal_keep_better(char *best, const char *candidate) {
+    if (!candidate[0]) return;
+    if (!best[0]) {
+        strcpy(best, candidate);
+        return;
+    }
+    int rank_best = byte_rank((unsigned char)best[literal_rare_index(best)]);
+    int rank_candidate = byte_rank((unsigned char)candidate[literal_rare_index(candidate)]);
+    if (rank_candidate < rank_best ||
+        (rank_candidate == rank_best && strlen(candidate) > strlen(best))) {
+        strcpy(best, candidate);
+    }
+}
+
+static void literal_join(char *out, const char *a, const char *b, int keep_tail) {
+    char joined[2 * REGEX_MAX_LITERAL + 1];
+    size_t la = strlen(a), lb = strlen(b);
+    memcpy(joined, a, la);
+    memcpy(joined + la, b, lb + 1);
+    size_t total = la + lb;
+    if (total <= REGEX_MAX_LITERAL) {
+        memcpy(out, joined, total + 1);
+    } else if (keep_tail) {
+        memcpy(out, joined + total - REGEX_MAX_LITERAL, REGEX_MAX_LITERAL + 1);
+    } else {
+        memcpy(out, joined, REGEX_MAX_LITERAL);
+        out[REGEX_MAX_LITERAL] = '\0';
+    }
+}
+
+static void literal_info(const Parser *ps, int index, LiteralInfo *info) {
+    const AstNode *node = &ps->nodes[index];
+    memset(info, 0, sizeof(*info));
+
+    switch (node->type) {
+    case AST_SET: {
+        unsigned only = 0;
+        if (byteset_count(&ps->sets[node->set], &only) == 1 && only != 0) {
+            info->exact = 1;
+            info->prefix[0] = info->suffix[0] = info->required[0] = (char)only;
+        }
+        break;
+    }
+    case AST_EMPTY:
+        info->exact = 1;
+        break;
+    case AST_CONCAT: {
+        LiteralInfo a, b;
+        literal_info(ps, node->left, &a);
+        literal_info(ps, node->right, &b);
+        info->exact = a.exact && b.exact && strlen(a.prefix) + strlen(b.prefix) <= REGEX_MAX_LITERAL;
+        if (a.exact) literal_join(info->prefix, a.prefix, b.prefix, 0);
+        else strcpy(info->prefix, a.prefix);
+        if (b.exact) literal_join(info->suffix, a.suffix, b.suffix, 1);
+        else strcpy(info->suffix, b.suffix);
+
+        char junction[REGEX_MAX_LITERAL + 1];
+        literal_join(junction, a.suffix, b.prefix, 0);
+        strcpy(info->required, a.required);
+        literal_keep_better(info->required, b.required);
+        literal_keep_better(info->required, junction);
+        if (info->exact) strcpy(info->required, info->prefix);
+        break;
+    }
+    case AST_ALT: {
+        LiteralInfo a, b;
+        literal_info(ps, node->left, &a);
+        literal_info(ps, node->right, &b);
+        if (a.exact && b.exact && strcmp(a.prefix, b.prefix) == 0) *info = a;
+        break;
+    }
+    case AST_PLUS:
+        literal_info(ps, node->left, info);
+        info->exact = 0;
+        break;
+    case AST_REPEAT:
+        if (node->min > 0) {
+            literal_info(ps, node->left, info);
+            info->exact = 0;
+        }
+        break;
+    default:
+        break;      // *, ?, ^ and $ guarantee nothing
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* NFA construction                                                   */
+
+typedef struct {
+    StringRegex *re;
+    const Parser *ps;
+    int error;
+} NfaBuilder;
+
+typedef struct {
+    int start;
+    int holes;      /* list of unpatched out slots: state * 2 + (out1 ? 1 : 0) */
+} Fragment;
+
+static int nfa_new(NfaBuilder *b, int type, int set, int out, int out1) {
+    StringRegex *re = b->re;
+    if (re->nfa_count == REGEX_MAX_STATES) {
+        b->error = 1;
+        return 0;
+    }
+    NfaState *state = &re->nfa[re->nfa_count];
+    state->type = type;
+    state->set = set;
+    state->out = out;
+    state->out1 = out1;
+    return re->nfa_count++;
+}
+
+static int* nfa_slot(StringRegex *re, int hole) {
+    return (hole & 1) ? &re->nfa[hole >> 1].out1 : &re->nfa[hole >> 1].out;
+}
+
+/* Holes are chained through the unpatched slots themselves */
+static void nfa_patch(NfaBuilder *b, int holes, int target) {
+    StringRegex *re = b->re;
+    if (b->error) return;       // lists may reference states never created
+    while (holes != -1) {
+        int *slot = nfa_slot(re, holes);
+        holes = *slot;
+        *slot = target;
+    }
+}
+
+static int nfa_append(NfaBuilder *b, int first, int second) {
+    StringRegex *re = b->re;
+    if (b->error) return -1;
+    if (first == -1) return second;
+    int holes = first;
+    while (*nfa_slot(re, holes) != -1) holes = *nfa_slot(re, holes);
+    *nfa_slot(re, holes) = second;
+    return first;
+}
+
+static Fragment nfa_single(NfaBuilder *b, int type, int set) {
+    int s = nfa_new(b, type, set, -1, -1);
+    Fragment f = { s, b->error ? -1 : s * 2 };
+    return f;
+}
+
+static Fragment nfa_compile(NfaBuilder *b, int index);
+
+static Fragment nfa_concat(NfaBuilder *b, Fragment first, Fragment second) {
+    nfa_patch(b, first.holes, second.start);
+    Fragment f = { first.start, second.holes };
+    return f;
+}
+
+static Fragment nfa_star(NfaBuilder *b, int child) {
+    Fragment inner = nfa_compile(b, child);
+    int split = nfa_new(b, NFA_SPLIT, 0, inner.start, -1);
+    nfa_patch(b, inner.holes, split);
+    Fragment f = { split, split * 2 + 1 };
+    return f;
+}
+
+static Fragment nfa_quest(NfaBuilder *b, int child) {
+    Fragment inner = nfa_compile(b, child);
+    int split = nfa_new(b, NFA_SPLIT, 0, inner.start, -1);
+    Fragment f = { split, nfa_append(b, inner.holes, split * 2 + 1) };
+    return f;
+}
+
+static Fragment nfa_compile(NfaBuilder *b, int index) {
+    const AstNode *node = &b->ps->nodes[index];
+    Fragment f = { 0, -1 };
+    if (b->error) return f;
+
+    switch (node->type) {
+    case AST_SET:
+        return nfa_single(b, NFA_SET, node->set);
+    case AST_EMPTY:
+        return nfa_single(b, NFA_JUMP, 0);
+    case AST_BOL:
+        return nfa_single(b, NFA_BOL, 0);
+    case AST_EOL:
+        return nfa_single(b, NFA_EOL, 0);
+    case AST_CONCAT: {
+        Fragment first = nfa_compile(b, node->left);
+        return nfa_concat(b, first, nfa_compile(b, node->right));
+    }
+    case AST_ALT: {
+        Fragment first = nfa_compile(b, node->left);
+        Fragment second = nfa_compile(b, node->right);
+        int split = nfa_new(b, NFA_SPLIT, 0, first.start, second.start);
+        f.start = split;
+        f.holes = nfa_append(b, first.holes, second.holes);
+        return f;
+    }
+    case AST_STAR:
+        return nfa_star(b, node->left);
+    case AST_PLUS: {
+        Fragment inner = nfa_compile(b, node->left);
+        int split = nfa_new(b, NFA_SPLIT, 0, inner.start, -1);
+        nfa_patch(b, inner.holes, split);
+        f.start = inner.start;
+        f.holes = split * 2 + 1;
+        return f;
+    }
+    case AST_QUEST:
+        return nfa_quest(b, node->left);
+    case AST_REPEAT: {
+        // x{m,n} = m copies of x, then n - m copies of x? (x* when unbounded)
+        f = nfa_single(b, NFA_JUMP, 0);
+        for (int i = 0; i < node->min && !b->error; i++) {
+            f = nfa_concat(b, f, nfa_compile(b, node->left));
+        }
+        if (node->max < 0) return nfa_concat(b, f, nfa_star(b, node->left));
+        for (int i = node->min; i < node->max && !b->error; i++) {
+            f = nfa_concat(b, f, nfa_quest(b, node->left));
+        }
+        return f;
+    }
+    default:
+        b->error = 1;
+        return f;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* Closures and the lazy DFA                                          */
+
+/*
+ * Epsilon closure of state into re->list. DFA states keep the NFA states
+ * that consume input, MATCH, and any $ still waiting for the line end;
+ * ^ is only crossed at the start of a line.
+ */
+static void closure_add(StringRegex *re, int state, int at_bol, int at_eol, int *count) {
+    int top = 0;
+    re->stack[top++] = state;
+    while (top) {
+        int s = re->stack[--top];
+        if (s < 0 || re->marks[s] == re->generation) continue;
+        re->marks[s] = re->generation;
+
+        const NfaState *n = &re->nfa[s];
+        switch (n->type) {
+        case NFA_SPLIT:
+            re->stack[top++] = n->out1;
+            re->stack[top++] = n->out;
+            break;
+        case NFA_JUMP:
+            re->stack[top++] = n->out;
+            break;
+        case NFA_BOL:
+            if (at_bol) re->stack[top++] = n->out;
+            break;
+        case NFA_EOL:
+            if (at_eol) re->stack[top++] = n->out;
+            else re->list[(*count)++] = s;
+            break;
+        default:
+            re->list[(*count)++] = s;
+            break;
+        }
+    }
+}
+
+static void next_generation(StringRegex *re) {
+    if (++re->generation == 0x7fffffff) {
+        memset(re->marks, 0, (size_t)re->nfa_count * sizeof(int));
+        re->generation = 1;
+    }
+}
+
+static int list_has_match(const StringRegex *re, const int *list, int count) {
+    for (int i = 0; i < count; i++) {
+        if (list[i] >= 0 && re->nfa[list[i]].type == NFA_MATCH) return 1;
+    }
+    return 0;
+}
+
+/* Does a line ending here complete a match? (An empty line is also at ^) */
+static int set_accepts_at_eol(StringRegex *re, const int *set, int length) {
+    int at_bol = length > 0 && set[0] == DFA_LINE_START;
+    next_generation(re);
+    int count = 0;
+    for (int i = at_bol; i < length; i++) {
+        if (re->nfa[set[i]].type == NFA_EOL) closure_add(re, re->nfa[set[i]].out, at_bol, 1, &count);
+    }
+    return list_has_match(re, re->list, count);
+}
+
+static void sort_states(int *list, int count) {
+    for (int i = 1; i < count; i++) {
+        int v = list[i];
+        int j = i;
+        while (j > 0 && list[j - 1] > v) {
+            list[j] = list[j - 1];
+            j--;
+        }
+        list[j] = v;
+    }
+}
+
+static void dfa_flush(StringRegex *re) {
+    re->dfa_count = 0;
+    re->pool_length = 0;
+    for (size_t i = 0; i < DFA_BUCKETS; i++) re->buckets[i] = -1;
+}
+
+/* Row offset of the DFA state for a sorted NFA state list; -2 if the cache is full, -1 on error */
+static int dfa_state(StringRegex *re, const int *set, int length) {
+    uint64_t h = hash64(set, (size_t)length * sizeof(int), 0);
+    size_t bucket = (size_t)h & (DFA_BUCKETS - 1);
+    for (;; bucket = (bucket + 1) & (DFA_BUCKETS - 1)) {
+        int index = re->buckets[bucket];
+        if (index < 0) break;
+        if (re->set_length[index] == length &&
+            memcmp(re->pool + re->set_offset[index], set, (size_t)length * sizeof(int)) == 0) {
+            return index * re->class_count;
+        }
+    }
+
+    if (re->dfa_count == DFA_MAX_STATES) return -2;
+    if (re->pool_length + (size_t)length > re->pool_capacity) {
+        size_t capacity = re->pool_capacity * 2;
+        while (capacity < re->pool_length + (size_t)length) capacity *= 2;
+        int *pool = realloc(re->pool, capacity * sizeof(int));
+        if (!pool) return -1;
+        re->pool = pool;
+        re->pool_capacity = capacity;
+    }
+
+    int index = re->dfa_count++;
+    memcpy(re->pool + re->pool_length, set, (size_t)length * sizeof(int));
+    re->set_offset[index] = (int)re->pool_length;
+    re->set_length[index] = length;
+    re->pool_length += (size_t)length;
+    re->buckets[bucket] = index;
+    for (int c = 0; c < re->class_count; c++) {
+        re->trans[(size_t)index * re->class_count + c] = -1;
+    }
+    re->eol_accept[index] = (unsigned char)set_accepts_at_eol(re, re->pool + re->set_offset[index], length);
+    return index * re->class_count;
+}
+
+/* Reset the cache to its three fixed states: dead, match and line start */
+static int dfa_reset(StringRegex *re) {
+    dfa_flush(re);
+
+    int empty = 0;
+    if (dfa_state(re, &empty, 0) != DFA_DEAD) return -1;
+    re->set_length[re->dfa_count] = -1;         // MATCH: a row nobody looks up
+    re->set_offset[re->dfa_count] = 0;
+    re->eol_accept[re->dfa_count] = 1;
+    re->dfa_count++;
+
+    next_generation(re);
+    int count = 1;
+    re->list[0] = DFA_LINE_START;
+    closure_add(re, re->nfa_start, 1, 0, &count);
+    sort_states(re->list, count);
+    re->empty_match = list_has_match(re, re->list, count);
+    return dfa_state(re, re->list, count) == DFA_START * re->class_count ? 0 : -1;
+}
+
+/* Compute and cache the transition of state row on byte c */
+static int dfa_transition(StringRegex *re, int row, unsigned char c) {
+    REGION_SCOPE(REGION_REGEX_BUILD);
+    int index = row / re->class_count;
+    int target;
+
+    if (c == '\n') {
+        target = re->eol_accept[index] ? DFA_MATCH * re->class_count : DFA_START * re->class_count;
+    } else {
+        const int *set = re->pool + re->set_offset[index];
+        int length = re->set_length[index];
+
+        next_generation(re);
+        int count = 0;
+        for (int i = 0; i < length; i++) {
+            if (set[i] < 0) continue;
+            const NfaState *n = &re->nfa[set[i]];
+            if (n->type == NFA_SET && byteset_has(&re->sets[n->set], c)) {
+                closure_add(re, n->out, 0, 0, &count);
+            }
+        }
+        // Unanchored search: a match may also begin at the next byte
+        for (int i = 0; i < re->restart_length; i++) {
+            if (re->marks[re->restart[i]] != re->generation) {
+                re->marks[re->restart[i]] = re->generation;
+                re->list[count++] = re->restart[i];
+            }
+        }
+
+        if (list_has_match(re, re->list, count)) {
+            target = DFA_MATCH * re->class_count;
+        } else {
+            sort_states(re->list, count);
+            target = dfa_state(re, re->list, count);
+            if (target == -2) {
+                // Cache full: start over from the fixed states and this one
+                re->flushes++;
+                int *saved = malloc((size_t)(count ? count : 1) * sizeof(int));
+                if (!saved) return -1;
+                memcpy(saved, re->list, (size_t)count * sizeof(int));
+                if (dfa_reset(re) != 0) {
+                    free(saved);
+                    return -1;
+                }
+                target = dfa_state(re, saved, count);
+                free(saved);
+                return target;      // row no longer exists: nothing to cache
+            }
+            if (target < 0) return -1;
+        }
+    }
+
+    re->trans[row + re->byte_class[c]] = target;
+    return target;
+}
+
+/* ------------------------------------------------------------------ */
+/* Compilation                                                        */
+
+/* Merge bytes that no byte set tells apart into classes (newline alone) */
+static void build_byte_classes(StringRegex *re, int set_count) {
+    unsigned char cls[256] = {0};
+    int count = 1;
+
+    for (int s = -1; s < set_count; s++) {
+        int remap[256][2];
+        for (int i = 0; i < 256; i++) remap[i][0] = remap[i][1] = -1;
+        int next = 0;
+        for (unsigned c = 0; c < 256; c++) {
+            int in = s < 0 ? c == '\n' : byteset_has(&re->sets[s], c);
+            if (remap[cls[c]][in] < 0) remap[cls[c]][in] = next++;
+            cls[c] = (unsigned char)remap[cls[c]][in];
+        }
+        count = next;
+    }
+
+    memcpy(re->byte_class, cls, sizeof(cls));
+    re->class_count = count;
+}
+
+StringRegex* string_regex_compile(const char *pattern) {
+    if (!pattern) return NULL;
+
+    Parser ps = { pattern, NULL, 0, NULL, 0, 0 };
+    ps.nodes = malloc(REGEX_MAX_NODES * sizeof(AstNode));
+    ps.sets = malloc(REGEX_MAX_NODES * sizeof(ByteSet));
+    StringRegex *re = calloc(1, sizeof(StringRegex));
+    if (!ps.nodes || !ps.sets || !re) {
+        free(ps.nodes);
+        free(ps.sets);
+        free(re);
+        return NULL;
+    }
+
+    int root = parse_alt(&ps);
+    if (*ps.p) ps.error = 1;        // unbalanced ')'
+    if (ps.error || root < 0) {
+        free(ps.nodes);
+        free(ps.sets);
+        free(re);
+        return NULL;
+    }
+
+    LiteralInfo info;
+    literal_info(&ps, root, &info);
+    re->literal_length = strlen(info.required);
+    memcpy(re->literal, info.required, re->literal_length + 1);
+    re->pure_literal = info.exact && re->literal_length > 0;
+    re->literal_anchor = re->literal_length ? literal_rare_index(re->literal) : 0;
+
+    // A short literal of common bytes hits nearly every line: the DFA alone is faster
+    re->prefilter = re->pure_literal || re->literal_length >= 3 ||
+                    (re->literal_length && byte_rank((unsigned char)re->literal[re->literal_anchor]) < 200);
+
+    re->nfa = malloc(REGEX_MAX_STATES * sizeof(NfaState));
+    re->sets = ps.sets;
+    int ok = re->nfa != NULL;
+    if (ok) {
+        NfaBuilder builder = { re, &ps, 0 };
+        Fragment whole = nfa_compile(&builder, root);
+        int match = nfa_new(&builder, NFA_MATCH, 0, -1, -1);
+        nfa_patch(&builder, whole.holes, match);
+        re->nfa_start = whole.start;
+        ok = !builder.error;
+    }
+    free(ps.nodes);
+
+    if (ok) {
+        build_byte_classes(re, ps.set_count);
+        re->trans = malloc((size_t)DFA_MAX_STATES * re->class_count * sizeof(int));
+        re->set_offset = malloc(DFA_MAX_STATES * sizeof(int));
+        re->set_length = malloc(DFA_MAX_STATES * sizeof(int));
+        re->eol_accept = malloc(DFA_MAX_STATES);
+        re->buckets = malloc(DFA_BUCKETS * sizeof(int));
+        re->pool_capacity = 1024;
+        re->pool = malloc(re->pool_capacity * sizeof(int));
+        re->stack = malloc((2 * (size_t)re->nfa_count + 2) * sizeof(int));
+        re->list = malloc(((size_t)re->nfa_count + 1) * sizeof(int));
+        re->marks = calloc((size_t)re->nfa_count, sizeof(int));
+        re->restart = malloc((size_t)re->nfa_count * sizeof(int));
+        ok = re->trans && re->set_offset && re->set_length && re->eol_accept && re->buckets &&
+             re->pool && re->stack && re->list && re->marks && re->restart;
+    }
+
+    if (ok) {
+        next_generation(re);
+        int count = 0;
+        closure_add(re, re->nfa_start, 0, 0, &count);
+        sort_states(re->list, count);
+        memcpy(re->restart, re->list, (size_t)count * sizeof(int));
+        re->restart_length = count;
+        ok = dfa_reset(re) == 0;
+    }
+
+    if (!ok) {
+        string_regex_free(re);
+        return NULL;
+    }
+    return re;
+}
+
+void string_regex_free(StringRegex *re) {
+    if (!re) return;
+    free(re->nfa);
+    free(re->sets);
+    free(re->trans);
+    free(re->set_offset);
+    free(re->set_length);
+    free(re->eol_accept);
+    free(re->buckets);
+    free(re->pool);
+    free(re->stack);
+    free(re->list);
+    free(re->marks);
+    free(re->restart);
+    free(re);
+}
+
+const char* string_regex_literal(const StringRegex *re, size_t *length) {
+    if (!re) return NULL;
+    if (length) *length = re->literal_length;
+    return re->literal;
+}
+
+/* ------------------------------------------------------------------ */
+/* Matching                                                           */
+
+/*
+ * Run the DFA from a line start at p. Returns where the first match was
+ * detected (the byte completing it, the '\n' of a line matched by $, or
+ * end), NULL if no line in [p, end) matches, or (const char *)-1 when
+ * memory runs out.
+ */
+static const unsigned char* dfa_scan(StringRegex *re, const unsigned char *p,
+                                     const unsigned char *end) {
+    REGION_SCOPE(REGION_REGEX_DFA);
+    const int match = DFA_MATCH * re->class_count;
+    const int start = DFA_START * re->class_count;
+    const unsigned char *cls = re->byte_class;
+
+    if (p == end) return NULL;
+    if (re->empty_match) return p;
+
+    int row = start;
+    while (p < end) {
+        int next = re->trans[row + cls[*p]];
+        if (next < 0) {
+            next = dfa_transition(re, row, *p);
+            if (next < 0) return (const unsigned char *)-1;
+        }
+        row = next;
+        if (row <= match) {
+            if (row == match) return p;
+            // Dead (only after ^ failed): skip the rest of the line
+            const unsigned char *nl = string_memchr(p, '\n', (size_t)(end - p));
+            if (!nl) return NULL;
+            p = nl + 1;
+            row = start;
+            continue;
+        }
+        p++;
+    }
+    // A final '\n' ends the last line; there is no empty line after it
+    if (end[-1] == '\n') return NULL;
+    return re->eol_accept[row / re->class_count] ? end : NULL;
+}
+
+/* Start of the line containing p, not before floor */
+static const char* line_start(const char *floor, const char *p) {
+    while (p > floor && p[-1] != '\n') p--;
+    return p;
+}
+
+static const char* line_end(const char *p, const char *end) {
+    const char *nl = string_memchr(p, '\n', (size_t)(end - p));
+    return nl ? nl : end;
+}
+
+/* Next literal occurrence from p and its line [*line, *stop) */
+static const char* next_candidate(const StringRegex *re, const char *p, const char *end,
+                                  const char **line, const char **stop) {
+    const char *hit = string_find_bytes_at(p, (size_t)(end - p), re->literal, re->literal_length,
+                                           re->literal_anchor);
+    if (hit) {
+        *line = line_start(p, hit);
+        *stop = line_end(hit + re->literal_length, end);
+    }
+    return hit;
+}
+
+int string_regex_search(StringRegex *re, const char *text, size_t length, size_t *end) {
+    if (!re || (!text && length)) return -1;
+    const char *limit = text + length;
+
+    if (re->literal_length && re->prefilter) {
+        const char *p = text, *line, *stop, *hit;
+        while (p <= limit && (hit = next_candidate(re, p, limit, &line, &stop)) != NULL) {
+            if (re->pure_literal) {
+                if (end) *end = (size_t)(hit - text) + re->literal_length;
+                return 1;
+            }
+            const unsigned char *m = dfa_scan(re, (const unsigned char *)line, (const unsigned char *)stop);
+            if (m == (const unsigned char *)-1) return -1;
+            if (m) {
+                if (end) *end = (size_t)((const char *)m - text);
+                return 1;
+            }
+            p = stop + 1;
+        }
+        return 0;
+    }
+
+    const unsigned char *m = dfa_scan(re, (const unsigned char *)text, (const unsigned char *)limit);
+    if (m == (const unsigned char *)-1) return -1;
+    if (!m) return 0;
+    if (end) *end = (size_t)((const char *)m - text);
+    return 1;
+}
+
+size_t string_regex_count_lines(StringRegex *re, const char *text, size_t length) {
+    if (!re || !text) return 0;
+    const char *limit = text + length;
+    const char *p = text;
+    size_t lines = 0;
+
+    if (re->literal_length && re->prefilter) {
+        const char *line, *stop;
+        while (p < limit && next_candidate(re, p, limit, &line, &stop)) {
+            if (re->pure_literal) {
+                lines++;
+            } else {
+                const unsigned char *m = dfa_scan(re, (const unsigned char *)line, (const unsigned char *)stop);
+                if (m == (const unsigned char *)-1) return lines;
+                if (m) lines++;
+            }
+            p = stop + 1;
+        }
+        return lines;
+    }
+
+    while (p < limit) {
+        const unsigned char *m = dfa_scan(re, (const unsigned char *)p, (const unsigned char *)limit);
+        if (!m || m == (const unsigned char *)-1) break;
+        lines++;
+        p = line_end((const char *)m, limit) + 1;
+    }
+    return lines;
+}
+
+/* ------------------------------------------------------------------ */
+/* Comparison against POSIX regexec                                   */
+
+static size_t posix_count_lines(const regex_t *compiled, const char *text, size_t length) {
+    char line[4096];
+    size_t lines = 0;
+    const char *p = text;
+    const char *limit = text + length;
+
+    while (p < limit) {
+        const char *stop = line_end(p, limit);
+        size_t n = (size_t)(stop - p);
+        if (n >= sizeof(line)) n = sizeof(line) - 1;
+        memcpy(line, p, n);
+        line[n] = '\0';
+        if (regexec(compiled, line, 0, NULL, 0) == 0) lines++;
+        p = stop + 1;
+    }
+    return lines;
+}
+
+/* POSIX ERE-compatible patterns over the log_stats_synthetic format */
+static const char *regex_patterns[] = {
+    "timed out",
+    "\"GET /api/v[12]/users/[0-9]+ ",
+    "\" 50[0-9] [0-9]+ ",
+    "^10\\.1[0-9]\\.[0-9]+\\.[0-9]+ .*\"POST",
+    "[0-9]{2}:[0-9]{2}:59 ",
+    "(HEAD|POST) /(blog|images)/[0-9]*7 ",
+};
+
+#define REGEX_PATTERN_COUNT (sizeof(regex_patterns) / sizeof(regex_patterns[0]))
+
+void compare_regex_algorithms(size_t size) {
+    printf("Regex Line Counting Comparison [%zu-byte synthetic access log]\n", size);
+    printf("=========================================\n");
+
+    size_t length = 0;
+    char *text = log_stats_synthetic(size, &length);
+    if (!text) {
+        printf("Failed to allocate log\n");
+        return;
+    }
+
+    int all_ok = 1;
+    double mb = (double)length / (1024.0 * 1024.0);
+    for (size_t i = 0; i < REGEX_PATTERN_COUNT; i++) {
+        const char *pattern = regex_patterns[i];
+        StringRegex *re = string_regex_compile(pattern);
+        regex_t posix;
+        int posix_ok = regcomp(&posix, pattern, REG_EXTENDED | REG_NOSUB) == 0;
+        if (!re || !posix_ok) {
+            printf("/%s/: failed to compile\n", pattern);
+            string_regex_free(re);
+            if (posix_ok) regfree(&posix);
+            all_ok = 0;
+            continue;
+        }
+
+        Timer timer;
+        timer_start(&timer);
+        size_t expected = posix_count_lines(&posix, text, length);
+        timer_stop(&timer);
+        double time_posix = timer_elapsed_ms(&timer);
+
+        int prefilter = re->prefilter;
+        re->prefilter = 0;
+        timer_start(&timer);
+        size_t dfa_only = string_regex_count_lines(re, text, length);
+        timer_stop(&timer);
+        double time_dfa = timer_elapsed_ms(&timer);
+
+        re->prefilter = prefilter;
+        timer_start(&timer);
+        size_t filtered = string_regex_count_lines(re, text, length);
+        timer_stop(&timer);
+        double time_filtered = timer_elapsed_ms(&timer);
+
+        size_t literal_length = 0;
+        const char *literal = string_regex_literal(re, &literal_length);
+        printf("/%s/ (literal \"%s\"%s): %zu lines\n", pattern, literal,
+               re->pure_literal ? ", pure" : prefilter ? "" : ", too common to prefilter", filtered);
+        printf("  POSIX regexec:       %9.3f ms (%7.1f MB/s)\n", time_posix,
+               time_posix > 0 ? mb / (time_posix / 1000.0) : 0.0);
+        printf("  Lazy DFA:            %9.3f ms (%7.1f MB/s, %d states)\n", time_dfa,
+               time_dfa > 0 ? mb / (time_dfa / 1000.0) : 0.0, re->dfa_count);
+        printf("  Literal + lazy DFA:  %9.3f ms (%7.1f MB/s, %.1fx vs POSIX)\n", time_filtered,
+               time_filtered > 0 ? mb / (time_filtered / 1000.0) : 0.0,
+               time_filtered > 0 ? time_posix / time_filtered : 0.0);
+
+        if (dfa_only != expected || filtered != expected) {
+            printf("  Mismatch: POSIX %zu, DFA %zu, prefiltered %zu\n", expected, dfa_only, filtered);
+            all_ok = 0;
+        }
+        string_regex_free(re);
+        regfree(&posix);
+    }
+    printf("Result verification: %s\n", all_ok ? "PASS" : "FAIL");
+    free(text);
+}
+
+/* Registered benchmarks (see BENCHMARK_REGISTER in benchmark.h) */
+typedef struct {
+    char *text;
+    size_t length;
+    StringRegex *regex[REGEX_PATTERN_COUNT];
+    regex_t posix[REGEX_PATTERN_COUNT];
+    int posix_ready;
+} RegexBenchState;
+
+static void regex_bench_teardown(void *p) {
+    RegexBenchState *state = p;
+    for (size_t i = 0; i < REGEX_PATTERN_COUNT; i++) {
+        string_regex_free(state->regex[i]);
+        if (i < (size_t)state->posix_ready) regfree(&state->posix[i]);
+    }
+    free(state->text);
+    free(state);
+}
+
+static void *regex_bench_setup(const BenchmarkParams *params) {
+    RegexBenchState *state = calloc(1, sizeof(RegexBenchState));
+    if (!state) return NULL;
+    state->text = log_stats_synthetic(params->size, &state->length);
+    int ok = state->text != NULL;
+    for (size_t i = 0; ok && i < REGEX_PATTERN_COUNT; i++) {
+        state->regex[i] = string_regex_compile(regex_patterns[i]);
+        ok = state->regex[i] && regcomp(&state->posix[i], regex_patterns[i], REG_EXTENDED | REG_NOSUB) == 0;
+        if (ok) state->posix_ready++;
+    }
+    if (!ok) {
+        regex_bench_teardown(state);
+        return NULL;
+    }
+    return state;
+}
+
+static double bench_regex_dfa(void *p, const BenchmarkParams *params) {
+    RegexBenchState *state = p;
+    (void)params;
+    size_t lines = 0;
+    for (size_t i = 0; i < REGEX_PATTERN_COUNT; i++) {
+        lines += string_regex_count_lines(state->regex[i], state->text, state->length);
+    }
+    return (double)lines;
+}
+
+static double bench_regex_posix(void *p, const BenchmarkParams *params) {
+    RegexBenchState *state = p;
+    (void)params;
+    size_t lines = 0;
+    for (size_t i = 0; i < REGEX_PATTERN_COUNT; i++) {
+        lines += posix_count_lines(&state->posix[i], state->text, state->length);
+    }
+    return (double)lines;
+}
+
+static const BenchmarkParams regex_sizes[] = { {1 << 20, 0, 0} };
+
+BENCHMARK_REGISTER(string_regex_dfa, "string/regex_dfa", regex_bench_setup, bench_regex_dfa, regex_bench_teardown, regex_sizes)
+BENCHMARK_REGISTER(string_regex_posix, "string/regex_posix", regex_bench_setup, bench_regex_posix, regex_bench_teardown, regex_sizes)
@@ -0,0 +1,401 @@
+#define _GNU_SOURCE
+#include "string_ops.h"
+#include "benchmark.h"
+#include "bitmanip.h"
+#include "region_marker.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__riscv) && defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Word-at-a-time scanning kernels. Each aligned 64-bit word is tested
+ * for a zero or matching byte with orc.b (one instruction on Zbb, a few
+ * SWAR operations elsewhere) and the first hit is located with ctz.
+ */
+
+/*
+ * Misaligned-load strategy. Streams that cannot be aligned together with
+ * the primary pointer are read either with native misaligned loads (when
+ * the hardware handles them at close to aligned speed) or as two aligned
+ * loads merged with shifts (when misaligned loads trap into firmware).
+ * Decided once at startup: RVOPT_MISALIGNED=fast|slow, then the kernel's
+ * hwprobe report on RISC-V Linux, then a short timing probe.
+ */
+static MisalignedAccessInfo misaligned_info = { 0, 0.0, "default" };
+static MisalignedAccessInfo misaligned_detected;
+static volatile uint64_t misaligned_probe_sink;
+
+#define MISALIGNED_PROBE_WORDS 511
+#define STRING_PAGE_SIZE 4096
+
+static double misaligned_probe(size_t offset, int passes) {
+    static uint64_t buffer[MISALIGNED_PROBE_WORDS + 1];
+    const unsigned char *base = (const unsigned char *)buffer + offset;
+    uint64_t acc = 0;
+    
+    Timer timer;
+    timer_start(&timer);
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < MISALIGNED_PROBE_WORDS; i++) {
+            acc += bit_load64_misaligned(base + 8 * i);
+        }
+    }
+    timer_stop(&timer);
+    
+    misaligned_probe_sink = acc;
+    return timer_elapsed_us(&timer);
+}
+
+/* 1 fast, 0 slow or emulated, -1 unknown */
+static int misaligned_hwprobe(void) {
+#if defined(__riscv) && defined(__linux__)
+#ifndef __NR_riscv_hwprobe
+#define __NR_riscv_hwprobe 258
+#endif
+    struct { int64_t key; uint64_t value; } pair = { 5, 0 };    /* RISCV_HWPROBE_KEY_CPUPERF_0 */
+    if (syscall(__NR_riscv_hwprobe, &pair, 1, 0, NULL, 0) == 0 && pair.key != -1) {
+        switch (pair.value & 7) {
+            case 3: return 1;                                   /* MISALIGNED_FAST */
+            case 1: case 2: case 4: return 0;                   /* EMULATED, SLOW, UNSUPPORTED */
+            default: break;
+        }
+    }
+#endif
+    return -1;
+}
+
+static void misaligned_access_detect(void) {
+    const char *env = getenv("RVOPT_MISALIGNED");
+    if (env && (strcmp(env, "fast") == 0 || strcmp(env, "slow") == 0)) {
+        misaligned_info.fast = env[0] == 'f';
+        misaligned_info.source = "RVOPT_MISALIGNED";
+        return;
+    }
+    
+    int probed = misaligned_hwprobe();
+    if (probed >= 0) {
+        misaligned_info.fast = probed;
+        misaligned_info.source = "hwprobe";
+        return;
+    }
+    
+    // Grow the probe until the aligned run is measurable, stopping early
+    // when misaligned loads are clearly trapping
+    for (int passes = 8; passes <= (1 << 16); passes *= 4) {
+        double aligned = misaligned_probe(0, passes);
+        double misaligned = misaligned_probe(3, passes);
+        int trapping = misaligned >= 50.0 && misaligned > 8.0 * (aligned + 1.0);
+        if (trapping || aligned >= 200.0) {
+            misaligned_info.ratio = aligned > 0 ? misaligned / aligned : 0.0;
+            misaligned_info.fast = !trapping && misaligned_info.ratio < 1.5;
+            misaligned_info.source = "measured";
+            return;
+        }
+    }
+}
+
+__attribute__((constructor))
+static void misaligned_access_init(void) {
+    misaligned_access_detect();
+    misaligned_detected = misaligned_info;
+}
+
+const MisalignedAccessInfo* string_misaligned_access(void) {
+    return &misaligned_info;
+}
+
+void string_set_misaligned_access(int fast) {
+    if (fast < 0) {
+        misaligned_info = misaligned_detected;
+        return;
+    }
+    misaligned_info.fast = fast != 0;
+    misaligned_info.source = "override";
+}
+
+/* Whether the rest of p's aligned word (from p on) holds a NUL */
+static inline int word_tail_has_zero(const char *p) {
+    unsigned shift = ((uintptr_t)p & 7) * 8;
+    return (bit_zero_bytes(bit_load64_aligned(p - shift / 8)) >> shift) != 0;
+}
+
+/* Copy n bytes with aligned stores; see misaligned_info for the source stream */
+void* string_memcpy(void *dst, const void *src, size_t n) {
+    REGION_SCOPE(REGION_STRING_MEMCPY);
+    if (!dst || !src) return dst;
+    
+    unsigned char *d = dst;
+    const unsigned char *s = src;
+    
+    while (n && ((uintptr_t)d & 7)) {
+        *d++ = *s++;
+        n--;
+    }
+    
+    unsigned shift = ((uintptr_t)s & 7) * 8;
+    if (shift == 0) {
+        for (; n >= 8; d += 8, s += 8, n -= 8) {
+            bit_store64_aligned(d, bit_load64_aligned(s));
+        }
+    } else if (misaligned_info.fast) {
+        for (; n >= 8; d += 8, s += 8, n -= 8) {
+            bit_store64_aligned(d, bit_load64_misaligned(s));
+        }
+    } else {
+        // Every output word spans two aligned source words
+        const unsigned char *a = s - shift / 8;
+        uint64_t lo = bit_load64_aligned(a);
+        for (; n >= 8; d += 8, s += 8, n -= 8) {
+            a += 8;
+            uint64_t hi = bit_load64_aligned(a);
+            bit_store64_aligned(d, bit_merge64(lo, hi, shift));
+            lo = hi;
+        }
+    }
+    
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+/* Whether the first n bytes of a and b are equal (a is the aligned stream) */
+int string_bytes_equal(const void *a, const void *b, size_t n) {
+    if (!a || !b) return 0;
+    
+    const unsigned char *p = a;
+    const unsigned char *q = b;
+    
+    while (n && ((uintptr_t)p & 7)) {
+        if (*p++ != *q++) return 0;
+        n--;
+    }
+    
+    unsigned shift = ((uintptr_t)q & 7) * 8;
+    if (shift == 0) {
+        for (; n >= 8; p += 8, q += 8, n -= 8) {
+            if (bit_load64_aligned(p) != bit_load64_aligned(q)) return 0;
+        }
+    } else if (misaligned_info.fast) {
+        for (; n >= 8; p += 8, q += 8, n -= 8) {
+            if (bit_load64_aligned(p) != bit_load64_misaligned(q)) return 0;
+        }
+    } else {
+        const unsigned char *aq = q - shift / 8;
+        uint64_t lo = bit_load64_aligned(aq);
+        for (; n >= 8; p += 8, q += 8, n -= 8) {
+            aq += 8;
+            uint64_t hi = bit_load64_aligned(aq);
+            if (bit_load64_aligned(p) != bit_merge64(lo, hi, shift)) return 0;
+            lo = hi;
+        }
+    }
+    
+    for (; n; n--) {
+        if (*p++ != *q++) return 0;
+    }
+    return 1;
+}
+
+/* Find the first byte equal to c in the first n bytes of buf */
+const void* string_memchr(const void *buf, int c, size_t n) {
+    REGION_SCOPE(REGION_STRING_MEMCHR);
+    if (!buf) return NULL;
+    
+    const unsigned char *p = buf;
+    unsigned char target = (unsigned char)c;
+    
+    while (n && ((uintptr_t)p & 7)) {
+        if (*p == target) return p;
+        p++;
+        n--;
+    }
+    
+    // Bounded: whole words only, the tail is finished bytewise
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t hits = bit_match_bytes(bit_load64_aligned(p), target);
+        if (hits) return p + bit_first_byte(hits);
+    }
+    
+    for (; n; p++, n--) {
+        if (*p == target) return p;
+    }
+    return NULL;
+}
+
+/*
+ * ASCII case-insensitive variants. A letter c matches exactly the bytes
+ * whose value OR 0x20 equals c | 0x20, so scanning for a letter is one
+ * OR per word before the usual match. Comparing two words, only the
+ * case bit of letter bytes may differ: the letter mask of one side is
+ * enough, since a letter never folds onto a non-letter.
+ */
+static inline int ascii_is_alpha(unsigned char c) {
+    return (unsigned char)((c | 0x20) - 'a') < 26;
+}
+
+static inline int words_equal_nocase(uint64_t x, uint64_t y) {
+    return ((x ^ y) & ~bit_alpha_bytes(y)) == 0;
+}
+
+/* string_memchr ignoring ASCII case */
+const void* string_memchr_nocase(const void *buf, int c, size_t n) {
+    unsigned char target = (unsigned char)c;
+    if (!ascii_is_alpha(target)) return string_memchr(buf, c, n);
+    REGION_SCOPE(REGION_STRING_FIND_NOCASE);
+    if (!buf) return NULL;
+    
+    const unsigned char *p = buf;
+    target |= 0x20;
+    
+    while (n && ((uintptr_t)p & 7)) {
+        if ((*p | 0x20) == target) return p;
+        p++;
+        n--;
+    }
+    
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t hits = bit_match_bytes(bit_load64_aligned(p) | (BIT_ONES * 0x20), target);
+        if (hits) return p + bit_first_byte(hits);
+    }
+    
+    for (; n; p++, n--) {
+        if ((*p | 0x20) == target) return p;
+    }
+    return NULL;
+}
+
+/* string_bytes_equal ignoring ASCII case (a is the aligned stream) */
+int string_bytes_equal_nocase(const void *a, const void *b, size_t n) {
+    if (!a || !b) return 0;
+    
+    const unsigned char *p = a;
+    const unsigned char *q = b;
+    
+    while (n && ((uintptr_t)p & 7)) {
+        if (*p != *q && !(ascii_is_alpha(*q) && (*p | 0x20) == (*q | 0x20))) return 0;
+        p++;
+        q++;
+        n--;
+    }
+    
+    unsigned shift = ((uintptr_t)q & 7) * 8;
+    if (shift == 0) {
+        for (; n >= 8; p += 8, q += 8, n -= 8) {
+            if (!words_equal_nocase(bit_load64_aligned(p), bit_load64_aligned(q))) return 0;
+        }
+    } else if (misaligned_info.fast) {
+        for (; n >= 8; p += 8, q += 8, n -= 8) {
+            if (!words_equal_nocase(bit_load64_aligned(p), bit_load64_misaligned(q))) return 0;
+        }
+    } else {
+        const unsigned char *aq = q - shift / 8;
+        uint64_t lo = bit_load64_aligned(aq);
+        for (; n >= 8; p += 8, q += 8, n -= 8) {
+            aq += 8;
+            uint64_t hi = bit_load64_aligned(aq);
+            if (!words_equal_nocase(bit_load64_aligned(p), bit_merge64(lo, hi, shift))) return 0;
+            lo = hi;
+        }
+    }
+    
+    for (; n; p++, q++, n--) {
+        if (*p != *q && !(ascii_is_alpha(*q) && (*p | 0x20) == (*q | 0x20))) return 0;
+    }
+    return 1;
+}
+
+/* Find the first occurrence of c before the terminator (strchr semantics) */
+const char* string_find_char(const char *str, char c) {
+    REGION_SCOPE(REGION_STRING_FIND_CHAR);
+    if (!str) return NULL;
+    
+    const char *p = str;
+    while ((uintptr_t)p & 7) {
+        if (*p == c) return p;
+        if (*p == '\0') return NULL;
+        p++;
+    }
+    
+    // Aligned words never cross a page, so reading past the NUL is safe
+    for (;; p += 8) {
+        uint64_t w = bit_load64_aligned(p);
+        uint64_t hits = bit_match_bytes(w, (unsigned char)c) | bit_zero_bytes(w);
+        if (hits) {
+            p += bit_first_byte(hits);
+            return (*p == c) ? p : NULL;
+        }
+    }
+}
+
+/*
+ * Compare two strings a word at a time (same results as string_compare).
+ * str1 is aligned; str2 is read so that no load crosses into a page the
+ * string does not reach.
+ */
+int string_compare_optimized(const char *str1, const char *str2) {
+    REGION_SCOPE(REGION_STRING_COMPARE);
+    if (!str1 || !str2) return -1;
+    
+    while (((uintptr_t)str1 & 7) && *str1 == *str2 && *str1 != '\0') {
+        str1++;
+        str2++;
+    }
+    
+    // A head that stopped early has already found the deciding byte
+    unsigned shift = ((uintptr_t)str2 & 7) * 8;
+    if (((uintptr_t)str1 & 7) != 0) {
+        shift = 64;
+    }
+    
+    if (shift == 0) {
+        for (;;) {
+            uint64_t w1 = bit_load64_aligned(str1);
+            uint64_t w2 = bit_load64_aligned(str2);
+            if (bit_zero_bytes(w1) | (w1 ^ w2)) break;
+            str1 += 8;
+            str2 += 8;
+        }
+    } else if (shift < 64 && misaligned_info.fast) {
+        for (;;) {
+            // Near a page end, only cross if str2 continues past it
+            if (((uintptr_t)str2 & (STRING_PAGE_SIZE - 1)) > STRING_PAGE_SIZE - 8 &&
+                word_tail_has_zero(str2)) break;
+            uint64_t w1 = bit_load64_aligned(str1);
+            uint64_t w2 = bit_load64_misaligned(str2);
+            if (bit_zero_bytes(w1) | (w1 ^ w2)) break;
+            str1 += 8;
+            str2 += 8;
+        }
+    } else if (shift < 64) {
+        const char *a = str2 - shift / 8;
+        uint64_t lo = bit_load64_aligned(a);
+        for (;;) {
+            // The next aligned word is only read if str2 does not end in lo
+            if (bit_zero_bytes(lo) >> shift) break;
+            uint64_t hi = bit_load64_aligned(a + 8);
+            uint64_t w1 = bit_load64_aligned(str1);
+            uint64_t w2 = bit_merge64(lo, hi, shift);
+            if (bit_zero_bytes(w1) | (w1 ^ w2)) break;
+            str1 += 8;
+            str2 += 8;
+            a += 8;
+            lo = hi;
+        }
+    }
+    
+    // Resolve the deciding byte (at most one word remains)
+    while (*str1 == *str2 && *str1 != '\0') {
+        str1++;
+        str2++;
+    }
+    
+    if (*str1 == '\0' && *str2 == '\0') return 0;
+    if (*str1 == '\0') return -1;
+    if (*str2 == '\0') return 1;
+    return *str1 < *str2 ? -1 : 1;
+}
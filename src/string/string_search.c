@@ -1,8 +1,10 @@
 #include "string_ops.h"
+#include "region_marker.h"
 #include <stdlib.h>
 
 /* Basic string search (naive algorithm) */
 int string_find(const char *haystack, const char *needle) {
+    REGION_SCOPE(REGION_STRING_FIND);
     if (!haystack || !needle) return -1;
     
     int haystack_len = string_length(haystack);
@@ -27,33 +29,78 @@ int string_find(const char *haystack, const char *needle) {
 
 /* Optimized string search with early termination */
 int string_find_optimized(const char *haystack, const char *needle) {
+    REGION_SCOPE(REGION_STRING_FIND_OPT);
     if (!haystack || !needle) return -1;
     
     int haystack_len = string_length(haystack);
     int needle_len = string_length(needle);
     
-    if (needle_len == 0) return 0;
-    if (needle_len > haystack_len) return -1;
+    const char *found = string_find_bytes(haystack, haystack_len, needle, needle_len);
+    return found ? (int)(found - haystack) : -1;
+}
+
+/* Bounded search over byte spans (no terminators needed) */
+const char* string_find_bytes(const char *haystack, size_t haystack_len,
+                              const char *needle, size_t needle_len) {
+    return string_find_bytes_at(haystack, haystack_len, needle, needle_len, 0);
+}
+
+/* As string_find_bytes, scanning for needle[anchor] (pick a rare byte) */
+const char* string_find_bytes_at(const char *haystack, size_t haystack_len,
+                                 const char *needle, size_t needle_len, size_t anchor) {
+    if (!haystack || !needle) return NULL;
+    if (needle_len == 0) return haystack;
+    if (needle_len > haystack_len || anchor >= needle_len) return NULL;
     
-    // Quick check for first character
-    char first_char = needle[0];
+    // Jump between anchor-byte candidates with the word-wide memchr
+    const char *candidate = haystack + anchor;
+    const char *last = haystack + (haystack_len - needle_len) + anchor;
     
-    for (int i = 0; i <= haystack_len - needle_len; i++) {
-        // Skip positions where first character doesn't match
-        if (haystack[i] != first_char) continue;
-        
-        // Check remaining characters
-        int match = 1;
-        for (int j = 1; j < needle_len; j++) {
-            if (haystack[i + j] != needle[j]) {
-                match = 0;
-                break;
-            }
+    while ((candidate = string_memchr(candidate, needle[anchor], last - candidate + 1)) != NULL) {
+        // Check the whole needle (haystack aligned, needle merged)
+        if (string_bytes_equal(candidate - anchor, needle, needle_len)) {
+            return candidate - anchor;
         }
-        if (match) return i;
+        candidate++;
     }
     
-    return -1;
+    return NULL;
+}
+
+/* ASCII case-insensitive string_find_optimized, without lowered copies */
+int string_find_nocase(const char *haystack, const char *needle) {
+    if (!haystack || !needle) return -1;
+    
+    int haystack_len = string_length(haystack);
+    int needle_len = string_length(needle);
+    
+    const char *found = string_find_bytes_nocase(haystack, haystack_len, needle, needle_len);
+    return found ? (int)(found - haystack) : -1;
+}
+
+const char* string_find_bytes_nocase(const char *haystack, size_t haystack_len,
+                                     const char *needle, size_t needle_len) {
+    return string_find_bytes_nocase_at(haystack, haystack_len, needle, needle_len, 0);
+}
+
+/* As string_find_bytes_at, folding ASCII case in the scan and the verify */
+const char* string_find_bytes_nocase_at(const char *haystack, size_t haystack_len,
+                                        const char *needle, size_t needle_len, size_t anchor) {
+    if (!haystack || !needle) return NULL;
+    if (needle_len == 0) return haystack;
+    if (needle_len > haystack_len || anchor >= needle_len) return NULL;
+    
+    const char *candidate = haystack + anchor;
+    const char *last = haystack + (haystack_len - needle_len) + anchor;
+    
+    while ((candidate = string_memchr_nocase(candidate, needle[anchor], last - candidate + 1)) != NULL) {
+        if (string_bytes_equal_nocase(candidate - anchor, needle, needle_len)) {
+            return candidate - anchor;
+        }
+        candidate++;
+    }
+    
+    return NULL;
 }
 
 /* KMP (Knuth-Morris-Pratt) string search algorithm */
@@ -79,6 +126,7 @@ static void compute_lps_array(const char *pattern, int *lps, int pattern_len) {
 }
 
 int kmp_search(const char *text, const char *pattern) {
+    REGION_SCOPE(REGION_KMP);
     if (!text || !pattern) return -1;
     
     int text_len = string_length(text);
@@ -120,6 +168,7 @@ int kmp_search(const char *text, const char *pattern) {
 
 /* Boyer-Moore string search algorithm (simplified) */
 int boyer_moore_search(const char *text, const char *pattern) {
+    REGION_SCOPE(REGION_BOYER_MOORE);
     if (!text || !pattern) return -1;
     
     int text_len = string_length(text);
@@ -161,6 +210,7 @@ int boyer_moore_search(const char *text, const char *pattern) {
 #define PRIME 101
 
 int rabin_karp_search(const char *text, const char *pattern) {
+    REGION_SCOPE(REGION_RABIN_KARP);
     if (!text || !pattern) return -1;
     
     int text_len = string_length(text);
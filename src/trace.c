@@ -0,0 +1,181 @@
+#define _POSIX_C_SOURCE 200112L
+#include "trace.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+typedef struct TraceBuffer {
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+    uint64_t head;              /* total events written; slot = head % capacity */
+    int thread_index;
+    int in_use;                 /* owned by a live thread; cleared when it exits */
+    struct TraceBuffer *next;
+} TraceBuffer;
+
+static int trace_active = 0;
+static int trace_thread_counter = 0;
+static TraceBuffer *trace_buffers = NULL;     /* lock-free list of all buffers */
+static __thread TraceBuffer *thread_buffer = NULL;
+static pthread_key_t trace_exit_key;
+static pthread_once_t trace_key_once = PTHREAD_ONCE_INIT;
+
+static uint64_t trace_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Thread exit: hand the buffer back for the next thread to append to */
+static void trace_release_buffer(void *buffer) {
+    __atomic_store_n(&((TraceBuffer *)buffer)->in_use, 0, __ATOMIC_RELEASE);
+}
+
+static void trace_create_key(void) {
+    pthread_key_create(&trace_exit_key, trace_release_buffer);
+}
+
+/*
+ * Claim a buffer released by an exited thread, or allocate one and
+ * publish it with a CAS push. parallel_for starts fresh threads on every
+ * call, so reuse keeps memory and the number of timeline rows bounded
+ * by the peak thread count.
+ */
+static TraceBuffer *trace_thread_buffer(void) {
+    if (thread_buffer) return thread_buffer;
+
+    pthread_once(&trace_key_once, trace_create_key);
+    TraceBuffer *buffer = NULL;
+    for (TraceBuffer *b = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE); b && !buffer; b = b->next) {
+        int expected = 0;
+        if (__atomic_compare_exchange_n(&b->in_use, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            buffer = b;
+        }
+    }
+    if (buffer) {
+        thread_buffer = buffer;
+        pthread_setspecific(trace_exit_key, buffer);
+        return buffer;
+    }
+
+    buffer = calloc(1, sizeof(TraceBuffer));
+    if (!buffer) return NULL;
+
+    buffer->in_use = 1;
+    buffer->thread_index = __atomic_fetch_add(&trace_thread_counter, 1, __ATOMIC_RELAXED);
+    buffer->next = __atomic_load_n(&trace_buffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&trace_buffers, &buffer->next, buffer, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        /* buffer->next was refreshed by the failed CAS */
+    }
+
+    thread_buffer = buffer;
+    pthread_setspecific(trace_exit_key, buffer);
+    return buffer;
+}
+
+void trace_enable(void) {
+    __atomic_store_n(&trace_active, 1, __ATOMIC_RELEASE);
+}
+
+void trace_disable(void) {
+    __atomic_store_n(&trace_active, 0, __ATOMIC_RELEASE);
+}
+
+int trace_is_enabled(void) {
+    return __atomic_load_n(&trace_active, __ATOMIC_RELAXED);
+}
+
+void trace_record(const char *name, char phase) {
+    TraceBuffer *buffer = trace_thread_buffer();
+    if (!buffer) return;
+
+    uint64_t head = buffer->head;
+    TraceEvent *event = &buffer->events[head & (TRACE_BUFFER_EVENTS - 1)];
+    event->name = name;
+    event->timestamp_ns = trace_now_ns();
+    event->phase = phase;
+
+    // Publish the slot before advancing head so a concurrent exporter
+    // never sees a half-written event
+    __atomic_store_n(&buffer->head, head + 1, __ATOMIC_RELEASE);
+}
+
+const char* trace_zone_begin(const char *name) {
+    if (__builtin_expect(trace_is_enabled(), 0)) {
+        trace_record(name, 'B');
+    }
+    return name;
+}
+
+void trace_zone_end(const char *name) {
+    if (__builtin_expect(trace_is_enabled(), 0)) {
+        trace_record(name, 'E');
+    }
+}
+
+void trace_zone_cleanup(const char **name) {
+    trace_zone_end(*name);
+}
+
+static void trace_write_json_string(FILE *out, const char *s) {
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') fputc('\\', out);
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+int trace_export_chrome(const char *path) {
+    if (!path) return -1;
+
+    FILE *out = fopen(path, "w");
+    if (!out) return -1;
+
+    uint64_t origin = UINT64_MAX;
+    TraceBuffer *list = __atomic_load_n(&trace_buffers, __ATOMIC_ACQUIRE);
+
+    // Timestamps are emitted relative to the earliest surviving event
+    for (TraceBuffer *b = list; b; b = b->next) {
+        uint64_t head = __atomic_load_n(&b->head, __ATOMIC_ACQUIRE);
+        uint64_t first = (head > TRACE_BUFFER_EVENTS) ? head - TRACE_BUFFER_EVENTS : 0;
+        if (head > first && b->events[first & (TRACE_BUFFER_EVENTS - 1)].timestamp_ns < origin) {
+            origin = b->events[first & (TRACE_BUFFER_EVENTS - 1)].timestamp_ns;
+        }
+    }
+    if (origin == UINT64_MAX) origin = 0;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    int first_record = 1;
+    long total = 0;
+
+    for (TraceBuffer *b = list; b; b = b->next) {
+        uint64_t head = __atomic_load_n(&b->head, __ATOMIC_ACQUIRE);
+        uint64_t first = (head > TRACE_BUFFER_EVENTS) ? head - TRACE_BUFFER_EVENTS : 0;
+        int depth = 0;
+
+        fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":\"worker %d\"}}",
+                first_record ? "" : ",\n", b->thread_index, b->thread_index);
+        first_record = 0;
+
+        for (uint64_t i = first; i < head; i++) {
+            const TraceEvent *e = &b->events[i & (TRACE_BUFFER_EVENTS - 1)];
+            // A wrapped ring can start inside zones whose 'B' was overwritten
+            if (e->phase == 'E' && depth == 0) continue;
+            depth += e->phase == 'B' ? 1 : -1;
+            fprintf(out, ",\n{\"name\":");
+            trace_write_json_string(out, e->name);
+            fprintf(out, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                    e->phase, (e->timestamp_ns - origin) / 1000.0, b->thread_index);
+            total++;
+        }
+    }
+
+    fprintf(out, "\n]}\n");
+    fclose(out);
+
+    printf("Trace written to %s (%ld events)\n", path, total);
+    return 0;
+}
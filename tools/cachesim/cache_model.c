@@ -0,0 +1,427 @@
+#include "cache_model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_VALID      0x1
+#define LINE_DIRTY      0x2
+#define LINE_PREFETCHED 0x4
+
+/*
+ * Presets approximate published figures for a few RISC-V cores; use
+ * --level to model anything else.
+ */
+typedef struct {
+    const char *name;
+    const char *levels[CACHE_MAX_LEVELS];
+    int memory_latency;
+} CachePreset;
+
+static const CachePreset presets[] = {
+    { "generic", { "L1D:32K:8:64:lru:4", "L2:512K:8:64:lru:14", "L3:8M:16:64:lru:40" }, 200 },
+    { "u74",     { "L1D:32K:8:64:lru:3", "L2:2M:16:64:random:21" }, 150 },
+    { "c910",    { "L1D:64K:2:64:lru:3", "L2:1M:16:64:lru:16" }, 150 },
+};
+
+static int is_power_of_two(size_t x) {
+    return x && (x & (x - 1)) == 0;
+}
+
+static int log2_size(size_t x) {
+    int shift = 0;
+    while ((1ULL << shift) < x) shift++;
+    return shift;
+}
+
+/* "32K", "2M", "65536" */
+static int parse_size(const char *s, size_t *out) {
+    char *end;
+    unsigned long long value = strtoull(s, &end, 10);
+    if (end == s) return -1;
+    if (*end == 'K' || *end == 'k') { value <<= 10; end++; }
+    else if (*end == 'M' || *end == 'm') { value <<= 20; end++; }
+    if (*end != '\0') return -1;
+    *out = (size_t)value;
+    return 0;
+}
+
+static int parse_policy(const char *s, ReplacementPolicy *policy) {
+    if (strcmp(s, "lru") == 0) *policy = REPL_LRU;
+    else if (strcmp(s, "fifo") == 0) *policy = REPL_FIFO;
+    else if (strcmp(s, "random") == 0) *policy = REPL_RANDOM;
+    else return -1;
+    return 0;
+}
+
+const char *cache_policy_name(ReplacementPolicy policy) {
+    switch (policy) {
+    case REPL_FIFO:   return "fifo";
+    case REPL_RANDOM: return "random";
+    default:          return "lru";
+    }
+}
+
+const char *cache_prefetch_name(PrefetchPolicy policy) {
+    switch (policy) {
+    case PREFETCH_NEXT_LINE: return "next-line";
+    case PREFETCH_STRIDE:    return "stride";
+    default:                 return "none";
+    }
+}
+
+int cache_parse_prefetch(const char *name, PrefetchPolicy *policy) {
+    if (strcmp(name, "none") == 0) *policy = PREFETCH_NONE;
+    else if (strcmp(name, "next-line") == 0) *policy = PREFETCH_NEXT_LINE;
+    else if (strcmp(name, "stride") == 0) *policy = PREFETCH_STRIDE;
+    else return -1;
+    return 0;
+}
+
+int cache_config_add_level(CacheConfig *config, const char *spec) {
+    char buffer[128];
+    char *fields[6] = { 0 };
+    int count = 0;
+
+    if (config->level_count >= CACHE_MAX_LEVELS || strlen(spec) >= sizeof(buffer)) return -1;
+    strcpy(buffer, spec);
+
+    for (char *p = buffer; p && count < 6; count++) {
+        fields[count] = p;
+        p = strchr(p, ':');
+        if (p) *p++ = '\0';
+    }
+    if (count < 4) return -1;
+
+    CacheLevelConfig *level = &config->levels[config->level_count];
+    memset(level, 0, sizeof(*level));
+    snprintf(level->name, sizeof(level->name), "%s", fields[0]);
+    if (parse_size(fields[1], &level->size) != 0) return -1;
+    level->ways = atoi(fields[2]);
+    level->line_size = atoi(fields[3]);
+    level->policy = REPL_LRU;
+    level->latency = 4 * (config->level_count + 1);
+    if (count > 4 && parse_policy(fields[4], &level->policy) != 0) return -1;
+    if (count > 5) level->latency = atoi(fields[5]);
+
+    if (level->ways <= 0 || !is_power_of_two((size_t)level->line_size)) return -1;
+    size_t sets = level->size / ((size_t)level->ways * (size_t)level->line_size);
+    if (!is_power_of_two(sets)) return -1;
+
+    config->level_count++;
+    return 0;
+}
+
+int cache_config_preset(CacheConfig *config, const char *name) {
+    for (size_t i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+        if (strcmp(presets[i].name, name) != 0) continue;
+
+        config->level_count = 0;
+        for (int l = 0; l < CACHE_MAX_LEVELS && presets[i].levels[l]; l++) {
+            if (cache_config_add_level(config, presets[i].levels[l]) != 0) return -1;
+        }
+        config->memory_latency = presets[i].memory_latency;
+        return 0;
+    }
+    return -1;
+}
+
+void cache_config_init(CacheConfig *config) {
+    memset(config, 0, sizeof(*config));
+    cache_config_preset(config, "generic");
+    config->prefetch_degree = 1;
+}
+
+int cache_config_parse_option(CacheConfig *config, const char *option, const char *value,
+                              int *custom_levels) {
+    if (strcmp(option, "--preset") == 0) {
+        if (cache_config_preset(config, value) != 0) {
+            fprintf(stderr, "Unknown cache preset: %s\n", value);
+            return -1;
+        }
+        *custom_levels = 0;
+    } else if (strcmp(option, "--level") == 0) {
+        if (!*custom_levels) config->level_count = 0;
+        *custom_levels = 1;
+        if (cache_config_add_level(config, value) != 0) {
+            fprintf(stderr, "Invalid cache level: %s\n", value);
+            return -1;
+        }
+    } else if (strcmp(option, "--memory-latency") == 0) {
+        config->memory_latency = atoi(value);
+    } else if (strcmp(option, "--prefetch") == 0) {
+        if (cache_parse_prefetch(value, &config->prefetch) != 0) {
+            fprintf(stderr, "Unknown prefetcher: %s\n", value);
+            return -1;
+        }
+    } else if (strcmp(option, "--prefetch-degree") == 0) {
+        config->prefetch_degree = atoi(value);
+    } else if (strcmp(option, "--prefetch-level") == 0) {
+        config->prefetch_level = atoi(value) - 1;
+    } else if (strcmp(option, "--seed") == 0) {
+        config->seed = strtoull(value, NULL, 0);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+int cache_config_validate(const CacheConfig *config) {
+    if (config->prefetch_level < 0 || config->prefetch_level >= config->level_count) {
+        fprintf(stderr, "Prefetch level must be between 1 and %d\n", config->level_count);
+        return -1;
+    }
+    return 0;
+}
+
+void cache_config_print(const CacheConfig *config) {
+    printf("# Cache hierarchy\n");
+    for (int l = 0; l < config->level_count; l++) {
+        const CacheLevelConfig *c = &config->levels[l];
+        printf("#   %-4s %8zu KB  %2d-way  %3d B lines  %-6s  %3d cycles\n",
+               c->name, c->size / 1024, c->ways, c->line_size,
+               cache_policy_name(c->policy), c->latency);
+    }
+    printf("#   memory %d cycles, prefetch %s", config->memory_latency,
+           cache_prefetch_name(config->prefetch));
+    if (config->prefetch != PREFETCH_NONE) {
+        printf(" (degree %d into L%d)", config->prefetch_degree, config->prefetch_level + 1);
+    }
+    printf("\n");
+}
+
+CacheHierarchy *cache_hierarchy_create(const CacheConfig *config) {
+    if (config->level_count <= 0) return NULL;
+
+    CacheHierarchy *h = calloc(1, sizeof(CacheHierarchy));
+    if (!h) return NULL;
+    h->config = *config;
+    h->rng = config->seed ? config->seed : 0x9E3779B97F4A7C15ULL;
+
+    for (int l = 0; l < config->level_count; l++) {
+        CacheLevel *level = &h->levels[l];
+        level->config = config->levels[l];
+        level->sets = level->config.size / ((size_t)level->config.ways * level->config.line_size);
+        level->line_shift = log2_size((size_t)level->config.line_size);
+
+        size_t lines = level->sets * (size_t)level->config.ways;
+        level->tags = calloc(lines, sizeof(uint64_t));
+        level->stamps = calloc(lines, sizeof(uint64_t));
+        level->flags = calloc(lines, sizeof(uint8_t));
+        if (!level->tags || !level->stamps || !level->flags) {
+            cache_hierarchy_destroy(h);
+            return NULL;
+        }
+    }
+    return h;
+}
+
+void cache_hierarchy_destroy(CacheHierarchy *h) {
+    if (!h) return;
+    for (int l = 0; l < CACHE_MAX_LEVELS; l++) {
+        free(h->levels[l].tags);
+        free(h->levels[l].stamps);
+        free(h->levels[l].flags);
+    }
+    free(h);
+}
+
+static uint64_t next_random(CacheHierarchy *h) {
+    h->rng ^= h->rng << 13;
+    h->rng ^= h->rng >> 7;
+    h->rng ^= h->rng << 17;
+    return h->rng;
+}
+
+/* Way holding `line` in its set, or -1 */
+static int level_lookup(const CacheLevel *level, uint64_t line, size_t *base) {
+    int ways = level->config.ways;
+    *base = (size_t)(line & (level->sets - 1)) * (size_t)ways;
+
+    for (int w = 0; w < ways; w++) {
+        size_t slot = *base + (size_t)w;
+        if ((level->flags[slot] & LINE_VALID) && level->tags[slot] == line) return w;
+    }
+    return -1;
+}
+
+static size_t level_fill(CacheHierarchy *h, int l, uint64_t line, size_t base, int region);
+
+/* Write a dirty line evicted from level l into the next level out, or memory */
+static void level_writeback(CacheHierarchy *h, int l, uint64_t addr, int region) {
+    if (l + 1 >= h->config.level_count) {
+        h->memory_accesses[region]++;
+        return;
+    }
+
+    CacheLevel *next = &h->levels[l + 1];
+    uint64_t line = addr >> next->line_shift;
+    size_t base;
+    int way = level_lookup(next, line, &base);
+    size_t slot = way >= 0 ? base + (size_t)way : level_fill(h, l + 1, line, base, region);
+    next->flags[slot] |= LINE_DIRTY;
+}
+
+/* Install `line` in level l, evicting a victim; returns the slot used */
+static size_t level_fill(CacheHierarchy *h, int l, uint64_t line, size_t base, int region) {
+    CacheLevel *level = &h->levels[l];
+    int ways = level->config.ways;
+    int victim = -1;
+
+    for (int w = 0; w < ways; w++) {
+        if (!(level->flags[base + (size_t)w] & LINE_VALID)) {
+            victim = w;
+            break;
+        }
+    }
+
+    if (victim < 0) {
+        if (level->config.policy == REPL_RANDOM) {
+            victim = (int)(next_random(h) % (uint64_t)ways);
+        } else {
+            // LRU and FIFO both evict the oldest stamp; they differ in
+            // whether hits refresh it
+            victim = 0;
+            for (int w = 1; w < ways; w++) {
+                if (level->stamps[base + (size_t)w] < level->stamps[base + (size_t)victim]) victim = w;
+            }
+        }
+        if (level->flags[base + (size_t)victim] & LINE_DIRTY) {
+            level->stats[region].writebacks++;
+            level_writeback(h, l, level->tags[base + (size_t)victim] << level->line_shift, region);
+        }
+    }
+
+    size_t slot = base + (size_t)victim;
+    level->tags[slot] = line;
+    level->stamps[slot] = ++h->clock;
+    level->flags[slot] = LINE_VALID;
+    return slot;
+}
+
+/* Bring the line holding `addr` into levels [first, level_count) without demand stats */
+static void prefetch_line(CacheHierarchy *h, uint64_t addr, int region) {
+    for (int l = h->config.prefetch_level; l < h->config.level_count; l++) {
+        CacheLevel *level = &h->levels[l];
+        uint64_t line = addr >> level->line_shift;
+        size_t base;
+
+        if (level_lookup(level, line, &base) >= 0) break;
+        size_t slot = level_fill(h, l, line, base, region);
+        level->flags[slot] |= LINE_PREFETCHED;
+        level->stats[region].prefetch_fills++;
+    }
+}
+
+static void run_prefetcher(CacheHierarchy *h, uint64_t addr, uint64_t pc, int trigger, int region) {
+    int line_size = h->levels[0].config.line_size;
+    int degree = h->config.prefetch_degree > 0 ? h->config.prefetch_degree : 1;
+
+    if (h->config.prefetch == PREFETCH_NEXT_LINE) {
+        if (!trigger) return;
+        for (int d = 1; d <= degree; d++) {
+            prefetch_line(h, addr + (uint64_t)d * (uint64_t)line_size, region);
+        }
+    } else if (h->config.prefetch == PREFETCH_STRIDE) {
+        StrideEntry *e = &h->stride_table[(pc >> 1) % STRIDE_TABLE_SIZE];
+        if (e->pc != pc) {
+            e->pc = pc;
+            e->last_addr = addr;
+            e->stride = 0;
+            e->confidence = 0;
+            return;
+        }
+
+        int64_t stride = (int64_t)(addr - e->last_addr);
+        e->last_addr = addr;
+        if (stride != 0 && stride == e->stride) {
+            if (e->confidence < 3) e->confidence++;
+        } else {
+            e->stride = stride;
+            e->confidence = 0;
+        }
+
+        // Prefetch once the stride has repeated twice; strides shorter
+        // than a line advance a whole line per step instead
+        if (e->confidence >= 2) {
+            int64_t step = stride;
+            if (step < line_size && step > -line_size) step = (step > 0) ? line_size : -line_size;
+            for (int d = 1; d <= degree; d++) {
+                prefetch_line(h, addr + (uint64_t)(step * d), region);
+            }
+        }
+    }
+}
+
+/* Demand access to one line; returns the serving level */
+static int access_line(CacheHierarchy *h, uint64_t addr, int is_store, int region) {
+    int served = h->config.level_count;
+
+    for (int l = 0; l < h->config.level_count; l++) {
+        CacheLevel *level = &h->levels[l];
+        uint64_t line = addr >> level->line_shift;
+        size_t base;
+        int way = level_lookup(level, line, &base);
+
+        level->stats[region].accesses++;
+        if (way >= 0) {
+            size_t slot = base + (size_t)way;
+            if (level->flags[slot] & LINE_PREFETCHED) {
+                level->stats[region].prefetch_useful++;
+                level->flags[slot] &= (uint8_t)~LINE_PREFETCHED;
+            }
+            if (level->config.policy == REPL_LRU) level->stamps[slot] = ++h->clock;
+            served = l;
+            break;
+        }
+        level->stats[region].misses++;
+    }
+
+    if (served == h->config.level_count) h->memory_accesses[region]++;
+
+    // Fill every level that missed, innermost last so it is the freshest
+    for (int l = served - 1; l >= 0; l--) {
+        CacheLevel *level = &h->levels[l];
+        uint64_t line = addr >> level->line_shift;
+        size_t base;
+        level_lookup(level, line, &base);
+        level_fill(h, l, line, base, region);
+    }
+
+    if (is_store) {
+        CacheLevel *l1 = &h->levels[0];
+        size_t base;
+        int way = level_lookup(l1, addr >> l1->line_shift, &base);
+        if (way >= 0) l1->flags[base + (size_t)way] |= LINE_DIRTY;
+    }
+    return served;
+}
+
+int cache_hierarchy_access(CacheHierarchy *h, uint64_t addr, unsigned int size,
+                           int is_store, uint64_t pc, int region) {
+    if (region < 0 || region >= REGION_COUNT) region = REGION_NONE;
+    if (size == 0) size = 1;
+
+    int shift = h->levels[0].line_shift;
+    uint64_t first = addr >> shift;
+    uint64_t last = (addr + size - 1) >> shift;
+    uint64_t useful = h->levels[0].stats[region].prefetch_useful;
+    int served = 0;
+
+    for (uint64_t line = first; line <= last; line++) {
+        int level = access_line(h, line << shift, is_store, region);
+        if (level > served) served = level;
+    }
+
+    // Tagged next-line: an L1 miss or the first hit on a prefetched line
+    // triggers the next batch
+    if (h->config.prefetch != PREFETCH_NONE) {
+        int trigger = served > 0 || h->levels[0].stats[region].prefetch_useful != useful;
+        run_prefetcher(h, addr, pc, trigger, region);
+    }
+    return served;
+}
+
+int cache_hierarchy_latency(const CacheHierarchy *h, int level) {
+    if (level >= h->config.level_count) return h->config.memory_latency;
+    return h->levels[level].config.latency;
+}
@@ -0,0 +1,129 @@
+#ifndef CACHE_MODEL_H
+#define CACHE_MODEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "region_marker.h"
+
+/*
+ * Trace-driven model of a multi-level, set-associative data cache
+ * hierarchy. Every level is write-back / write-allocate and is filled on
+ * a miss (non-inclusive, no back-invalidation); dirty victims are written
+ * into the next level out, or to memory from the last level. Statistics
+ * are kept per kernel region from region_marker.h.
+ */
+
+#define CACHE_MAX_LEVELS 4
+#define CACHE_NAME_LEN 16
+
+typedef enum {
+    REPL_LRU = 0,
+    REPL_FIFO,
+    REPL_RANDOM
+} ReplacementPolicy;
+
+typedef enum {
+    PREFETCH_NONE = 0,
+    PREFETCH_NEXT_LINE,         /* tagged: L1 miss or prefetch hit fetches `degree` lines */
+    PREFETCH_STRIDE             /* per-PC stride detection, `degree` strides ahead */
+} PrefetchPolicy;
+
+typedef struct {
+    char name[CACHE_NAME_LEN];
+    size_t size;                /* bytes */
+    int ways;
+    int line_size;              /* bytes, power of two */
+    ReplacementPolicy policy;
+    int latency;                /* hit latency in cycles */
+} CacheLevelConfig;
+
+typedef struct {
+    CacheLevelConfig levels[CACHE_MAX_LEVELS];
+    int level_count;
+    int memory_latency;         /* cycles for an access that misses every level */
+    PrefetchPolicy prefetch;
+    int prefetch_degree;
+    int prefetch_level;         /* index of the level prefetches fill (and below) */
+    uint64_t seed;
+} CacheConfig;
+
+typedef struct {
+    uint64_t accesses;
+    uint64_t misses;
+    uint64_t writebacks;
+    uint64_t prefetch_fills;
+    uint64_t prefetch_useful;   /* demand hits on a prefetched line */
+} CacheStats;
+
+typedef struct {
+    CacheLevelConfig config;
+    size_t sets;
+    int line_shift;
+    uint64_t *tags;             /* sets * ways, line address */
+    uint64_t *stamps;           /* last use (LRU) or fill time (FIFO) */
+    uint8_t *flags;
+    CacheStats stats[REGION_COUNT];
+} CacheLevel;
+
+#define STRIDE_TABLE_SIZE 256
+
+typedef struct {
+    uint64_t pc;
+    uint64_t last_addr;
+    int64_t stride;
+    int confidence;
+} StrideEntry;
+
+typedef struct {
+    CacheConfig config;
+    CacheLevel levels[CACHE_MAX_LEVELS];
+    uint64_t clock;
+    uint64_t rng;
+    StrideEntry stride_table[STRIDE_TABLE_SIZE];
+    uint64_t memory_accesses[REGION_COUNT];    /* last-level misses and writebacks */
+} CacheHierarchy;
+
+/* Fill `config` with a named preset ("generic", "u74", "c910"); -1 if unknown */
+int cache_config_preset(CacheConfig *config, const char *name);
+
+/* Parse NAME:SIZE:WAYS:LINE[:POLICY[:LATENCY]] and append it as the next level */
+int cache_config_add_level(CacheConfig *config, const char *spec);
+
+/*
+ * Apply one command-line option shared by the trace tools (--preset,
+ * --level, --memory-latency, --prefetch*, --seed). Returns 1 if the
+ * option was consumed, 0 if it is not a cache option and -1 on a bad
+ * value (after printing a message). *custom_levels tracks whether the
+ * first --level has already replaced the preset hierarchy.
+ */
+int cache_config_parse_option(CacheConfig *config, const char *option, const char *value,
+                              int *custom_levels);
+
+/* Defaults: generic preset, no prefetching */
+void cache_config_init(CacheConfig *config);
+
+/* Check cross-field constraints after parsing; -1 (with a message) if invalid */
+int cache_config_validate(const CacheConfig *config);
+
+void cache_config_print(const CacheConfig *config);
+
+const char *cache_policy_name(ReplacementPolicy policy);
+const char *cache_prefetch_name(PrefetchPolicy policy);
+int cache_parse_prefetch(const char *name, PrefetchPolicy *policy);
+
+CacheHierarchy *cache_hierarchy_create(const CacheConfig *config);
+void cache_hierarchy_destroy(CacheHierarchy *h);
+
+/*
+ * Demand access of `size` bytes at `addr` from instruction `pc`. Returns
+ * the index of the level that served the access (level_count means main
+ * memory); accesses spanning lines report the slowest line.
+ */
+int cache_hierarchy_access(CacheHierarchy *h, uint64_t addr, unsigned int size,
+                           int is_store, uint64_t pc, int region);
+
+/* Load-to-use latency of an access served by `level` (level_count = memory) */
+int cache_hierarchy_latency(const CacheHierarchy *h, int level);
+
+#endif /* CACHE_MODEL_H */
@@ -0,0 +1,213 @@
+/*
+ * Offline cache simulator for memory traces captured by the kernel_profile
+ * QEMU plugin (trace=PATH). Replays every load and store through a
+ * configurable cache hierarchy and reports misses per kernel region.
+ *
+ * All vCPUs share one hierarchy, so run traces with --threads 1 for a
+ * single-core view.
+ *
+ * Usage:
+ *   cachesim [options] TRACE
+ *     --preset NAME            generic (default), u74, c910
+ *     --level SPEC             NAME:SIZE:WAYS:LINE[:lru|fifo|random[:LATENCY]],
+ *                              repeat from L1 outwards (replaces the preset)
+ *     --memory-latency N       cycles for accesses that miss every level
+ *     --prefetch KIND          none, next-line, stride
+ *     --prefetch-degree N      lines (next-line) or strides (stride) ahead
+ *     --prefetch-level N       first level prefetches fill (1 = L1)
+ *     --seed N                 seed for random replacement
+ *     --csv                    CSV output
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cache_model.h"
+#include "mem_trace.h"
+
+#define MAX_VCPUS 1024
+#define MAX_REGION_DEPTH 16
+#define READ_BATCH 4096
+
+typedef struct {
+    int depth;
+    int stack[MAX_REGION_DEPTH];
+} VcpuRegions;
+
+static const char *const region_names[REGION_COUNT] = {
+    "(unmarked)",
+    KERNEL_REGIONS(REGION_NAME_ENTRY)
+};
+
+static VcpuRegions vcpus[MAX_VCPUS];
+
+static int current_region(unsigned int vcpu) {
+    const VcpuRegions *v = &vcpus[vcpu % MAX_VCPUS];
+    if (v->depth == 0) return REGION_NONE;
+    return v->stack[(v->depth < MAX_REGION_DEPTH ? v->depth : MAX_REGION_DEPTH) - 1];
+}
+
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options] TRACE\n"
+            "  --preset NAME         generic (default), u74, c910\n"
+            "  --level SPEC          NAME:SIZE:WAYS:LINE[:lru|fifo|random[:LATENCY]]\n"
+            "  --memory-latency N    main memory latency in cycles\n"
+            "  --prefetch KIND       none, next-line, stride\n"
+            "  --prefetch-degree N   prefetch distance\n"
+            "  --prefetch-level N    first level filled by prefetches (1 = L1)\n"
+            "  --seed N              seed for random replacement\n"
+            "  --csv                 CSV output\n",
+            program);
+}
+
+static void print_report(const CacheHierarchy *h, int csv) {
+    int levels = h->config.level_count;
+
+    if (csv) {
+        printf("region,accesses");
+        for (int l = 0; l < levels; l++) {
+            const char *n = h->levels[l].config.name;
+            printf(",%s_misses,%s_writebacks,%s_prefetch_fills,%s_prefetch_useful", n, n, n, n);
+        }
+        printf(",memory_accesses,amat\n");
+    } else {
+        printf("%-26s %12s", "Region", "Accesses");
+        for (int l = 0; l < levels; l++) {
+            char label[CACHE_NAME_LEN + 8];
+            snprintf(label, sizeof(label), "%s-misses", h->levels[l].config.name);
+            printf(" %15s %7s", label, "rate%");
+        }
+        printf(" %12s %7s\n", "MemAccesses", "AMAT");
+    }
+
+    for (int r = 0; r < REGION_COUNT; r++) {
+        uint64_t accesses = h->levels[0].stats[r].accesses;
+        if (accesses == 0) continue;
+
+        // AMAT from the per-level service counts
+        double cycles = 0.0;
+        uint64_t reached = accesses;
+        for (int l = 0; l < levels; l++) {
+            uint64_t hits = reached - h->levels[l].stats[r].misses;
+            cycles += (double)hits * cache_hierarchy_latency(h, l);
+            reached = h->levels[l].stats[r].misses;
+        }
+        cycles += (double)reached * cache_hierarchy_latency(h, levels);
+        double amat = cycles / (double)accesses;
+
+        if (csv) {
+            printf("%s,%" PRIu64, region_names[r], accesses);
+            for (int l = 0; l < levels; l++) {
+                const CacheStats *s = &h->levels[l].stats[r];
+                printf(",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64,
+                       s->misses, s->writebacks, s->prefetch_fills, s->prefetch_useful);
+            }
+            printf(",%" PRIu64 ",%.3f\n", h->memory_accesses[r], amat);
+            continue;
+        }
+
+        printf("%-26s %12" PRIu64, region_names[r], accesses);
+        for (int l = 0; l < levels; l++) {
+            const CacheStats *s = &h->levels[l].stats[r];
+            double rate = s->accesses ? 100.0 * (double)s->misses / (double)s->accesses : 0.0;
+            printf(" %15" PRIu64 " %7.2f", s->misses, rate);
+        }
+        printf(" %12" PRIu64 " %7.2f\n", h->memory_accesses[r], amat);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    CacheConfig config;
+    const char *trace_path = NULL;
+    int csv = 0;
+    int custom_levels = 0;
+
+    cache_config_init(&config);
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--csv") == 0) {
+            csv = 1;
+            continue;
+        }
+        if (arg[0] != '-') {
+            trace_path = arg;
+            continue;
+        }
+        if (!value) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+
+        int consumed = cache_config_parse_option(&config, arg, value, &custom_levels);
+        if (consumed < 0) return 1;
+        if (consumed == 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!trace_path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (cache_config_validate(&config) != 0) return 1;
+
+    FILE *in = fopen(trace_path, "rb");
+    if (!in) {
+        fprintf(stderr, "Cannot open trace %s\n", trace_path);
+        return 1;
+    }
+
+    char magic[8];
+    if (fread(magic, 1, sizeof(magic), in) != sizeof(magic) ||
+        memcmp(magic, MEM_TRACE_MAGIC, sizeof(magic)) != 0) {
+        fprintf(stderr, "%s is not a kernel_profile memory trace\n", trace_path);
+        fclose(in);
+        return 1;
+    }
+
+    CacheHierarchy *h = cache_hierarchy_create(&config);
+    if (!h) {
+        fprintf(stderr, "Failed to allocate cache model\n");
+        fclose(in);
+        return 1;
+    }
+
+    static MemTraceRecord batch[READ_BATCH];
+    size_t n;
+    while ((n = fread(batch, sizeof(MemTraceRecord), READ_BATCH, in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            const MemTraceRecord *rec = &batch[i];
+            VcpuRegions *v = &vcpus[rec->vcpu % MAX_VCPUS];
+
+            switch (rec->type) {
+            case TRACE_LOAD:
+            case TRACE_STORE:
+                cache_hierarchy_access(h, rec->addr, rec->size, rec->type == TRACE_STORE,
+                                       rec->pc, current_region(rec->vcpu));
+                break;
+            case TRACE_REGION_BEGIN:
+                if (v->depth < MAX_REGION_DEPTH) v->stack[v->depth] = (int)rec->addr;
+                v->depth++;
+                break;
+            case TRACE_REGION_END:
+                if (v->depth > 0) v->depth--;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    fclose(in);
+
+    if (!csv) cache_config_print(&config);
+    print_report(h, csv);
+    cache_hierarchy_destroy(h);
+    return 0;
+}
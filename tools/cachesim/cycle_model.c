@@ -0,0 +1,389 @@
+#include "cycle_model.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_VCPUS 1024
+#define MAX_REGION_DEPTH 16
+#define MAX_RAS_DEPTH 64
+
+/*
+ * Presets approximate public descriptions of each core; treat them as
+ * starting points and override individual fields on the command line.
+ */
+typedef struct {
+    const char *name;
+    int out_of_order;
+    int issue_width;
+    int window;
+    int mispredict_penalty;
+    int bp_entries;
+    int bp_history;
+    int latency[INSN_CLASS_COUNT];
+} CorePreset;
+
+/* int_alu, int_muldiv, load, store, branch, jump, fp, fp_divsqrt, vector, vector_mem, atomic, system */
+static const CorePreset core_presets[] = {
+    { "generic", 1, 4, 128, 14, 4096, 12, { 1, 4, 4, 1, 1, 1, 4, 20, 4, 4, 20, 10 } },
+    { "u74",     0, 2,   0,  5, 1024,  0, { 1, 4, 3, 1, 1, 1, 5, 24, 4, 3, 20, 10 } },
+    { "c910",    1, 3, 192, 12, 4096, 12, { 1, 4, 3, 1, 1, 1, 4, 20, 4, 3, 20, 10 } },
+};
+
+struct VcpuPipeline {
+    uint64_t reg_ready[RISCV_REG_COUNT];
+    uint64_t fetch_ready;       /* earliest issue after a mispredict */
+    uint64_t issue_cycle;
+    int issue_count;
+    uint64_t retire_cycle;
+    int retire_count;
+    uint64_t *rob;              /* retire cycle per window slot */
+    uint64_t seq;
+    uint64_t progress;          /* time already attributed to regions */
+    uint64_t last_complete;
+    int last_region;
+
+    uint8_t *bp_counters;
+    uint64_t *btb;
+    uint64_t history;
+    uint64_t ras[MAX_RAS_DEPTH];
+    int ras_top;
+
+    int region_depth;
+    int region_stack[MAX_REGION_DEPTH];
+
+    /* Instruction awaiting its memory records and successor PC */
+    int has_pending;
+    uint64_t pending_pc;
+    uint32_t pending_raw;
+    int pending_region;
+    int pending_level;          /* slowest cache level served, -1 if none */
+    uint64_t pending_skip;      /* marker bytes between it and its successor */
+};
+
+int core_config_preset(CoreConfig *config, const char *name) {
+    for (size_t i = 0; i < sizeof(core_presets) / sizeof(core_presets[0]); i++) {
+        const CorePreset *p = &core_presets[i];
+        if (strcmp(p->name, name) != 0) continue;
+
+        memset(config, 0, sizeof(*config));
+        snprintf(config->name, sizeof(config->name), "%s", p->name);
+        config->out_of_order = p->out_of_order;
+        config->issue_width = p->issue_width;
+        config->window = p->window;
+        config->mispredict_penalty = p->mispredict_penalty;
+        config->bp_entries = p->bp_entries;
+        config->bp_history = p->bp_history;
+        config->ras_depth = 16;
+        memcpy(config->latency, p->latency, sizeof(config->latency));
+        return 0;
+    }
+    return -1;
+}
+
+static int parse_latency(CoreConfig *config, const char *spec) {
+    const char *eq = strchr(spec, '=');
+    if (!eq) return -1;
+
+    for (int c = 0; c < INSN_CLASS_COUNT; c++) {
+        size_t len = strlen(insn_class_names[c]);
+        if ((size_t)(eq - spec) == len && strncmp(spec, insn_class_names[c], len) == 0) {
+            config->latency[c] = atoi(eq + 1);
+            return 0;
+        }
+    }
+    return -1;
+}
+
+int core_config_parse_option(CoreConfig *config, const char *option, const char *value) {
+    if (strcmp(option, "--core") == 0) {
+        if (core_config_preset(config, value) != 0) {
+            fprintf(stderr, "Unknown core preset: %s\n", value);
+            return -1;
+        }
+    } else if (strcmp(option, "--pipeline") == 0) {
+        if (strcmp(value, "in-order") == 0) config->out_of_order = 0;
+        else if (strcmp(value, "out-of-order") == 0) config->out_of_order = 1;
+        else {
+            fprintf(stderr, "Pipeline must be in-order or out-of-order\n");
+            return -1;
+        }
+    } else if (strcmp(option, "--width") == 0) {
+        config->issue_width = atoi(value);
+    } else if (strcmp(option, "--window") == 0) {
+        config->window = atoi(value);
+    } else if (strcmp(option, "--mispredict-penalty") == 0) {
+        config->mispredict_penalty = atoi(value);
+    } else if (strcmp(option, "--bp-entries") == 0) {
+        config->bp_entries = atoi(value);
+    } else if (strcmp(option, "--bp-history") == 0) {
+        config->bp_history = atoi(value);
+    } else if (strcmp(option, "--latency") == 0) {
+        if (parse_latency(config, value) != 0) {
+            fprintf(stderr, "Invalid latency (expected CLASS=N): %s\n", value);
+            return -1;
+        }
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+void core_config_print(const CoreConfig *config) {
+    printf("# Core %s: %s, width %d", config->name,
+           config->out_of_order ? "out-of-order" : "in-order", config->issue_width);
+    if (config->out_of_order) printf(", window %d", config->window);
+    printf(", mispredict %d cycles, %d-entry %s predictor\n", config->mispredict_penalty,
+           config->bp_entries, config->bp_history ? "gshare" : "bimodal");
+    printf("#   latencies:");
+    for (int c = 0; c < INSN_CLASS_COUNT; c++) {
+        if (c == INSN_LOAD || c == INSN_VECTOR_MEM) continue;
+        printf(" %s=%d", insn_class_names[c], config->latency[c]);
+    }
+    printf("\n");
+}
+
+static int is_power_of_two(int x) {
+    return x > 0 && (x & (x - 1)) == 0;
+}
+
+CycleModel *cycle_model_create(const CoreConfig *config, CacheHierarchy *cache) {
+    if (config->issue_width <= 0 || !is_power_of_two(config->bp_entries)) return NULL;
+    if (config->out_of_order && config->window <= 0) return NULL;
+
+    CycleModel *model = calloc(1, sizeof(CycleModel));
+    if (!model) return NULL;
+    model->config = *config;
+    if (model->config.ras_depth > MAX_RAS_DEPTH) model->config.ras_depth = MAX_RAS_DEPTH;
+    model->cache = cache;
+    model->vcpus = calloc(MAX_VCPUS, sizeof(VcpuPipeline *));
+    if (!model->vcpus) {
+        free(model);
+        return NULL;
+    }
+    return model;
+}
+
+void cycle_model_destroy(CycleModel *model) {
+    if (!model) return;
+    for (int i = 0; i < MAX_VCPUS; i++) {
+        VcpuPipeline *v = model->vcpus[i];
+        if (!v) continue;
+        free(v->rob);
+        free(v->bp_counters);
+        free(v->btb);
+        free(v);
+    }
+    free(model->vcpus);
+    free(model);
+}
+
+static VcpuPipeline *get_vcpu(CycleModel *model, unsigned int index) {
+    index %= MAX_VCPUS;
+    if (model->vcpus[index]) return model->vcpus[index];
+
+    VcpuPipeline *v = calloc(1, sizeof(VcpuPipeline));
+    if (!v) return NULL;
+    size_t entries = (size_t)model->config.bp_entries;
+    v->bp_counters = malloc(entries);
+    v->btb = calloc(entries, sizeof(uint64_t));
+    if (model->config.out_of_order) v->rob = calloc((size_t)model->config.window, sizeof(uint64_t));
+    if (!v->bp_counters || !v->btb || (model->config.out_of_order && !v->rob)) {
+        free(v->bp_counters);
+        free(v->btb);
+        free(v->rob);
+        free(v);
+        return NULL;
+    }
+    memset(v->bp_counters, 1, entries);     // weakly not-taken
+    model->vcpus[index] = v;
+    model->vcpu_count++;
+    return v;
+}
+
+static int current_region(const VcpuPipeline *v) {
+    if (v->region_depth == 0) return REGION_NONE;
+    int depth = v->region_depth < MAX_REGION_DEPTH ? v->region_depth : MAX_REGION_DEPTH;
+    return v->region_stack[depth - 1];
+}
+
+/* Claim one of `width` slots at or after cycle t; slots are handed out in order */
+static uint64_t take_slot(uint64_t *cycle, int *count, uint64_t t, int width) {
+    if (t > *cycle) {
+        *cycle = t;
+        *count = 0;
+    }
+    if (*count >= width) {
+        (*cycle)++;
+        *count = 0;
+    }
+    (*count)++;
+    return *cycle;
+}
+
+static uint64_t max_u64(uint64_t a, uint64_t b) {
+    return a > b ? a : b;
+}
+
+/* Returns 1 if the control transfer to next_pc was mispredicted */
+static int predict_control(const CycleModel *model, VcpuPipeline *v, uint32_t raw,
+                           const InsnOperands *ops, uint64_t pc, uint64_t next_pc) {
+    const CoreConfig *c = &model->config;
+    InsnClass cls = riscv_classify(raw);
+    uint64_t fallthrough = pc + riscv_insn_length(raw);
+    int taken = next_pc != fallthrough + v->pending_skip;
+    uint64_t mask = (uint64_t)c->bp_entries - 1;
+
+    if (cls == INSN_BRANCH) {
+        uint64_t history = c->bp_history ? (v->history & ((1ULL << c->bp_history) - 1)) : 0;
+        uint8_t *ctr = &v->bp_counters[((pc >> 1) ^ history) & mask];
+        int predicted = *ctr >= 2;
+
+        if (taken && *ctr < 3) (*ctr)++;
+        if (!taken && *ctr > 0) (*ctr)--;
+        v->history = (v->history << 1) | (uint64_t)taken;
+        return predicted != taken;
+    }
+
+    if (cls != INSN_JUMP) return 0;
+
+    int mispredicted = 0;
+    int is_call = ops->dst == 1 || ops->dst == 5;
+    int is_return = !is_call && ops->dst == REG_NONE && (ops->src[0] == 1 || ops->src[0] == 5);
+
+    if (riscv_is_direct_jump(raw)) {
+        mispredicted = 0;                   // target known at decode
+    } else if (is_return && v->ras_top > 0) {
+        mispredicted = v->ras[--v->ras_top] != next_pc;
+    } else {
+        uint64_t *target = &v->btb[(pc >> 1) & mask];
+        mispredicted = *target != next_pc;
+        *target = next_pc;
+    }
+
+    if (is_call && c->ras_depth > 0) {
+        // On overflow drop the oldest entry, as a circular hardware stack would
+        if (v->ras_top >= c->ras_depth) {
+            memmove(v->ras, v->ras + 1, (size_t)(c->ras_depth - 1) * sizeof(uint64_t));
+            v->ras_top = c->ras_depth - 1;
+        }
+        v->ras[v->ras_top++] = fallthrough;
+    }
+    return mispredicted;
+}
+
+static void retire_pending(CycleModel *model, VcpuPipeline *v, int have_next, uint64_t next_pc) {
+    const CoreConfig *c = &model->config;
+    uint32_t raw = v->pending_raw;
+    InsnClass cls = riscv_classify(raw);
+    InsnOperands ops;
+    riscv_operands(raw, &ops);
+
+    uint64_t ready = 0;
+    for (int s = 0; s < 3; s++) {
+        if (ops.src[s] != REG_NONE) ready = max_u64(ready, v->reg_ready[ops.src[s]]);
+    }
+
+    uint64_t latency = (uint64_t)c->latency[cls];
+    if (cls == INSN_LOAD || cls == INSN_VECTOR_MEM || cls == INSN_ATOMIC) {
+        int level = v->pending_level >= 0 ? v->pending_level : 0;
+        uint64_t memory = (uint64_t)cache_hierarchy_latency(model->cache, level);
+        latency = (cls == INSN_ATOMIC) ? max_u64(latency, memory) : memory;
+    }
+
+    uint64_t complete;
+    uint64_t progress;
+    if (!c->out_of_order) {
+        uint64_t t = max_u64(max_u64(ready, v->fetch_ready), v->issue_cycle);
+        t = take_slot(&v->issue_cycle, &v->issue_count, t, c->issue_width);
+        complete = t + latency;
+        progress = t;
+    } else {
+        uint64_t slot = v->seq % (uint64_t)c->window;
+        uint64_t dispatch = v->fetch_ready;
+        if (v->seq >= (uint64_t)c->window) dispatch = max_u64(dispatch, v->rob[slot]);
+        dispatch = take_slot(&v->issue_cycle, &v->issue_count, dispatch, c->issue_width);
+
+        complete = max_u64(dispatch, ready) + latency;
+        uint64_t retire = take_slot(&v->retire_cycle, &v->retire_count, complete, c->issue_width);
+        v->rob[slot] = retire;
+        v->seq++;
+        progress = retire;
+    }
+
+    if (ops.dst != REG_NONE) v->reg_ready[ops.dst] = complete;
+
+    PerfCounters *counters = &model->counters[v->pending_region];
+    if (have_next && predict_control(model, v, raw, &ops, v->pending_pc, next_pc)) {
+        v->fetch_ready = max_u64(v->fetch_ready, complete + (uint64_t)c->mispredict_penalty);
+        counters->branch_misses++;
+    }
+
+    counters->instructions++;
+    if (progress > v->progress) {
+        counters->cycles += (long long)(progress - v->progress);
+        v->progress = progress;
+    }
+    v->last_complete = max_u64(v->last_complete, complete);
+    v->last_region = v->pending_region;
+    v->has_pending = 0;
+}
+
+void cycle_model_record(CycleModel *model, const MemTraceRecord *record) {
+    VcpuPipeline *v = get_vcpu(model, record->vcpu);
+    if (!v) return;
+
+    switch (record->type) {
+    case TRACE_INSN:
+        if (v->has_pending) retire_pending(model, v, 1, record->addr);
+        v->has_pending = 1;
+        v->pending_pc = record->addr;
+        v->pending_raw = record->insn;
+        v->pending_region = current_region(v);
+        v->pending_level = -1;
+        v->pending_skip = 0;
+        break;
+    case TRACE_LOAD:
+    case TRACE_STORE: {
+        int region = v->has_pending ? v->pending_region : current_region(v);
+        int level = cache_hierarchy_access(model->cache, record->addr, record->size,
+                                           record->type == TRACE_STORE, record->pc, region);
+        if (v->has_pending && record->pc == v->pending_pc && level > v->pending_level) {
+            v->pending_level = level;
+        }
+        break;
+    }
+    case TRACE_REGION_BEGIN:
+        if (v->region_depth < MAX_REGION_DEPTH) {
+            int region = (int)record->addr;
+            v->region_stack[v->region_depth] = (region > 0 && region < REGION_COUNT) ? region : REGION_NONE;
+        }
+        v->region_depth++;
+        v->pending_skip += 4;       // markers are uncompressed HINTs
+        break;
+    case TRACE_REGION_END:
+        if (v->region_depth > 0) v->region_depth--;
+        v->pending_skip += 4;
+        break;
+    default:
+        break;
+    }
+}
+
+void cycle_model_finish(CycleModel *model) {
+    for (int i = 0; i < MAX_VCPUS; i++) {
+        VcpuPipeline *v = model->vcpus[i];
+        if (!v) continue;
+        if (v->has_pending) retire_pending(model, v, 0, 0);
+
+        // Drain: the pipeline is busy until the last result is written
+        if (v->last_complete > v->progress) {
+            model->counters[v->last_region].cycles += (long long)(v->last_complete - v->progress);
+            v->progress = v->last_complete;
+        }
+    }
+}
+
+void cycle_model_counters(const CycleModel *model, int region, PerfCounters *counters) {
+    *counters = model->counters[region];
+    counters->cache_misses = (long long)model->cache->levels[0].stats[region].misses;
+}
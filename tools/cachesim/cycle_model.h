@@ -0,0 +1,68 @@
+#ifndef CYCLE_MODEL_H
+#define CYCLE_MODEL_H
+
+#include <stdint.h>
+
+#include "benchmark.h"
+#include "cache_model.h"
+#include "mem_trace.h"
+#include "riscv_decode.h"
+
+/*
+ * Analytical pipeline cost model for instruction traces captured under
+ * QEMU (kernel_profile trace=PATH,insns=on). Each instruction waits for
+ * its source registers, an issue slot and any pending branch redirect;
+ * loads take the latency of the cache level that served them. The
+ * out-of-order variant adds a reorder window and in-order retirement.
+ * Estimates are meant for ranking kernel variants, not absolute timing.
+ */
+
+#define CORE_NAME_LEN 16
+
+typedef struct {
+    char name[CORE_NAME_LEN];
+    int out_of_order;
+    int issue_width;            /* issue (in-order) or dispatch/retire (OoO) per cycle */
+    int window;                 /* reorder buffer entries, out-of-order only */
+    int mispredict_penalty;     /* cycles from branch resolution to refetch */
+    int bp_entries;             /* 2-bit counters / indirect targets, power of two */
+    int bp_history;             /* global history bits hashed in (0 = bimodal) */
+    int ras_depth;
+    int latency[INSN_CLASS_COUNT];  /* loads use the cache model instead */
+} CoreConfig;
+
+typedef struct VcpuPipeline VcpuPipeline;
+
+typedef struct {
+    CoreConfig config;
+    CacheHierarchy *cache;      /* borrowed */
+    VcpuPipeline **vcpus;
+    int vcpu_count;
+    PerfCounters counters[REGION_COUNT];
+} CycleModel;
+
+/* Fill `config` with a named core ("generic", "u74", "c910"); -1 if unknown */
+int core_config_preset(CoreConfig *config, const char *name);
+
+/*
+ * Apply one core option (--core, --pipeline, --width, --window,
+ * --mispredict-penalty, --bp-entries, --bp-history, --latency CLASS=N).
+ * Same return convention as cache_config_parse_option.
+ */
+int core_config_parse_option(CoreConfig *config, const char *option, const char *value);
+
+void core_config_print(const CoreConfig *config);
+
+CycleModel *cycle_model_create(const CoreConfig *config, CacheHierarchy *cache);
+void cycle_model_destroy(CycleModel *model);
+
+/* Feed the next trace record (any type) */
+void cycle_model_record(CycleModel *model, const MemTraceRecord *record);
+
+/* Retire in-flight instructions at the end of the trace */
+void cycle_model_finish(CycleModel *model);
+
+/* Estimated counters for one region; cache_misses are L1 demand misses */
+void cycle_model_counters(const CycleModel *model, int region, PerfCounters *counters);
+
+#endif /* CYCLE_MODEL_H */
@@ -0,0 +1,189 @@
+/*
+ * Estimated cycles and IPC per kernel region for instruction traces
+ * captured by the kernel_profile QEMU plugin (trace=PATH,insns=on).
+ * Loads and stores go through the cache model of cachesim, so all of its
+ * options apply; when no cache option is given the cache preset with the
+ * core's name is used if one exists.
+ *
+ * Usage:
+ *   cyclesim [options] TRACE
+ *     --core NAME                 generic (default, out-of-order), u74, c910
+ *     --pipeline KIND             in-order, out-of-order
+ *     --width N                   issue/retire width
+ *     --window N                  reorder buffer entries
+ *     --mispredict-penalty N      cycles
+ *     --bp-entries N              predictor table entries (power of two)
+ *     --bp-history N              global history bits (0 = bimodal)
+ *     --latency CLASS=N           e.g. int_muldiv=5, fp_divsqrt=30
+ *     --perf                      print PerfCounters blocks per region
+ *     --csv                       CSV output
+ *   plus the cache options of cachesim (--preset, --level, --prefetch, ...)
+ */
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cycle_model.h"
+
+#define READ_BATCH 4096
+
+static const char *const region_names[REGION_COUNT] = {
+    "(unmarked)",
+    KERNEL_REGIONS(REGION_NAME_ENTRY)
+};
+
+static void print_usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [options] TRACE\n"
+            "  --core NAME               generic (default), u74, c910\n"
+            "  --pipeline KIND           in-order, out-of-order\n"
+            "  --width N                 issue/retire width\n"
+            "  --window N                reorder buffer entries\n"
+            "  --mispredict-penalty N    branch mispredict penalty in cycles\n"
+            "  --bp-entries N            branch predictor entries\n"
+            "  --bp-history N            global history bits (0 = bimodal)\n"
+            "  --latency CLASS=N         execute latency of an instruction class\n"
+            "  --perf                    print PerfCounters per region\n"
+            "  --csv                     CSV output\n"
+            "Cache options as for cachesim: --preset, --level, --memory-latency,\n"
+            "  --prefetch, --prefetch-degree, --prefetch-level, --seed\n",
+            program);
+}
+
+static double per_kilo(long long events, long long insns) {
+    return insns ? 1000.0 * (double)events / (double)insns : 0.0;
+}
+
+static void print_report(const CycleModel *model, int csv, int perf) {
+    if (csv) {
+        printf("region,instructions,cycles,ipc,branch_misses,l1_misses\n");
+    } else if (!perf) {
+        printf("%-26s %14s %14s %6s %6s %10s %7s %10s %7s\n", "Region", "Insns", "Cycles",
+               "IPC", "CPI", "BrMiss", "BrMPKI", "L1Miss", "L1MPKI");
+    }
+
+    for (int r = 0; r < REGION_COUNT; r++) {
+        PerfCounters c;
+        cycle_model_counters(model, r, &c);
+        if (c.instructions == 0) continue;
+
+        double ipc = c.cycles ? (double)c.instructions / (double)c.cycles : 0.0;
+        if (csv) {
+            printf("%s,%lld,%lld,%.4f,%lld,%lld\n", region_names[r], c.instructions, c.cycles,
+                   ipc, c.branch_misses, c.cache_misses);
+        } else if (perf) {
+            printf("\n%s\n", region_names[r]);
+            perf_counters_print(&c);
+        } else {
+            printf("%-26s %14lld %14lld %6.3f %6.2f %10lld %7.2f %10lld %7.2f\n",
+                   region_names[r], c.instructions, c.cycles, ipc,
+                   ipc > 0.0 ? 1.0 / ipc : 0.0,
+                   c.branch_misses, per_kilo(c.branch_misses, c.instructions),
+                   c.cache_misses, per_kilo(c.cache_misses, c.instructions));
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    CoreConfig core;
+    CacheConfig cache_config;
+    const char *trace_path = NULL;
+    int csv = 0;
+    int perf = 0;
+    int custom_levels = 0;
+    int cache_options = 0;
+
+    core_config_preset(&core, "generic");
+    cache_config_init(&cache_config);
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--csv") == 0) {
+            csv = 1;
+            continue;
+        }
+        if (strcmp(arg, "--perf") == 0) {
+            perf = 1;
+            continue;
+        }
+        if (arg[0] != '-') {
+            trace_path = arg;
+            continue;
+        }
+        if (!value) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        i++;
+
+        int consumed = core_config_parse_option(&core, arg, value);
+        if (consumed == 0) {
+            consumed = cache_config_parse_option(&cache_config, arg, value, &custom_levels);
+            if (consumed > 0) cache_options = 1;
+        }
+        if (consumed < 0) return 1;
+        if (consumed == 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!trace_path) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (!cache_options) cache_config_preset(&cache_config, core.name);
+    if (cache_config_validate(&cache_config) != 0) return 1;
+
+    FILE *in = fopen(trace_path, "rb");
+    if (!in) {
+        fprintf(stderr, "Cannot open trace %s\n", trace_path);
+        return 1;
+    }
+
+    char magic[8];
+    if (fread(magic, 1, sizeof(magic), in) != sizeof(magic) ||
+        memcmp(magic, MEM_TRACE_MAGIC, sizeof(magic)) != 0) {
+        fprintf(stderr, "%s is not a kernel_profile memory trace\n", trace_path);
+        fclose(in);
+        return 1;
+    }
+
+    CacheHierarchy *cache = cache_hierarchy_create(&cache_config);
+    CycleModel *model = cache ? cycle_model_create(&core, cache) : NULL;
+    if (!model) {
+        fprintf(stderr, "Invalid core or cache configuration\n");
+        cache_hierarchy_destroy(cache);
+        fclose(in);
+        return 1;
+    }
+
+    static MemTraceRecord batch[READ_BATCH];
+    uint64_t insn_records = 0;
+    size_t n;
+    while ((n = fread(batch, sizeof(MemTraceRecord), READ_BATCH, in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (batch[i].type == TRACE_INSN) insn_records++;
+            cycle_model_record(model, &batch[i]);
+        }
+    }
+    fclose(in);
+    cycle_model_finish(model);
+
+    if (insn_records == 0) {
+        fprintf(stderr, "%s has no instruction records; capture it with insns=on\n", trace_path);
+    }
+
+    if (!csv) {
+        core_config_print(&core);
+        cache_config_print(&cache_config);
+    }
+    print_report(model, csv, perf);
+
+    cycle_model_destroy(model);
+    cache_hierarchy_destroy(cache);
+    return 0;
+}
@@ -0,0 +1,346 @@
+/*
+ * QEMU TCG plugin: per-kernel dynamic instruction counts for RISC-V.
+ *
+ * Instructions are attributed to the innermost region opened by the
+ * markers in include/region_marker.h. For every region the plugin
+ * reports the dynamic instruction count, the instruction-class mix and
+ * the number and volume of guest memory accesses. Marker instructions
+ * themselves are not counted.
+ *
+ * Usage (user-mode emulation; static qemu builds cannot load plugins):
+ *   qemu-riscv64 -L /usr/riscv64-linux-gnu \
+ *       -plugin build/plugins/libkernel_profile.so,outfile=icount.txt \
+ *       build/riscv/riscv_optimizer --filter string/ --repeat 1
+ *
+ * Arguments:
+ *   outfile=PATH   write the report to PATH instead of stderr
+ *   csv=on         emit CSV instead of a table
+ *   trace=PATH     also write a binary memory-access trace (mem_trace.h)
+ *                  for the offline tools in tools/cachesim
+ *   insns=on       add a record per executed instruction to the trace
+ *                  (needed by the cycle model; much larger traces)
+ */
+#include <qemu-plugin.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mem_trace.h"
+#include "region_marker.h"
+#include "riscv_decode.h"
+
+QEMU_PLUGIN_EXPORT int qemu_plugin_version = QEMU_PLUGIN_VERSION;
+
+#define MAX_VCPUS 1024          /* linux-user allocates one per guest thread */
+#define MAX_REGION_DEPTH 16
+
+typedef struct {
+    uint64_t insns;
+    uint64_t classes[INSN_CLASS_COUNT];
+    uint64_t entries;
+    uint64_t mem_reads;
+    uint64_t mem_writes;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+} RegionStats;
+
+typedef struct {
+    int depth;
+    int stack[MAX_REGION_DEPTH];
+} VcpuRegions;
+
+/* Straight-line run of a TB between markers, counted with one callback */
+typedef struct {
+    uint64_t insns;
+    uint64_t classes[INSN_CLASS_COUNT];
+} Segment;
+
+static const char *const region_names[REGION_COUNT] = {
+    "(unmarked)",
+    KERNEL_REGIONS(REGION_NAME_ENTRY)
+};
+
+static RegionStats stats[REGION_COUNT];
+static VcpuRegions vcpus[MAX_VCPUS];
+static const char *output_path = NULL;
+static int output_csv = 0;
+
+#define TRACE_FLUSH_RECORDS 8192
+
+static FILE *trace_file = NULL;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static MemTraceRecord trace_buffer[TRACE_FLUSH_RECORDS];
+static size_t trace_pending = 0;
+static int trace_insns = 0;
+
+/* Per-instruction trace payload, allocated at translation time */
+typedef struct {
+    uint64_t pc;
+    uint32_t raw;
+    uint8_t cls;
+} TracedInsn;
+
+/* Caller holds trace_lock */
+static void trace_flush(void) {
+    if (trace_pending) {
+        fwrite(trace_buffer, sizeof(MemTraceRecord), trace_pending, trace_file);
+        trace_pending = 0;
+    }
+}
+
+static void trace_emit(unsigned int vcpu_index, TraceRecordType type, uint64_t addr,
+                       uint64_t pc, unsigned int size, uint32_t insn) {
+    if (!trace_file) return;
+
+    pthread_mutex_lock(&trace_lock);
+    MemTraceRecord *rec = &trace_buffer[trace_pending++];
+    rec->addr = addr;
+    rec->pc = pc;
+    rec->type = (uint8_t)type;
+    rec->size = (uint8_t)size;
+    rec->vcpu = (uint16_t)vcpu_index;
+    rec->insn = insn;
+    if (trace_pending == TRACE_FLUSH_RECORDS) trace_flush();
+    pthread_mutex_unlock(&trace_lock);
+}
+
+/* Levels nested past MAX_REGION_DEPTH count towards the deepest tracked one */
+static inline int current_region(unsigned int vcpu_index) {
+    const VcpuRegions *v = &vcpus[vcpu_index % MAX_VCPUS];
+    if (v->depth == 0) return REGION_NONE;
+    int region = v->stack[(v->depth < MAX_REGION_DEPTH ? v->depth : MAX_REGION_DEPTH) - 1];
+    return region > REGION_NONE && region < REGION_COUNT ? region : REGION_NONE;
+}
+
+static inline void stat_add(uint64_t *counter, uint64_t value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static void segment_exec(unsigned int vcpu_index, void *udata) {
+    const Segment *seg = udata;
+    RegionStats *r = &stats[current_region(vcpu_index)];
+
+    stat_add(&r->insns, seg->insns);
+    for (int c = 0; c < INSN_CLASS_COUNT; c++) {
+        if (seg->classes[c]) stat_add(&r->classes[c], seg->classes[c]);
+    }
+}
+
+static void marker_begin(unsigned int vcpu_index, void *udata) {
+    VcpuRegions *v = &vcpus[vcpu_index % MAX_VCPUS];
+    int region = (int)(uintptr_t)udata;
+    if (region <= REGION_NONE || region >= REGION_COUNT) region = REGION_NONE;
+
+    // Keep the stack balanced even when it overflows: extra levels
+    // are attributed to the deepest tracked region
+    if (v->depth < MAX_REGION_DEPTH) {
+        v->stack[v->depth] = region;
+    }
+    v->depth++;
+    stat_add(&stats[region].entries, 1);
+    trace_emit(vcpu_index, TRACE_REGION_BEGIN, (uint64_t)region, 0, 0, 0);
+}
+
+static void marker_end(unsigned int vcpu_index, void *udata) {
+    VcpuRegions *v = &vcpus[vcpu_index % MAX_VCPUS];
+    (void)udata;
+    if (v->depth > 0) v->depth--;
+    trace_emit(vcpu_index, TRACE_REGION_END, 0, 0, 0, 0);
+}
+
+static void mem_access(unsigned int vcpu_index, qemu_plugin_meminfo_t info,
+                       uint64_t vaddr, void *udata) {
+    RegionStats *r = &stats[current_region(vcpu_index)];
+    uint64_t bytes = 1ULL << qemu_plugin_mem_size_shift(info);
+    int store = qemu_plugin_mem_is_store(info);
+
+    if (store) {
+        stat_add(&r->mem_writes, 1);
+        stat_add(&r->bytes_written, bytes);
+    } else {
+        stat_add(&r->mem_reads, 1);
+        stat_add(&r->bytes_read, bytes);
+    }
+    trace_emit(vcpu_index, store ? TRACE_STORE : TRACE_LOAD, vaddr,
+               (uint64_t)(uintptr_t)udata, (unsigned int)bytes, 0);
+}
+
+static void insn_exec(unsigned int vcpu_index, void *udata) {
+    const TracedInsn *t = udata;
+    trace_emit(vcpu_index, TRACE_INSN, t->pc, 0, t->cls, t->raw);
+}
+
+/* First (up to) 4 bytes of the instruction, little-endian */
+static uint32_t insn_word(const struct qemu_plugin_insn *insn) {
+    uint32_t raw = 0;
+#if QEMU_PLUGIN_VERSION >= 3
+    qemu_plugin_insn_data(insn, &raw, sizeof(raw));
+#else
+    size_t size = qemu_plugin_insn_size(insn);
+    memcpy(&raw, qemu_plugin_insn_data(insn), size < sizeof(raw) ? size : sizeof(raw));
+#endif
+    return raw;
+}
+
+static void vcpu_tb_trans(qemu_plugin_id_t id, struct qemu_plugin_tb *tb) {
+    size_t n = qemu_plugin_tb_n_insns(tb);
+    Segment *seg = NULL;
+    (void)id;
+
+    for (size_t i = 0; i < n; i++) {
+        struct qemu_plugin_insn *insn = qemu_plugin_tb_get_insn(tb, i);
+        uint32_t raw = insn_word(insn);
+        int region = REGION_NONE;
+
+        MarkerKind kind = riscv_marker_kind(raw, &region);
+        if (kind == MARKER_BEGIN) {
+            if (region <= REGION_NONE || region >= REGION_COUNT) region = REGION_NONE;
+            qemu_plugin_register_vcpu_insn_exec_cb(insn, marker_begin, QEMU_PLUGIN_CB_NO_REGS,
+                                                   (void *)(uintptr_t)region);
+            seg = NULL;
+            continue;
+        }
+        if (kind == MARKER_END) {
+            qemu_plugin_register_vcpu_insn_exec_cb(insn, marker_end, QEMU_PLUGIN_CB_NO_REGS, NULL);
+            seg = NULL;
+            continue;
+        }
+
+        // Segments live as long as their TB may be executed; like the
+        // upstream example plugins we never free them
+        if (!seg) {
+            seg = calloc(1, sizeof(Segment));
+            if (!seg) return;
+            qemu_plugin_register_vcpu_insn_exec_cb(insn, segment_exec, QEMU_PLUGIN_CB_NO_REGS, seg);
+        }
+
+        InsnClass cls = riscv_classify(raw);
+        seg->insns++;
+        seg->classes[cls]++;
+
+        if (trace_insns) {
+            TracedInsn *t = malloc(sizeof(TracedInsn));
+            if (t) {
+                t->pc = qemu_plugin_insn_vaddr(insn);
+                t->raw = riscv_insn_length(raw) == 2 ? (raw & 0xffff) : raw;
+                t->cls = (uint8_t)cls;
+                qemu_plugin_register_vcpu_insn_exec_cb(insn, insn_exec, QEMU_PLUGIN_CB_NO_REGS, t);
+            }
+        }
+
+        if (cls == INSN_LOAD || cls == INSN_STORE || cls == INSN_ATOMIC || cls == INSN_VECTOR_MEM) {
+            // The instruction address rides in udata for PC-indexed prefetchers
+            qemu_plugin_register_vcpu_mem_cb(insn, mem_access, QEMU_PLUGIN_CB_NO_REGS,
+                                             QEMU_PLUGIN_MEM_RW,
+                                             (void *)(uintptr_t)qemu_plugin_insn_vaddr(insn));
+        }
+    }
+}
+
+static void write_report(FILE *out) {
+    uint64_t total = 0;
+    for (int r = 0; r < REGION_COUNT; r++) {
+        total += stats[r].insns;
+    }
+
+    if (output_csv) {
+        fprintf(out, "region,entries,insns");
+        for (int c = 0; c < INSN_CLASS_COUNT; c++) {
+            fprintf(out, ",%s", insn_class_names[c]);
+        }
+        fprintf(out, ",mem_reads,mem_writes,bytes_read,bytes_written\n");
+    } else {
+        fprintf(out, "Kernel region instruction profile (%" PRIu64 " instructions)\n", total);
+        fprintf(out, "%-26s %10s %14s %6s %6s %6s %6s %6s %6s %6s %12s %12s\n",
+                "Region", "Entries", "Insns", "%", "Load%", "Store%", "Br%",
+                "FP%", "Vec%", "MulD%", "MemReads", "MemWrites");
+    }
+
+    for (int r = 0; r < REGION_COUNT; r++) {
+        const RegionStats *s = &stats[r];
+        if (s->insns == 0) continue;
+
+        if (output_csv) {
+            fprintf(out, "%s,%" PRIu64 ",%" PRIu64, region_names[r], s->entries, s->insns);
+            for (int c = 0; c < INSN_CLASS_COUNT; c++) {
+                fprintf(out, ",%" PRIu64, s->classes[c]);
+            }
+            fprintf(out, ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                    s->mem_reads, s->mem_writes, s->bytes_read, s->bytes_written);
+            continue;
+        }
+
+        double n = (double)s->insns;
+        fprintf(out, "%-26s %10" PRIu64 " %14" PRIu64 " %6.1f %6.1f %6.1f %6.1f %6.1f %6.1f %6.1f"
+                " %12" PRIu64 " %12" PRIu64 "\n",
+                region_names[r], s->entries, s->insns, 100.0 * n / total,
+                100.0 * s->classes[INSN_LOAD] / n,
+                100.0 * s->classes[INSN_STORE] / n,
+                100.0 * (s->classes[INSN_BRANCH] + s->classes[INSN_JUMP]) / n,
+                100.0 * (s->classes[INSN_FP] + s->classes[INSN_FP_DIVSQRT]) / n,
+                100.0 * (s->classes[INSN_VECTOR] + s->classes[INSN_VECTOR_MEM]) / n,
+                100.0 * s->classes[INSN_INT_MULDIV] / n,
+                s->mem_reads, s->mem_writes);
+    }
+}
+
+static void plugin_exit(qemu_plugin_id_t id, void *p) {
+    (void)id;
+    (void)p;
+
+    if (trace_file) {
+        pthread_mutex_lock(&trace_lock);
+        trace_flush();
+        fclose(trace_file);
+        trace_file = NULL;
+        pthread_mutex_unlock(&trace_lock);
+    }
+
+    FILE *out = output_path ? fopen(output_path, "w") : stderr;
+    if (!out) {
+        fprintf(stderr, "kernel_profile: cannot open %s\n", output_path);
+        out = stderr;
+    }
+    write_report(out);
+    if (out != stderr) fclose(out);
+}
+
+QEMU_PLUGIN_EXPORT int qemu_plugin_install(qemu_plugin_id_t id, const qemu_info_t *info,
+                                           int argc, char **argv) {
+    if (strncmp(info->target_name, "riscv", 5) != 0) {
+        fprintf(stderr, "kernel_profile: only RISC-V targets are supported (got %s)\n",
+                info->target_name);
+        return -1;
+    }
+
+    for (int i = 0; i < argc; i++) {
+        if (strncmp(argv[i], "outfile=", 8) == 0) {
+            output_path = strdup(argv[i] + 8);
+        } else if (strcmp(argv[i], "csv=on") == 0) {
+            output_csv = 1;
+        } else if (strncmp(argv[i], "trace=", 6) == 0) {
+            trace_file = fopen(argv[i] + 6, "wb");
+            if (!trace_file) {
+                fprintf(stderr, "kernel_profile: cannot create trace %s\n", argv[i] + 6);
+                return -1;
+            }
+            fwrite(MEM_TRACE_MAGIC, 1, 8, trace_file);
+        } else if (strcmp(argv[i], "insns=on") == 0) {
+            trace_insns = 1;
+        } else {
+            fprintf(stderr, "kernel_profile: unknown argument %s\n", argv[i]);
+            return -1;
+        }
+    }
+
+    if (trace_insns && !trace_file) {
+        fprintf(stderr, "kernel_profile: insns=on requires trace=PATH\n");
+        return -1;
+    }
+
+    qemu_plugin_register_vcpu_tb_trans_cb(id, vcpu_tb_trans);
+    qemu_plugin_register_atexit_cb(id, plugin_exit, NULL);
+    return 0;
+}
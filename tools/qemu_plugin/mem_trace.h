@@ -0,0 +1,33 @@
+#ifndef MEM_TRACE_H
+#define MEM_TRACE_H
+
+#include <stdint.h>
+
+/*
+ * Binary trace written by the kernel_profile plugin (trace=PATH) and read
+ * by the offline tools in tools/cachesim. The file starts with an 8-byte
+ * magic followed by fixed-size little-endian records in execution order
+ * (records from different vCPUs interleave). With instruction records
+ * enabled, each TRACE_INSN precedes the loads and stores it performs.
+ */
+
+#define MEM_TRACE_MAGIC "RVTRACE1"
+
+typedef enum {
+    TRACE_LOAD = 0,         /* addr = data address, size = bytes */
+    TRACE_STORE,
+    TRACE_REGION_BEGIN,     /* addr = region id */
+    TRACE_REGION_END,
+    TRACE_INSN              /* addr = pc, size = InsnClass (plugin insns=on) */
+} TraceRecordType;
+
+typedef struct {
+    uint64_t addr;
+    uint64_t pc;            /* instruction address for loads/stores */
+    uint8_t type;
+    uint8_t size;
+    uint16_t vcpu;
+    uint32_t insn;          /* raw encoding for TRACE_INSN, 0 otherwise */
+} MemTraceRecord;
+
+#endif /* MEM_TRACE_H */
@@ -0,0 +1,282 @@
+#ifndef RISCV_DECODE_H
+#define RISCV_DECODE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Minimal RV64GCV instruction classifier used by the QEMU plugin and the
+ * offline trace tools. Only the fields needed to bucket instructions,
+ * spot region markers and follow register dependencies are decoded.
+ */
+
+typedef enum {
+    INSN_INT_ALU = 0,
+    INSN_INT_MULDIV,
+    INSN_LOAD,
+    INSN_STORE,
+    INSN_BRANCH,
+    INSN_JUMP,
+    INSN_FP,
+    INSN_FP_DIVSQRT,
+    INSN_VECTOR,
+    INSN_VECTOR_MEM,
+    INSN_ATOMIC,
+    INSN_SYSTEM,
+    INSN_CLASS_COUNT
+} InsnClass;
+
+static const char *const insn_class_names[INSN_CLASS_COUNT] = {
+    "int_alu", "int_muldiv", "load", "store", "branch", "jump",
+    "fp", "fp_divsqrt", "vector", "vector_mem", "atomic", "system"
+};
+
+typedef enum {
+    MARKER_NONE = 0,
+    MARKER_BEGIN,
+    MARKER_END
+} MarkerKind;
+
+/* Instruction length from the low bits of the first parcel */
+static inline size_t riscv_insn_length(uint32_t insn) {
+    return ((insn & 3) == 3) ? 4 : 2;
+}
+
+/* Region markers from region_marker.h: slli/srli with rd = x0 */
+static inline MarkerKind riscv_marker_kind(uint32_t insn, int *region) {
+    if ((insn & 3) != 3) return MARKER_NONE;
+
+    uint32_t opcode = insn & 0x7f;
+    uint32_t rd = (insn >> 7) & 0x1f;
+    uint32_t funct3 = (insn >> 12) & 7;
+    uint32_t funct6 = insn >> 26;
+    if (opcode != 0x13 || rd != 0 || funct6 != 0) return MARKER_NONE;
+
+    if (funct3 == 1) {
+        uint32_t rs1 = (insn >> 15) & 0x1f;
+        uint32_t shamt = (insn >> 20) & 0x3f;
+        if (region) *region = (int)((rs1 << 6) | shamt);
+        return MARKER_BEGIN;
+    }
+    if (funct3 == 5 && ((insn >> 15) & 0x1f) == 0 && ((insn >> 20) & 0x3f) == 1) {
+        return MARKER_END;
+    }
+    return MARKER_NONE;
+}
+
+static inline InsnClass riscv_classify_compressed(uint32_t insn) {
+    uint32_t quadrant = insn & 3;
+    uint32_t funct3 = (insn >> 13) & 7;
+
+    switch (quadrant) {
+    case 0:
+        if (funct3 == 0) return INSN_INT_ALU;            /* c.addi4spn */
+        return (funct3 < 4) ? INSN_LOAD : INSN_STORE;    /* c.fld/lw/ld, c.fsd/sw/sd */
+    case 1:
+        if (funct3 == 5) return INSN_JUMP;               /* c.j */
+        if (funct3 >= 6) return INSN_BRANCH;             /* c.beqz/c.bnez */
+        return INSN_INT_ALU;
+    default:
+        if (funct3 == 0) return INSN_INT_ALU;            /* c.slli */
+        if (funct3 < 4) return INSN_LOAD;                /* c.fldsp/lwsp/ldsp */
+        if (funct3 > 4) return INSN_STORE;               /* c.fsdsp/swsp/sdsp */
+        {
+            uint32_t rd = (insn >> 7) & 0x1f;
+            uint32_t rs2 = (insn >> 2) & 0x1f;
+            if (rs2 == 0 && rd != 0) return INSN_JUMP;   /* c.jr/c.jalr */
+            if (rs2 == 0 && rd == 0) return INSN_SYSTEM; /* c.ebreak */
+            return INSN_INT_ALU;                         /* c.mv/c.add */
+        }
+    }
+}
+
+static inline InsnClass riscv_classify(uint32_t insn) {
+    if ((insn & 3) != 3) return riscv_classify_compressed(insn & 0xffff);
+
+    uint32_t opcode = insn & 0x7f;
+    uint32_t funct3 = (insn >> 12) & 7;
+    uint32_t funct7 = insn >> 25;
+
+    switch (opcode) {
+    case 0x03: return INSN_LOAD;
+    case 0x23: return INSN_STORE;
+    case 0x07:                                          /* LOAD-FP / vector loads */
+    case 0x27:                                          /* STORE-FP / vector stores */
+        if (funct3 == 0 || funct3 >= 5) return INSN_VECTOR_MEM;
+        return (opcode == 0x07) ? INSN_LOAD : INSN_STORE;
+    case 0x63: return INSN_BRANCH;
+    case 0x67:
+    case 0x6f: return INSN_JUMP;
+    case 0x33:
+    case 0x3b: return (funct7 == 1) ? INSN_INT_MULDIV : INSN_INT_ALU;
+    case 0x13:
+    case 0x1b:
+    case 0x37:
+    case 0x17: return INSN_INT_ALU;
+    case 0x43:
+    case 0x47:
+    case 0x4b:
+    case 0x4f: return INSN_FP;                           /* fused multiply-add */
+    case 0x53: {
+        uint32_t funct5 = funct7 >> 2;
+        return (funct5 == 0x03 || funct5 == 0x0b) ? INSN_FP_DIVSQRT : INSN_FP;
+    }
+    case 0x57: return INSN_VECTOR;
+    case 0x2f: return INSN_ATOMIC;
+    default:   return INSN_SYSTEM;                       /* fences, CSRs, ecall */
+    }
+}
+
+/*
+ * Register operands for dependency tracking. Registers are numbered
+ * x0-x31 = 0-31, f0-f31 = 32-63, v0-v31 = 64-95; x0 and unused slots
+ * are REG_NONE. Vector masks and grouping (LMUL > 1) are ignored.
+ */
+#define REG_NONE (-1)
+#define REG_X(n) ((int)(n) == 0 ? REG_NONE : (int)(n))
+#define REG_F(n) (32 + (int)(n))
+#define REG_V(n) (64 + (int)(n))
+#define RISCV_REG_COUNT 96
+
+typedef struct {
+    int dst;
+    int src[3];
+} InsnOperands;
+
+static inline void riscv_operands_compressed(uint32_t insn, InsnOperands *ops) {
+    uint32_t funct3 = (insn >> 13) & 7;
+    uint32_t rd = (insn >> 7) & 0x1f;          /* also rs1 in CI/CR forms */
+    uint32_t rs2 = (insn >> 2) & 0x1f;
+    uint32_t rd_p = 8 + ((insn >> 2) & 7);     /* rd'/rs2' */
+    uint32_t rs1_p = 8 + ((insn >> 7) & 7);    /* rs1'/rd' */
+
+    switch (insn & 3) {
+    case 0:
+        if (funct3 == 0) { ops->dst = REG_X(rd_p); ops->src[0] = REG_X(2); }
+        else if (funct3 == 1) { ops->dst = REG_F(rd_p); ops->src[0] = REG_X(rs1_p); }
+        else if (funct3 < 4) { ops->dst = REG_X(rd_p); ops->src[0] = REG_X(rs1_p); }
+        else if (funct3 == 5) { ops->src[0] = REG_X(rs1_p); ops->src[1] = REG_F(rd_p); }
+        else if (funct3 > 5) { ops->src[0] = REG_X(rs1_p); ops->src[1] = REG_X(rd_p); }
+        break;
+    case 1:
+        if (funct3 <= 1) { ops->dst = REG_X(rd); ops->src[0] = REG_X(rd); }        /* c.addi(w) */
+        else if (funct3 == 2) { ops->dst = REG_X(rd); }                            /* c.li */
+        else if (funct3 == 3) {                                                    /* c.lui/addi16sp */
+            ops->dst = REG_X(rd);
+            if (rd == 2) ops->src[0] = REG_X(2);
+        } else if (funct3 == 4) {
+            ops->dst = REG_X(rs1_p);
+            ops->src[0] = REG_X(rs1_p);
+            if (((insn >> 10) & 3) == 3) ops->src[1] = REG_X(rd_p);
+        } else if (funct3 >= 6) { ops->src[0] = REG_X(rs1_p); }                    /* c.beqz/bnez */
+        break;
+    default:
+        if (funct3 == 0) { ops->dst = REG_X(rd); ops->src[0] = REG_X(rd); }        /* c.slli */
+        else if (funct3 == 1) { ops->dst = REG_F(rd); ops->src[0] = REG_X(2); }
+        else if (funct3 < 4) { ops->dst = REG_X(rd); ops->src[0] = REG_X(2); }
+        else if (funct3 == 4) {
+            int bit12 = (insn >> 12) & 1;
+            if (rs2 == 0) {
+                ops->src[0] = REG_X(rd);                                           /* c.jr/c.jalr */
+                if (bit12) ops->dst = REG_X(1);
+            } else {
+                ops->dst = REG_X(rd);                                              /* c.mv/c.add */
+                ops->src[0] = REG_X(rs2);
+                if (bit12) ops->src[1] = REG_X(rd);
+            }
+        } else if (funct3 == 5) { ops->src[0] = REG_X(2); ops->src[1] = REG_F(rs2); }
+        else { ops->src[0] = REG_X(2); ops->src[1] = REG_X(rs2); }
+        break;
+    }
+}
+
+static inline void riscv_operands(uint32_t insn, InsnOperands *ops) {
+    ops->dst = REG_NONE;
+    ops->src[0] = ops->src[1] = ops->src[2] = REG_NONE;
+
+    if ((insn & 3) != 3) {
+        riscv_operands_compressed(insn & 0xffff, ops);
+        return;
+    }
+
+    uint32_t opcode = insn & 0x7f;
+    uint32_t rd = (insn >> 7) & 0x1f;
+    uint32_t funct3 = (insn >> 12) & 7;
+    uint32_t rs1 = (insn >> 15) & 0x1f;
+    uint32_t rs2 = (insn >> 20) & 0x1f;
+
+    switch (opcode) {
+    case 0x03: ops->dst = REG_X(rd); ops->src[0] = REG_X(rs1); break;
+    case 0x07:
+        ops->dst = (funct3 == 0 || funct3 >= 5) ? REG_V(rd) : REG_F(rd);
+        ops->src[0] = REG_X(rs1);
+        break;
+    case 0x23: ops->src[0] = REG_X(rs1); ops->src[1] = REG_X(rs2); break;
+    case 0x27:
+        ops->src[0] = REG_X(rs1);
+        ops->src[1] = (funct3 == 0 || funct3 >= 5) ? REG_V(rd) : REG_F(rs2);   /* vs3 sits in rd */
+        break;
+    case 0x63: ops->src[0] = REG_X(rs1); ops->src[1] = REG_X(rs2); break;
+    case 0x67: ops->dst = REG_X(rd); ops->src[0] = REG_X(rs1); break;
+    case 0x6f:
+    case 0x37:
+    case 0x17: ops->dst = REG_X(rd); break;
+    case 0x13:
+    case 0x1b: ops->dst = REG_X(rd); ops->src[0] = REG_X(rs1); break;
+    case 0x33:
+    case 0x3b:
+    case 0x2f: ops->dst = REG_X(rd); ops->src[0] = REG_X(rs1); ops->src[1] = REG_X(rs2); break;
+    case 0x43:
+    case 0x47:
+    case 0x4b:
+    case 0x4f:
+        ops->dst = REG_F(rd);
+        ops->src[0] = REG_F(rs1);
+        ops->src[1] = REG_F(rs2);
+        ops->src[2] = REG_F(insn >> 27);
+        break;
+    case 0x53:
+        switch (insn >> 27) {
+        case 0x08:                                          /* fcvt fp <- fp */
+        case 0x0b:                                          /* fsqrt; rs2 is an encoding field */
+            ops->dst = REG_F(rd); ops->src[0] = REG_F(rs1); break;
+        case 0x14:                                          /* feq/flt/fle */
+            ops->dst = REG_X(rd); ops->src[0] = REG_F(rs1); ops->src[1] = REG_F(rs2); break;
+        case 0x18:                                          /* fcvt int <- fp */
+        case 0x1c:                                          /* fmv.x / fclass */
+            ops->dst = REG_X(rd); ops->src[0] = REG_F(rs1); break;
+        case 0x1a:                                          /* fcvt fp <- int */
+        case 0x1e:                                          /* fmv.w.x / fmv.d.x */
+            ops->dst = REG_F(rd); ops->src[0] = REG_X(rs1); break;
+        default:
+            ops->dst = REG_F(rd); ops->src[0] = REG_F(rs1); ops->src[1] = REG_F(rs2); break;
+        }
+        break;
+    case 0x57:
+        if (funct3 == 7) {                                  /* vsetvl{i} */
+            ops->dst = REG_X(rd);
+            ops->src[0] = REG_X(rs1);
+            break;
+        }
+        ops->dst = REG_V(rd);
+        ops->src[0] = REG_V(rs2);
+        if (funct3 <= 2) ops->src[1] = REG_V(rs1);          /* .vv */
+        else if (funct3 == 5) ops->src[1] = REG_F(rs1);     /* .vf */
+        else if (funct3 != 3) ops->src[1] = REG_X(rs1);     /* .vx */
+        break;
+    case 0x73:
+        if (funct3 != 0) ops->dst = REG_X(rd);
+        if (funct3 != 0 && !(funct3 & 4)) ops->src[0] = REG_X(rs1);   /* csrr*i: rs1 is a uimm */
+        break;
+    default:
+        break;
+    }
+}
+
+/* Direct jumps whose target is known at decode (jal, c.j) */
+static inline int riscv_is_direct_jump(uint32_t insn) {
+    if ((insn & 3) != 3) return (insn & 0xe003) == 0xa001;
+    return (insn & 0x7f) == 0x6f;
+}
+
+#endif /* RISCV_DECODE_H */